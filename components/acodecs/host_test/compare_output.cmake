@@ -0,0 +1,16 @@
+# Runs FIRST and SECOND with ARGS, and fails unless both succeed and print the
+# same thing.
+#
+#   cmake -DFIRST=prog -DSECOND=prog [-DARGS=args] -P compare_output.cmake
+foreach(prog FIRST SECOND)
+    execute_process(COMMAND ${${prog}} ${ARGS}
+        RESULT_VARIABLE result OUTPUT_VARIABLE output_${prog})
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${${prog}} failed: ${result}")
+    endif()
+endforeach()
+
+message("${output_FIRST}")
+if(NOT output_FIRST STREQUAL output_SECOND)
+    message(FATAL_ERROR "${SECOND} differs:\n${output_SECOND}")
+endif()
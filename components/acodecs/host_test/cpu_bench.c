@@ -0,0 +1,740 @@
+/*
+ * Emulated cycles per second of each gme CPU core, with audio output disabled,
+ * on generated files whose code never returns from init and so keeps the CPU
+ * busy the whole time. The loops mix loads, stores, arithmetic, shifts,
+ * branches, calls and stack use, and write what they compute to a sound
+ * register, so the output depends on every instruction and its timing.
+ *
+ * With -c, prints a checksum of each file's output instead, for comparing
+ * two builds of the cores. Files given on the command line replace the
+ * generated ones; for those, cycles/s is the CPU clock times the emulated
+ * time, which counts the time real rips spend idle.
+ *
+ * cpu_bench [-c] [seconds] [file...]
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <gme.h>
+
+#define SAMPLE_RATE 44100
+#define RUNS 3 /* timings are the best of this many */
+
+#define LO(n) ((n) & 0xFF)
+#define HI(n) ((n) >> 8 & 0xFF)
+
+typedef struct {
+	const char *name;
+	unsigned char *data;
+	long size;
+} Song;
+
+/* Code being assembled at address org */
+typedef struct {
+	unsigned char *code;
+	unsigned org;
+	int len;
+} Asm;
+
+static void emit(Asm *a, int count, ...)
+{
+	va_list args;
+
+	va_start(args, count);
+	while (count--) {
+		a->code[a->len++] = va_arg(args, int);
+	}
+	va_end(args);
+}
+
+static unsigned here(const Asm *a)
+{
+	return a->org + a->len;
+}
+
+/* Displacement of a relative branch to target, as the branch's last byte */
+static void rel(Asm *a, unsigned target)
+{
+	a->code[a->len] = target - (here(a) + 1);
+	a->len++;
+}
+
+static void put16(unsigned char *p, unsigned v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+static void put16be(unsigned char *p, unsigned v)
+{
+	p[0] = v >> 8;
+	p[1] = v;
+}
+
+/* 6502 loop shared by NSF, SAP and HES. buf is 257 bytes of RAM, and
+ * the stores of the value A holds to a sound register come from out(). */
+static void asm_6502(Asm *a, unsigned buf, void (*out)(Asm *))
+{
+	unsigned fill, outer, inner, sub, s1;
+	int skip, sub_call;
+
+	emit(a, 4, 0xA9, 0x01, 0x85, 0x10);             /* lda #1; sta $10 */
+	emit(a, 4, 0xA9, LO(buf), 0x85, 0x12);          /* pointer at $12 */
+	emit(a, 4, 0xA9, HI(buf), 0x85, 0x13);
+	emit(a, 2, 0xA2, 0x00);                         /* ldx #0 */
+	fill = here(a);
+	emit(a, 1, 0x8A);                               /* txa */
+	emit(a, 1, 0x0A);                               /* asl a */
+	emit(a, 2, 0x69, 0x07);                         /* adc #7 */
+	emit(a, 3, 0x9D, LO(buf), HI(buf));             /* sta buf,x */
+	emit(a, 1, 0xE8);                               /* inx */
+	emit(a, 1, 0xD0); rel(a, fill);                 /* bne fill */
+
+	outer = here(a);
+	emit(a, 2, 0xA0, 0x00);                         /* ldy #0 */
+	inner = here(a);
+	emit(a, 2, 0xB1, 0x12);                         /* lda ($12),y */
+	emit(a, 1, 0x18);                               /* clc */
+	emit(a, 2, 0x65, 0x10);                         /* adc $10 */
+	emit(a, 1, 0x2A);                               /* rol a */
+	emit(a, 2, 0x49, 0xA5);                         /* eor #$A5 */
+	emit(a, 2, 0x91, 0x12);                         /* sta ($12),y */
+	emit(a, 2, 0x85, 0x10);                         /* sta $10 */
+	emit(a, 2, 0x29, 0x3F);                         /* and #$3F */
+	emit(a, 1, 0xAA);                               /* tax */
+	emit(a, 3, 0xBD, LO(buf), HI(buf));             /* lda buf,x */
+	emit(a, 2, 0x05, 0x11);                         /* ora $11 */
+	emit(a, 1, 0x38);                               /* sec */
+	emit(a, 3, 0xF9, LO(buf + 1), HI(buf + 1));     /* sbc buf+1,y */
+	emit(a, 2, 0x85, 0x11);                         /* sta $11 */
+	emit(a, 2, 0xC9, 0x80);                         /* cmp #$80 */
+	emit(a, 2, 0x90, 0x02);                         /* bcc +2 */
+	emit(a, 2, 0x49, 0xFF);                         /* eor #$FF */
+	emit(a, 2, 0x24, 0x10);                         /* bit $10 */
+	emit(a, 2, 0x10, 0x02);                         /* bpl +2 */
+	emit(a, 2, 0xE6, 0x14);                         /* inc $14 */
+	emit(a, 2, 0xC6, 0x15);                         /* dec $15 */
+	emit(a, 2, 0x46, 0x16);                         /* lsr $16 */
+	emit(a, 2, 0x66, 0x17);                         /* ror $17 */
+	emit(a, 2, 0x95, 0x18);                         /* sta $18,x */
+	emit(a, 1, 0x48);                               /* pha */
+	emit(a, 1, 0x98);                               /* tya */
+	emit(a, 1, 0x48);                               /* pha */
+	emit(a, 2, 0xE5, 0x14);                         /* sbc $14 */
+	emit(a, 1, 0xA8);                               /* tay */
+	emit(a, 1, 0x68);                               /* pla */
+	emit(a, 1, 0xA8);                               /* tay */
+	emit(a, 1, 0x68);                               /* pla */
+	out(a);
+	emit(a, 1, 0xC8);                               /* iny */
+	emit(a, 1, 0xD0); rel(a, inner);                /* bne inner */
+	sub_call = a->len;
+	emit(a, 3, 0x20, 0, 0);                         /* jsr sub */
+	emit(a, 2, 0xA2, 0x00);                         /* ldx #0 */
+	emit(a, 2, 0xA1, 0x12);                         /* lda ($12,x) */
+	emit(a, 3, 0x4C, LO(outer), HI(outer));         /* jmp outer */
+
+	sub = here(a);
+	put16(a->code + sub_call + 1, sub);
+	emit(a, 5, 0x48, 0x8A, 0x48, 0x98, 0x48);       /* save a, x, y */
+	emit(a, 2, 0xA2, 0x08);                         /* ldx #8 */
+	s1 = here(a);
+	emit(a, 2, 0x06, 0x14);                         /* asl $14 */
+	emit(a, 2, 0x26, 0x15);                         /* rol $15 */
+	emit(a, 1, 0xCA);                               /* dex */
+	emit(a, 1, 0xD0); rel(a, s1);                   /* bne s1 */
+	emit(a, 2, 0xA4, 0x14);                         /* ldy $14 */
+	emit(a, 2, 0xC0, 0x40);                         /* cpy #$40 */
+	skip = a->len;
+	emit(a, 2, 0xB0, 0x00);                         /* bcs past */
+	emit(a, 2, 0xE6, 0x16);                         /* inc $16 */
+	emit(a, 3, 0xEE, LO(buf), HI(buf));             /* inc buf */
+	a->code[skip + 1] = a->len - (skip + 2);
+	emit(a, 2, 0x08, 0x28);                         /* php; plp */
+	emit(a, 5, 0x68, 0xA8, 0x68, 0xAA, 0x68);       /* restore y, x, a */
+	emit(a, 1, 0x60);                               /* rts */
+}
+
+/* DMC direct output */
+static void out_nes(Asm *a)
+{
+	emit(a, 3, 0x8D, 0x11, 0x40);                   /* sta $4011 */
+}
+
+static void make_nsf(Song *song)
+{
+	unsigned char *f = calloc(1, 0x80 + 0x400);
+	Asm a = { f + 0x80, 0x8000, 0 };
+
+	asm_6502(&a, 0x0300, out_nes);
+	emit(&a, 1, 0x60);                              /* play: rts */
+
+	memcpy(f, "NESM\x1A", 5);
+	f[5] = 1;                           /* version */
+	f[6] = 1;                           /* songs */
+	f[7] = 1;                           /* first song */
+	put16(f + 0x08, 0x8000);            /* load */
+	put16(f + 0x0A, 0x8000);            /* init */
+	put16(f + 0x0C, here(&a) - 1);      /* play */
+	put16(f + 0x6E, 16666);             /* NTSC frame period, us */
+
+	song->name = "NSF";
+	song->data = f;
+	song->size = 0x80 + a.len;
+}
+
+/* POKEY channel 1 in volume only mode */
+static void out_sap(Asm *a)
+{
+	emit(a, 2, 0x29, 0x0F);                         /* and #$0F */
+	emit(a, 2, 0x09, 0x10);                         /* ora #$10 */
+	emit(a, 3, 0x8D, 0x01, 0xD2);                   /* sta $D201 */
+}
+
+static void make_sap(Song *song)
+{
+	static const char header[] = "SAP\r\nTYPE B\r\nINIT 2000\r\nPLAYER 2000\r\n";
+	long head = sizeof header - 1;
+	unsigned char *f = calloc(1, head + 6 + 0x400);
+	Asm a = { f + head + 6, 0x2000, 0 };
+
+	asm_6502(&a, 0x3000, out_sap);
+
+	memcpy(f, header, head);
+	f[head] = f[head + 1] = 0xFF;
+	put16(f + head + 2, 0x2000);
+	put16(f + head + 4, here(&a) - 1);
+
+	song->name = "SAP";
+	song->data = f;
+	song->size = head + 6 + a.len;
+}
+
+/* PSG channel 0 in direct output mode */
+static void out_hes(Asm *a)
+{
+	emit(a, 3, 0x8D, 0x06, 0x08);                   /* sta $0806 */
+}
+
+static void make_hes(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x00, 0x00 }, { 0x01, 0xFF }, { 0x05, 0xFF }, { 0x04, 0xDF },
+	};
+	unsigned char *f = calloc(1, 0x20 + 0x400);
+	Asm a = { f + 0x20, 0x4000, 0 };
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		emit(&a, 2, 0xA9, regs[i][1]);              /* lda #value */
+		emit(&a, 3, 0x8D, regs[i][0], 0x08);        /* sta $08xx */
+	}
+	asm_6502(&a, 0x2300, out_hes);
+
+	memcpy(f, "HESM", 4);
+	put16(f + 0x06, 0x4000);            /* init */
+	f[0x08] = 0xFF;                     /* I/O at $0000 */
+	f[0x09] = 0xF8;                     /* RAM at $2000 */
+	memcpy(f + 0x10, "DATA", 4);
+	put16(f + 0x14, a.len);             /* size, loaded in bank 0 at $4000 */
+
+	song->name = "HES";
+	song->data = f;
+	song->size = 0x20 + a.len;
+}
+
+/* The same loop for the Game Boy CPU, setting the pitch of square 1 */
+static void make_gbs(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x26, 0x80 }, { 0x24, 0x77 }, { 0x25, 0xFF },
+		{ 0x11, 0x80 }, { 0x12, 0xF0 }, { 0x13, 0x00 }, { 0x14, 0x87 },
+	};
+	unsigned char *f = calloc(1, 0x70 + 0x400);
+	Asm a = { f + 0x70, 0x0400, 0 };
+	unsigned fill, outer, inner, sub;
+	int sub_call;
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		emit(&a, 2, 0x3E, regs[i][1]);              /* ld a,value */
+		emit(&a, 2, 0xE0, regs[i][0]);              /* ldh ($FFxx),a */
+	}
+	emit(&a, 3, 0x21, 0x00, 0xC0);                  /* ld hl,$C000 */
+	emit(&a, 2, 0x06, 0x00);                        /* ld b,0 */
+	fill = here(&a);
+	emit(&a, 1, 0x78);                              /* ld a,b */
+	emit(&a, 1, 0x87);                              /* add a,a */
+	emit(&a, 2, 0xC6, 0x07);                        /* add a,7 */
+	emit(&a, 1, 0x22);                              /* ld (hl+),a */
+	emit(&a, 1, 0x05);                              /* dec b */
+	emit(&a, 1, 0x20); rel(&a, fill);               /* jr nz,fill */
+
+	outer = here(&a);
+	emit(&a, 3, 0x21, 0x00, 0xC0);                  /* ld hl,$C000 */
+	emit(&a, 2, 0x0E, 0x00);                        /* ld c,0 */
+	inner = here(&a);
+	emit(&a, 1, 0x7E);                              /* ld a,(hl) */
+	emit(&a, 1, 0x83);                              /* add a,e */
+	emit(&a, 1, 0x17);                              /* rla */
+	emit(&a, 2, 0xEE, 0xA5);                        /* xor $A5 */
+	emit(&a, 1, 0x22);                              /* ld (hl+),a */
+	emit(&a, 1, 0x5F);                              /* ld e,a */
+	emit(&a, 2, 0xE6, 0x3F);                        /* and $3F */
+	emit(&a, 1, 0x57);                              /* ld d,a */
+	emit(&a, 1, 0x8A);                              /* adc a,d */
+	emit(&a, 1, 0x91);                              /* sub c */
+	emit(&a, 1, 0x47);                              /* ld b,a */
+	emit(&a, 2, 0xFE, 0x80);                        /* cp $80 */
+	emit(&a, 2, 0x38, 0x02);                        /* jr c,+2 */
+	emit(&a, 2, 0xEE, 0xFF);                        /* xor $FF */
+	emit(&a, 1, 0xC5);                              /* push bc */
+	emit(&a, 2, 0xCB, 0x37);                        /* swap a */
+	emit(&a, 2, 0xCB, 0x3F);                        /* srl a */
+	emit(&a, 2, 0xCB, 0x5F);                        /* bit 3,a */
+	emit(&a, 2, 0x28, 0x01);                        /* jr z,+1 */
+	emit(&a, 1, 0x1C);                              /* inc e */
+	emit(&a, 1, 0xC1);                              /* pop bc */
+	emit(&a, 2, 0xE0, 0x13);                        /* ldh ($FF13),a */
+	emit(&a, 1, 0x0D);                              /* dec c */
+	emit(&a, 1, 0x20); rel(&a, inner);              /* jr nz,inner */
+	sub_call = a.len;
+	emit(&a, 3, 0xCD, 0, 0);                        /* call sub */
+	emit(&a, 3, 0xC3, LO(outer), HI(outer));        /* jp outer */
+
+	sub = here(&a);
+	put16(a.code + sub_call + 1, sub);
+	emit(&a, 2, 0xE5, 0xD5);                        /* push hl; push de */
+	emit(&a, 3, 0x21, 0x00, 0xC1);                  /* ld hl,$C100 */
+	emit(&a, 1, 0x7B);                              /* ld a,e */
+	emit(&a, 1, 0x77);                              /* ld (hl),a */
+	emit(&a, 1, 0x34);                              /* inc (hl) */
+	emit(&a, 1, 0x56);                              /* ld d,(hl) */
+	emit(&a, 2, 0xCB, 0x12);                        /* rl d */
+	emit(&a, 2, 0xCB, 0x1B);                        /* rr e */
+	emit(&a, 2, 0xCB, 0x23);                        /* sla e */
+	emit(&a, 1, 0x19);                              /* add hl,de */
+	emit(&a, 2, 0xD1, 0xE1);                        /* pop de; pop hl */
+	emit(&a, 1, 0xC9);                              /* ret */
+	emit(&a, 1, 0xC9);                              /* play: ret */
+
+	memcpy(f, "GBS", 3);
+	f[3] = 1;                           /* version */
+	f[4] = 1;                           /* songs */
+	f[5] = 1;                           /* first song */
+	put16(f + 0x06, 0x0400);            /* load */
+	put16(f + 0x08, 0x0400);            /* init */
+	put16(f + 0x0A, here(&a) - 1);      /* play */
+	put16(f + 0x0C, 0xFFFE);            /* stack */
+
+	song->name = "GBS";
+	song->data = f;
+	song->size = 0x70 + a.len;
+}
+
+/* Z80 loop shared by KSS and AY, setting the pitch of AY channel A through
+ * psg(), which writes the value in A to the register in E */
+static void asm_z80(Asm *a, void (*psg)(Asm *))
+{
+	static const unsigned char regs[][2] = {
+		{ 0x07, 0x3E }, { 0x08, 0x0F }, { 0x01, 0x00 },
+	};
+	unsigned fill, outer, inner, sub;
+	int sub_call;
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		emit(a, 2, 0x1E, regs[i][0]);               /* ld e,reg */
+		emit(a, 2, 0x3E, regs[i][1]);               /* ld a,value */
+		psg(a);
+	}
+	emit(a, 3, 0x21, 0x00, 0xC0);                   /* ld hl,$C000 */
+	emit(a, 2, 0x06, 0x00);                         /* ld b,0 */
+	fill = here(a);
+	emit(a, 1, 0x78);                               /* ld a,b */
+	emit(a, 1, 0x87);                               /* add a,a */
+	emit(a, 2, 0xC6, 0x07);                         /* add a,7 */
+	emit(a, 1, 0x77);                               /* ld (hl),a */
+	emit(a, 1, 0x23);                               /* inc hl */
+	emit(a, 1, 0x10); rel(a, fill);                 /* djnz fill */
+	emit(a, 4, 0xDD, 0x21, 0x00, 0xC0);             /* ld ix,$C000 */
+
+	outer = here(a);
+	emit(a, 3, 0x21, 0x00, 0xC0);                   /* ld hl,$C000 */
+	emit(a, 2, 0x06, 0x00);                         /* ld b,0 */
+	inner = here(a);
+	emit(a, 1, 0x7E);                               /* ld a,(hl) */
+	emit(a, 1, 0x82);                               /* add a,d */
+	emit(a, 1, 0x17);                               /* rla */
+	emit(a, 2, 0xEE, 0xA5);                         /* xor $A5 */
+	emit(a, 1, 0x77);                               /* ld (hl),a */
+	emit(a, 1, 0x23);                               /* inc hl */
+	emit(a, 1, 0x57);                               /* ld d,a */
+	emit(a, 2, 0xE6, 0x3F);                         /* and $3F */
+	emit(a, 1, 0x4F);                               /* ld c,a */
+	emit(a, 3, 0xDD, 0x8E, 0x05);                   /* adc a,(ix+5) */
+	emit(a, 1, 0x91);                               /* sub c */
+	emit(a, 2, 0xFE, 0x80);                         /* cp $80 */
+	emit(a, 2, 0x38, 0x02);                         /* jr c,+2 */
+	emit(a, 2, 0xEE, 0xFF);                         /* xor $FF */
+	emit(a, 1, 0xC5);                               /* push bc */
+	emit(a, 2, 0xCB, 0x07);                         /* rlc a */
+	emit(a, 2, 0xCB, 0x3A);                         /* srl d */
+	emit(a, 2, 0xCB, 0x5F);                         /* bit 3,a */
+	emit(a, 2, 0x28, 0x01);                         /* jr z,+1 */
+	emit(a, 1, 0x14);                               /* inc d */
+	emit(a, 2, 0x08, 0x08);                         /* ex af,af' twice */
+	emit(a, 3, 0xDD, 0x77, 0x07);                   /* ld (ix+7),a */
+	emit(a, 2, 0x1E, 0x00);                         /* ld e,0 */
+	psg(a);
+	emit(a, 1, 0xC1);                               /* pop bc */
+	emit(a, 1, 0x10); rel(a, inner);                /* djnz inner */
+	sub_call = a->len;
+	emit(a, 3, 0xCD, 0, 0);                         /* call sub */
+	emit(a, 3, 0xC3, LO(outer), HI(outer));         /* jp outer */
+
+	sub = here(a);
+	put16(a->code + sub_call + 1, sub);
+	emit(a, 2, 0xE5, 0xD5);                         /* push hl; push de */
+	emit(a, 1, 0xD9);                               /* exx */
+	emit(a, 3, 0x21, 0x34, 0x12);                   /* ld hl,$1234 */
+	emit(a, 1, 0xD9);                               /* exx */
+	emit(a, 1, 0x7A);                               /* ld a,d */
+	emit(a, 2, 0xED, 0x44);                         /* neg */
+	emit(a, 3, 0xDD, 0x77, 0x07);                   /* ld (ix+7),a */
+	emit(a, 2, 0xED, 0x52);                         /* sbc hl,de */
+	emit(a, 2, 0xCB, 0xC4);                         /* set 0,h */
+	emit(a, 2, 0xD1, 0xE1);                         /* pop de; pop hl */
+	emit(a, 1, 0xC9);                               /* ret */
+}
+
+/* MSX PSG ports */
+static void psg_kss(Asm *a)
+{
+	emit(a, 1, 0xF5);                               /* push af */
+	emit(a, 1, 0x7B);                               /* ld a,e */
+	emit(a, 2, 0xD3, 0xA0);                         /* out ($A0),a */
+	emit(a, 1, 0xF1);                               /* pop af */
+	emit(a, 2, 0xD3, 0xA1);                         /* out ($A1),a */
+}
+
+static void make_kss(Song *song)
+{
+	unsigned char *f = calloc(1, 0x10 + 0x400);
+	Asm a = { f + 0x10, 0x8000, 0 };
+
+	asm_z80(&a, psg_kss);
+	emit(&a, 1, 0xC9);                              /* play: ret */
+
+	memcpy(f, "KSCC", 4);
+	put16(f + 0x04, 0x8000);            /* load */
+	put16(f + 0x06, a.len);             /* size */
+	put16(f + 0x08, 0x8000);            /* init */
+	put16(f + 0x0A, here(&a) - 1);      /* play */
+
+	song->name = "KSS";
+	song->data = f;
+	song->size = 0x10 + a.len;
+}
+
+/* Spectrum 128 AY ports */
+static void psg_ay(Asm *a)
+{
+	emit(a, 1, 0xC5);                               /* push bc */
+	emit(a, 3, 0x01, 0xFD, 0xFF);                   /* ld bc,$FFFD */
+	emit(a, 2, 0xED, 0x59);                         /* out (c),e */
+	emit(a, 2, 0x06, 0xBF);                         /* ld b,$BF */
+	emit(a, 2, 0xED, 0x79);                         /* out (c),a */
+	emit(a, 1, 0xC1);                               /* pop bc */
+}
+
+static void make_ay(Song *song)
+{
+	unsigned char *f = calloc(1, 0x40 + 0x400);
+	Asm a = { f + 0x40, 0x8000, 0 };
+
+	asm_z80(&a, psg_ay);
+
+	/* Offsets in the header are big-endian and relative to themselves */
+	memcpy(f, "ZXAYEMUL", 8);
+	put16be(f + 0x12, 0x14 - 0x12);     /* track list */
+	put16be(f + 0x16, 0x18 - 0x16);     /* track data */
+	f[0x18 + 8] = f[0x18 + 9] = 0;      /* register values */
+	put16be(f + 0x18 + 10, 0x26 - 0x22);    /* stack, init and play */
+	put16be(f + 0x18 + 12, 0x2C - 0x24);    /* blocks */
+	put16be(f + 0x26, 0xF000);          /* stack */
+	put16be(f + 0x28, 0x8000);          /* init */
+	put16be(f + 0x2C, 0x8000);          /* block address */
+	put16be(f + 0x2E, a.len);           /* and size */
+	put16be(f + 0x30, 0x40 - 0x30);     /* and data */
+
+	song->name = "AY";
+	song->data = f;
+	song->size = 0x40 + a.len;
+}
+
+/* The same loop for the SPC700, setting the pitch of a looping sample */
+static void make_spc(Song *song)
+{
+	static const unsigned char brr[] = {
+		0xB0, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77,
+		0xB3, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	};
+	unsigned char *f = calloc(1, 0x10200);
+	unsigned char *ram = f + 0x100, *dsp = f + 0x10100;
+	Asm a = { ram + 0x0400, 0x0400, 0 };
+	unsigned fill, outer, inner, sub, s1;
+	int sub_call;
+
+	emit(&a, 3, 0x8F, 0x4C, 0xF2);                  /* mov $F2,#$4C ; KON */
+	emit(&a, 3, 0x8F, 0x01, 0xF3);                  /* mov $F3,#1 */
+	emit(&a, 2, 0xCD, 0x00);                        /* mov x,#0 */
+	fill = here(&a);
+	emit(&a, 1, 0x7D);                              /* mov a,x */
+	emit(&a, 1, 0x1C);                              /* asl a */
+	emit(&a, 3, 0xD5, 0x00, 0x03);                  /* mov $0300+x,a */
+	emit(&a, 1, 0x3D);                              /* inc x */
+	emit(&a, 1, 0xD0); rel(&a, fill);               /* bne fill */
+
+	outer = here(&a);
+	emit(&a, 2, 0x8D, 0x00);                        /* mov y,#0 */
+	inner = here(&a);
+	emit(&a, 3, 0xF6, 0x00, 0x03);                  /* mov a,$0300+y */
+	emit(&a, 1, 0x60);                              /* clrc */
+	emit(&a, 2, 0x84, 0x10);                        /* adc a,$10 */
+	emit(&a, 1, 0x3C);                              /* rol a */
+	emit(&a, 2, 0x48, 0xA5);                        /* eor a,#$A5 */
+	emit(&a, 3, 0xD6, 0x00, 0x03);                  /* mov $0300+y,a */
+	emit(&a, 2, 0xC4, 0x10);                        /* mov $10,a */
+	emit(&a, 2, 0x28, 0x3F);                        /* and a,#$3F */
+	emit(&a, 1, 0x5D);                              /* mov x,a */
+	emit(&a, 3, 0xF5, 0x00, 0x03);                  /* mov a,$0300+x */
+	emit(&a, 2, 0x04, 0x11);                        /* or a,$11 */
+	emit(&a, 1, 0x80);                              /* setc */
+	emit(&a, 2, 0xA4, 0x12);                        /* sbc a,$12 */
+	emit(&a, 2, 0xC4, 0x11);                        /* mov $11,a */
+	emit(&a, 2, 0x68, 0x80);                        /* cmp a,#$80 */
+	emit(&a, 2, 0x90, 0x02);                        /* bcc +2 */
+	emit(&a, 2, 0x48, 0xFF);                        /* eor a,#$FF */
+	emit(&a, 1, 0x2D);                              /* push a */
+	emit(&a, 1, 0x9F);                              /* xcn a */
+	emit(&a, 1, 0x5C);                              /* lsr a */
+	emit(&a, 2, 0xC4, 0x12);                        /* mov $12,a */
+	emit(&a, 1, 0xAE);                              /* pop a */
+	emit(&a, 3, 0x8F, 0x02, 0xF2);                  /* mov $F2,#2 ; pitch */
+	emit(&a, 2, 0xC4, 0xF3);                        /* mov $F3,a */
+	emit(&a, 2, 0x3A, 0x14);                        /* incw $14 */
+	emit(&a, 1, 0xFC);                              /* inc y */
+	emit(&a, 1, 0xD0); rel(&a, inner);              /* bne inner */
+	sub_call = a.len;
+	emit(&a, 3, 0x3F, 0, 0);                        /* call sub */
+	emit(&a, 3, 0x5F, LO(outer), HI(outer));        /* jmp outer */
+
+	sub = here(&a);
+	put16(a.code + sub_call + 1, sub);
+	emit(&a, 2, 0x4D, 0x6D);                        /* push x; push y */
+	emit(&a, 2, 0xCD, 0x08);                        /* mov x,#8 */
+	s1 = here(&a);
+	emit(&a, 2, 0x0B, 0x16);                        /* asl $16 */
+	emit(&a, 2, 0x2B, 0x17);                        /* rol $17 */
+	emit(&a, 1, 0x1D);                              /* dec x */
+	emit(&a, 1, 0xD0); rel(&a, s1);                 /* bne s1 */
+	emit(&a, 2, 0xBA, 0x16);                        /* movw ya,$16 */
+	emit(&a, 2, 0x7A, 0x14);                        /* addw ya,$14 */
+	emit(&a, 2, 0xDA, 0x16);                        /* movw $16,ya */
+	emit(&a, 2, 0xEE, 0xCE);                        /* pop y; pop x */
+	emit(&a, 1, 0x6F);                              /* ret */
+
+	memcpy(f, "SNES-SPC700 Sound File Data v0.30\x1A\x1A", 35);
+	f[0x23] = 26;
+	put16(f + 0x25, 0x0400);            /* PC */
+	f[0x2B] = 0xEF;                     /* SP */
+	memcpy(f + 0xA9, "300", 3);         /* length, seconds */
+	memcpy(f + 0xAC, "10000", 5);       /* fade, ms */
+
+	put16(ram + 0x0A00, 0x1000);        /* sample 0 start */
+	put16(ram + 0x0A02, 0x1000);        /* and loop */
+	memcpy(ram + 0x1000, brr, sizeof brr);
+	dsp[0x00] = dsp[0x01] = 0x7F;       /* voice 0 volume */
+	put16(dsp + 0x02, 0x1000);          /* pitch */
+	dsp[0x05] = 0x8F;                   /* ADSR, fast attack */
+	dsp[0x06] = 0xE0;                   /* sustain at full level */
+	dsp[0x0C] = dsp[0x1C] = 0x7F;       /* main volume */
+	dsp[0x6C] = 0x20;                   /* FLG: no echo writes */
+	dsp[0x5D] = 0x0A;                   /* sample directory at $0A00 */
+
+	song->name = "SPC";
+	song->data = f;
+	song->size = 0x10200;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* CPU clock of the system a file is for */
+static long cpu_clock(gme_type_t type)
+{
+	static const struct {
+		const gme_type_t *type;
+		long clock;
+	} clocks[] = {
+		{ &gme_nsf_type, 1789773 }, { &gme_nsfe_type, 1789773 },
+		{ &gme_sap_type, 1773447 }, { &gme_hes_type, 7159091 },
+		{ &gme_gbs_type, 4194304 }, { &gme_kss_type, 3579545 },
+		{ &gme_ay_type, 3546900 }, { &gme_spc_type, 1024000 },
+	};
+
+	for (size_t i = 0; i < sizeof clocks / sizeof clocks[0]; i++) {
+		if (*clocks[i].type == type) {
+			return clocks[i].clock;
+		}
+	}
+	return 0;
+}
+
+/* Plays seconds of the song, with every voice muted if mute is set. Returns
+ * an FNV-1a hash of the output and sets the CPU clock, the peak sample and
+ * the time taken, or returns 0 on error. */
+static unsigned long render(const Song *song, int mute, int seconds, long *clock,
+                            int *peak, double *elapsed)
+{
+	Music_Emu *emu;
+	short buf[4096];
+	long total = (long)seconds * SAMPLE_RATE * 2;
+	unsigned long hash = 2166136261u;
+	gme_err_t err;
+
+	if ((err = gme_open_data(song->data, song->size, &emu, SAMPLE_RATE)) != NULL) {
+		fprintf(stderr, "%s: %s\n", song->name, err);
+		return 0;
+	}
+	*clock = cpu_clock(gme_type(emu));
+	gme_ignore_silence(emu, 1);
+	if (mute) {
+		gme_mute_voices(emu, -1);
+	}
+	if ((err = gme_start_track(emu, 0)) != NULL) {
+		fprintf(stderr, "%s: %s\n", song->name, err);
+		gme_delete(emu);
+		return 0;
+	}
+
+	double start = now();
+	for (long done = 0; done < total; done += 4096) {
+		if ((err = gme_play(emu, 4096, buf)) != NULL) {
+			fprintf(stderr, "%s: %s\n", song->name, err);
+			gme_delete(emu);
+			return 0;
+		}
+		for (int i = 0; i < 4096; i++) {
+			int v = abs(buf[i]);
+			*peak = v > *peak ? v : *peak;
+			hash = ((hash ^ (buf[i] & 0xFF)) * 16777619u) & 0xFFFFFFFF;
+			hash = ((hash ^ (buf[i] >> 8 & 0xFF)) * 16777619u) & 0xFFFFFFFF;
+		}
+	}
+	*elapsed = now() - start;
+	gme_delete(emu);
+
+	return hash ? hash : 1;
+}
+
+static int load_file(Song *song, const char *path)
+{
+	FILE *in = fopen(path, "rb");
+
+	if (in == NULL || fseek(in, 0, SEEK_END) != 0 || (song->size = ftell(in)) <= 0) {
+		fprintf(stderr, "%s: can't read\n", path);
+		if (in != NULL) {
+			fclose(in);
+		}
+		return -1;
+	}
+	rewind(in);
+	song->name = path;
+	song->data = malloc(song->size);
+	if (song->data == NULL || fread(song->data, 1, song->size, in) != (size_t)song->size) {
+		fprintf(stderr, "%s: can't read\n", path);
+		free(song->data);
+		fclose(in);
+		return -1;
+	}
+	fclose(in);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	int checksums = 0, seconds = 10, failed = 0, count = 0;
+	int arg = 1;
+	Song *songs;
+
+	if (arg < argc && !strcmp(argv[arg], "-c")) {
+		checksums = 1;
+		arg++;
+	}
+	if (arg < argc) {
+		seconds = atoi(argv[arg++]);
+	}
+	if (seconds <= 0) {
+		fprintf(stderr, "usage: %s [-c] [seconds] [file...]\n", argv[0]);
+		return 2;
+	}
+
+	songs = calloc(argc > 8 ? argc : 8, sizeof *songs);
+	if (arg < argc) {
+		for (; arg < argc; arg++) {
+			if (load_file(&songs[count], argv[arg]) == 0) {
+				count++;
+			} else {
+				failed = 1;
+			}
+		}
+	} else {
+		make_nsf(&songs[count++]);
+		make_sap(&songs[count++]);
+		make_hes(&songs[count++]);
+		make_gbs(&songs[count++]);
+		make_kss(&songs[count++]);
+		make_ay(&songs[count++]);
+		make_spc(&songs[count++]);
+	}
+
+	if (!checksums) {
+		printf("%-4s %14s %12s\n", "file", "ms/s output", "Mcycles/s");
+	}
+	for (int s = 0; s < count; s++) {
+		long clock = 0;
+		int peak = 0;
+		double elapsed = 0, best = 0;
+		unsigned long hash = 0;
+
+		for (int run = 0; run < (checksums ? 1 : RUNS); run++) {
+			hash = render(&songs[s], !checksums, seconds, &clock, &peak, &elapsed);
+			if (run == 0 || elapsed < best) {
+				best = elapsed;
+			}
+		}
+
+		if (hash == 0) {
+			failed = 1;
+		} else if (checksums) {
+			if (peak == 0) {
+				fprintf(stderr, "%s: no output\n", songs[s].name);
+				failed = 1;
+			}
+			printf("%s %08lx\n", songs[s].name, hash);
+		} else {
+			printf("%-4s %14.2f %12.1f\n", songs[s].name, best * 1000 / seconds,
+			       best > 0 ? clock * (double)seconds / best / 1e6 : 0);
+		}
+		free(songs[s].data);
+	}
+	free(songs);
+
+	return failed;
+}
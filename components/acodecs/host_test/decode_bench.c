@@ -0,0 +1,227 @@
+/*
+ * Decode time of MP3, Ogg Vorbis and FLAC streams, per second of audio and
+ * per frame. Built twice from the same decoder sources: decode_bench_float
+ * runs the float MP3 and Vorbis decoders and dr_flac's generic scalar code,
+ * decode_bench_fixed the fixed-point MP3 and Vorbis paths and dr_flac's
+ * 32-bit path for 16-bit audio. Neither uses SIMD, like the ESP32.
+ *
+ * With -w each stream's s16 output also goes to dir/<file name>.raw, for
+ * pcm_compare to check one build against the other.
+ *
+ * decode_bench [-w dir] file...
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dr_mp3.h>
+#include <dr_flac.h>
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.h>
+
+/* each stream is timed for at least this long, the best run counts */
+#define MIN_RUNS 5
+#define MIN_SECONDS 0.5
+
+typedef struct {
+	FILE *file;         /* output, or NULL when only timing */
+	long frames;        /* codec frames decoded */
+	long samples;       /* sample frames, per channel */
+	int rate;
+} Output;
+
+static void put(Output *out, const short *pcm, long samples, int channels)
+{
+	out->samples += samples;
+	if (out->file != NULL) {
+		fwrite(pcm, sizeof(short), samples * channels, out->file);
+	}
+}
+
+static int decode_mp3(const unsigned char *data, long size, Output *out)
+{
+	static drmp3_int16 pcm[DRMP3_MAX_SAMPLES_PER_FRAME];
+	drmp3dec dec;
+	drmp3dec_frame_info info;
+	long pos = 0;
+
+	drmp3dec_init(&dec);
+	while (pos < size) {
+		int samples = drmp3dec_decode_frame(&dec, data + pos, (int)(size - pos), pcm, &info);
+		if (info.frame_bytes == 0) {
+			break;
+		}
+		pos += info.frame_bytes;
+		/* the encoder's info frame decodes to nothing */
+		if (samples > 0) {
+			out->frames++;
+			out->rate = info.hz;
+			put(out, pcm, samples, info.channels);
+		}
+	}
+
+	return out->frames > 0 ? 0 : -1;
+}
+
+static int decode_vorbis(const unsigned char *data, long size, Output *out)
+{
+	static short pcm[4096 * 8];
+	int error, samples;
+	stb_vorbis *v = stb_vorbis_open_memory(data, (int)size, &error, NULL);
+
+	if (v == NULL) {
+		return -1;
+	}
+	stb_vorbis_info info = stb_vorbis_get_info(v);
+	out->rate = info.sample_rate;
+	while ((samples = stb_vorbis_get_frame_short_interleaved(v, info.channels,
+			pcm, sizeof pcm / sizeof pcm[0])) > 0) {
+		out->frames++;
+		put(out, pcm, samples, info.channels);
+	}
+	stb_vorbis_close(v);
+
+	return 0;
+}
+
+/* Reads a block at a time, which is a FLAC frame in a fixed block size
+ * stream like every encoder writes by default */
+static int decode_flac(const unsigned char *data, long size, Output *out)
+{
+	drflac *flac = drflac_open_memory(data, size, NULL);
+	drflac_uint64 samples;
+
+	if (flac == NULL) {
+		return -1;
+	}
+	short *pcm = malloc(flac->maxBlockSizeInPCMFrames * flac->channels * sizeof(short));
+	if (pcm == NULL) {
+		drflac_close(flac);
+		return -1;
+	}
+	out->rate = flac->sampleRate;
+	while ((samples = drflac_read_pcm_frames_s16(flac, flac->maxBlockSizeInPCMFrames, pcm)) > 0) {
+		out->frames++;
+		put(out, pcm, (long)samples, flac->channels);
+	}
+	free(pcm);
+	drflac_close(flac);
+
+	return 0;
+}
+
+static const struct {
+	const char *extension;
+	int (*decode)(const unsigned char *data, long size, Output *out);
+} codecs[] = {
+	{ ".mp3", decode_mp3 },
+	{ ".ogg", decode_vorbis },
+	{ ".flac", decode_flac },
+};
+
+static unsigned char *load_file(const char *path, long *size)
+{
+	FILE *f = fopen(path, "rb");
+	unsigned char *data = NULL;
+
+	if (f == NULL) {
+		return NULL;
+	}
+	if (fseek(f, 0, SEEK_END) == 0 && (*size = ftell(f)) > 0 &&
+	    fseek(f, 0, SEEK_SET) == 0 && (data = malloc(*size)) != NULL &&
+	    fread(data, 1, *size, f) != (size_t)*size) {
+		free(data);
+		data = NULL;
+	}
+	fclose(f);
+
+	return data;
+}
+
+static const char *base_name(const char *path)
+{
+	const char *slash = strrchr(path, '/');
+	return slash != NULL ? slash + 1 : path;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+	const char *dir = NULL;
+	int first = 1, failed = 0;
+
+	if (argc > 2 && strcmp(argv[1], "-w") == 0) {
+		dir = argv[2];
+		first = 3;
+	}
+	if (first >= argc) {
+		fprintf(stderr, "usage: %s [-w dir] file...\n", argv[0]);
+		return 2;
+	}
+
+	printf("%-12s %8s %12s %10s\n", "file", "frames", "ms/s audio", "us/frame");
+	for (int i = first; i < argc; i++) {
+		const char *name = base_name(argv[i]);
+		const char *extension = strrchr(name, '.');
+		int (*decode)(const unsigned char *, long, Output *) = NULL;
+		long size;
+		unsigned char *data;
+
+		for (size_t c = 0; c < sizeof codecs / sizeof codecs[0]; c++) {
+			if (extension != NULL && strcmp(extension, codecs[c].extension) == 0) {
+				decode = codecs[c].decode;
+			}
+		}
+		if (decode == NULL || (data = load_file(argv[i], &size)) == NULL) {
+			fprintf(stderr, "%s: can't read\n", argv[i]);
+			failed = 1;
+			continue;
+		}
+
+		/* the first run writes the output, the best of the rest is timed */
+		double best = 0, total = 0;
+		Output out;
+		for (int run = 0; run <= MIN_RUNS || total < MIN_SECONDS; run++) {
+			memset(&out, 0, sizeof out);
+			if (run == 0 && dir != NULL) {
+				char path[1024];
+				snprintf(path, sizeof path, "%s/%s.raw", dir, name);
+				if ((out.file = fopen(path, "wb")) == NULL) {
+					fprintf(stderr, "%s: can't write\n", path);
+					failed = 1;
+				}
+			}
+			double start = now();
+			int err = decode(data, size, &out);
+			double elapsed = now() - start;
+			total += elapsed;
+			if (out.file != NULL) {
+				fclose(out.file);
+			}
+			if (err || out.samples == 0) {
+				fprintf(stderr, "%s: decoding failed\n", argv[i]);
+				failed = 1;
+				break;
+			}
+			if (run > 0 && (best == 0 || elapsed < best)) {
+				best = elapsed;
+			}
+		}
+		free(data);
+
+		if (best > 0) {
+			printf("%-12s %8ld %12.3f %10.2f\n", name, out.frames,
+			       best * 1000 / ((double)out.samples / out.rate),
+			       best * 1e6 / out.frames);
+		}
+	}
+
+	return failed;
+}
@@ -0,0 +1,143 @@
+/*
+ * Decode throughput of FLAC streams on the calling thread and with
+ * flac_parallel on 1 and 2 worker threads, as seconds of audio decoded per
+ * second. Fails unless flac_parallel's output is byte-identical to
+ * drflac_read_pcm_frames_s16's for every stream and worker count.
+ *
+ * The output is read in chunks of an odd number of frames, so reads end
+ * partway through FLAC frames.
+ *
+ * flac_parallel_bench file...
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <dr_flac.h>
+#include <flac_parallel.h>
+
+/* each stream is timed for at least this long, the best run counts */
+#define MIN_RUNS 5
+#define MIN_SECONDS 0.5
+#define CHUNK 1001
+#define MAX_WORKERS 2
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Decodes path into pcm, which holds frames of channels samples, with
+ * drflac on this thread if workers is 0. Returns the PCM frames decoded, or
+ * -1 if it can't be opened. */
+static long decode(const char *path, int workers, unsigned channels, int16_t *pcm, long frames)
+{
+	drflac *flac = drflac_open_file(path, NULL);
+	FlacParallel *fp = NULL;
+	long done = 0;
+	size_t n;
+
+	if (flac == NULL) {
+		return -1;
+	}
+	if (workers > 0) {
+		fp = flac_parallel_open(flac, path, workers);
+		drflac_close(flac);
+		if (fp == NULL) {
+			return -1;
+		}
+	}
+
+	for (;;) {
+		size_t want = frames - done < CHUNK ? (size_t)(frames - done) : CHUNK;
+		if (fp != NULL) {
+			n = flac_parallel_read_s16(fp, pcm, want);
+		} else {
+			n = (size_t)drflac_read_pcm_frames_s16(flac, want, pcm);
+		}
+		if (n == 0) {
+			break;
+		}
+		done += n;
+		pcm += n * channels;
+	}
+
+	if (fp != NULL) {
+		flac_parallel_close(fp);
+	} else {
+		drflac_close(flac);
+	}
+	return done;
+}
+
+int main(int argc, char **argv)
+{
+	int failed = 0;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s file...\n", argv[0]);
+		return 2;
+	}
+
+	printf("%-12s %8s %8s %12s %8s\n", "file", "rate", "bits", "workers", "x speed");
+	for (int i = 1; i < argc; i++) {
+		const char *name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+		drflac *flac = drflac_open_file(argv[i], NULL);
+		if (flac == NULL) {
+			fprintf(stderr, "%s: can't open\n", argv[i]);
+			failed = 1;
+			continue;
+		}
+		unsigned rate = flac->sampleRate, bits = flac->bitsPerSample, channels = flac->channels;
+		size_t samples = (size_t)flac->totalPCMFrameCount * flac->channels;
+		long frames = (long)flac->totalPCMFrameCount;
+		drflac_close(flac);
+
+		int16_t *ref = malloc(samples * sizeof(int16_t) + 1);
+		int16_t *pcm = malloc(samples * sizeof(int16_t) + 1);
+		if (ref == NULL || pcm == NULL) {
+			return 2;
+		}
+
+		for (int workers = 0; workers <= MAX_WORKERS; workers++) {
+			double best = 0, total = 0;
+			long count = 0;
+
+			for (int run = 0; run < MIN_RUNS || total < MIN_SECONDS; run++) {
+				double start = now();
+				count = decode(argv[i], workers, channels, workers ? pcm : ref, frames);
+				double elapsed = now() - start;
+				if (count < 0) {
+					break;
+				}
+				total += elapsed;
+				if (run == 0 || elapsed < best) {
+					best = elapsed;
+				}
+			}
+			if (count != frames) {
+				fprintf(stderr, "%s: %ld of %ld frames with %d workers\n", name, count, frames, workers);
+				failed = 1;
+				continue;
+			}
+			if (workers > 0 && memcmp(ref, pcm, samples * sizeof(int16_t)) != 0) {
+				fprintf(stderr, "%s: output with %d workers differs\n", name, workers);
+				failed = 1;
+			}
+			if (workers == 0) {
+				printf("%-12s %8u %8u %12s %8.1f\n", name, rate, bits, "drflac",
+				       (double)frames / rate / best);
+			} else {
+				printf("%-12s %8u %8u %12d %8.1f\n", name, rate, bits, workers,
+				       (double)frames / rate / best);
+			}
+		}
+		free(ref);
+		free(pcm);
+	}
+
+	return failed;
+}
@@ -0,0 +1,245 @@
+/*
+ * Cost per second of output as voices are muted, for generated SPC, NSF and
+ * GBS files that keep every voice sounding. Also checks that a file with all
+ * voices on makes sound and one with all voices muted is silent.
+ *
+ * mute_bench [seconds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <gme.h>
+
+#define SAMPLE_RATE 44100
+
+typedef struct {
+	const char *name;
+	unsigned char *data;
+	long size;
+} Song;
+
+static void put16(unsigned char *p, unsigned v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+/* Eight voices looping a two-block BRR sample at different pitches. The
+ * SPC700 keys them on and then spins. */
+static void make_spc(Song *song)
+{
+	static const unsigned char code[] = {
+		0x8F, 0x4C, 0xF2,   /* mov $F2,#$4C  ; KON */
+		0x8F, 0xFF, 0xF3,   /* mov $F3,#$FF */
+		0x2F, 0xFE,         /* bra * */
+	};
+	static const unsigned char brr[] = {
+		0xB0, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77,
+		0xB3, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99, 0x99,
+	};
+	unsigned char *f = calloc(1, 0x10200);
+	unsigned char *ram = f + 0x100, *dsp = f + 0x10100;
+
+	memcpy(f, "SNES-SPC700 Sound File Data v0.30\x1A\x1A", 35);
+	f[0x23] = 26;
+	put16(f + 0x25, 0x0200);            /* PC */
+	f[0x2B] = 0xEF;                     /* SP */
+	memcpy(f + 0xA9, "300", 3);         /* length, seconds */
+	memcpy(f + 0xAC, "10000", 5);       /* fade, ms */
+
+	memcpy(ram + 0x0200, code, sizeof code);
+	put16(ram + 0x0A00, 0x1000);        /* sample 0 start */
+	put16(ram + 0x0A02, 0x1000);        /* and loop */
+	memcpy(ram + 0x1000, brr, sizeof brr);
+
+	for (int v = 0; v < 8; v++) {
+		unsigned char *r = dsp + v * 0x10;
+		r[0] = r[1] = 0x30;             /* volume */
+		put16(r + 2, 0x0800 + v * 0x180);   /* pitch */
+		r[4] = 0;                       /* sample */
+		r[5] = 0x8F;                    /* ADSR, fast attack */
+		r[6] = 0xE0;                    /* sustain at full level */
+	}
+	dsp[0x0C] = dsp[0x1C] = 0x7F;       /* main volume */
+	dsp[0x6C] = 0x20;                   /* FLG: no echo writes */
+	dsp[0x5D] = 0x0A;                   /* sample directory at $0A00 */
+
+	song->name = "SPC";
+	song->data = f;
+	song->size = 0x10200;
+}
+
+/* Both pulses, the triangle and the noise channel holding a tone */
+static void make_nsf(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x15, 0x0F },
+		{ 0x00, 0xBF }, { 0x01, 0x00 }, { 0x02, 0xFD }, { 0x03, 0x08 },
+		{ 0x04, 0xBF }, { 0x05, 0x00 }, { 0x06, 0xA9 }, { 0x07, 0x08 },
+		{ 0x08, 0xFF }, { 0x0A, 0x80 }, { 0x0B, 0x08 },
+		{ 0x0C, 0x3F }, { 0x0E, 0x05 }, { 0x0F, 0x08 },
+	};
+	unsigned char *f = calloc(1, 0x80 + 0x100);
+	unsigned char *code = f + 0x80;
+	int n = 0;
+
+	memcpy(f, "NESM\x1A", 5);
+	f[5] = 1;                           /* version */
+	f[6] = 1;                           /* songs */
+	f[7] = 1;                           /* first song */
+	put16(f + 0x08, 0x8000);            /* load */
+	put16(f + 0x0A, 0x8000);            /* init */
+	put16(f + 0x0C, 0x80F0);            /* play */
+	put16(f + 0x6E, 16666);             /* NTSC frame period, us */
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		code[n++] = 0xA9;               /* lda #value */
+		code[n++] = regs[i][1];
+		code[n++] = 0x8D;               /* sta $40xx */
+		code[n++] = regs[i][0];
+		code[n++] = 0x40;
+	}
+	code[n] = 0x60;                     /* rts */
+	code[0xF0] = 0x60;
+
+	song->name = "NSF";
+	song->data = f;
+	song->size = 0x80 + 0x100;
+}
+
+/* Both squares, the wave and the noise channel holding a tone */
+static void make_gbs(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x26, 0x80 }, { 0x24, 0x77 }, { 0x25, 0xFF },
+		{ 0x10, 0x00 }, { 0x11, 0x80 }, { 0x12, 0xF0 }, { 0x13, 0x00 }, { 0x14, 0x87 },
+		{ 0x16, 0x40 }, { 0x17, 0xF0 }, { 0x18, 0x80 }, { 0x19, 0x86 },
+		{ 0x30, 0x01 }, { 0x31, 0x23 }, { 0x32, 0x45 }, { 0x33, 0x67 },
+		{ 0x34, 0x89 }, { 0x35, 0xAB }, { 0x36, 0xCD }, { 0x37, 0xEF },
+		{ 0x1A, 0x80 }, { 0x1B, 0x00 }, { 0x1C, 0x20 }, { 0x1D, 0x00 }, { 0x1E, 0x87 },
+		{ 0x20, 0x00 }, { 0x21, 0xF0 }, { 0x22, 0x35 }, { 0x23, 0x80 },
+	};
+	unsigned char *f = calloc(1, 0x70 + 0x100);
+	unsigned char *code = f + 0x70;
+	int n = 0;
+
+	memcpy(f, "GBS", 3);
+	f[3] = 1;                           /* version */
+	f[4] = 1;                           /* songs */
+	f[5] = 1;                           /* first song */
+	put16(f + 0x06, 0x0400);            /* load */
+	put16(f + 0x08, 0x0400);            /* init */
+	put16(f + 0x0A, 0x04F0);            /* play */
+	put16(f + 0x0C, 0xFFFE);            /* stack */
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		code[n++] = 0x3E;               /* ld a,value */
+		code[n++] = regs[i][1];
+		code[n++] = 0xE0;               /* ldh ($FFxx),a */
+		code[n++] = regs[i][0];
+	}
+	code[n] = 0xC9;                     /* ret */
+	code[0xF0] = 0xC9;
+
+	song->name = "GBS";
+	song->data = f;
+	song->size = 0x70 + 0x100;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Renders with the voices in mute_mask muted. Returns the peak sample, or
+ * -1 on error. */
+static int render(const Song *song, int mute_mask, int seconds, double *elapsed)
+{
+	Music_Emu *emu;
+	short buf[4096];
+	long total = (long)seconds * SAMPLE_RATE * 2;
+	int peak = 0;
+	gme_err_t err;
+
+	if ((err = gme_open_data(song->data, song->size, &emu, SAMPLE_RATE)) != NULL) {
+		fprintf(stderr, "%s: %s\n", song->name, err);
+		return -1;
+	}
+	gme_ignore_silence(emu, 1);
+	gme_mute_voices(emu, mute_mask);
+	if ((err = gme_start_track(emu, 0)) != NULL) {
+		fprintf(stderr, "%s: %s\n", song->name, err);
+		gme_delete(emu);
+		return -1;
+	}
+
+	double start = now();
+	for (long done = 0; done < total; done += 4096) {
+		if ((err = gme_play(emu, 4096, buf)) != NULL) {
+			fprintf(stderr, "%s: %s\n", song->name, err);
+			gme_delete(emu);
+			return -1;
+		}
+		/* skip the click of the first notes */
+		if (done >= SAMPLE_RATE) {
+			for (int i = 0; i < 4096; i++) {
+				int v = abs(buf[i]);
+				peak = v > peak ? v : peak;
+			}
+		}
+	}
+	*elapsed = now() - start;
+	gme_delete(emu);
+
+	return peak;
+}
+
+static int voice_count(const Song *song)
+{
+	Music_Emu *emu;
+	if (gme_open_data(song->data, song->size, &emu, SAMPLE_RATE) != NULL) {
+		return 0;
+	}
+	int count = gme_voice_count(emu);
+	gme_delete(emu);
+	return count;
+}
+
+int main(int argc, char **argv)
+{
+	int seconds = argc > 1 ? atoi(argv[1]) : 10;
+	int failed = 0;
+	Song songs[3];
+
+	if (seconds < 2) {
+		fprintf(stderr, "usage: %s [seconds, at least 2]\n", argv[0]);
+		return 2;
+	}
+	make_spc(&songs[0]);
+	make_nsf(&songs[1]);
+	make_gbs(&songs[2]);
+
+	printf("%-4s %6s %14s\n", "file", "voices", "ms/s output");
+	for (int s = 0; s < 3; s++) {
+		int count = voice_count(&songs[s]);
+		for (int active = count; active >= 0; active--) {
+			double elapsed = 0;
+			int peak = render(&songs[s], ~((1 << active) - 1), seconds, &elapsed);
+			if (peak < 0 || (active == count && peak == 0) ||
+			    (active == 0 && peak != 0)) {
+				fprintf(stderr, "%s: peak %d with %d of %d voices\n",
+					songs[s].name, peak, active, count);
+				failed = 1;
+			}
+			printf("%-4s %6d %14.2f\n", songs[s].name, active,
+			       elapsed * 1000 / seconds);
+		}
+		free(songs[s].data);
+	}
+
+	return failed;
+}
@@ -0,0 +1,86 @@
+/*
+ * Plays the given Ogg Vorbis files in turn through the OGG decoder, round
+ * after round, and fails unless the heap stays flat: after the first round,
+ * by when the arena has grown to fit the largest file, the heap in use with
+ * each file open and after each close must be the same every round. Files
+ * with different setups make each open a setup cache miss, whose tables
+ * belong in the arena rather than on the heap.
+ *
+ * ogg_arena_test file...
+ */
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <acodecs.h>
+
+#define ROUNDS 10
+#define BUFFERS 16 /* decoded per file each round */
+
+static size_t heap_in_use(void)
+{
+	return mallinfo2().uordblks;
+}
+
+int main(int argc, char **argv)
+{
+	AudioDecoder *decoder = acodec_get_decoder(AudioCodecOGG);
+	int files = argc - 1, failed = 0;
+	size_t *open_heap = calloc(files > 0 ? files : 1, sizeof(size_t));
+	size_t closed_heap = 0;
+	int16_t buf[4096 * 2];
+
+	if (files < 2) {
+		fprintf(stderr, "usage: %s file file...\n", argv[0]);
+		return 2;
+	}
+
+	printf("%5s %12s %12s\n", "round", "heap open", "heap closed");
+	for (int round = 0; round < ROUNDS; round++) {
+		size_t most_open = 0;
+
+		for (int i = 0; i < files; i++) {
+			void *handle;
+			AudioInfo info;
+			long samples = 0;
+
+			if (decoder->open(&handle, argv[i + 1]) != 0) {
+				fprintf(stderr, "%s: can't open\n", argv[i + 1]);
+				return 1;
+			}
+			decoder->get_info(handle, &info);
+			for (int b = 0; b < BUFFERS; b++) {
+				samples += decoder->decode(handle, buf, (int)info.channels,
+				                           (unsigned)(sizeof buf / sizeof buf[0]));
+			}
+			if (samples == 0) {
+				fprintf(stderr, "%s: decoded nothing\n", argv[i + 1]);
+				failed = 1;
+			}
+
+			size_t heap = heap_in_use();
+			most_open = heap > most_open ? heap : most_open;
+			if (round == 1) {
+				open_heap[i] = heap;
+			} else if (round > 1 && heap != open_heap[i]) {
+				fprintf(stderr, "round %d, %s: %zu bytes in use open, %zu in round 1\n",
+				        round, argv[i + 1], heap, open_heap[i]);
+				failed = 1;
+			}
+
+			decoder->close(handle);
+			heap = heap_in_use();
+			if (round == 0 && i == files - 1) {
+				closed_heap = heap;
+			} else if (round > 0 && heap != closed_heap) {
+				fprintf(stderr, "round %d, %s: %zu bytes in use closed, %zu after round 0\n",
+				        round, argv[i + 1], heap, closed_heap);
+				failed = 1;
+			}
+		}
+		printf("%5d %12zu %12zu\n", round, most_open, heap_in_use());
+	}
+
+	free(open_heap);
+	return failed;
+}
@@ -0,0 +1,65 @@
+/*
+ * Compares two raw s16 outputs of the same stream. Fails if their lengths
+ * differ, if any sample is further apart than max_diff, or if the PSNR
+ * against full scale is below min_psnr dB. 0 0 asks for identical output.
+ *
+ * pcm_compare reference.raw test.raw max_diff min_psnr
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static short *load_raw(const char *path, long *count)
+{
+	FILE *f = fopen(path, "rb");
+	short *data = NULL;
+	long size;
+
+	if (f == NULL) {
+		return NULL;
+	}
+	if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) >= 0 &&
+	    fseek(f, 0, SEEK_SET) == 0 && (data = malloc(size + 1)) != NULL) {
+		*count = size / sizeof(short);
+		if (fread(data, sizeof(short), *count, f) != (size_t)*count) {
+			free(data);
+			data = NULL;
+		}
+	}
+	fclose(f);
+
+	return data;
+}
+
+int main(int argc, char **argv)
+{
+	long count_a, count_b, max_diff = 0;
+	double sum = 0;
+
+	if (argc != 5) {
+		fprintf(stderr, "usage: %s reference.raw test.raw max_diff min_psnr\n", argv[0]);
+		return 2;
+	}
+	short *a = load_raw(argv[1], &count_a);
+	short *b = load_raw(argv[2], &count_b);
+	if (a == NULL || b == NULL) {
+		fprintf(stderr, "can't read %s\n", a == NULL ? argv[1] : argv[2]);
+		return 2;
+	}
+	if (count_a != count_b || count_a == 0) {
+		fprintf(stderr, "%ld samples against %ld\n", count_a, count_b);
+		return 1;
+	}
+
+	for (long i = 0; i < count_a; i++) {
+		long d = labs((long)a[i] - b[i]);
+		max_diff = d > max_diff ? d : max_diff;
+		sum += (double)d * d;
+	}
+	double psnr = sum > 0 ? 10 * log10(32767.0 * 32767.0 * count_a / sum) : INFINITY;
+	printf("%ld samples, max diff %ld, PSNR %.1f dB\n", count_a, max_diff, psnr);
+
+	free(a);
+	free(b);
+	return max_diff > atol(argv[3]) || psnr < atof(argv[4]);
+}
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Writes the MP3, Ogg Vorbis and FLAC streams decode_bench runs on.
+
+They are a few seconds of generated music encoded with libsndfile's encoders
+(LAME, libvorbis, libFLAC), so the streams are what real encoders produce.
+Needs numpy and soundfile:
+
+    python3 make_streams.py [output directory]
+"""
+import os
+import sys
+
+import numpy as np
+import soundfile as sf
+
+SECONDS = 4
+
+
+def note(freq, rate, length, harmonics):
+    t = np.arange(int(length * rate)) / rate
+    tone = sum(np.sin(2 * np.pi * freq * k * t) / k ** harmonics for k in range(1, 9))
+    return tone * np.exp(-3 * t)
+
+
+def music(rate, channels, peak, seconds=SECONDS, seed=1):
+    """Bass, chords, a lead line and noise hits, panned across the channels"""
+    rnd = np.random.default_rng(seed)
+    out = np.zeros((seconds * rate, 2))
+    beat = rate // 4
+    scale = [0, 2, 4, 5, 7, 9, 11, 12]
+    for start in range(0, len(out) - beat, beat):
+        step = start // beat
+        parts = [
+            (55 * 2 ** (scale[(step // 4) % 8] / 12), 0.5, 1.5, 0.4),
+            (220 * 2 ** (scale[rnd.integers(8)] / 12), 0.2, 1.0, 0.1),
+            (440 * 2 ** (scale[rnd.integers(8)] / 12), 0.8, 0.8, 0.15),
+        ]
+        for freq, pan, harmonics, level in parts:
+            tone = note(freq, rate, min(0.5, (len(out) - start) / rate), harmonics)
+            end = start + len(tone)
+            out[start:end, 0] += tone * level * (1 - pan)
+            out[start:end, 1] += tone * level * pan
+        if step % 2:
+            hit = rnd.standard_normal(beat // 2) * np.exp(-np.arange(beat // 2) / (beat / 16))
+            out[start:start + len(hit)] += 0.2 * hit[:, None]
+    out *= peak / np.max(np.abs(out))
+    return out if channels == 2 else out.mean(axis=1)
+
+
+def main():
+    directory = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    streams = [
+        ("music.mp3", 44100, 2, SECONDS, "MP3", "MPEG_LAYER_III", {}),
+        ("mono22.mp3", 22050, 1, SECONDS, "MP3", "MPEG_LAYER_III", {}),
+        ("music.ogg", 44100, 2, SECONDS, "OGG", "VORBIS", {}),
+        ("mono22.ogg", 22050, 1, SECONDS, "OGG", "VORBIS", {"compression_level": 0.8}),
+        ("music.flac", 44100, 2, SECONDS, "FLAC", "PCM_16", {"compression_level": 1.0}),
+        # hi-res, for flac_parallel_bench; shorter, as 24 bits barely compress
+        ("hires.flac", 96000, 2, 2, "FLAC", "PCM_24", {"compression_level": 1.0}),
+    ]
+    for name, rate, channels, seconds, container, subtype, options in streams:
+        sf.write(os.path.join(directory, name), music(rate, channels, 0.9, seconds), rate,
+                 format=container, subtype=subtype, **options)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,552 @@
+/*
+ * Cost of Blip_Synth per amplitude transition at each quality level, and
+ * the output of generated AY, SMS (VGM), NSF and GBS files, for comparing
+ * fast synthesis against accurate synthesis per sound chip.
+ *
+ * The program is built against a gme with every chip on fast synthesis and
+ * one with every chip accurate. The transition cost is measured on synths
+ * compiled into the program itself, so it's the same in both builds. The
+ * files play melodies over three octaves, so the treble the fast synth
+ * doesn't filter is there to alias. -w writes each file's output to dir,
+ * and -r compares it against the output written by the other build,
+ * printing its SNR. The run fails if a file is silent, if its output
+ * differs in length from the reference, or if its SNR is below min_snr.
+ *
+ * synth_bench [-w dir] [-r dir min_snr] [seconds]
+ */
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <gme.h>
+#include "Blip_Buffer.h"
+
+#define SAMPLE_RATE 44100
+#define RUNS 3 /* timings are the best of this many */
+#define NOTES 16
+#define FRAMES_PER_NOTE 8
+#define MAX_LAG 32 /* frames the outputs are lined up over */
+
+#define LO(n) ((n) & 0xFF)
+#define HI(n) ((n) >> 8 & 0xFF)
+
+typedef struct {
+	const char *name;
+	unsigned char *data;
+	long size;
+} Song;
+
+/* Code being assembled at address org */
+typedef struct {
+	unsigned char *code;
+	unsigned org;
+	int len;
+} Asm;
+
+static void emit(Asm *a, int count, ...)
+{
+	va_list args;
+
+	va_start(args, count);
+	while (count--) {
+		a->code[a->len++] = va_arg(args, int);
+	}
+	va_end(args);
+}
+
+static void put16(unsigned char *p, unsigned v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+static void put16be(unsigned char *p, unsigned v)
+{
+	p[0] = v >> 8;
+	p[1] = v;
+}
+
+static void put32(unsigned char *p, unsigned long v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+/* Frequency of note n of a voice an octave above base */
+static double note(double base, int n)
+{
+	static const int melody[NOTES] = { 0, 4, 7, 12, 16, 19, 24, 28, 31, 28, 24, 19, 16, 12, 7, 4 };
+	return base * pow(2, melody[n] / 12.0);
+}
+
+static const double voice_base[3] = { 262, 523, 131 };
+
+/* Three voices holding each note for FRAMES_PER_NOTE frames and noise
+ * throughout. The PSG is written directly, a frame at a time. */
+static void make_vgm(Song *song)
+{
+	int frames = NOTES * FRAMES_PER_NOTE;
+	long size = 0x40 + frames * 23 + 1;
+	unsigned char *f = (unsigned char *)calloc(1, size);
+	unsigned char *p = f + 0x40;
+
+	memcpy(f, "Vgm ", 4);
+	put32(f + 0x04, size - 0x04);
+	put32(f + 0x08, 0x150);
+	put32(f + 0x0C, 3579545);           /* PSG */
+	put32(f + 0x18, (long)frames * 735);
+	put32(f + 0x1C, 0x40 - 0x1C);       /* loop the whole song */
+	put32(f + 0x20, (long)frames * 735);
+	put32(f + 0x24, 60);
+	f[0x28] = 0x09;                     /* noise feedback */
+	f[0x2A] = 16;                       /* noise width */
+	put32(f + 0x34, 0x40 - 0x34);
+
+	for (int frame = 0; frame < frames; frame++) {
+		for (int v = 0; v < 3; v++) {
+			int div = (int)(3579545 / (32 * note(voice_base[v], frame / FRAMES_PER_NOTE)));
+			*p++ = 0x50; *p++ = 0x80 | v << 5 | (div & 15);
+			*p++ = 0x50; *p++ = div >> 4;
+			*p++ = 0x50; *p++ = 0x90 | v << 5 | (v * 2 + frame % FRAMES_PER_NOTE);
+		}
+		*p++ = 0x50; *p++ = 0xE5;       /* white noise */
+		*p++ = 0x50; *p++ = 0xF6;
+		*p++ = 0x62;                    /* wait 735 */
+	}
+	*p = 0x66;
+
+	song->name = "SMS";
+	song->data = f;
+	song->size = size;
+}
+
+/* Both pulses and the triangle playing notes from tables at $8100, a
+ * table of low and one of high period bytes per voice, and the noise
+ * holding a tone */
+static void make_nsf(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x15, 0x0F },
+		{ 0x00, 0xBF }, { 0x01, 0x00 }, { 0x04, 0xB6 }, { 0x05, 0x00 },
+		{ 0x08, 0xFF }, { 0x0C, 0x36 }, { 0x0E, 0x05 }, { 0x0F, 0x08 },
+	};
+	static const unsigned char period_regs[6] = { 0x02, 0x03, 0x06, 0x07, 0x0A, 0x0B };
+	unsigned char *f = (unsigned char *)calloc(1, 0x80 + 0x200);
+	Asm a = { f + 0x80, 0x8000, 0 };
+
+	memcpy(f, "NESM\x1A", 5);
+	f[5] = 1;                           /* version */
+	f[6] = 1;                           /* songs */
+	f[7] = 1;                           /* first song */
+	put16(f + 0x08, 0x8000);            /* load */
+	put16(f + 0x0A, 0x8000);            /* init */
+	put16(f + 0x0C, 0x8080);            /* play */
+	put16(f + 0x6E, 16666);             /* NTSC frame period, us */
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		emit(&a, 5, 0xA9, regs[i][1], 0x8D, regs[i][0], 0x40);   /* lda #value; sta $40xx */
+	}
+	emit(&a, 1, 0x60);                              /* rts */
+
+	a.len = 0x80;
+	emit(&a, 2, 0xE6, 0x00);                        /* inc $00 */
+	emit(&a, 2, 0xA5, 0x00);                        /* lda $00 */
+	emit(&a, 2, 0x29, FRAMES_PER_NOTE - 1);         /* and #7 */
+	emit(&a, 2, 0xD0, 8 + 6 * 6);                   /* bne done */
+	emit(&a, 2, 0xA5, 0x00);                        /* lda $00 */
+	emit(&a, 3, 0x4A, 0x4A, 0x4A);                  /* lsr; lsr; lsr */
+	emit(&a, 2, 0x29, NOTES - 1);                   /* and #15 */
+	emit(&a, 1, 0xAA);                              /* tax */
+	for (int i = 0; i < 6; i++) {
+		emit(&a, 3, 0xBD, i * NOTES, 0x81);         /* lda $8100+table,x */
+		emit(&a, 3, 0x8D, period_regs[i], 0x40);    /* sta $40xx */
+	}
+	emit(&a, 1, 0x60);                              /* done: rts */
+
+	for (int v = 0; v < 3; v++) {
+		for (int n = 0; n < NOTES; n++) {
+			/* the triangle's step is half as long */
+			int period = (int)(1789773 / ((v == 2 ? 32 : 16) * note(voice_base[v], n))) - 1;
+			a.code[0x100 + v * 2 * NOTES + n] = LO(period);
+			a.code[0x100 + (v * 2 + 1) * NOTES + n] = HI(period) | 0x08;
+		}
+	}
+
+	song->name = "NSF";
+	song->data = f;
+	song->size = 0x80 + 0x200;
+}
+
+/* Both squares and the wave playing notes from tables at $0500, as in
+ * make_nsf(), and the noise channel holding a tone */
+static void make_gbs(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x26, 0x80 }, { 0x24, 0x77 }, { 0x25, 0xFF },
+		{ 0x10, 0x00 }, { 0x11, 0x80 }, { 0x12, 0xF0 }, { 0x13, 0x00 }, { 0x14, 0x87 },
+		{ 0x16, 0x40 }, { 0x17, 0xC0 }, { 0x18, 0x80 }, { 0x19, 0x86 },
+		{ 0x30, 0x01 }, { 0x31, 0x23 }, { 0x32, 0x45 }, { 0x33, 0x67 },
+		{ 0x34, 0x89 }, { 0x35, 0xAB }, { 0x36, 0xCD }, { 0x37, 0xEF },
+		{ 0x1A, 0x80 }, { 0x1B, 0x00 }, { 0x1C, 0x20 }, { 0x1D, 0x00 }, { 0x1E, 0x87 },
+		{ 0x20, 0x00 }, { 0x21, 0x60 }, { 0x22, 0x35 }, { 0x23, 0x80 },
+	};
+	static const unsigned char period_regs[6] = { 0x13, 0x14, 0x18, 0x19, 0x1D, 0x1E };
+	unsigned char *f = (unsigned char *)calloc(1, 0x70 + 0x200);
+	Asm a = { f + 0x70, 0x0400, 0 };
+
+	memcpy(f, "GBS", 3);
+	f[3] = 1;                           /* version */
+	f[4] = 1;                           /* songs */
+	f[5] = 1;                           /* first song */
+	put16(f + 0x06, 0x0400);            /* load */
+	put16(f + 0x08, 0x0400);            /* init */
+	put16(f + 0x0A, 0x0480);            /* play */
+	put16(f + 0x0C, 0xFFFE);            /* stack */
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		emit(&a, 4, 0x3E, regs[i][1], 0xE0, regs[i][0]);     /* ld a,value; ldh ($FFxx),a */
+	}
+	emit(&a, 1, 0xC9);                              /* ret */
+
+	a.len = 0x80;
+	emit(&a, 3, 0x21, 0x00, 0xC0);                  /* ld hl,$C000 */
+	emit(&a, 1, 0x34);                              /* inc (hl) */
+	emit(&a, 1, 0x7E);                              /* ld a,(hl) */
+	emit(&a, 2, 0xE6, FRAMES_PER_NOTE - 1);         /* and 7 */
+	emit(&a, 1, 0xC0);                              /* ret nz */
+	emit(&a, 1, 0x7E);                              /* ld a,(hl) */
+	emit(&a, 3, 0x0F, 0x0F, 0x0F);                  /* rrca; rrca; rrca */
+	emit(&a, 2, 0xE6, NOTES - 1);                   /* and 15 */
+	emit(&a, 3, 0x5F, 0x16, 0x00);                  /* ld e,a; ld d,0 */
+	emit(&a, 3, 0x21, 0x00, 0x05);                  /* ld hl,$0500 */
+	emit(&a, 1, 0x19);                              /* add hl,de */
+	for (int i = 0; i < 6; i++) {
+		emit(&a, 1, 0x7E);                          /* ld a,(hl) */
+		emit(&a, 2, 0xE0, period_regs[i]);         /* ldh ($FFxx),a */
+		emit(&a, 4, 0x11, NOTES, 0x00, 0x19);       /* ld de,16; add hl,de */
+	}
+	emit(&a, 1, 0xC9);                              /* ret */
+
+	for (int v = 0; v < 3; v++) {
+		for (int n = 0; n < NOTES; n++) {
+			/* the wave's 32 steps take twice as long */
+			int period = 2048 - (int)((v == 2 ? 65536 : 131072) / note(voice_base[v], n));
+			a.code[0x100 + v * 2 * NOTES + n] = LO(period);
+			a.code[0x100 + (v * 2 + 1) * NOTES + n] = HI(period);
+		}
+	}
+
+	song->name = "GBS";
+	song->data = f;
+	song->size = 0x70 + 0x200;
+}
+
+/* Channels A to C playing notes from tables at $8100, as in make_nsf(),
+ * and noise on C */
+static void make_ay(Song *song)
+{
+	static const unsigned char regs[][2] = {
+		{ 0x06, 0x10 }, { 0x07, 0x18 }, { 0x08, 0x0F }, { 0x09, 0x0D }, { 0x0A, 0x0B },
+	};
+	unsigned char *f = (unsigned char *)calloc(1, 0x40 + 0x200);
+	Asm a = { f + 0x40, 0x8000, 0 };
+
+	for (size_t i = 0; i < sizeof regs / sizeof regs[0]; i++) {
+		emit(&a, 3, 0x01, 0xFD, 0xFF);              /* ld bc,$FFFD */
+		emit(&a, 2, 0x3E, regs[i][0]);              /* ld a,reg */
+		emit(&a, 2, 0xED, 0x79);                    /* out (c),a */
+		emit(&a, 2, 0x06, 0xBF);                    /* ld b,$BF */
+		emit(&a, 2, 0x3E, regs[i][1]);              /* ld a,value */
+		emit(&a, 2, 0xED, 0x79);                    /* out (c),a */
+	}
+	emit(&a, 1, 0xC9);                              /* ret */
+
+	a.len = 0x80;
+	emit(&a, 3, 0x21, 0x00, 0xC0);                  /* ld hl,$C000 */
+	emit(&a, 1, 0x34);                              /* inc (hl) */
+	emit(&a, 1, 0x7E);                              /* ld a,(hl) */
+	emit(&a, 2, 0xE6, FRAMES_PER_NOTE - 1);         /* and 7 */
+	emit(&a, 1, 0xC0);                              /* ret nz */
+	emit(&a, 1, 0x7E);                              /* ld a,(hl) */
+	emit(&a, 3, 0x0F, 0x0F, 0x0F);                  /* rrca; rrca; rrca */
+	emit(&a, 2, 0xE6, NOTES - 1);                   /* and 15 */
+	emit(&a, 3, 0x5F, 0x16, 0x00);                  /* ld e,a; ld d,0 */
+	emit(&a, 3, 0x21, 0x00, 0x81);                  /* ld hl,$8100 */
+	emit(&a, 1, 0x19);                              /* add hl,de */
+	for (int i = 0; i < 6; i++) {
+		emit(&a, 3, 0x01, 0xFD, 0xFF);              /* ld bc,$FFFD */
+		emit(&a, 2, 0x3E, i);                       /* ld a,reg */
+		emit(&a, 2, 0xED, 0x79);                    /* out (c),a */
+		emit(&a, 2, 0x06, 0xBF);                    /* ld b,$BF */
+		emit(&a, 1, 0x7E);                          /* ld a,(hl) */
+		emit(&a, 2, 0xED, 0x79);                    /* out (c),a */
+		emit(&a, 4, 0x11, NOTES, 0x00, 0x19);       /* ld de,16; add hl,de */
+	}
+	emit(&a, 1, 0xC9);                              /* ret */
+
+	for (int v = 0; v < 3; v++) {
+		for (int n = 0; n < NOTES; n++) {
+			int period = (int)(1773400 / (16 * note(voice_base[v], n)));
+			a.code[0x100 + v * 2 * NOTES + n] = LO(period);
+			a.code[0x100 + (v * 2 + 1) * NOTES + n] = HI(period);
+		}
+	}
+
+	/* Offsets in the header are big-endian and relative to themselves */
+	memcpy(f, "ZXAYEMUL", 8);
+	put16be(f + 0x12, 0x14 - 0x12);     /* track list */
+	put16be(f + 0x16, 0x18 - 0x16);     /* track data */
+	put16be(f + 0x18 + 10, 0x26 - 0x22);    /* stack, init and play */
+	put16be(f + 0x18 + 12, 0x2C - 0x24);    /* blocks */
+	put16be(f + 0x26, 0xF000);          /* stack */
+	put16be(f + 0x28, 0x8000);          /* init */
+	put16be(f + 0x2A, 0x8080);          /* play */
+	put16be(f + 0x2C, 0x8000);          /* block address */
+	put16be(f + 0x2E, 0x200);           /* and size */
+	put16be(f + 0x30, 0x40 - 0x30);     /* and data */
+
+	song->name = "AY";
+	song->data = f;
+	song->size = 0x40 + 0x200;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Nanoseconds per Blip_Synth transition at the given quality: the time of
+ * a minute of output with a transition every 24 to 55 clocks of a 3.58 MHz
+ * chip, less that of the same frames with none, over their number */
+template<int quality>
+static double transition_cost(void)
+{
+	const long clock_rate = 3579545;
+	const int frame = clock_rate / 60;
+	Blip_Buffer buf;
+	Blip_Synth<quality, 30> synth;
+	blip_sample_t out[1024];
+	double cost[2];
+	long count = 0;
+
+	buf.clock_rate(clock_rate);
+	if (buf.set_sample_rate(SAMPLE_RATE, 1000 / 60 + 5) != NULL) {
+		return 0;
+	}
+	synth.volume(0.5);
+	synth.output(&buf);
+
+	for (int transitions = 0; transitions < 2; transitions++) {
+		cost[transitions] = 0;
+		for (int run = 0; run < RUNS; run++) {
+			unsigned long seed = 1;
+			int amp = 0;
+			long n = 0;
+
+			buf.clear();
+			double start = now();
+			for (int f = 0; f < 60 * 60; f++) {
+				if (transitions) {
+					for (blip_time_t t = 0; t < frame; t += 24 + (seed >> 16) % 32) {
+						int delta = ((seed >> 8) & 15) - amp;
+						synth.offset(t, delta);
+						amp += delta;
+						seed = seed * 1103515245 + 12345;
+						n++;
+					}
+				}
+				buf.end_frame(frame);
+				while (buf.read_samples(out, 1024) > 0) {
+				}
+			}
+			double elapsed = now() - start;
+			if (run == 0 || elapsed < cost[transitions]) {
+				cost[transitions] = elapsed;
+			}
+			count = n;
+		}
+	}
+
+	return (cost[1] - cost[0]) * 1e9 / count;
+}
+
+/* Plays seconds of the song into out, which holds them. Returns 0 and sets
+ * the time taken, or -1 on error. */
+static int render(const Song *song, short *out, long total, double *elapsed)
+{
+	Music_Emu *emu;
+	gme_err_t err;
+
+	if ((err = gme_open_data(song->data, song->size, &emu, SAMPLE_RATE)) != NULL) {
+		fprintf(stderr, "%s: %s\n", song->name, err);
+		return -1;
+	}
+	gme_ignore_silence(emu, 1);
+	if ((err = gme_start_track(emu, 0)) != NULL) {
+		fprintf(stderr, "%s: %s\n", song->name, err);
+		gme_delete(emu);
+		return -1;
+	}
+
+	double start = now();
+	for (long done = 0; done < total; done += 4096) {
+		int count = total - done < 4096 ? (int)(total - done) : 4096;
+		if ((err = gme_play(emu, count, out + done)) != NULL) {
+			fprintf(stderr, "%s: %s\n", song->name, err);
+			gme_delete(emu);
+			return -1;
+		}
+	}
+	*elapsed = now() - start;
+	gme_delete(emu);
+
+	return 0;
+}
+
+/* SNR in dB of out against the raw file of the same name in dir, or NAN
+ * if it can't be read or its length differs. The fast step has none of the
+ * band-limited impulse's delay, so out is first lined up with the reference
+ * at the offset of up to MAX_LAG frames that gives the best SNR. */
+static double snr(const char *dir, const Song *song, const short *out, long total)
+{
+	char path[512];
+	short *ref = (short *)malloc((total + 1) * sizeof(short));
+	double best = NAN;
+
+	snprintf(path, sizeof path, "%s/%s.raw", dir, song->name);
+	FILE *f = fopen(path, "rb");
+	if (f == NULL || ref == NULL) {
+		fprintf(stderr, "%s: can't read\n", path);
+		free(ref);
+		return NAN;
+	}
+	if (fread(ref, sizeof(short), total + 1, f) != (size_t)total) {
+		fprintf(stderr, "%s: length differs\n", path);
+		fclose(f);
+		free(ref);
+		return NAN;
+	}
+	fclose(f);
+
+	for (long lag = -MAX_LAG * 2; lag <= MAX_LAG * 2; lag += 2) {
+		double signal = 0, noise = 0;
+		for (long i = MAX_LAG * 2; i < total - MAX_LAG * 2; i++) {
+			double d = (double)ref[i] - out[i + lag];
+			signal += (double)ref[i] * ref[i];
+			noise += d * d;
+		}
+		double db = noise > 0 ? 10 * log10(signal / noise) : INFINITY;
+		if (!(db <= best)) {
+			best = db;
+		}
+	}
+	free(ref);
+
+	return best;
+}
+
+static int write_raw(const char *dir, const Song *song, const short *out, long total)
+{
+	char path[512];
+
+	snprintf(path, sizeof path, "%s/%s.raw", dir, song->name);
+	FILE *f = fopen(path, "wb");
+	if (f == NULL || fwrite(out, sizeof(short), total, f) != (size_t)total) {
+		fprintf(stderr, "%s: can't write\n", path);
+		if (f != NULL) {
+			fclose(f);
+		}
+		return -1;
+	}
+	fclose(f);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *write_dir = NULL, *ref_dir = NULL;
+	double min_snr = 0;
+	int seconds = 10, failed = 0, arg = 1;
+	Song songs[4];
+
+	for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+		if (!strcmp(argv[arg], "-w")) {
+			write_dir = argv[arg + 1];
+		} else if (!strcmp(argv[arg], "-r") && arg + 2 < argc) {
+			ref_dir = argv[arg + 1];
+			min_snr = atof(argv[++arg + 1]);
+		} else {
+			break;
+		}
+	}
+	if (arg < argc) {
+		seconds = atoi(argv[arg++]);
+	}
+	if (seconds <= 0 || arg < argc) {
+		fprintf(stderr, "usage: %s [-w dir] [-r dir min_snr] [seconds]\n", argv[0]);
+		return 2;
+	}
+
+	printf("%-7s %14s\n", "quality", "ns/transition");
+	printf("%-7s %14.1f\n", "fast", transition_cost<blip_fast_quality>());
+	printf("%-7s %14.1f\n", "med", transition_cost<blip_med_quality>());
+	printf("%-7s %14.1f\n", "good", transition_cost<blip_good_quality>());
+	printf("%-7s %14.1f\n", "high", transition_cost<blip_high_quality>());
+	printf("\n");
+
+	make_ay(&songs[0]);
+	make_vgm(&songs[1]);
+	make_nsf(&songs[2]);
+	make_gbs(&songs[3]);
+
+	long total = (long)seconds * SAMPLE_RATE * 2;
+	short *out = (short *)malloc(total * sizeof(short));
+	printf("%-4s %14s %9s\n", "file", "ms/s output", "SNR dB");
+	for (int s = 0; s < 4; s++) {
+		double elapsed = 0, best = 0, db = NAN;
+		int peak = 0;
+
+		for (int run = 0; run < RUNS; run++) {
+			if (render(&songs[s], out, total, &elapsed) != 0) {
+				failed = 1;
+				break;
+			}
+			if (run == 0 || elapsed < best) {
+				best = elapsed;
+			}
+		}
+		for (long i = 0; i < total; i++) {
+			peak = abs(out[i]) > peak ? abs(out[i]) : peak;
+		}
+		if (peak == 0) {
+			fprintf(stderr, "%s: silent\n", songs[s].name);
+			failed = 1;
+		}
+		if (write_dir != NULL && write_raw(write_dir, &songs[s], out, total) != 0) {
+			failed = 1;
+		}
+		if (ref_dir != NULL) {
+			db = snr(ref_dir, &songs[s], out, total);
+			if (!(db >= min_snr)) {
+				fprintf(stderr, "%s: SNR below %.1f dB\n", songs[s].name, min_snr);
+				failed = 1;
+			}
+		}
+		if (ref_dir != NULL) {
+			printf("%-4s %14.2f %9.1f\n", songs[s].name, best * 1000 / seconds, db);
+		} else {
+			printf("%-4s %14.2f %9s\n", songs[s].name, best * 1000 / seconds, "-");
+		}
+		free(songs[s].data);
+	}
+	free(out);
+
+	return failed;
+}
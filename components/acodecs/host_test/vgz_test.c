@@ -0,0 +1,353 @@
+/*
+ * Plays a generated VGM file and the same file gzip'd as VGZ, and fails
+ * unless both give the same output sample for sample: from the start
+ * through the loop point, then after seeks back into the intro, into the
+ * loop and past its first repeat.
+ *
+ * The VGM has PSG and FM parts and a DAC section streamed from a PCM data
+ * block, so it is long enough for the deflate window to wrap. Its gzip'd
+ * copy is written in stored, fixed and dynamic Huffman blocks, each
+ * segment free to refer back into the ones before it, and the loop point
+ * falls in a dynamic one.
+ *
+ * vgz_test [directory]
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gme.h>
+#include <zlib.h>
+
+#define SAMPLE_RATE 44100
+#define FRAME 735               /* VGM samples per 60 Hz frame */
+#define INTRO_FRAMES 60
+#define LOOP_FRAMES 180
+#define PCM_SIZE 6000
+
+typedef struct {
+	unsigned char *data;
+	long size;
+	long cap;
+} Buf;
+
+static void put(Buf *b, int count, const unsigned char *bytes)
+{
+	if (b->size + count > b->cap) {
+		b->cap = (b->size + count) * 2;
+		b->data = realloc(b->data, b->cap);
+	}
+	memcpy(b->data + b->size, bytes, count);
+	b->size += count;
+}
+
+/* A command of count bytes */
+static void emit(Buf *b, int count, ...)
+{
+	unsigned char c[8];
+	va_list args;
+
+	va_start(args, count);
+	for (int i = 0; i < count; i++) {
+		c[i] = va_arg(args, int);
+	}
+	va_end(args);
+	put(b, count, c);
+}
+
+static void put32(unsigned char *p, unsigned long v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static unsigned long seed = 1;
+
+static int rnd(int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % n;
+}
+
+/* A frame of music: a PSG note and noise, an FM note every few frames */
+static void frame(Buf *b, int n)
+{
+	static const int psg_div[] = { 0x1AC, 0x17D, 0x153, 0x140, 0x11D, 0xFE, 0xE2, 0xD6 };
+	static const int fm_fnum[] = { 644, 723, 811, 859, 964, 1082, 1214, 1288 };
+	int div = psg_div[rnd(8)] >> (n % 2);
+
+	emit(b, 2, 0x50, 0x80 | (div & 15));
+	emit(b, 2, 0x50, div >> 4);
+	emit(b, 2, 0x50, 0x90 | (n % 16));
+	emit(b, 2, 0x50, 0xE4 | (n % 3));
+	emit(b, 2, 0x50, 0xF0 | rnd(16));
+	if (n % 4 == 0) {
+		int fnum = fm_fnum[rnd(8)];
+		emit(b, 3, 0x52, 0x28, 0x00);           /* key off */
+		emit(b, 3, 0x52, 0xA4, (rnd(3) + 3) << 3 | fnum >> 8);
+		emit(b, 3, 0x52, 0xA0, fnum & 0xFF);
+		emit(b, 3, 0x52, 0x28, 0xF0);           /* key on */
+	}
+}
+
+/* A frame of the DAC playing the PCM block, a sample every 1 to 3 VGM
+ * samples, along with the PSG part */
+static void dac_frame(Buf *b, int n, long *pcm_pos)
+{
+	int left = FRAME;
+
+	frame(b, n);
+	while (left > 0) {
+		int wait = 1 + rnd(3);
+		emit(b, 1, 0x80 | (wait < left ? wait : left));
+		left -= wait;
+		if (++*pcm_pos == PCM_SIZE) {
+			emit(b, 5, 0xE0, 0, 0, 0, 0);       /* back to the start */
+			*pcm_pos = 0;
+		}
+	}
+}
+
+static Buf make_vgm(long *loop_out)
+{
+	static const unsigned char fm_voice[][2] = {
+		{ 0xB0, 0x07 }, { 0xB4, 0xC0 },         /* algorithm 7, both speakers */
+		{ 0x30, 0x01 }, { 0x34, 0x02 }, { 0x38, 0x04 }, { 0x3C, 0x01 },
+		{ 0x40, 0x20 }, { 0x44, 0x28 }, { 0x48, 0x30 }, { 0x4C, 0x10 },
+		{ 0x50, 0x1F }, { 0x54, 0x1F }, { 0x58, 0x1F }, { 0x5C, 0x1F },
+		{ 0x60, 0x08 }, { 0x64, 0x0A }, { 0x68, 0x0C }, { 0x6C, 0x06 },
+		{ 0x80, 0x47 }, { 0x84, 0x47 }, { 0x88, 0x47 }, { 0x8C, 0x47 },
+	};
+	Buf b = { 0 };
+	unsigned char h[0x40] = { 'V', 'g', 'm', ' ' };
+	long loop, pcm_pos = 0;
+
+	put(&b, sizeof h, h);
+
+	/* PCM data block: a decaying tone with some noise */
+	unsigned char block[7] = { 0x67, 0x66, 0x00 };
+	put32(block + 3, PCM_SIZE);
+	put(&b, sizeof block, block);
+	for (int i = 0; i < PCM_SIZE; i++) {
+		unsigned char s = 0x80 + ((i * 7 % 64) - 32) * (PCM_SIZE - i) / PCM_SIZE + rnd(9) - 4;
+		put(&b, 1, &s);
+	}
+
+	for (size_t i = 0; i < sizeof fm_voice / sizeof fm_voice[0]; i++) {
+		emit(&b, 3, 0x52, fm_voice[i][0], fm_voice[i][1]);
+	}
+	for (int n = 0; n < INTRO_FRAMES; n++) {
+		frame(&b, n);
+		emit(&b, 1, 0x62);                      /* wait 735 */
+	}
+
+	loop = b.size;
+	emit(&b, 3, 0x52, 0x2B, 0x80);              /* DAC on */
+	emit(&b, 5, 0xE0, 0, 0, 0, 0);
+	for (int n = 0; n < LOOP_FRAMES / 2; n++) {
+		dac_frame(&b, n, &pcm_pos);
+	}
+	emit(&b, 3, 0x52, 0x2B, 0x00);              /* DAC off */
+	for (int n = 0; n < LOOP_FRAMES / 2; n++) {
+		frame(&b, n + 7);
+		emit(&b, 1, 0x63);                      /* wait 882 */
+	}
+	emit(&b, 1, 0x66);
+
+	put32(b.data + 0x04, b.size - 0x04);
+	put32(b.data + 0x08, 0x150);
+	put32(b.data + 0x0C, 3579545);               /* PSG */
+	put32(b.data + 0x18, (long)(INTRO_FRAMES * FRAME + LOOP_FRAMES / 2 * (FRAME + 882)));
+	put32(b.data + 0x1C, loop - 0x1C);
+	put32(b.data + 0x20, (long)(LOOP_FRAMES / 2 * (FRAME + 882)));
+	put32(b.data + 0x24, 60);
+	b.data[0x28] = 0x09;                        /* noise feedback */
+	b.data[0x2A] = 16;                          /* noise width */
+	put32(b.data + 0x2C, 7670453);               /* YM2612 */
+	put32(b.data + 0x34, 0x40 - 0x34);
+
+	*loop_out = loop;
+	return b;
+}
+
+/* Deflates data in segments of stored, fixed, dynamic Huffman and stored
+ * blocks, the dynamic ones from just before the loop point to three
+ * quarters through. Each segment is compressed on its own, primed with the
+ * data before it so its matches can reach back across the segment
+ * boundary. Returns nonzero if a segment didn't start with the block type
+ * it was meant to. */
+static int make_vgz(const Buf *vgm, long loop, Buf *gz)
+{
+	const struct {
+		int level, strategy, type;
+		long end;
+	} segments[] = {
+		{ 0, Z_DEFAULT_STRATEGY, 0, loop / 2 },
+		{ 6, Z_FIXED, 1, loop - 256 },
+		{ 9, Z_DEFAULT_STRATEGY, 2, vgm->size * 3 / 4 },
+		{ 0, Z_DEFAULT_STRATEGY, 0, vgm->size },
+	};
+	static const unsigned char header[] = {
+		0x1F, 0x8B, 8, 0x08, 0, 0, 0, 0, 0, 3, 't', 'e', 's', 't', '.', 'v', 'g', 'm', 0
+	};
+	int count = sizeof segments / sizeof segments[0];
+	unsigned char out[1 << 16], trailer[8];
+	long pos = 0;
+
+	put(gz, sizeof header, header);
+	for (int s = 0; s < count; s++) {
+		long end = segments[s].end;
+		long dict = pos < 0x8000 ? pos : 0x8000;
+		z_stream z = { 0 };
+
+		deflateInit2(&z, segments[s].level, Z_DEFLATED, -15, 8, segments[s].strategy);
+		if (dict > 0) {
+			deflateSetDictionary(&z, vgm->data + pos - dict, dict);
+		}
+		z.next_in = vgm->data + pos;
+		z.avail_in = end - pos;
+		long start = gz->size;
+		int flush = s == count - 1 ? Z_FINISH : Z_SYNC_FLUSH;
+		do {
+			z.next_out = out;
+			z.avail_out = sizeof out;
+			deflate(&z, flush);
+			put(gz, sizeof out - z.avail_out, out);
+		} while (z.avail_out == 0);
+		deflateEnd(&z);
+
+		/* A sync flush ends on a byte boundary, so each segment's first
+		 * block header is in the low bits of its first byte */
+		if ((gz->data[start] >> 1 & 3) != segments[s].type) {
+			fprintf(stderr, "segment %d: block type %d\n", s, gz->data[start] >> 1 & 3);
+			return 1;
+		}
+		pos = end;
+	}
+
+	put32(trailer, crc32(0, vgm->data, vgm->size));
+	put32(trailer + 4, vgm->size);
+	put(gz, sizeof trailer, trailer);
+
+	return 0;
+}
+
+static int write_file(const char *path, const Buf *b)
+{
+	FILE *f = fopen(path, "wb");
+	int err = f == NULL || fwrite(b->data, 1, b->size, f) != (size_t)b->size;
+
+	if (f != NULL && fclose(f) != 0) {
+		err = 1;
+	}
+	if (err) {
+		fprintf(stderr, "%s: can't write\n", path);
+	}
+	return err;
+}
+
+/* Where each part of the output starts, in ms, and how long it lasts */
+static const struct {
+	int seek, length;
+} parts[] = {
+	{ -1, 7000 },   /* from the start, through the loop point at 1 s and its repeat at 4.3 s */
+	{ 500, 1000 },  /* back into the intro */
+	{ 2500, 1000 }, /* into the DAC section of the loop */
+	{ 5800, 1000 }, /* past the first repeat */
+	{ 1200, 500 },  /* back to just after the loop point */
+};
+
+#define PARTS (sizeof parts / sizeof parts[0])
+
+static short *render(const char *path, long *count)
+{
+	Music_Emu *emu;
+	const char *err;
+	long total = 0;
+
+	for (size_t p = 0; p < PARTS; p++) {
+		total += (long)parts[p].length * SAMPLE_RATE / 1000 * 2;
+	}
+	short *out = malloc(total * sizeof(short));
+	if (out == NULL) {
+		return NULL;
+	}
+
+	if ((err = gme_open_file(path, &emu, SAMPLE_RATE)) != NULL ||
+	    (err = gme_start_track(emu, 0)) != NULL) {
+		fprintf(stderr, "%s: %s\n", path, err);
+		free(out);
+		return NULL;
+	}
+	gme_ignore_silence(emu, 1);
+
+	*count = 0;
+	for (size_t p = 0; p < PARTS && err == NULL; p++) {
+		long n = (long)parts[p].length * SAMPLE_RATE / 1000 * 2;
+		if (parts[p].seek >= 0) {
+			err = gme_seek(emu, parts[p].seek);
+		}
+		if (err == NULL) {
+			err = gme_play(emu, n, out + *count);
+		}
+		*count += n;
+	}
+	if (err != NULL) {
+		fprintf(stderr, "%s: %s\n", path, err);
+		free(out);
+		out = NULL;
+	}
+	gme_delete(emu);
+
+	return out;
+}
+
+int main(int argc, char **argv)
+{
+	const char *dir = argc > 1 ? argv[1] : ".";
+	char vgm_path[1024], vgz_path[1024];
+	Buf vgm, gz = { 0 };
+	long loop, vgm_count, vgz_count, peak = 0;
+
+	snprintf(vgm_path, sizeof vgm_path, "%s/test.vgm", dir);
+	snprintf(vgz_path, sizeof vgz_path, "%s/test.vgz", dir);
+	vgm = make_vgm(&loop);
+	if (make_vgz(&vgm, loop, &gz) || write_file(vgm_path, &vgm) || write_file(vgz_path, &gz)) {
+		return 1;
+	}
+	printf("VGM %ld bytes, VGZ %ld bytes\n", vgm.size, gz.size);
+
+	short *a = render(vgm_path, &vgm_count);
+	short *b = render(vgz_path, &vgz_count);
+	if (a == NULL || b == NULL) {
+		return 1;
+	}
+
+	long offset = 0;
+	for (size_t p = 0; p < PARTS; p++) {
+		long n = (long)parts[p].length * SAMPLE_RATE / 1000 * 2;
+		for (long i = offset; i < offset + n; i++) {
+			if (a[i] != b[i]) {
+				fprintf(stderr, "part %zu: output differs at sample %ld\n",
+				        p, (i - offset) / 2);
+				return 1;
+			}
+			peak = labs(a[i]) > peak ? labs(a[i]) : peak;
+		}
+		offset += n;
+	}
+	if (peak == 0) {
+		fprintf(stderr, "no output\n");
+		return 1;
+	}
+	printf("%ld samples match\n", vgm_count / 2);
+
+	free(a);
+	free(b);
+	free(vgm.data);
+	free(gz.data);
+	return 0;
+}
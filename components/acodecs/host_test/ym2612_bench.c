@@ -0,0 +1,209 @@
+/*
+ * Cost per second of output of each YM2612 core, on a generated VGM that
+ * keeps all six FM channels playing. Also checks that every core makes
+ * sound and that switching cores in the middle of a track keeps it going.
+ *
+ * ym2612_bench [seconds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <gme.h>
+
+#define SAMPLE_RATE 44100
+#define YM2612_CLOCK 7670453
+
+typedef struct {
+	unsigned char *data;
+	long size;
+	long cap;
+} Vgm;
+
+static void vgm_put(Vgm *vgm, int a, int b, int c, int len)
+{
+	if (vgm->size + 3 > vgm->cap) {
+		vgm->cap = vgm->cap ? vgm->cap * 2 : 4096;
+		vgm->data = realloc(vgm->data, vgm->cap);
+		if (vgm->data == NULL) {
+			exit(2);
+		}
+	}
+	unsigned char *p = vgm->data + vgm->size;
+	p[0] = a;
+	p[1] = b;
+	p[2] = c;
+	vgm->size += len;
+}
+
+static void vgm_write32(unsigned char *p, unsigned v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+/* YM2612 register write on port 0 or 1 */
+static void fm_write(Vgm *vgm, int port, int addr, int data)
+{
+	vgm_put(vgm, 0x52 + port, addr, data, 3);
+}
+
+/* Six channels of a plucked patch, a new chord every eighth of a second */
+static void make_vgm(Vgm *vgm, int seconds)
+{
+	static const int fnum[] = { 644, 681, 722, 765, 810, 858, 910, 964, 1021, 1081, 1146, 1214 };
+	unsigned seed = 1;
+	long samples = 0;
+
+	vgm->size = vgm->cap = 0;
+	vgm->data = NULL;
+	for (int i = 0; i < 0x40; i++) {
+		vgm_put(vgm, 0, 0, 0, 1);
+	}
+
+	fm_write(vgm, 0, 0x22, 0x00);
+	fm_write(vgm, 0, 0x27, 0x00);
+	fm_write(vgm, 0, 0x2B, 0x00);
+	for (int port = 0; port < 2; port++) {
+		for (int ch = 0; ch < 3; ch++) {
+			for (int op = 0; op < 4; op++) {
+				int o = ch + op * 4;
+				fm_write(vgm, port, 0x30 + o, 0x71);
+				fm_write(vgm, port, 0x40 + o, op < 3 ? 0x23 : 0x00);
+				fm_write(vgm, port, 0x50 + o, 0x1F);
+				fm_write(vgm, port, 0x60 + o, 0x05);
+				fm_write(vgm, port, 0x70 + o, 0x02);
+				fm_write(vgm, port, 0x80 + o, 0x11);
+			}
+			fm_write(vgm, port, 0xB0 + ch, 0x32);
+			fm_write(vgm, port, 0xB4 + ch, 0xC0);
+		}
+	}
+
+	while (samples < (long)seconds * SAMPLE_RATE) {
+		for (int c = 0; c < 6; c++) {
+			int port = c / 3, ch = c % 3;
+			int key = ch | (port ? 4 : 0);
+			seed = seed * 1103515245 + 12345;
+			int f = fnum[(seed >> 16) % 12];
+			int block = 3 + (seed >> 24) % 3;
+			fm_write(vgm, 0, 0x28, key);
+			fm_write(vgm, port, 0xA4 + ch, block << 3 | f >> 8);
+			fm_write(vgm, port, 0xA0 + ch, f & 0xFF);
+			fm_write(vgm, 0, 0x28, 0xF0 | key);
+		}
+		vgm_put(vgm, 0x61, 5512 & 0xFF, 5512 >> 8, 3);
+		samples += 5512;
+	}
+	vgm_put(vgm, 0x66, 0, 0, 1);
+
+	memcpy(vgm->data, "Vgm ", 4);
+	vgm_write32(vgm->data + 0x04, vgm->size - 4);
+	vgm_write32(vgm->data + 0x08, 0x150);
+	vgm_write32(vgm->data + 0x18, samples);
+	vgm_write32(vgm->data + 0x2C, YM2612_CLOCK);
+	vgm_write32(vgm->data + 0x34, 0x40 - 0x34);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char *const core_names[] = { "Nuked", "MAME", "GENS" };
+
+/* Renders the track on one core, switching to switch_to halfway unless it's
+ * negative. Returns the peak sample, or -1 on error. */
+static int render(const Vgm *vgm, int core, int switch_to, int seconds, double *elapsed)
+{
+	Music_Emu *emu;
+	short buf[4096];
+	long total = (long)seconds * SAMPLE_RATE * 2, done = 0;
+	int peak = 0;
+	gme_err_t err;
+
+	if ((err = gme_open_data(vgm->data, vgm->size, &emu, SAMPLE_RATE)) != NULL ||
+	    (err = gme_set_ym2612_core(emu, core)) != NULL ||
+	    (err = gme_start_track(emu, 0)) != NULL) {
+		fprintf(stderr, "%s: %s\n", core_names[core], err);
+		return -1;
+	}
+
+	double start = now();
+	while (done < total && !gme_track_ended(emu)) {
+		if (switch_to >= 0 && done >= total / 2) {
+			if ((err = gme_set_ym2612_core(emu, switch_to)) != NULL) {
+				fprintf(stderr, "switching to %s: %s\n", core_names[switch_to], err);
+				gme_delete(emu);
+				return -1;
+			}
+			core = switch_to;
+			switch_to = -1;
+		}
+		if ((err = gme_play(emu, 4096, buf)) != NULL) {
+			fprintf(stderr, "%s: %s\n", core_names[core], err);
+			gme_delete(emu);
+			return -1;
+		}
+		/* only what's played after a switch tells if the new core runs */
+		if (switch_to < 0) {
+			for (int i = 0; i < 4096; i++) {
+				int v = abs(buf[i]);
+				peak = v > peak ? v : peak;
+			}
+		}
+		done += 4096;
+	}
+	*elapsed = now() - start;
+
+	if (gme_ym2612_core(emu) != core) {
+		fprintf(stderr, "%s: running core %d\n", core_names[core], gme_ym2612_core(emu));
+		peak = -1;
+	}
+	gme_delete(emu);
+
+	return peak;
+}
+
+int main(int argc, char **argv)
+{
+	int seconds = argc > 1 ? atoi(argv[1]) : 10;
+	int failed = 0;
+	double elapsed;
+	Vgm vgm;
+
+	if (seconds <= 0) {
+		fprintf(stderr, "usage: %s [seconds]\n", argv[0]);
+		return 2;
+	}
+	make_vgm(&vgm, seconds);
+
+	printf("%-6s %14s %10s\n", "core", "ms/s output", "realtime");
+	for (int core = gme_ym2612_nuked; core <= gme_ym2612_gens; core++) {
+		int peak = render(&vgm, core, -1, seconds, &elapsed);
+		if (peak <= 0) {
+			fprintf(stderr, "%s: no output\n", core_names[core]);
+			failed = 1;
+			continue;
+		}
+		printf("%-6s %14.2f %9.0fx\n", core_names[core],
+		       elapsed * 1000 / seconds, seconds / elapsed);
+	}
+
+	/* the fallback steps down while a track plays */
+	for (int core = gme_ym2612_nuked; core < gme_ym2612_gens; core++) {
+		if (render(&vgm, core, core + 1, seconds, &elapsed) <= 0) {
+			fprintf(stderr, "%s -> %s: no output after the switch\n",
+				core_names[core], core_names[core + 1]);
+			failed = 1;
+		}
+	}
+
+	free(vgm.data);
+	return failed;
+}
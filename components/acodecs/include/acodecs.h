@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -30,7 +31,43 @@ typedef struct AudioDecoder {
 	int (*decode)(void *handle, int16_t *buf, int num_c, unsigned buf_len);
 	/** Close the given handle, eventually freeing memory. */
 	int (*close)(void *handle);
+	/** Seek to the given time in milliseconds. NULL if the codec can't seek. */
+	int (*seek)(void *handle, unsigned ms);
+	/** Open the given track of a multi-track file. NULL if the codec has a single track. */
+	int (*open_track)(void **handle, const char *filename, int track);
+	/** Count the tracks in the given file without loading it, 0 if it can't be played. */
+	int (*track_count)(const char *filename);
+	/** Length of the given file in milliseconds from its headers, without
+	 * decoding it. 0 if unknown, NULL if the codec can't tell. */
+	int (*duration)(const char *filename);
 } AudioDecoder;
 
+/** Low-power decode modes, combined as flags. They trade output quality for
+ * decode time; codecs without a cheaper path (WAV, FLAC) ignore them. */
+typedef enum AudioDecodeMode {
+	AudioDecodeFull = 0,
+	/** Mix down to one channel as early as the codec allows; get_info then
+	 * reports a single channel. */
+	AudioDecodeMono = 1 << 0,
+	/** Decode at half the sample rate, band-limiting the output. */
+	AudioDecodeHalfRate = 1 << 1,
+} AudioDecodeMode;
+
 /** Choose an AudioDecoder given the codec and return it */
 AudioDecoder *acodec_get_decoder(AudioCodec codec);
+
+/** Set the AudioDecodeMode flags for the files opened after this call. */
+void acodec_set_mode(unsigned mode);
+
+/** Directory the files of the flash set are opened under, as
+ * ACODEC_FLASH_DIR "/" name. The flash set is game music packed into the
+ * appfs partition by tools/flashset.py; its files are played from
+ * memory-mapped flash instead of being copied to the heap. */
+#define ACODEC_FLASH_DIR "/appfs"
+
+/** Number of files in the flash set, 0 if there is none. */
+int acodec_flash_count(void);
+
+/** Copy the name of the given file of the flash set into name, which holds
+ * size bytes. Returns 0, or -1 if there is no such file or it doesn't fit. */
+int acodec_flash_name(int index, char *name, size_t size);
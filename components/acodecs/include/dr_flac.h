@@ -213,6 +213,10 @@ OPTIONS
   Disables SIMD optimizations (SSE on x86/x64 architectures, NEON on ARM architectures). Use this if you are having
   compatibility issues with your compiler.
 
+#define DR_FLAC_NO_SCALAR_32
+  Disables the 32-bit unrolled prediction and fused s16 stereo paths used where there is no SIMD code for the same step,
+  leaving the generic scalar code. The output is the same either way.
+
 
 
 QUICK NOTES
@@ -804,6 +808,55 @@ Returns DRFLAC_TRUE if successful; DRFLAC_FALSE otherwise.
 drflac_bool32 drflac_seek_to_pcm_frame(drflac* pFlac, drflac_uint64 pcmFrameIndex);
 
 
+/*
+Looks for the next FLAC frame header in a block of raw stream data.
+
+pFlac    [in]            The decoder of the stream the data belongs to.
+pData    [in]            A pointer to the raw data of a native FLAC stream, somewhere past the metadata blocks.
+dataSize [in]            The size in bytes of the data pointed to by pData.
+pHeader  [out, optional] Receives the parsed header.
+
+Returns the offset of the header, or dataSize if there is none.
+
+A header is only reported if its CRC-8 is valid and its channel count, bit depth, sample rate and block size agree with the
+stream, and only if all of its bytes are within the data; a header cut off at the end is looked for again once more data is
+available. A header is never longer than 16 bytes.
+
+Audio data can contain a sync code followed by a valid CRC-8 by chance. Callers splitting a stream into frames should also
+check that the frame or sample number in pHeader follows on from the previous frame.
+*/
+size_t drflac_find_frame_header(const drflac* pFlac, const void* pData, size_t dataSize, drflac_frame_header* pHeader);
+
+/*
+Opens a decoder for individual frames of the stream pFlac is decoding.
+
+pFlac                [in]           The decoder whose stream the frames belong to. Must be a native FLAC stream.
+pAllocationCallbacks [in, optional] A pointer to application defined callbacks for managing memory allocations. The
+                                    callbacks of pFlac are used if this is NULL.
+
+Returns a pointer to the frame decoder, or NULL if pFlac is an Ogg stream or memory can't be allocated.
+
+A frame decoder takes whole frames through drflac_decode_frame_s16() rather than reading from a stream, so frames found with
+drflac_find_frame_header() can be decoded on several threads at once, each with its own frame decoder. It holds no reference
+to pFlac, which can be closed first. Close it with drflac_close().
+*/
+drflac* drflac_open_frame_decoder(const drflac* pFlac, const drflac_allocation_callbacks* pAllocationCallbacks);
+
+/*
+Decodes one whole frame with a decoder opened by drflac_open_frame_decoder().
+
+pDecoder   [in]  The frame decoder.
+pData      [in]  A pointer to the frame, starting at its header.
+dataSize   [in]  The size in bytes of the frame. Trailing bytes past its end are ignored.
+pBufferOut [out] Receives the interleaved samples, which needs room for the frame's block size times the channel count.
+
+Returns the number of PCM frames decoded, or 0 if the frame is damaged or incomplete.
+
+The samples are exactly those drflac_read_pcm_frames_s16() returns for the same frame.
+*/
+drflac_uint32 drflac_decode_frame_s16(drflac* pDecoder, const void* pData, size_t dataSize, drflac_int16* pBufferOut);
+
+
 
 #ifndef DR_FLAC_NO_STDIO
 /*
@@ -1077,6 +1130,16 @@ drflac_bool32 drflac_next_cuesheet_track(drflac_cuesheet_track_iterator* pIter,
     #endif
 #endif
 
+/* The scalar 32-bit paths for 16-bit audio, for each step that has no SIMD version. */
+#if !defined(DR_FLAC_NO_SCALAR_32)
+    #if !defined(DRFLAC_SUPPORT_SSE41) && !defined(DRFLAC_SUPPORT_NEON)
+        #define DRFLAC_SCALAR_32_PREDICTION
+    #endif
+    #if !defined(DRFLAC_SUPPORT_SSE2) && !defined(DRFLAC_SUPPORT_NEON)
+        #define DRFLAC_SCALAR_32_S16_STEREO
+    #endif
+#endif
+
 /* Compile-time CPU feature support. */
 #if !defined(DR_FLAC_NO_SIMD) && (defined(DRFLAC_X86) || defined(DRFLAC_X64))
     #if defined(_MSC_VER) && !defined(__clang__)
@@ -4232,6 +4295,103 @@ static drflac_bool32 drflac__decode_samples_with_residual__rice(drflac_bs* bs, d
     }
 }
 
+#if defined(DRFLAC_SCALAR_32_PREDICTION)
+/*
+The scalar path for the common case of 16-bit audio and a prediction order of 12 or less. Each order gets its own loop, so the
+prediction is unrolled with no switch per sample, and the coefficients are copied to locals the compiler can keep in registers.
+The prediction is always summed in 32 bits, so this must only be used where drflac__is_prediction_32_safe() says so. This is
+what runs on 32-bit microcontrollers such as the ESP32, where 64-bit arithmetic is slow and there are no SIMD paths.
+*/
+static DRFLAC_INLINE drflac_bool32 drflac__decode_samples_with_residual__rice__order_32(drflac_bs* bs, drflac_uint32 count, drflac_uint8 riceParam, drflac_uint32 order, drflac_int32 shift, const drflac_int32* coefficients, drflac_int32* pSamplesOut)
+{
+    drflac_uint32 t[2] = {0x00000000, 0xFFFFFFFF};
+    drflac_uint32 riceParamMask = ~((~0UL) << riceParam);
+    drflac_int32 c[12];
+    drflac_uint32 i;
+
+    for (i = 0; i < order; ++i) {
+        c[i] = coefficients[i];
+    }
+
+    for (i = 0; i < count; ++i) {
+        drflac_uint32 zeroCountPart;
+        drflac_uint32 riceParamPart;
+        drflac_int32 prediction = 0;
+
+        if (!drflac__read_rice_parts_x1(bs, riceParam, &zeroCountPart, &riceParamPart)) {
+            return DRFLAC_FALSE;
+        }
+
+        riceParamPart &= riceParamMask;
+        riceParamPart |= (zeroCountPart << riceParam);
+        riceParamPart  = (riceParamPart >> 1) ^ t[riceParamPart & 0x01];
+
+        /* order is a constant wherever this is inlined, so this switch is resolved at compile time. */
+        switch (order)
+        {
+        case 12: prediction += c[11] * pSamplesOut[-12];
+        case 11: prediction += c[10] * pSamplesOut[-11];
+        case 10: prediction += c[ 9] * pSamplesOut[-10];
+        case  9: prediction += c[ 8] * pSamplesOut[- 9];
+        case  8: prediction += c[ 7] * pSamplesOut[- 8];
+        case  7: prediction += c[ 6] * pSamplesOut[- 7];
+        case  6: prediction += c[ 5] * pSamplesOut[- 6];
+        case  5: prediction += c[ 4] * pSamplesOut[- 5];
+        case  4: prediction += c[ 3] * pSamplesOut[- 4];
+        case  3: prediction += c[ 2] * pSamplesOut[- 3];
+        case  2: prediction += c[ 1] * pSamplesOut[- 2];
+        case  1: prediction += c[ 0] * pSamplesOut[- 1];
+        }
+
+        pSamplesOut[0] = (drflac_int32)riceParamPart + (prediction >> shift);
+        pSamplesOut += 1;
+    }
+
+    return DRFLAC_TRUE;
+}
+
+static drflac_bool32 drflac__decode_samples_with_residual__rice__unrolled_32(drflac_bs* bs, drflac_uint32 count, drflac_uint8 riceParam, drflac_uint32 order, drflac_int32 shift, const drflac_int32* coefficients, drflac_int32* pSamplesOut)
+{
+    switch (order)
+    {
+    case  1: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  1, shift, coefficients, pSamplesOut);
+    case  2: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  2, shift, coefficients, pSamplesOut);
+    case  3: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  3, shift, coefficients, pSamplesOut);
+    case  4: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  4, shift, coefficients, pSamplesOut);
+    case  5: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  5, shift, coefficients, pSamplesOut);
+    case  6: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  6, shift, coefficients, pSamplesOut);
+    case  7: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  7, shift, coefficients, pSamplesOut);
+    case  8: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  8, shift, coefficients, pSamplesOut);
+    case  9: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam,  9, shift, coefficients, pSamplesOut);
+    case 10: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam, 10, shift, coefficients, pSamplesOut);
+    case 11: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam, 11, shift, coefficients, pSamplesOut);
+    case 12: return drflac__decode_samples_with_residual__rice__order_32(bs, count, riceParam, 12, shift, coefficients, pSamplesOut);
+    default: return DRFLAC_FALSE;
+    }
+}
+
+/*
+Whether the prediction sum for every sample of a subframe fits in 32 bits: the sum of the magnitudes of the coefficients times
+the largest magnitude a sample can have. This is exact, where the bitsPerSample+shift test used by the generic paths is only a
+heuristic.
+*/
+static drflac_bool32 drflac__is_prediction_32_safe(drflac_uint32 bitsPerSample, drflac_uint32 order, const drflac_int32* coefficients)
+{
+    drflac_uint32 coefficientSum = 0;
+    drflac_uint32 i;
+
+    if (bitsPerSample == 0 || bitsPerSample > 31) {
+        return DRFLAC_FALSE;
+    }
+
+    for (i = 0; i < order; ++i) {
+        coefficientSum += (drflac_uint32)(coefficients[i] < 0 ? -coefficients[i] : coefficients[i]);
+    }
+
+    return coefficientSum <= (0x7FFFFFFFUL >> (bitsPerSample - 1));
+}
+#endif
+
 /* Reads and seeks past a string of residual values as Rice codes. The decoder should be sitting on the first bit of the Rice codes. */
 static drflac_bool32 drflac__read_and_seek_residual__rice(drflac_bs* bs, drflac_uint32 count, drflac_uint8 riceParam)
 {
@@ -4289,11 +4449,18 @@ static drflac_bool32 drflac__decode_samples_with_residual(drflac_bs* bs, drflac_
     drflac_uint8 partitionOrder;
     drflac_uint32 samplesInPartition;
     drflac_uint32 partitionsRemaining;
+#if defined(DRFLAC_SCALAR_32_PREDICTION)
+    drflac_bool32 isUnrolled32;
+#endif
 
     drflac_assert(bs != NULL);
     drflac_assert(blockSize != 0);
     drflac_assert(pDecodedSamples != NULL);       /* <-- Should we allow NULL, in which case we just seek past the residual rather than do a full decode? */
 
+#if defined(DRFLAC_SCALAR_32_PREDICTION)
+    isUnrolled32 = order >= 1 && order <= 12 && drflac__is_prediction_32_safe(bitsPerSample, order, coefficients);
+#endif
+
     if (!drflac__read_uint8(bs, 2, &residualMethod)) {
         return DRFLAC_FALSE;
     }
@@ -4343,6 +4510,13 @@ static drflac_bool32 drflac__decode_samples_with_residual(drflac_bs* bs, drflac_
         }
 
         if (riceParam != 0xFF) {
+#if defined(DRFLAC_SCALAR_32_PREDICTION)
+            if (isUnrolled32) {
+                if (!drflac__decode_samples_with_residual__rice__unrolled_32(bs, samplesInPartition, riceParam, order, shift, coefficients, pDecodedSamples)) {
+                    return DRFLAC_FALSE;
+                }
+            } else
+#endif
             if (!drflac__decode_samples_with_residual__rice(bs, bitsPerSample, samplesInPartition, riceParam, order, shift, coefficients, pDecodedSamples)) {
                 return DRFLAC_FALSE;
             }
@@ -7560,6 +7734,233 @@ drflac* drflac_open_memory_with_metadata(const void* data, size_t dataSize, drfl
     return pFlac;
 }
 
+static drflac_bool32 drflac__parse_frame_header(const drflac* pFlac, const drflac_uint8* pData, size_t dataSize, drflac_frame_header* pHeader)
+{
+    const drflac_uint32 sampleRateTable[12]  = {0, 88200, 176400, 192000, 8000, 16000, 22050, 24000, 32000, 44100, 48000, 96000};
+    const drflac_uint8 bitsPerSampleTable[8] = {0, 8, 12, (drflac_uint8)-1, 16, 20, 24, (drflac_uint8)-1};   /* -1 = reserved. */
+    drflac_uint8 blockSize;
+    drflac_uint8 sampleRate;
+    drflac_uint8 channelAssignment;
+    drflac_uint8 bitsPerSample;
+    drflac_uint64 number;
+    drflac_uint32 numberByteCount;
+    drflac_uint32 headerSize;
+    drflac_uint8 crc8;
+    drflac_uint32 i;
+
+    /* The fixed part plus the first byte of the coded number. */
+    if (dataSize < 5 || pData[0] != 0xFF || (pData[1] & 0xFE) != 0xF8) {
+        return DRFLAC_FALSE;
+    }
+
+    blockSize         = pData[2] >> 4;
+    sampleRate        = pData[2] & 0x0F;
+    channelAssignment = pData[3] >> 4;
+    bitsPerSample     = (pData[3] >> 1) & 0x07;
+    if (blockSize == 0 || sampleRate == 15 || channelAssignment > 10 || bitsPerSample == 3 || bitsPerSample == 7 || (pData[3] & 0x01) != 0) {
+        return DRFLAC_FALSE;
+    }
+
+    /* The frame or sample number, UTF-8 coded. */
+    if ((pData[4] & 0x80) == 0) {
+        numberByteCount = 1;
+        number = pData[4];
+    } else if ((pData[4] & 0xE0) == 0xC0) {
+        numberByteCount = 2;
+        number = pData[4] & 0x1F;
+    } else if ((pData[4] & 0xF0) == 0xE0) {
+        numberByteCount = 3;
+        number = pData[4] & 0x0F;
+    } else if ((pData[4] & 0xF8) == 0xF0) {
+        numberByteCount = 4;
+        number = pData[4] & 0x07;
+    } else if ((pData[4] & 0xFC) == 0xF8) {
+        numberByteCount = 5;
+        number = pData[4] & 0x03;
+    } else if ((pData[4] & 0xFE) == 0xFC) {
+        numberByteCount = 6;
+        number = pData[4] & 0x01;
+    } else if (pData[4] == 0xFE) {
+        numberByteCount = 7;
+        number = 0;
+    } else {
+        return DRFLAC_FALSE;
+    }
+
+    headerSize = 4 + numberByteCount;
+    if (blockSize == 6) {
+        headerSize += 1;
+    } else if (blockSize == 7) {
+        headerSize += 2;
+    }
+    if (sampleRate == 12) {
+        headerSize += 1;
+    } else if (sampleRate == 13 || sampleRate == 14) {
+        headerSize += 2;
+    }
+    if (dataSize < headerSize + 1) {
+        return DRFLAC_FALSE;
+    }
+
+    for (i = 1; i < numberByteCount; ++i) {
+        if ((pData[4 + i] & 0xC0) != 0x80) {
+            return DRFLAC_FALSE;
+        }
+        number = (number << 6) | (pData[4 + i] & 0x3F);
+    }
+
+    crc8 = 0;
+    for (i = 0; i < headerSize; ++i) {
+        crc8 = drflac_crc8_byte(crc8, pData[i]);
+    }
+    if (crc8 != pData[headerSize]) {
+        return DRFLAC_FALSE;
+    }
+
+    i = 4 + numberByteCount;
+    if (blockSize == 1) {
+        pHeader->blockSizeInPCMFrames = 192;
+    } else if (blockSize >= 2 && blockSize <= 5) {
+        pHeader->blockSizeInPCMFrames = 576 * (1 << (blockSize - 2));
+    } else if (blockSize == 6) {
+        pHeader->blockSizeInPCMFrames = (drflac_uint16)(pData[i] + 1);
+        i += 1;
+    } else if (blockSize == 7) {
+        pHeader->blockSizeInPCMFrames = (drflac_uint16)(((pData[i] << 8) | pData[i + 1]) + 1);
+        i += 2;
+    } else {
+        pHeader->blockSizeInPCMFrames = 256 * (1 << (blockSize - 8));
+    }
+
+    if (sampleRate <= 11) {
+        pHeader->sampleRate = sampleRateTable[sampleRate];
+    } else if (sampleRate == 12) {
+        pHeader->sampleRate = pData[i] * 1000;
+    } else if (sampleRate == 13) {
+        pHeader->sampleRate = (pData[i] << 8) | pData[i + 1];
+    } else {
+        pHeader->sampleRate = ((pData[i] << 8) | pData[i + 1]) * 10;
+    }
+
+    pHeader->channelAssignment = channelAssignment;
+    pHeader->bitsPerSample = bitsPerSampleTable[bitsPerSample];
+    if (pHeader->bitsPerSample == 0) {
+        pHeader->bitsPerSample = pFlac->bitsPerSample;
+    }
+    pHeader->crc8 = crc8;
+
+    if ((pData[1] & 0x01) != 0) {
+        pHeader->flacFrameNumber = 0;
+        pHeader->pcmFrameNumber  = number;
+    } else {
+        pHeader->flacFrameNumber = (drflac_uint32)number;
+        pHeader->pcmFrameNumber  = 0;
+    }
+
+    /* Anything that disagrees with the stream is audio data that happens to look like a header. */
+    if (drflac__get_channel_count_from_channel_assignment(channelAssignment) != pFlac->channels ||
+        pHeader->bitsPerSample != pFlac->bitsPerSample ||
+        (pHeader->sampleRate != 0 && pHeader->sampleRate != pFlac->sampleRate) ||
+        pHeader->blockSizeInPCMFrames > pFlac->maxBlockSizeInPCMFrames) {
+        return DRFLAC_FALSE;
+    }
+
+    return DRFLAC_TRUE;
+}
+
+size_t drflac_find_frame_header(const drflac* pFlac, const void* pData, size_t dataSize, drflac_frame_header* pHeader)
+{
+    const drflac_uint8* pBytes = (const drflac_uint8*)pData;
+    drflac_frame_header header;
+    size_t offset;
+
+    if (pFlac == NULL || pData == NULL) {
+        return dataSize;
+    }
+
+    for (offset = 0; offset + 1 < dataSize; ++offset) {
+        const drflac_uint8* pSync = (const drflac_uint8*)memchr(pBytes + offset, 0xFF, dataSize - offset - 1);
+        if (pSync == NULL) {
+            break;
+        }
+
+        offset = (size_t)(pSync - pBytes);
+        if (drflac__parse_frame_header(pFlac, pSync, dataSize - offset, &header)) {
+            if (pHeader != NULL) {
+                *pHeader = header;
+            }
+            return offset;
+        }
+    }
+
+    return dataSize;
+}
+
+drflac* drflac_open_frame_decoder(const drflac* pFlac, const drflac_allocation_callbacks* pAllocationCallbacks)
+{
+    drflac_uint32 wholeSIMDVectorCountPerChannel;
+    drflac_uint32 decodedSamplesAllocationSize;
+    drflac* pDecoder;
+
+    if (pFlac == NULL || pFlac->container != drflac_container_native) {
+        return NULL;
+    }
+
+    if (pAllocationCallbacks == NULL) {
+        pAllocationCallbacks = &pFlac->allocationCallbacks;
+    }
+
+    /* Room for the decoded samples of the largest frame, laid out the same way as in drflac_open_with_metadata_private(). */
+    wholeSIMDVectorCountPerChannel = (pFlac->maxBlockSizeInPCMFrames + (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(drflac_int32)) - 1) / (DRFLAC_MAX_SIMD_VECTOR_SIZE / sizeof(drflac_int32));
+    decodedSamplesAllocationSize = wholeSIMDVectorCountPerChannel * DRFLAC_MAX_SIMD_VECTOR_SIZE * pFlac->channels;
+
+    pDecoder = (drflac*)drflac__malloc_from_callbacks(sizeof(drflac) + decodedSamplesAllocationSize + DRFLAC_MAX_SIMD_VECTOR_SIZE, pAllocationCallbacks);
+    if (pDecoder == NULL) {
+        return NULL;
+    }
+
+    drflac_zero_memory(pDecoder, sizeof(*pDecoder));
+    pDecoder->allocationCallbacks     = *pAllocationCallbacks;
+    pDecoder->sampleRate              = pFlac->sampleRate;
+    pDecoder->channels                = pFlac->channels;
+    pDecoder->bitsPerSample           = pFlac->bitsPerSample;
+    pDecoder->maxBlockSizeInPCMFrames = pFlac->maxBlockSizeInPCMFrames;
+    pDecoder->totalPCMFrameCount      = pFlac->totalPCMFrameCount;
+    pDecoder->container               = drflac_container_native;
+    pDecoder->pDecodedSamples         = (drflac_int32*)drflac_align((size_t)pDecoder->pExtraData, DRFLAC_MAX_SIMD_VECTOR_SIZE);
+
+    /* Frames are read from memory, one at a time. See drflac_decode_frame_s16(). */
+    pDecoder->bs.onRead    = drflac__on_read_memory;
+    pDecoder->bs.onSeek    = drflac__on_seek_memory;
+    pDecoder->bs.pUserData = &pDecoder->memoryStream;
+    drflac__reset_cache(&pDecoder->bs);
+
+    return pDecoder;
+}
+
+drflac_uint32 drflac_decode_frame_s16(drflac* pDecoder, const void* pData, size_t dataSize, drflac_int16* pBufferOut)
+{
+    if (pDecoder == NULL || pData == NULL || pBufferOut == NULL || pDecoder->bs.onRead != drflac__on_read_memory) {
+        return 0;
+    }
+
+    pDecoder->memoryStream.data           = (const unsigned char*)pData;
+    pDecoder->memoryStream.dataSize       = dataSize;
+    pDecoder->memoryStream.currentReadPos = 0;
+    drflac__reset_cache(&pDecoder->bs);
+    drflac_zero_memory(&pDecoder->currentFLACFrame, sizeof(pDecoder->currentFLACFrame));
+
+    if (!drflac__read_next_flac_frame_header(&pDecoder->bs, pDecoder->bitsPerSample, &pDecoder->currentFLACFrame.header)) {
+        return 0;
+    }
+    if (drflac__decode_flac_frame(pDecoder) != DRFLAC_SUCCESS) {
+        return 0;
+    }
+
+    /* The frame is loaded and fully read here, so this never goes on to the memory stream for another one. */
+    return (drflac_uint32)drflac_read_pcm_frames_s16(pDecoder, pDecoder->currentFLACFrame.header.blockSizeInPCMFrames, pBufferOut);
+}
+
 
 
 drflac* drflac_open(drflac_read_proc onRead, drflac_seek_proc onSeek, void* pUserData, const drflac_allocation_callbacks* pAllocationCallbacks)
@@ -9267,6 +9668,67 @@ static DRFLAC_INLINE void drflac_read_pcm_frames_s16__decode_independent_stereo(
     }
 }
 
+#if defined(DRFLAC_SCALAR_32_S16_STEREO)
+/*
+16-bit stereo straight to interleaved s16 with the channel decorrelation done in the same pass. The samples already fit in 16
+bits, so there's no shifting up and back down, and the loop counts in 32 bits since a FLAC frame is at most 65535 PCM frames.
+Gives the same output as the generic scalar paths.
+*/
+static void drflac_read_pcm_frames_s16__decode_stereo_16(drflac* pFlac, drflac_uint32 frameCount, const drflac_int32* pInputSamples0, const drflac_int32* pInputSamples1, drflac_int16* pOutputSamples)
+{
+    drflac_int32 shift0 = pFlac->currentFLACFrame.subframes[0].wastedBitsPerSample;
+    drflac_int32 shift1 = pFlac->currentFLACFrame.subframes[1].wastedBitsPerSample;
+    drflac_uint32 i;
+
+    switch (pFlac->currentFLACFrame.header.channelAssignment)
+    {
+        case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE:
+        {
+            for (i = 0; i < frameCount; ++i) {
+                drflac_int32 left = pInputSamples0[i] << shift0;
+                drflac_int32 side = pInputSamples1[i] << shift1;
+                pOutputSamples[0] = (drflac_int16)left;
+                pOutputSamples[1] = (drflac_int16)(left - side);
+                pOutputSamples += 2;
+            }
+        } break;
+
+        case DRFLAC_CHANNEL_ASSIGNMENT_RIGHT_SIDE:
+        {
+            for (i = 0; i < frameCount; ++i) {
+                drflac_int32 side  = pInputSamples0[i] << shift0;
+                drflac_int32 right = pInputSamples1[i] << shift1;
+                pOutputSamples[0] = (drflac_int16)(side + right);
+                pOutputSamples[1] = (drflac_int16)right;
+                pOutputSamples += 2;
+            }
+        } break;
+
+        case DRFLAC_CHANNEL_ASSIGNMENT_MID_SIDE:
+        {
+            for (i = 0; i < frameCount; ++i) {
+                drflac_int32 mid  = pInputSamples0[i] << shift0;
+                drflac_int32 side = pInputSamples1[i] << shift1;
+                mid = (drflac_int32)(((drflac_uint32)mid) << 1) | (side & 0x01);
+                pOutputSamples[0] = (drflac_int16)((mid + side) >> 1);
+                pOutputSamples[1] = (drflac_int16)((mid - side) >> 1);
+                pOutputSamples += 2;
+            }
+        } break;
+
+        case DRFLAC_CHANNEL_ASSIGNMENT_INDEPENDENT:
+        default:
+        {
+            for (i = 0; i < frameCount; ++i) {
+                pOutputSamples[0] = (drflac_int16)(pInputSamples0[i] << shift0);
+                pOutputSamples[1] = (drflac_int16)(pInputSamples1[i] << shift1);
+                pOutputSamples += 2;
+            }
+        } break;
+    }
+}
+#endif
+
 drflac_uint64 drflac_read_pcm_frames_s16(drflac* pFlac, drflac_uint64 framesToRead, drflac_int16* pBufferOut)
 {
     drflac_uint64 framesRead;
@@ -9302,6 +9764,11 @@ drflac_uint64 drflac_read_pcm_frames_s16(drflac* pFlac, drflac_uint64 framesToRe
                 const drflac_int32* pDecodedSamples0 = pFlac->currentFLACFrame.subframes[0].pSamplesS32 + iFirstPCMFrame;
                 const drflac_int32* pDecodedSamples1 = pFlac->currentFLACFrame.subframes[1].pSamplesS32 + iFirstPCMFrame;
 
+#if defined(DRFLAC_SCALAR_32_S16_STEREO)
+                if (pFlac->bitsPerSample == 16) {
+                    drflac_read_pcm_frames_s16__decode_stereo_16(pFlac, (drflac_uint32)frameCountThisIteration, pDecodedSamples0, pDecodedSamples1, pBufferOut);
+                } else
+#endif
                 switch (pFlac->currentFLACFrame.header.channelAssignment)
                 {
                     case DRFLAC_CHANNEL_ASSIGNMENT_LEFT_SIDE:
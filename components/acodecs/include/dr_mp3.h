@@ -55,6 +55,11 @@ OPTIONS
 
 #define DR_MP3_NO_SIMD
   Disable SIMD optimizations.
+
+#define DR_MP3_FIXED_POINT
+  Run the hybrid filterbank and polyphase synthesis in 32-bit fixed point and produce 16-bit samples straight from the
+  integer accumulators. Huffman decoding and dequantization stay in floating point. Meant for CPUs without a fast FPU.
+  Cannot be combined with DR_MP3_FLOAT_OUTPUT.
 */
 
 #ifndef dr_mp3_h
@@ -115,11 +120,25 @@ typedef struct
 
 typedef struct
 {
+#ifdef DR_MP3_FIXED_POINT
+    drmp3_int32 mdct_overlap[2][9*32], qmf_state[15*2*32];
+#else
     float mdct_overlap[2][9*32], qmf_state[15*2*32];
+#endif
     int reserv, free_format_bytes;
+    int flags;
     unsigned char header[4], reserv_buf[511];
 } drmp3dec;
 
+/*
+Low power decode flags for drmp3dec.flags. These are not reset by drmp3dec_init(), so set them once before decoding.
+DRMP3_DECODE_MONO downmixes stereo streams before synthesis and outputs a single channel. DRMP3_DECODE_HALF_RATE
+drops the upper 16 subbands and outputs at half the stream's sample rate. The frame info reports the resulting
+channel count and rate, and drmp3dec_decode_frame() returns the reduced number of samples per channel.
+*/
+#define DRMP3_DECODE_MONO       1
+#define DRMP3_DECODE_HALF_RATE  2
+
 /* Initializes a low level decoder. */
 void drmp3dec_init(drmp3dec *dec);
 
@@ -233,6 +252,7 @@ typedef struct
 {
     drmp3_uint32 outputChannels;
     drmp3_uint32 outputSampleRate;
+    drmp3_uint32 decodeFlags;   /* DRMP3_DECODE_* flags. DRMP3_DECODE_MONO is implied when outputChannels is 1. */
 } drmp3_config;
 
 typedef struct
@@ -254,6 +274,15 @@ typedef struct
     drmp3_src src;
     drmp3_seek_point* pSeekPoints;      /* NULL by default. Set with drmp3_bind_seek_table(). Memory is owned by the client. dr_mp3 will never attempt to free this pointer. */
     drmp3_uint32 seekPointCount;        /* The number of items in pSeekPoints. When set to 0 assumes to no seek table. Defaults to zero. */
+    drmp3_uint64 audioStartPos;         /* Byte position of the first MP3 frame holding audio, past any tags and the VBR header frame. */
+    drmp3_uint64 vbrHeaderPos;          /* Byte position of the frame holding the Xing/Info or VBRI header, which is skipped when decoding. */
+    drmp3_uint64 vbrPCMFrameCount;      /* PCM frames in the stream at the MP3 sample rate, from the VBR header. 0 if unknown. */
+    drmp3_uint32 vbrMP3FrameCount;      /* MP3 frames in the stream, not counting the VBR header frame. 0 if unknown. */
+    drmp3_uint32 vbrStreamBytes;        /* Bytes of MP3 frames from vbrHeaderPos on, which vbrTOC is relative to. */
+    drmp3_uint8 vbrTOC[100];            /* Byte position at each percent of the duration, in 1/256ths of vbrStreamBytes. */
+    drmp3_bool32 hasVBRHeader : 1;
+    drmp3_bool32 hasVBRTOC : 1;
+    drmp3_bool32 isFirstFrameChecked : 1;
     size_t dataSize;
     size_t dataCapacity;
     drmp3_uint8* pData;
@@ -325,29 +354,40 @@ drmp3_uint64 drmp3_read_pcm_frames_s16(drmp3* pMP3, drmp3_uint64 framesToRead, d
 Seeks to a specific frame.
 
 Note that this is _not_ an MP3 frame, but rather a PCM frame.
+
+Without a seek table, streams with a Xing/Info or VBRI header are seeked through the header's table of contents: the
+decoder jumps close to the target, resyncs on the next frame and decodes forward from there. This is quick but only as
+exact as the table, which has 100 entries. Other streams are decoded from the start or the current position.
 */
 drmp3_bool32 drmp3_seek_to_pcm_frame(drmp3* pMP3, drmp3_uint64 frameIndex);
 
 /*
 Calculates the total number of PCM frames in the MP3 stream. Cannot be used for infinite streams such as internet
-radio. Runs in linear time. Returns 0 on error.
+radio. Runs in constant time if the stream has a Xing/Info or VBRI header and linear time otherwise. Returns 0 on error.
 */
 drmp3_uint64 drmp3_get_pcm_frame_count(drmp3* pMP3);
 
 /*
 Calculates the total number of MP3 frames in the MP3 stream. Cannot be used for infinite streams such as internet
-radio. Runs in linear time. Returns 0 on error.
+radio. Runs in constant time if the stream has a Xing/Info or VBRI header and linear time otherwise. Returns 0 on error.
 */
 drmp3_uint64 drmp3_get_mp3_frame_count(drmp3* pMP3);
 
 /*
 Calculates the total number of MP3 and PCM frames in the MP3 stream. Cannot be used for infinite streams such as internet
-radio. Runs in linear time. Returns 0 on error.
+radio. Runs in constant time if the stream has a Xing/Info or VBRI header and linear time otherwise. Returns 0 on error.
 
 This is equivalent to calling drmp3_get_mp3_frame_count() and drmp3_get_pcm_frame_count() except that it's more efficient.
 */
 drmp3_bool32 drmp3_get_mp3_and_pcm_frame_count(drmp3* pMP3, drmp3_uint64* pMP3FrameCount, drmp3_uint64* pPCMFrameCount);
 
+/*
+Returns the number of PCM frames in the MP3 stream without reading any further into it. The count is exact if the stream
+has a Xing/Info or VBRI header. Otherwise it is estimated from streamSizeInBytes, the size of the whole stream including
+tags, and the bitrate of the first frame, which is right for CBR streams. Returns 0 if neither is known.
+*/
+drmp3_uint64 drmp3_get_pcm_frame_count_estimate(drmp3* pMP3, drmp3_uint64 streamSizeInBytes);
+
 /*
 Calculates the seekpoints based on PCM frames. This is slow.
 
@@ -456,6 +496,31 @@ void drmp3_free(void* p);
 #define DRMP3_MIN(a, b)           ((a) > (b) ? (b) : (a))
 #define DRMP3_MAX(a, b)           ((a) < (b) ? (b) : (a))
 
+#ifdef DR_MP3_FIXED_POINT
+#ifdef DR_MP3_FLOAT_OUTPUT
+#error "DR_MP3_FIXED_POINT only produces 16-bit output."
+#endif
+/*
+Fixed-point samples have DRMP3_FX_BITS fraction bits. Dequantized input is clamped to DRMP3_FX_MAX_INPUT, about 26 dB
+above a full scale signal, which keeps every stage of the filterbank within 32 bits. Constants have DRMP3_FX_CBITS
+fraction bits so that the largest (10.19 in the DCT) still fits. Products are 32x32->64 multiplies with a rounding shift.
+*/
+#ifndef DRMP3_FX_BITS
+#define DRMP3_FX_BITS                     22
+#endif
+#define DRMP3_FX_CBITS                    27
+#ifndef DRMP3_FX_MAX_INPUT
+#define DRMP3_FX_MAX_INPUT                8.0f
+#endif
+#define DRMP3_FX_C(c)                     ((drmp3_int32)((c)*(1 << DRMP3_FX_CBITS) + ((c) < 0 ? -0.5 : 0.5)))
+#define DRMP3_FX_PROD(x, c)               ((drmp3_int64)(x)*(c))
+#define DRMP3_FX_SHIFT(p)                 ((drmp3_int32)(((p) + (1 << (DRMP3_FX_CBITS - 1))) >> DRMP3_FX_CBITS))
+#define DRMP3_FX_MUL(x, c)                DRMP3_FX_SHIFT(DRMP3_FX_PROD(x, c))
+typedef drmp3_int32 drmp3d_fb_t;
+#else
+typedef float drmp3d_fb_t;
+#endif
+
 #if !defined(DR_MP3_NO_SIMD)
 
 #if !defined(DR_MP3_ONLY_SIMD) && (defined(_M_X64) || defined(_M_ARM64) || defined(__x86_64__) || defined(__aarch64__))
@@ -1361,6 +1426,7 @@ static void drmp3_L3_reorder(float *grbuf, float *scratch, const drmp3_uint8 *sf
     memcpy(grbuf, scratch, (dst - scratch)*sizeof(float));
 }
 
+#ifndef DR_MP3_FIXED_POINT
 static void drmp3_L3_antialias(float *grbuf, int nbands)
 {
     static const float g_aa[2][8] = {
@@ -1543,7 +1609,7 @@ static void drmp3_L3_change_sign(float *grbuf)
             grbuf[i] = -grbuf[i];
 }
 
-static void drmp3_L3_imdct_gr(float *grbuf, float *overlap, unsigned block_type, unsigned n_long_bands)
+static void drmp3_L3_imdct_gr(float *grbuf, float *overlap, unsigned block_type, unsigned n_long_bands, unsigned nbands)
 {
     static const float g_mdct_window[2][18] = {
         { 0.99904822f,0.99144486f,0.97629601f,0.95371695f,0.92387953f,0.88701083f,0.84339145f,0.79335334f,0.73727734f,0.04361938f,0.13052619f,0.21643961f,0.30070580f,0.38268343f,0.46174861f,0.53729961f,0.60876143f,0.67559021f },
@@ -1556,10 +1622,197 @@ static void drmp3_L3_imdct_gr(float *grbuf, float *overlap, unsigned block_type,
         overlap += 9*n_long_bands;
     }
     if (block_type == DRMP3_SHORT_BLOCK_TYPE)
-        drmp3_L3_imdct_short(grbuf, overlap, 32 - n_long_bands);
+        drmp3_L3_imdct_short(grbuf, overlap, nbands - n_long_bands);
+    else
+        drmp3_L3_imdct36(grbuf, overlap, g_mdct_window[block_type == DRMP3_STOP_BLOCK_TYPE], nbands - n_long_bands);
+}
+
+#else
+/* Converts dequantized float samples to fixed point in place, clamping anything far above full scale. */
+static void drmp3_fx_from_float(float *buf, int n)
+{
+    drmp3_int32 *dst = (drmp3_int32*)buf;
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        float x = buf[i];
+        x = DRMP3_MIN(x,  DRMP3_FX_MAX_INPUT);
+        x = DRMP3_MAX(x, -DRMP3_FX_MAX_INPUT);
+        dst[i] = (drmp3_int32)(x*(1 << DRMP3_FX_BITS));
+    }
+}
+
+static void drmp3_L3_antialias(drmp3d_fb_t *grbuf, int nbands)
+{
+    static const drmp3_int32 g_aa[2][8] = {
+        {DRMP3_FX_C(0.85749293),DRMP3_FX_C(0.88174200),DRMP3_FX_C(0.94962865),DRMP3_FX_C(0.98331459),DRMP3_FX_C(0.99551782),DRMP3_FX_C(0.99916056),DRMP3_FX_C(0.99989920),DRMP3_FX_C(0.99999316)},
+        {DRMP3_FX_C(0.51449576),DRMP3_FX_C(0.47173197),DRMP3_FX_C(0.31337745),DRMP3_FX_C(0.18191320),DRMP3_FX_C(0.09457419),DRMP3_FX_C(0.04096558),DRMP3_FX_C(0.01419856),DRMP3_FX_C(0.00369997)}
+    };
+
+    for (; nbands > 0; nbands--, grbuf += 18)
+    {
+        int i;
+        for (i = 0; i < 8; i++)
+        {
+            drmp3_int32 u = grbuf[18 + i];
+            drmp3_int32 d = grbuf[17 - i];
+            grbuf[18 + i] = DRMP3_FX_SHIFT(DRMP3_FX_PROD(u, g_aa[0][i]) - DRMP3_FX_PROD(d, g_aa[1][i]));
+            grbuf[17 - i] = DRMP3_FX_SHIFT(DRMP3_FX_PROD(u, g_aa[1][i]) + DRMP3_FX_PROD(d, g_aa[0][i]));
+        }
+    }
+}
+
+static void drmp3_L3_dct3_9(drmp3_int32 *y)
+{
+    drmp3_int32 s0, s1, s2, s3, s4, s5, s6, s7, s8, t0, t2, t4;
+
+    s0 = y[0]; s2 = y[2]; s4 = y[4]; s6 = y[6]; s8 = y[8];
+    t0 = s0 + (s6 >> 1);
+    s0 -= s6;
+    t4 = DRMP3_FX_MUL(s4 + s2, DRMP3_FX_C(0.93969262));
+    t2 = DRMP3_FX_MUL(s8 + s2, DRMP3_FX_C(0.76604444));
+    s6 = DRMP3_FX_MUL(s4 - s8, DRMP3_FX_C(0.17364818));
+    s4 += s8 - s2;
+
+    s2 = s0 - (s4 >> 1);
+    y[4] = s4 + s0;
+    s8 = t0 - t2 + s6;
+    s0 = t0 - t4 + t2;
+    s4 = t0 + t4 - s6;
+
+    s1 = y[1]; s3 = y[3]; s5 = y[5]; s7 = y[7];
+
+    s3 = DRMP3_FX_MUL(s3, DRMP3_FX_C(0.86602540));
+    t0 = DRMP3_FX_MUL(s5 + s1, DRMP3_FX_C(0.98480775));
+    t4 = DRMP3_FX_MUL(s5 - s7, DRMP3_FX_C(0.34202014));
+    t2 = DRMP3_FX_MUL(s1 + s7, DRMP3_FX_C(0.64278761));
+    s1 = DRMP3_FX_MUL(s1 - s5 - s7, DRMP3_FX_C(0.86602540));
+
+    s5 = t0 - s3 - t2;
+    s7 = t4 - s3 - t0;
+    s3 = t4 + s3 - t2;
+
+    y[0] = s4 - s7;
+    y[1] = s2 + s1;
+    y[2] = s0 - s3;
+    y[3] = s8 + s5;
+    y[5] = s8 - s5;
+    y[6] = s0 + s3;
+    y[7] = s2 - s1;
+    y[8] = s4 + s7;
+}
+
+static void drmp3_L3_imdct36(drmp3d_fb_t *grbuf, drmp3d_fb_t *overlap, const drmp3_int32 *window, int nbands)
+{
+    int i, j;
+    static const drmp3_int32 g_twid9[18] = {
+        DRMP3_FX_C(0.73727734),DRMP3_FX_C(0.79335334),DRMP3_FX_C(0.84339145),DRMP3_FX_C(0.88701083),DRMP3_FX_C(0.92387953),DRMP3_FX_C(0.95371695),DRMP3_FX_C(0.97629601),DRMP3_FX_C(0.99144486),DRMP3_FX_C(0.99904822),
+        DRMP3_FX_C(0.67559021),DRMP3_FX_C(0.60876143),DRMP3_FX_C(0.53729961),DRMP3_FX_C(0.46174861),DRMP3_FX_C(0.38268343),DRMP3_FX_C(0.30070580),DRMP3_FX_C(0.21643961),DRMP3_FX_C(0.13052619),DRMP3_FX_C(0.04361938)
+    };
+
+    for (j = 0; j < nbands; j++, grbuf += 18, overlap += 9)
+    {
+        drmp3_int32 co[9], si[9];
+        co[0] = -grbuf[0];
+        si[0] = grbuf[17];
+        for (i = 0; i < 4; i++)
+        {
+            si[8 - 2*i] =   grbuf[4*i + 1] - grbuf[4*i + 2];
+            co[1 + 2*i] =   grbuf[4*i + 1] + grbuf[4*i + 2];
+            si[7 - 2*i] =   grbuf[4*i + 4] - grbuf[4*i + 3];
+            co[2 + 2*i] = -(grbuf[4*i + 3] + grbuf[4*i + 4]);
+        }
+        drmp3_L3_dct3_9(co);
+        drmp3_L3_dct3_9(si);
+
+        si[1] = -si[1];
+        si[3] = -si[3];
+        si[5] = -si[5];
+        si[7] = -si[7];
+
+        for (i = 0; i < 9; i++)
+        {
+            drmp3_int32 ovl = overlap[i];
+            drmp3_int32 sum = DRMP3_FX_SHIFT(DRMP3_FX_PROD(co[i], g_twid9[9 + i]) + DRMP3_FX_PROD(si[i], g_twid9[0 + i]));
+            overlap[i]    = DRMP3_FX_SHIFT(DRMP3_FX_PROD(co[i], g_twid9[0 + i]) - DRMP3_FX_PROD(si[i], g_twid9[9 + i]));
+            grbuf[i]      = DRMP3_FX_SHIFT(DRMP3_FX_PROD(ovl, window[0 + i]) - DRMP3_FX_PROD(sum, window[9 + i]));
+            grbuf[17 - i] = DRMP3_FX_SHIFT(DRMP3_FX_PROD(ovl, window[9 + i]) + DRMP3_FX_PROD(sum, window[0 + i]));
+        }
+    }
+}
+
+static void drmp3_L3_idct3(drmp3_int32 x0, drmp3_int32 x1, drmp3_int32 x2, drmp3_int32 *dst)
+{
+    drmp3_int32 m1 = DRMP3_FX_MUL(x1, DRMP3_FX_C(0.86602540));
+    drmp3_int32 a1 = x0 - (x2 >> 1);
+    dst[1] = x0 + x2;
+    dst[0] = a1 + m1;
+    dst[2] = a1 - m1;
+}
+
+static void drmp3_L3_imdct12(drmp3_int32 *x, drmp3_int32 *dst, drmp3_int32 *overlap)
+{
+    static const drmp3_int32 g_twid3[6] = {
+        DRMP3_FX_C(0.79335334),DRMP3_FX_C(0.92387953),DRMP3_FX_C(0.99144486), DRMP3_FX_C(0.60876143),DRMP3_FX_C(0.38268343),DRMP3_FX_C(0.13052619)
+    };
+    drmp3_int32 co[3], si[3];
+    int i;
+
+    drmp3_L3_idct3(-x[0], x[6] + x[3], x[12] + x[9], co);
+    drmp3_L3_idct3(x[15], x[12] - x[9], x[6] - x[3], si);
+    si[1] = -si[1];
+
+    for (i = 0; i < 3; i++)
+    {
+        drmp3_int32 ovl = overlap[i];
+        drmp3_int32 sum = DRMP3_FX_SHIFT(DRMP3_FX_PROD(co[i], g_twid3[3 + i]) + DRMP3_FX_PROD(si[i], g_twid3[0 + i]));
+        overlap[i] = DRMP3_FX_SHIFT(DRMP3_FX_PROD(co[i], g_twid3[0 + i]) - DRMP3_FX_PROD(si[i], g_twid3[3 + i]));
+        dst[i]     = DRMP3_FX_SHIFT(DRMP3_FX_PROD(ovl, g_twid3[2 - i]) - DRMP3_FX_PROD(sum, g_twid3[5 - i]));
+        dst[5 - i] = DRMP3_FX_SHIFT(DRMP3_FX_PROD(ovl, g_twid3[5 - i]) + DRMP3_FX_PROD(sum, g_twid3[2 - i]));
+    }
+}
+
+static void drmp3_L3_imdct_short(drmp3d_fb_t *grbuf, drmp3d_fb_t *overlap, int nbands)
+{
+    for (;nbands > 0; nbands--, overlap += 9, grbuf += 18)
+    {
+        drmp3_int32 tmp[18];
+        memcpy(tmp, grbuf, sizeof(tmp));
+        memcpy(grbuf, overlap, 6*sizeof(drmp3_int32));
+        drmp3_L3_imdct12(tmp, grbuf + 6, overlap + 6);
+        drmp3_L3_imdct12(tmp + 1, grbuf + 12, overlap + 6);
+        drmp3_L3_imdct12(tmp + 2, overlap, overlap + 6);
+    }
+}
+
+static void drmp3_L3_change_sign(drmp3d_fb_t *grbuf)
+{
+    int b, i;
+    for (b = 0, grbuf += 18; b < 32; b += 2, grbuf += 36)
+        for (i = 1; i < 18; i += 2)
+            grbuf[i] = -grbuf[i];
+}
+
+static void drmp3_L3_imdct_gr(drmp3d_fb_t *grbuf, drmp3d_fb_t *overlap, unsigned block_type, unsigned n_long_bands, unsigned nbands)
+{
+    static const drmp3_int32 g_mdct_window[2][18] = {
+        { DRMP3_FX_C(0.99904822),DRMP3_FX_C(0.99144486),DRMP3_FX_C(0.97629601),DRMP3_FX_C(0.95371695),DRMP3_FX_C(0.92387953),DRMP3_FX_C(0.88701083),DRMP3_FX_C(0.84339145),DRMP3_FX_C(0.79335334),DRMP3_FX_C(0.73727734),
+          DRMP3_FX_C(0.04361938),DRMP3_FX_C(0.13052619),DRMP3_FX_C(0.21643961),DRMP3_FX_C(0.30070580),DRMP3_FX_C(0.38268343),DRMP3_FX_C(0.46174861),DRMP3_FX_C(0.53729961),DRMP3_FX_C(0.60876143),DRMP3_FX_C(0.67559021) },
+        { DRMP3_FX_C(1.0),DRMP3_FX_C(1.0),DRMP3_FX_C(1.0),DRMP3_FX_C(1.0),DRMP3_FX_C(1.0),DRMP3_FX_C(1.0),DRMP3_FX_C(0.99144486),DRMP3_FX_C(0.92387953),DRMP3_FX_C(0.79335334),
+          0,0,0,0,0,0,DRMP3_FX_C(0.13052619),DRMP3_FX_C(0.38268343),DRMP3_FX_C(0.60876143) }
+    };
+    if (n_long_bands)
+    {
+        drmp3_L3_imdct36(grbuf, overlap, g_mdct_window[0], n_long_bands);
+        grbuf += 18*n_long_bands;
+        overlap += 9*n_long_bands;
+    }
+    if (block_type == DRMP3_SHORT_BLOCK_TYPE)
+        drmp3_L3_imdct_short(grbuf, overlap, nbands - n_long_bands);
     else
-        drmp3_L3_imdct36(grbuf, overlap, g_mdct_window[block_type == DRMP3_STOP_BLOCK_TYPE], 32 - n_long_bands);
+        drmp3_L3_imdct36(grbuf, overlap, g_mdct_window[block_type == DRMP3_STOP_BLOCK_TYPE], nbands - n_long_bands);
 }
+#endif /* DR_MP3_FIXED_POINT */
 
 static void drmp3_L3_save_reservoir(drmp3dec *h, drmp3dec_scratch *s)
 {
@@ -1608,7 +1861,9 @@ static void drmp3_L3_decode(drmp3dec *h, drmp3dec_scratch *s, drmp3_L3_gr_info *
 
     for (ch = 0; ch < nch; ch++, gr_info++)
     {
-        int aa_bands = 31;
+        /* At half rate the upper 16 subbands are dropped before synthesis, so they need no IMDCT. */
+        int nbands = (h->flags & DRMP3_DECODE_HALF_RATE) ? 16 : 32;
+        int aa_bands = nbands == 32 ? 31 : nbands;
         int n_long_bands = (gr_info->mixed_block_flag ? 2 : 0) << (int)(DRMP3_HDR_GET_MY_SAMPLE_RATE(h->header) == 2);
 
         if (gr_info->n_short_sfb)
@@ -1617,12 +1872,16 @@ static void drmp3_L3_decode(drmp3dec *h, drmp3dec_scratch *s, drmp3_L3_gr_info *
             drmp3_L3_reorder(s->grbuf[ch] + n_long_bands*18, s->syn[0], gr_info->sfbtab + gr_info->n_long_sfb);
         }
 
-        drmp3_L3_antialias(s->grbuf[ch], aa_bands);
-        drmp3_L3_imdct_gr(s->grbuf[ch], h->mdct_overlap[ch], gr_info->block_type, n_long_bands);
-        drmp3_L3_change_sign(s->grbuf[ch]);
+#ifdef DR_MP3_FIXED_POINT
+        drmp3_fx_from_float(s->grbuf[ch], 576);
+#endif
+        drmp3_L3_antialias((drmp3d_fb_t*)s->grbuf[ch], aa_bands);
+        drmp3_L3_imdct_gr((drmp3d_fb_t*)s->grbuf[ch], h->mdct_overlap[ch], gr_info->block_type, n_long_bands, nbands);
+        drmp3_L3_change_sign((drmp3d_fb_t*)s->grbuf[ch]);
     }
 }
 
+#ifndef DR_MP3_FIXED_POINT
 static void drmp3d_DCT_II(float *grbuf, int n)
 {
     static const float g_sec[24] = {
@@ -1686,11 +1945,10 @@ static void drmp3d_DCT_II(float *grbuf, int n)
 #endif
             for (i = 0; i < 7; i++, y += 4*18)
             {
-                drmp3_f4 s = DRMP3_VADD(t[3][i], t[3][i + 1]);
                 DRMP3_VSAVE2(0, t[0][i]);
-                DRMP3_VSAVE2(1, DRMP3_VADD(t[2][i], s));
+                DRMP3_VSAVE2(1, DRMP3_VADD(DRMP3_VADD(t[2][i], t[3][i]), t[3][i + 1]));
                 DRMP3_VSAVE2(2, DRMP3_VADD(t[1][i], t[1][i + 1]));
-                DRMP3_VSAVE2(3, DRMP3_VADD(t[2][1 + i], s));
+                DRMP3_VSAVE2(3, DRMP3_VADD(DRMP3_VADD(t[2][1 + i], t[3][i]), t[3][i + 1]));
             }
             DRMP3_VSAVE2(0, t[0][7]);
             DRMP3_VSAVE2(1, DRMP3_VADD(t[2][7], t[3][7]));
@@ -1701,11 +1959,10 @@ static void drmp3d_DCT_II(float *grbuf, int n)
 #define DRMP3_VSAVE4(i, v) DRMP3_VSTORE(&y[i*18], v)
             for (i = 0; i < 7; i++, y += 4*18)
             {
-                drmp3_f4 s = DRMP3_VADD(t[3][i], t[3][i + 1]);
                 DRMP3_VSAVE4(0, t[0][i]);
-                DRMP3_VSAVE4(1, DRMP3_VADD(t[2][i], s));
+                DRMP3_VSAVE4(1, DRMP3_VADD(DRMP3_VADD(t[2][i], t[3][i]), t[3][i + 1]));
                 DRMP3_VSAVE4(2, DRMP3_VADD(t[1][i], t[1][i + 1]));
-                DRMP3_VSAVE4(3, DRMP3_VADD(t[2][1 + i], s));
+                DRMP3_VSAVE4(3, DRMP3_VADD(DRMP3_VADD(t[2][1 + i], t[3][i]), t[3][i + 1]));
             }
             DRMP3_VSAVE4(0, t[0][7]);
             DRMP3_VSAVE4(1, DRMP3_VADD(t[2][7], t[3][7]));
@@ -1799,7 +2056,7 @@ static float drmp3d_scale_pcm(float sample)
 }
 #endif
 
-static void drmp3d_synth_pair(drmp3d_sample_t *pcm, int nch, const float *z)
+static void drmp3d_synth_pair(drmp3d_sample_t *pcm, int step, const float *z)
 {
     float a;
     a  = (z[14*64] - z[    0]) * 29;
@@ -1821,14 +2078,17 @@ static void drmp3d_synth_pair(drmp3d_sample_t *pcm, int nch, const float *z)
     a += z[ 4*64] * -45;
     a += z[ 2*64] * 146;
     a += z[ 0*64] * -5;
-    pcm[16*nch] = drmp3d_scale_pcm(a);
+    pcm[step] = drmp3d_scale_pcm(a);
 }
 
-static void drmp3d_synth(float *xl, drmp3d_sample_t *dstl, int nch, float *lins)
+/*
+Output samples go to dstl[k*nch] for k < 64, or only the even samples to dstl[(k/2)*nch] when half is set. For mono output
+only the left lanes are computed.
+*/
+static void drmp3d_synth(float *xl, drmp3d_sample_t *dstl, int nch, int half, float *lins)
 {
-    int i;
+    int i, step = (16*nch) >> half;
     float *xr = xl + 576*(nch - 1);
-    drmp3d_sample_t *dstr = dstl + (nch - 1);
 
     static const float g_win[] = {
         -1,26,-31,208,218,401,-519,2063,2000,4788,-5517,7134,5959,35640,-39336,74992,
@@ -1860,19 +2120,25 @@ static void drmp3d_synth(float *xl, drmp3d_sample_t *dstl, int nch, float *lins)
     zlin[4*31 + 2] = xl[1];
     zlin[4*31 + 3] = xr[1];
 
-    drmp3d_synth_pair(dstr, nch, lins + 4*15 + 1);
-    drmp3d_synth_pair(dstr + 32*nch, nch, lins + 4*15 + 64 + 1);
-    drmp3d_synth_pair(dstl, nch, lins + 4*15);
-    drmp3d_synth_pair(dstl + 32*nch, nch, lins + 4*15 + 64);
+    if (nch == 2)
+    {
+        drmp3d_synth_pair(dstl + 1, step, lins + 4*15 + 1);
+        drmp3d_synth_pair(dstl + 1 + 2*step, step, lins + 4*15 + 64 + 1);
+    }
+    drmp3d_synth_pair(dstl, step, lins + 4*15);
+    drmp3d_synth_pair(dstl + 2*step, step, lins + 4*15 + 64);
 
 #if DRMP3_HAVE_SIMD
-    if (drmp3_have_simd()) for (i = 14; i >= 0; i--)
+    if (drmp3_have_simd()) for (i = 14 - half; i >= 0; i -= 1 + half)
     {
 #define DRMP3_VLOAD(k) drmp3_f4 w0 = DRMP3_VSET(*w++); drmp3_f4 w1 = DRMP3_VSET(*w++); drmp3_f4 vz = DRMP3_VLD(&zlin[4*i - 64*k]); drmp3_f4 vy = DRMP3_VLD(&zlin[4*i - 64*(15 - k)]);
 #define DRMP3_V0(k) { DRMP3_VLOAD(k) b =               DRMP3_VADD(DRMP3_VMUL(vz, w1), DRMP3_VMUL(vy, w0)) ; a =               DRMP3_VSUB(DRMP3_VMUL(vz, w0), DRMP3_VMUL(vy, w1));  }
 #define DRMP3_V1(k) { DRMP3_VLOAD(k) b = DRMP3_VADD(b, DRMP3_VADD(DRMP3_VMUL(vz, w1), DRMP3_VMUL(vy, w0))); a = DRMP3_VADD(a, DRMP3_VSUB(DRMP3_VMUL(vz, w0), DRMP3_VMUL(vy, w1))); }
 #define DRMP3_V2(k) { DRMP3_VLOAD(k) b = DRMP3_VADD(b, DRMP3_VADD(DRMP3_VMUL(vz, w1), DRMP3_VMUL(vy, w0))); a = DRMP3_VADD(a, DRMP3_VSUB(DRMP3_VMUL(vy, w1), DRMP3_VMUL(vz, w0))); }
         drmp3_f4 a, b;
+        drmp3d_sample_t *d0 = dstl + ((15 - i) >> half)*nch, *d1 = dstl + ((17 + i) >> half)*nch, *d2 = dstl + ((47 - i) >> half)*nch, *d3 = dstl + ((49 + i) >> half)*nch;
+
+        w = g_win + 16*(14 - i);
         zlin[4*i]     = xl[18*(31 - i)];
         zlin[4*i + 1] = xr[18*(31 - i)];
         zlin[4*i + 2] = xl[1 + 18*(31 - i)];
@@ -1887,55 +2153,58 @@ static void drmp3d_synth(float *xl, drmp3d_sample_t *dstl, int nch, float *lins)
         {
 #ifndef DR_MP3_FLOAT_OUTPUT
 #if DRMP3_HAVE_SSE
+            /* Rounded the same way as drmp3d_scale_pcm() so that the output matches the scalar code bit for bit. */
             static const drmp3_f4 g_max = { 32767.0f, 32767.0f, 32767.0f, 32767.0f };
             static const drmp3_f4 g_min = { -32768.0f, -32768.0f, -32768.0f, -32768.0f };
-            __m128i pcm8 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(a, g_max), g_min)),
-                                           _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(b, g_max), g_min)));
-            dstr[(15 - i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 1);
-            dstr[(17 + i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 5);
-            dstl[(15 - i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 0);
-            dstl[(17 + i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 4);
-            dstr[(47 - i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 3);
-            dstr[(49 + i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 7);
-            dstl[(47 - i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 2);
-            dstl[(49 + i)*nch] = (drmp3_int16)_mm_extract_epi16(pcm8, 6);
+            __m128i pcma = _mm_cvttps_epi32(DRMP3_VADD(_mm_max_ps(_mm_min_ps(a, g_max), g_min), DRMP3_VSET(0.5f)));
+            __m128i pcmb = _mm_cvttps_epi32(DRMP3_VADD(_mm_max_ps(_mm_min_ps(b, g_max), g_min), DRMP3_VSET(0.5f)));
+            __m128i pcm8 = _mm_packs_epi32(_mm_add_epi32(pcma, _mm_srai_epi32(pcma, 31)),
+                                           _mm_add_epi32(pcmb, _mm_srai_epi32(pcmb, 31)));
+            d0[nch - 1] = (drmp3_int16)_mm_extract_epi16(pcm8, 1);
+            d1[nch - 1] = (drmp3_int16)_mm_extract_epi16(pcm8, 5);
+            d0[0] = (drmp3_int16)_mm_extract_epi16(pcm8, 0);
+            d1[0] = (drmp3_int16)_mm_extract_epi16(pcm8, 4);
+            d2[nch - 1] = (drmp3_int16)_mm_extract_epi16(pcm8, 3);
+            d3[nch - 1] = (drmp3_int16)_mm_extract_epi16(pcm8, 7);
+            d2[0] = (drmp3_int16)_mm_extract_epi16(pcm8, 2);
+            d3[0] = (drmp3_int16)_mm_extract_epi16(pcm8, 6);
 #else
             int16x4_t pcma, pcmb;
             a = DRMP3_VADD(a, DRMP3_VSET(0.5f));
             b = DRMP3_VADD(b, DRMP3_VSET(0.5f));
             pcma = vqmovn_s32(vqaddq_s32(vcvtq_s32_f32(a), vreinterpretq_s32_u32(vcltq_f32(a, DRMP3_VSET(0)))));
             pcmb = vqmovn_s32(vqaddq_s32(vcvtq_s32_f32(b), vreinterpretq_s32_u32(vcltq_f32(b, DRMP3_VSET(0)))));
-            vst1_lane_s16(dstr + (15 - i)*nch, pcma, 1);
-            vst1_lane_s16(dstr + (17 + i)*nch, pcmb, 1);
-            vst1_lane_s16(dstl + (15 - i)*nch, pcma, 0);
-            vst1_lane_s16(dstl + (17 + i)*nch, pcmb, 0);
-            vst1_lane_s16(dstr + (47 - i)*nch, pcma, 3);
-            vst1_lane_s16(dstr + (49 + i)*nch, pcmb, 3);
-            vst1_lane_s16(dstl + (47 - i)*nch, pcma, 2);
-            vst1_lane_s16(dstl + (49 + i)*nch, pcmb, 2);
+            vst1_lane_s16(d0 + nch - 1, pcma, 1);
+            vst1_lane_s16(d1 + nch - 1, pcmb, 1);
+            vst1_lane_s16(d0, pcma, 0);
+            vst1_lane_s16(d1, pcmb, 0);
+            vst1_lane_s16(d2 + nch - 1, pcma, 3);
+            vst1_lane_s16(d3 + nch - 1, pcmb, 3);
+            vst1_lane_s16(d2, pcma, 2);
+            vst1_lane_s16(d3, pcmb, 2);
 #endif
 #else
             static const drmp3_f4 g_scale = { 1.0f/32768.0f, 1.0f/32768.0f, 1.0f/32768.0f, 1.0f/32768.0f };
             a = DRMP3_VMUL(a, g_scale);
             b = DRMP3_VMUL(b, g_scale);
 #if DRMP3_HAVE_SSE
-            _mm_store_ss(dstr + (15 - i)*nch, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
-            _mm_store_ss(dstr + (17 + i)*nch, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1)));
-            _mm_store_ss(dstl + (15 - i)*nch, _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)));
-            _mm_store_ss(dstl + (17 + i)*nch, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
-            _mm_store_ss(dstr + (47 - i)*nch, _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)));
-            _mm_store_ss(dstr + (49 + i)*nch, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3)));
-            _mm_store_ss(dstl + (47 - i)*nch, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)));
-            _mm_store_ss(dstl + (49 + i)*nch, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_store_ss(d0 + nch - 1, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_store_ss(d1 + nch - 1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_store_ss(d0, _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_store_ss(d1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_store_ss(d2 + nch - 1, _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)));
+            _mm_store_ss(d3 + nch - 1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3)));
+            _mm_store_ss(d2, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_store_ss(d3, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2)));
 #else
-            vst1q_lane_f32(dstr + (15 - i)*nch, a, 1);
-            vst1q_lane_f32(dstr + (17 + i)*nch, b, 1);
-            vst1q_lane_f32(dstl + (15 - i)*nch, a, 0);
-            vst1q_lane_f32(dstl + (17 + i)*nch, b, 0);
-            vst1q_lane_f32(dstr + (47 - i)*nch, a, 3);
-            vst1q_lane_f32(dstr + (49 + i)*nch, b, 3);
-            vst1q_lane_f32(dstl + (47 - i)*nch, a, 2);
-            vst1q_lane_f32(dstl + (49 + i)*nch, b, 2);
+            vst1q_lane_f32(d0 + nch - 1, a, 1);
+            vst1q_lane_f32(d1 + nch - 1, b, 1);
+            vst1q_lane_f32(d0, a, 0);
+            vst1q_lane_f32(d1, b, 0);
+            vst1q_lane_f32(d2 + nch - 1, a, 3);
+            vst1q_lane_f32(d3 + nch - 1, b, 3);
+            vst1q_lane_f32(d2, a, 2);
+            vst1q_lane_f32(d3, b, 2);
 #endif
 #endif /* DR_MP3_FLOAT_OUTPUT */
         }
@@ -1944,14 +2213,16 @@ static void drmp3d_synth(float *xl, drmp3d_sample_t *dstl, int nch, float *lins)
 #ifdef DR_MP3_ONLY_SIMD
     {}
 #else
-    for (i = 14; i >= 0; i--)
+    for (i = 14 - half; i >= 0; i -= 1 + half)
     {
 #define DRMP3_LOAD(k) float w0 = *w++; float w1 = *w++; float *vz = &zlin[4*i - k*64]; float *vy = &zlin[4*i - (15 - k)*64];
-#define DRMP3_S0(k) { int j; DRMP3_LOAD(k); for (j = 0; j < 4; j++) b[j]  = vz[j]*w1 + vy[j]*w0, a[j]  = vz[j]*w0 - vy[j]*w1; }
-#define DRMP3_S1(k) { int j; DRMP3_LOAD(k); for (j = 0; j < 4; j++) b[j] += vz[j]*w1 + vy[j]*w0, a[j] += vz[j]*w0 - vy[j]*w1; }
-#define DRMP3_S2(k) { int j; DRMP3_LOAD(k); for (j = 0; j < 4; j++) b[j] += vz[j]*w1 + vy[j]*w0, a[j] += vy[j]*w1 - vz[j]*w0; }
+#define DRMP3_S0(k) { int j; DRMP3_LOAD(k); for (j = 0; j < 4; j += 3 - nch) b[j]  = vz[j]*w1 + vy[j]*w0, a[j]  = vz[j]*w0 - vy[j]*w1; }
+#define DRMP3_S1(k) { int j; DRMP3_LOAD(k); for (j = 0; j < 4; j += 3 - nch) b[j] += vz[j]*w1 + vy[j]*w0, a[j] += vz[j]*w0 - vy[j]*w1; }
+#define DRMP3_S2(k) { int j; DRMP3_LOAD(k); for (j = 0; j < 4; j += 3 - nch) b[j] += vz[j]*w1 + vy[j]*w0, a[j] += vy[j]*w1 - vz[j]*w0; }
         float a[4], b[4];
+        drmp3d_sample_t *d0 = dstl + ((15 - i) >> half)*nch, *d1 = dstl + ((17 + i) >> half)*nch, *d2 = dstl + ((47 - i) >> half)*nch, *d3 = dstl + ((49 + i) >> half)*nch;
 
+        w = g_win + 16*(14 - i);
         zlin[4*i]     = xl[18*(31 - i)];
         zlin[4*i + 1] = xr[18*(31 - i)];
         zlin[4*i + 2] = xl[1 + 18*(31 - i)];
@@ -1963,31 +2234,236 @@ static void drmp3d_synth(float *xl, drmp3d_sample_t *dstl, int nch, float *lins)
 
         DRMP3_S0(0) DRMP3_S2(1) DRMP3_S1(2) DRMP3_S2(3) DRMP3_S1(4) DRMP3_S2(5) DRMP3_S1(6) DRMP3_S2(7)
 
-        dstr[(15 - i)*nch] = drmp3d_scale_pcm(a[1]);
-        dstr[(17 + i)*nch] = drmp3d_scale_pcm(b[1]);
-        dstl[(15 - i)*nch] = drmp3d_scale_pcm(a[0]);
-        dstl[(17 + i)*nch] = drmp3d_scale_pcm(b[0]);
-        dstr[(47 - i)*nch] = drmp3d_scale_pcm(a[3]);
-        dstr[(49 + i)*nch] = drmp3d_scale_pcm(b[3]);
-        dstl[(47 - i)*nch] = drmp3d_scale_pcm(a[2]);
-        dstl[(49 + i)*nch] = drmp3d_scale_pcm(b[2]);
+        if (nch == 2)
+        {
+            d0[1] = drmp3d_scale_pcm(a[1]);
+            d1[1] = drmp3d_scale_pcm(b[1]);
+            d2[1] = drmp3d_scale_pcm(a[3]);
+            d3[1] = drmp3d_scale_pcm(b[3]);
+        }
+        d0[0] = drmp3d_scale_pcm(a[0]);
+        d1[0] = drmp3d_scale_pcm(b[0]);
+        d2[0] = drmp3d_scale_pcm(a[2]);
+        d3[0] = drmp3d_scale_pcm(b[2]);
     }
 #endif
 }
 
-static void drmp3d_synth_granule(float *qmf_state, float *grbuf, int nbands, int nch, drmp3d_sample_t *pcm, float *lins)
+#else
+static void drmp3d_DCT_II(drmp3d_fb_t *grbuf, int n)
+{
+    static const drmp3_int32 g_sec[24] = {
+        DRMP3_FX_C(10.19000816),DRMP3_FX_C(0.50060302),DRMP3_FX_C(0.50241929),DRMP3_FX_C(3.40760851),DRMP3_FX_C(0.50547093),DRMP3_FX_C(0.52249861),DRMP3_FX_C(2.05778098),DRMP3_FX_C(0.51544732),
+        DRMP3_FX_C(0.56694406),DRMP3_FX_C(1.48416460),DRMP3_FX_C(0.53104258),DRMP3_FX_C(0.64682180),DRMP3_FX_C(1.16943991),DRMP3_FX_C(0.55310392),DRMP3_FX_C(0.78815460),DRMP3_FX_C(0.97256821),
+        DRMP3_FX_C(0.58293498),DRMP3_FX_C(1.06067765),DRMP3_FX_C(0.83934963),DRMP3_FX_C(0.62250412),DRMP3_FX_C(1.72244716),DRMP3_FX_C(0.74453628),DRMP3_FX_C(0.67480832),DRMP3_FX_C(5.10114861)
+    };
+    int i, k;
+    for (k = 0; k < n; k++)
+    {
+        drmp3_int32 t[4][8], *x, *y = grbuf + k;
+
+        for (x = t[0], i = 0; i < 8; i++, x++)
+        {
+            drmp3_int32 x0 = y[i*18];
+            drmp3_int32 x1 = y[(15 - i)*18];
+            drmp3_int32 x2 = y[(16 + i)*18];
+            drmp3_int32 x3 = y[(31 - i)*18];
+            drmp3_int32 t0 = x0 + x3;
+            drmp3_int32 t1 = x1 + x2;
+            drmp3_int32 t2 = DRMP3_FX_MUL(x1 - x2, g_sec[3*i + 0]);
+            drmp3_int32 t3 = DRMP3_FX_MUL(x0 - x3, g_sec[3*i + 1]);
+            x[0] = t0 + t1;
+            x[8] = DRMP3_FX_MUL(t0 - t1, g_sec[3*i + 2]);
+            x[16] = t3 + t2;
+            x[24] = DRMP3_FX_MUL(t3 - t2, g_sec[3*i + 2]);
+        }
+        for (x = t[0], i = 0; i < 4; i++, x += 8)
+        {
+            drmp3_int32 x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3], x4 = x[4], x5 = x[5], x6 = x[6], x7 = x[7], xt;
+            xt = x0 - x7; x0 += x7;
+            x7 = x1 - x6; x1 += x6;
+            x6 = x2 - x5; x2 += x5;
+            x5 = x3 - x4; x3 += x4;
+            x4 = x0 - x3; x0 += x3;
+            x3 = x1 - x2; x1 += x2;
+            x[0] = x0 + x1;
+            x[4] = DRMP3_FX_MUL(x0 - x1, DRMP3_FX_C(0.70710677));
+            x5 =  x5 + x6;
+            x6 = DRMP3_FX_MUL(x6 + x7, DRMP3_FX_C(0.70710677));
+            x7 =  x7 + xt;
+            x3 = DRMP3_FX_MUL(x3 + x4, DRMP3_FX_C(0.70710677));
+            x5 -= DRMP3_FX_MUL(x7, DRMP3_FX_C(0.198912367));  /* rotate by PI/8 */
+            x7 += DRMP3_FX_MUL(x5, DRMP3_FX_C(0.382683432));
+            x5 -= DRMP3_FX_MUL(x7, DRMP3_FX_C(0.198912367));
+            x0 = xt - x6; xt += x6;
+            x[1] = DRMP3_FX_MUL(xt + x7, DRMP3_FX_C(0.50979561));
+            x[2] = DRMP3_FX_MUL(x4 + x3, DRMP3_FX_C(0.54119611));
+            x[3] = DRMP3_FX_MUL(x0 - x5, DRMP3_FX_C(0.60134488));
+            x[5] = DRMP3_FX_MUL(x0 + x5, DRMP3_FX_C(0.89997619));
+            x[6] = DRMP3_FX_MUL(x4 - x3, DRMP3_FX_C(1.30656302));
+            x[7] = DRMP3_FX_MUL(xt - x7, DRMP3_FX_C(2.56291556));
+        }
+        for (i = 0; i < 7; i++, y += 4*18)
+        {
+            y[0*18] = t[0][i];
+            y[1*18] = t[2][i] + t[3][i] + t[3][i + 1];
+            y[2*18] = t[1][i] + t[1][i + 1];
+            y[3*18] = t[2][i + 1] + t[3][i] + t[3][i + 1];
+        }
+        y[0*18] = t[0][7];
+        y[1*18] = t[2][7] + t[3][7];
+        y[2*18] = t[1][7];
+        y[3*18] = t[3][7];
+    }
+}
+
+typedef drmp3_int16 drmp3d_sample_t;
+
+/* The window taps are integers, so the accumulator holds the output sample with DRMP3_FX_BITS fraction bits. */
+static drmp3_int16 drmp3d_scale_pcm(drmp3_int64 a)
+{
+    a = (a + (1 << (DRMP3_FX_BITS - 1))) >> DRMP3_FX_BITS;
+    if (a >  32767) return (drmp3_int16) 32767;
+    if (a < -32768) return (drmp3_int16)-32768;
+    return (drmp3_int16)a;
+}
+
+static void drmp3d_synth_pair(drmp3d_sample_t *pcm, int step, const drmp3_int32 *z)
+{
+    drmp3_int64 a;
+    a  = (drmp3_int64)(z[14*64] - z[    0]) * 29;
+    a += (drmp3_int64)(z[ 1*64] + z[13*64]) * 213;
+    a += (drmp3_int64)(z[12*64] - z[ 2*64]) * 459;
+    a += (drmp3_int64)(z[ 3*64] + z[11*64]) * 2037;
+    a += (drmp3_int64)(z[10*64] - z[ 4*64]) * 5153;
+    a += (drmp3_int64)(z[ 5*64] + z[ 9*64]) * 6574;
+    a += (drmp3_int64)(z[ 8*64] - z[ 6*64]) * 37489;
+    a += (drmp3_int64) z[ 7*64]             * 75038;
+    pcm[0] = drmp3d_scale_pcm(a);
+
+    z += 2;
+    a  = (drmp3_int64)z[14*64] * 104;
+    a += (drmp3_int64)z[12*64] * 1567;
+    a += (drmp3_int64)z[10*64] * 9727;
+    a += (drmp3_int64)z[ 8*64] * 64019;
+    a += (drmp3_int64)z[ 6*64] * -9975;
+    a += (drmp3_int64)z[ 4*64] * -45;
+    a += (drmp3_int64)z[ 2*64] * 146;
+    a += (drmp3_int64)z[ 0*64] * -5;
+    pcm[step] = drmp3d_scale_pcm(a);
+}
+
+static void drmp3d_synth(drmp3d_fb_t *xl, drmp3d_sample_t *dstl, int nch, int half, drmp3d_fb_t *lins)
+{
+    int i, step = (16*nch) >> half;
+    drmp3_int32 *xr = xl + 576*(nch - 1);
+
+    static const drmp3_int32 g_win[] = {
+        -1,26,-31,208,218,401,-519,2063,2000,4788,-5517,7134,5959,35640,-39336,74992,
+        -1,24,-35,202,222,347,-581,2080,1952,4425,-5879,7640,5288,33791,-41176,74856,
+        -1,21,-38,196,225,294,-645,2087,1893,4063,-6237,8092,4561,31947,-43006,74630,
+        -1,19,-41,190,227,244,-711,2085,1822,3705,-6589,8492,3776,30112,-44821,74313,
+        -1,17,-45,183,228,197,-779,2075,1739,3351,-6935,8840,2935,28289,-46617,73908,
+        -1,16,-49,176,228,153,-848,2057,1644,3004,-7271,9139,2037,26482,-48390,73415,
+        -2,14,-53,169,227,111,-919,2032,1535,2663,-7597,9389,1082,24694,-50137,72835,
+        -2,13,-58,161,224,72,-991,2001,1414,2330,-7910,9592,70,22929,-51853,72169,
+        -2,11,-63,154,221,36,-1064,1962,1280,2006,-8209,9750,-998,21189,-53534,71420,
+        -2,10,-68,147,215,2,-1137,1919,1131,1692,-8491,9863,-2122,19478,-55178,70590,
+        -3,9,-73,139,208,-29,-1210,1870,970,1388,-8755,9935,-3300,17799,-56778,69679,
+        -3,8,-79,132,200,-57,-1283,1817,794,1095,-8998,9966,-4533,16155,-58333,68692,
+        -4,7,-85,125,189,-83,-1356,1759,605,814,-9219,9959,-5818,14548,-59838,67629,
+        -4,7,-91,117,177,-106,-1428,1698,402,545,-9416,9916,-7154,12980,-61289,66494,
+        -5,6,-97,111,163,-127,-1498,1634,185,288,-9585,9838,-8540,11455,-62684,65290
+    };
+    drmp3_int32 *zlin = lins + 15*64;
+    const drmp3_int32 *w = g_win;
+
+    zlin[4*15]     = xl[18*16];
+    zlin[4*15 + 1] = xr[18*16];
+    zlin[4*15 + 2] = xl[0];
+    zlin[4*15 + 3] = xr[0];
+
+    zlin[4*31]     = xl[1 + 18*16];
+    zlin[4*31 + 1] = xr[1 + 18*16];
+    zlin[4*31 + 2] = xl[1];
+    zlin[4*31 + 3] = xr[1];
+
+    if (nch == 2)
+    {
+        drmp3d_synth_pair(dstl + 1, step, lins + 4*15 + 1);
+        drmp3d_synth_pair(dstl + 1 + 2*step, step, lins + 4*15 + 64 + 1);
+    }
+    drmp3d_synth_pair(dstl, step, lins + 4*15);
+    drmp3d_synth_pair(dstl + 2*step, step, lins + 4*15 + 64);
+
+    for (i = 14 - half; i >= 0; i -= 1 + half)
+    {
+#define DRMP3_FX_LOAD(k) drmp3_int32 w0 = *w++; drmp3_int32 w1 = *w++; drmp3_int32 *vz = &zlin[4*i - k*64]; drmp3_int32 *vy = &zlin[4*i - (15 - k)*64];
+#define DRMP3_FX_S0(k) { int j; DRMP3_FX_LOAD(k); for (j = 0; j < 4; j += 3 - nch) b[j]  = (drmp3_int64)vz[j]*w1 + (drmp3_int64)vy[j]*w0, a[j]  = (drmp3_int64)vz[j]*w0 - (drmp3_int64)vy[j]*w1; }
+#define DRMP3_FX_S1(k) { int j; DRMP3_FX_LOAD(k); for (j = 0; j < 4; j += 3 - nch) b[j] += (drmp3_int64)vz[j]*w1 + (drmp3_int64)vy[j]*w0, a[j] += (drmp3_int64)vz[j]*w0 - (drmp3_int64)vy[j]*w1; }
+#define DRMP3_FX_S2(k) { int j; DRMP3_FX_LOAD(k); for (j = 0; j < 4; j += 3 - nch) b[j] += (drmp3_int64)vz[j]*w1 + (drmp3_int64)vy[j]*w0, a[j] += (drmp3_int64)vy[j]*w1 - (drmp3_int64)vz[j]*w0; }
+        drmp3_int64 a[4], b[4];
+        drmp3d_sample_t *d0 = dstl + ((15 - i) >> half)*nch, *d1 = dstl + ((17 + i) >> half)*nch, *d2 = dstl + ((47 - i) >> half)*nch, *d3 = dstl + ((49 + i) >> half)*nch;
+
+        w = g_win + 16*(14 - i);
+        zlin[4*i]     = xl[18*(31 - i)];
+        zlin[4*i + 1] = xr[18*(31 - i)];
+        zlin[4*i + 2] = xl[1 + 18*(31 - i)];
+        zlin[4*i + 3] = xr[1 + 18*(31 - i)];
+        zlin[4*(i + 16)]   = xl[1 + 18*(1 + i)];
+        zlin[4*(i + 16) + 1] = xr[1 + 18*(1 + i)];
+        zlin[4*(i - 16) + 2] = xl[18*(1 + i)];
+        zlin[4*(i - 16) + 3] = xr[18*(1 + i)];
+
+        DRMP3_FX_S0(0) DRMP3_FX_S2(1) DRMP3_FX_S1(2) DRMP3_FX_S2(3) DRMP3_FX_S1(4) DRMP3_FX_S2(5) DRMP3_FX_S1(6) DRMP3_FX_S2(7)
+
+        if (nch == 2)
+        {
+            d0[1] = drmp3d_scale_pcm(a[1]);
+            d1[1] = drmp3d_scale_pcm(b[1]);
+            d2[1] = drmp3d_scale_pcm(a[3]);
+            d3[1] = drmp3d_scale_pcm(b[3]);
+        }
+        d0[0] = drmp3d_scale_pcm(a[0]);
+        d1[0] = drmp3d_scale_pcm(b[0]);
+        d2[0] = drmp3d_scale_pcm(a[2]);
+        d3[0] = drmp3d_scale_pcm(b[2]);
+    }
+}
+#endif /* DR_MP3_FIXED_POINT */
+
+/* Mixes the second channel of a granule into the first, for mono output from a stereo stream. */
+static void drmp3d_downmix(drmp3d_fb_t *grbuf, int n)
+{
+    int i;
+    for (i = 0; i < n; i++)
+    {
+#ifdef DR_MP3_FIXED_POINT
+        grbuf[i] = (grbuf[i] + grbuf[576 + i]) >> 1;
+#else
+        grbuf[i] = (grbuf[i] + grbuf[576 + i])*0.5f;
+#endif
+    }
+}
+
+static void drmp3d_synth_granule(drmp3d_fb_t *qmf_state, drmp3d_fb_t *grbuf, int nbands, int nch, int half, drmp3d_sample_t *pcm, drmp3d_fb_t *lins)
 {
     int i;
     for (i = 0; i < nch; i++)
     {
+        if (half)
+        {
+            /* Band limit to a quarter of the stream rate so that every other output sample can be dropped. */
+            memset(grbuf + 576*i + 16*18, 0, sizeof(drmp3d_fb_t)*16*18);
+        }
         drmp3d_DCT_II(grbuf + 576*i, nbands);
     }
 
-    memcpy(lins, qmf_state, sizeof(float)*15*64);
+    memcpy(lins, qmf_state, sizeof(drmp3d_fb_t)*15*64);
 
     for (i = 0; i < nbands; i += 2)
     {
-        drmp3d_synth(grbuf + i, pcm + 32*nch*i, nch, lins + i*64);
+        drmp3d_synth(grbuf + i, pcm + ((32*nch*i) >> half), nch, half, lins + i*64);
     }
 #ifndef DR_MP3_NONSTANDARD_BUT_LOGICAL
     if (nch == 1)
@@ -1999,7 +2475,7 @@ static void drmp3d_synth_granule(float *qmf_state, float *grbuf, int nbands, int
     } else
 #endif
     {
-        memcpy(qmf_state, lins + nbands*64, sizeof(float)*15*64);
+        memcpy(qmf_state, lins + nbands*64, sizeof(drmp3d_fb_t)*15*64);
     }
 }
 
@@ -2062,7 +2538,7 @@ void drmp3dec_init(drmp3dec *dec)
 
 int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes, void *pcm, drmp3dec_frame_info *info)
 {
-    int i = 0, igr, frame_size = 0, success = 1;
+    int i = 0, igr, frame_size = 0, success = 1, nch, out_nch, half = (dec->flags & DRMP3_DECODE_HALF_RATE) ? 1 : 0;
     const drmp3_uint8 *hdr;
     drmp3_bs bs_frame[1];
     drmp3dec_scratch scratch;
@@ -2077,7 +2553,9 @@ int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes
     }
     if (!frame_size)
     {
+        int flags = dec->flags;
         memset(dec, 0, sizeof(drmp3dec));
+        dec->flags = flags;
         i = drmp3d_find_frame(mp3, mp3_bytes, &dec->free_format_bytes, &frame_size);
         if (!frame_size || i + frame_size > mp3_bytes)
         {
@@ -2089,8 +2567,10 @@ int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes
     hdr = mp3 + i;
     memcpy(dec->header, hdr, DRMP3_HDR_SIZE);
     info->frame_bytes = i + frame_size;
-    info->channels = DRMP3_HDR_IS_MONO(hdr) ? 1 : 2;
-    info->hz = drmp3_hdr_sample_rate_hz(hdr);
+    nch = DRMP3_HDR_IS_MONO(hdr) ? 1 : 2;
+    out_nch = (dec->flags & DRMP3_DECODE_MONO) ? 1 : nch;
+    info->channels = out_nch;
+    info->hz = drmp3_hdr_sample_rate_hz(hdr) >> half;
     info->layer = 4 - DRMP3_HDR_GET_LAYER(hdr);
     info->bitrate_kbps = drmp3_hdr_bitrate_kbps(hdr);
 
@@ -2111,11 +2591,15 @@ int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes
         success = drmp3_L3_restore_reservoir(dec, bs_frame, &scratch, main_data_begin);
         if (success && pcm != NULL)
         {
-            for (igr = 0; igr < (DRMP3_HDR_TEST_MPEG1(hdr) ? 2 : 1); igr++, pcm = DRMP3_OFFSET_PTR(pcm, sizeof(drmp3d_sample_t)*576*info->channels))
+            for (igr = 0; igr < (DRMP3_HDR_TEST_MPEG1(hdr) ? 2 : 1); igr++, pcm = DRMP3_OFFSET_PTR(pcm, sizeof(drmp3d_sample_t)*(576 >> half)*out_nch))
             {
                 memset(scratch.grbuf[0], 0, 576*2*sizeof(float));
-                drmp3_L3_decode(dec, &scratch, scratch.gr_info + igr*info->channels, info->channels);
-                drmp3d_synth_granule(dec->qmf_state, scratch.grbuf[0], 18, info->channels, (drmp3d_sample_t*)pcm, scratch.syn[0]);
+                drmp3_L3_decode(dec, &scratch, scratch.gr_info + igr*nch, nch);
+                if (out_nch < nch)
+                {
+                    drmp3d_downmix((drmp3d_fb_t*)scratch.grbuf[0], 576);
+                }
+                drmp3d_synth_granule(dec->qmf_state, (drmp3d_fb_t*)scratch.grbuf[0], 18, out_nch, half, (drmp3d_sample_t*)pcm, (drmp3d_fb_t*)scratch.syn[0]);
             }
         }
         drmp3_L3_save_reservoir(dec, &scratch);
@@ -2127,7 +2611,7 @@ int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes
         drmp3_L12_scale_info sci[1];
 
         if (pcm == NULL) {
-            return drmp3_hdr_frame_samples(hdr);
+            return drmp3_hdr_frame_samples(hdr) >> half;
         }
 
         drmp3_L12_read_scale_info(hdr, bs_frame, sci);
@@ -2139,9 +2623,16 @@ int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes
             {
                 i = 0;
                 drmp3_L12_apply_scf_384(sci, sci->scf + igr, scratch.grbuf[0]);
-                drmp3d_synth_granule(dec->qmf_state, scratch.grbuf[0], 12, info->channels, (drmp3d_sample_t*)pcm, scratch.syn[0]);
+#ifdef DR_MP3_FIXED_POINT
+                drmp3_fx_from_float(scratch.grbuf[0], 576*nch);
+#endif
+                if (out_nch < nch)
+                {
+                    drmp3d_downmix((drmp3d_fb_t*)scratch.grbuf[0], 576);
+                }
+                drmp3d_synth_granule(dec->qmf_state, (drmp3d_fb_t*)scratch.grbuf[0], 12, out_nch, half, (drmp3d_sample_t*)pcm, (drmp3d_fb_t*)scratch.syn[0]);
                 memset(scratch.grbuf[0], 0, 576*2*sizeof(float));
-                pcm = DRMP3_OFFSET_PTR(pcm, sizeof(drmp3d_sample_t)*384*info->channels);
+                pcm = DRMP3_OFFSET_PTR(pcm, sizeof(drmp3d_sample_t)*(384 >> half)*out_nch);
             }
             if (bs_frame->pos > bs_frame->limit)
             {
@@ -2152,7 +2643,7 @@ int drmp3dec_decode_frame(drmp3dec *dec, const unsigned char *mp3, int mp3_bytes
 #endif
     }
 
-    return success*drmp3_hdr_frame_samples(dec->header);
+    return success*(drmp3_hdr_frame_samples(dec->header) >> half);
 }
 
 void drmp3dec_f32_to_s16(const float *in, drmp3_int16 *out, int num_samples)
@@ -2699,6 +3190,111 @@ static drmp3_bool32 drmp3_init_src(drmp3* pMP3)
     return DRMP3_TRUE;
 }
 
+static drmp3_uint32 drmp3__be32(const drmp3_uint8* p)
+{
+    return ((drmp3_uint32)p[0] << 24) | ((drmp3_uint32)p[1] << 16) | ((drmp3_uint32)p[2] << 8) | p[3];
+}
+
+/*
+Reads the Xing/Info or VBRI header that VBR encoders put in a frame of its own at the start of the stream. The header
+gives the frame count, so the duration is known without a scan, and a table of contents for seeking. VBRI tables are
+converted to the Xing layout. Returns false if the frame holds audio.
+*/
+static drmp3_bool32 drmp3__parse_vbr_header(drmp3* pMP3, const drmp3_uint8* pFrame, int frameSize)
+{
+    const drmp3_uint8* p;
+    drmp3_uint32 frames = 0, bytes = 0;
+    drmp3_uint8 toc[100];
+    drmp3_bool32 hasTOC = DRMP3_FALSE;
+    int xingOffset, i;
+
+    /* Xing/Info follows the side info. */
+    if (DRMP3_HDR_TEST_MPEG1(pFrame)) {
+        xingOffset = DRMP3_HDR_IS_MONO(pFrame) ? 17 : 32;
+    } else {
+        xingOffset = DRMP3_HDR_IS_MONO(pFrame) ? 9 : 17;
+    }
+    xingOffset += DRMP3_HDR_SIZE + (DRMP3_HDR_IS_CRC(pFrame) ? 2 : 0);
+
+    p = pFrame + xingOffset;
+    if (xingOffset + 8 <= frameSize && (memcmp(p, "Xing", 4) == 0 || memcmp(p, "Info", 4) == 0)) {
+        drmp3_uint32 flags = drmp3__be32(p + 4);
+        const drmp3_uint8* pEnd = pFrame + frameSize;
+        p += 8;
+        if (flags & 1) {
+            if (p + 4 > pEnd) return DRMP3_FALSE;
+            frames = drmp3__be32(p);
+            p += 4;
+        }
+        if (flags & 2) {
+            if (p + 4 > pEnd) return DRMP3_FALSE;
+            bytes = drmp3__be32(p);
+            p += 4;
+        }
+        if (flags & 4) {
+            if (p + 100 > pEnd) return DRMP3_FALSE;
+            drmp3_copy_memory(toc, p, 100);
+            hasTOC = DRMP3_TRUE;
+        }
+    } else if (DRMP3_HDR_SIZE + 32 + 26 <= frameSize && memcmp(pFrame + DRMP3_HDR_SIZE + 32, "VBRI", 4) == 0) {
+        /* VBRI is always 32 bytes in, followed by a table of byte sizes, each entry covering framesPerEntry frames. */
+        drmp3_uint32 entryCount, scale, entrySize, framesPerEntry, entry, k;
+        drmp3_uint64 pos, size, into;
+        p = pFrame + DRMP3_HDR_SIZE + 32;
+        bytes          = drmp3__be32(p + 10);
+        frames         = drmp3__be32(p + 14);
+        entryCount     = ((drmp3_uint32)p[18] << 8) | p[19];
+        scale          = ((drmp3_uint32)p[20] << 8) | p[21];
+        entrySize      = ((drmp3_uint32)p[22] << 8) | p[23];
+        framesPerEntry = ((drmp3_uint32)p[24] << 8) | p[25];
+        p += 26;
+
+        if (entryCount > 0 && entrySize >= 1 && entrySize <= 4 && framesPerEntry > 0 && bytes > 0 && frames > 0 &&
+            DRMP3_HDR_SIZE + 32 + 26 + (int)(entryCount*entrySize) <= frameSize) {
+            /* The first entry starts after the VBRI frame. */
+            pos = (drmp3_uint64)frameSize;
+            entry = 0;
+            for (i = 0; i < 100; ++i) {
+                drmp3_uint64 targetFrame = (drmp3_uint64)frames * i / 100;
+                for (;;) {
+                    size = 0;
+                    for (k = 0; k < entrySize; ++k) {
+                        size = (size << 8) | p[entry*entrySize + k];
+                    }
+                    size *= scale;
+                    if (entry + 1 == entryCount || (drmp3_uint64)(entry + 1) * framesPerEntry > targetFrame) {
+                        break;
+                    }
+                    pos += size;
+                    entry += 1;
+                }
+                into = drmp3_min(targetFrame - (drmp3_uint64)entry * framesPerEntry, framesPerEntry);
+                toc[i] = (drmp3_uint8)drmp3_min((pos + size * into / framesPerEntry) * 256 / bytes, 255);
+            }
+            hasTOC = DRMP3_TRUE;
+        }
+    } else {
+        return DRMP3_FALSE;
+    }
+
+    if (frames > 0) {
+        pMP3->vbrMP3FrameCount = frames;
+        pMP3->vbrPCMFrameCount = (drmp3_uint64)frames * drmp3_hdr_frame_samples(pFrame);
+    }
+    if (frames > 0 && bytes > (drmp3_uint32)frameSize) {
+        if (!hasTOC) {
+            /* Without a table, assume the bytes are spread evenly, as they are in CBR streams with an Info header. */
+            for (i = 0; i < 100; ++i) {
+                toc[i] = (drmp3_uint8)(i * 256 / 100);
+            }
+        }
+        drmp3_copy_memory(pMP3->vbrTOC, toc, 100);
+        pMP3->vbrStreamBytes = bytes;
+        pMP3->hasVBRTOC = DRMP3_TRUE;
+    }
+    return DRMP3_TRUE;
+}
+
 static drmp3_uint32 drmp3_decode_next_frame_ex(drmp3* pMP3, drmp3d_sample_t* pPCMFrames, drmp3_bool32 discard)
 {
     drmp3_uint32 pcmFramesRead = 0;
@@ -2713,6 +3309,7 @@ static drmp3_uint32 drmp3_decode_next_frame_ex(drmp3* pMP3, drmp3d_sample_t* pPC
     do {
         drmp3dec_frame_info info;
         size_t leftoverDataSize;
+        drmp3_bool32 isVBRHeaderFrame;
 
         /* minimp3 recommends doing data submission in 16K chunks. If we don't have at least 16K bytes available, get more. */
         if (pMP3->dataSize < DRMP3_DATA_CHUNK_SIZE) {
@@ -2747,7 +3344,24 @@ static drmp3_uint32 drmp3_decode_next_frame_ex(drmp3* pMP3, drmp3d_sample_t* pPC
         }
 
         pcmFramesRead = drmp3dec_decode_frame(&pMP3->decoder, pMP3->pData, (int)pMP3->dataSize, pPCMFrames, &info);    /* <-- Safe size_t -> int conversion thanks to the check above. */
-        
+
+        /* Look for a VBR header in the first frame. Its frame decodes to silence that isn't part of the stream, so it's skipped. */
+        isVBRHeaderFrame = DRMP3_FALSE;
+        if (info.frame_bytes > 0 && (pcmFramesRead > 0 || discard)) {
+            int frameSize = drmp3_hdr_frame_bytes(pMP3->decoder.header, pMP3->decoder.free_format_bytes) + drmp3_hdr_padding(pMP3->decoder.header);
+            drmp3_uint64 framePos = pMP3->streamCursor - pMP3->dataSize + (size_t)(info.frame_bytes - frameSize);
+            if (!pMP3->isFirstFrameChecked) {
+                pMP3->isFirstFrameChecked = DRMP3_TRUE;
+                pMP3->audioStartPos = framePos;
+                if (drmp3__parse_vbr_header(pMP3, pMP3->pData + (info.frame_bytes - frameSize), frameSize)) {
+                    pMP3->hasVBRHeader = DRMP3_TRUE;
+                    pMP3->vbrHeaderPos = framePos;
+                    pMP3->audioStartPos = framePos + frameSize;
+                }
+            }
+            isVBRHeaderFrame = pMP3->hasVBRHeader && framePos == pMP3->vbrHeaderPos;
+        }
+
         /* Consume the data. */
         leftoverDataSize = (pMP3->dataSize - (size_t)info.frame_bytes);
         if (info.frame_bytes > 0) {
@@ -2755,16 +3369,21 @@ static drmp3_uint32 drmp3_decode_next_frame_ex(drmp3* pMP3, drmp3d_sample_t* pPC
             pMP3->dataSize = leftoverDataSize;
         }
 
+        if (isVBRHeaderFrame) {
+            continue;
+        }
+
         /*
         pcmFramesRead will be equal to 0 if decoding failed. If it is zero and info.frame_bytes > 0 then we have successfully
         decoded the frame. A special case is if we are wanting to discard the frame, in which case we return successfully.
         */
         if (pcmFramesRead > 0 || (info.frame_bytes > 0 && discard)) {
-            pcmFramesRead = drmp3_hdr_frame_samples(pMP3->decoder.header);
+            pcmFramesRead = drmp3_hdr_frame_samples(pMP3->decoder.header) >> ((pMP3->decoder.flags & DRMP3_DECODE_HALF_RATE) ? 1 : 0);
             pMP3->pcmFramesConsumedInMP3Frame = 0;
             pMP3->pcmFramesRemainingInMP3Frame = pcmFramesRead;
             pMP3->mp3FrameChannels = info.channels;
             pMP3->mp3FrameSampleRate = info.hz;
+            pMP3->frameInfo = info;
 
             /* We need to initialize the resampler if we don't yet have the channel count or sample rate. */
             if (pMP3->channels == 0 || pMP3->sampleRate == 0) {
@@ -2863,6 +3482,12 @@ drmp3_bool32 drmp3_init_internal(drmp3* pMP3, drmp3_read_proc onRead, drmp3_seek
 
     pMP3->sampleRate = config.outputSampleRate;
 
+    /* Mono output is cheaper to get from the decoder than by mixing down afterwards. */
+    pMP3->decoder.flags = (int)config.decodeFlags;
+    if (pMP3->channels == 1) {
+        pMP3->decoder.flags |= DRMP3_DECODE_MONO;
+    }
+
     pMP3->onRead = onRead;
     pMP3->onSeek = onSeek;
     pMP3->pUserData = pUserData;
@@ -3210,6 +3835,73 @@ drmp3_bool32 drmp3_seek_to_pcm_frame__brute_force(drmp3* pMP3, drmp3_uint64 fram
     return drmp3_seek_forward_by_pcm_frames__brute_force(pMP3, (frameIndex - pMP3->currentPCMFrame));
 }
 
+/* The PCM frame count from the VBR header, at the output sample rate. */
+static drmp3_uint64 drmp3__vbr_pcm_frame_count(drmp3* pMP3)
+{
+    drmp3_uint64 pcmFrameCount = pMP3->vbrPCMFrameCount >> ((pMP3->decoder.flags & DRMP3_DECODE_HALF_RATE) ? 1 : 0);
+    if (pMP3->mp3FrameSampleRate != 0 && pMP3->sampleRate != pMP3->mp3FrameSampleRate) {
+        pcmFrameCount = pcmFrameCount * pMP3->sampleRate / pMP3->mp3FrameSampleRate;
+    }
+    return pcmFrameCount;
+}
+
+drmp3_bool32 drmp3_seek_to_pcm_frame__vbr_toc(drmp3* pMP3, drmp3_uint64 frameIndex)
+{
+    drmp3_uint64 totalPCMFrameCount;
+    drmp3_uint64 pcmFramesPerMP3Frame;
+    drmp3_uint64 leadingPCMFrames;
+    drmp3_uint64 landingPCMFrame;
+    drmp3_uint64 milliPercent;
+    drmp3_uint64 tocPos;
+    drmp3_uint64 seekPos;
+    drmp3_uint32 iTOC;
+
+    drmp3_assert(pMP3 != NULL);
+    drmp3_assert(pMP3->hasVBRTOC);
+
+    totalPCMFrameCount   = drmp3__vbr_pcm_frame_count(pMP3);
+    pcmFramesPerMP3Frame = totalPCMFrameCount / pMP3->vbrMP3FrameCount;
+    leadingPCMFrames     = DRMP3_SEEK_LEADING_MP3_FRAMES * pcmFramesPerMP3Frame;
+
+    /* Targets near the start, or just ahead, are quicker to decode up to. */
+    if (pcmFramesPerMP3Frame == 0 || frameIndex <= leadingPCMFrames ||
+        (frameIndex >= pMP3->currentPCMFrame && frameIndex - pMP3->currentPCMFrame <= 2*leadingPCMFrames)) {
+        return drmp3_seek_to_pcm_frame__brute_force(pMP3, frameIndex);
+    }
+
+    /*
+    Land a few MP3 frames before the target so the bit reservoir is filled again once it's reached. The table maps each percent
+    of the duration to a byte position; interpolate between entries.
+    */
+    landingPCMFrame = drmp3_min(frameIndex - leadingPCMFrames, totalPCMFrameCount - 1);
+    milliPercent = landingPCMFrame * 100000 / totalPCMFrameCount;
+    iTOC     = (drmp3_uint32)(milliPercent / 1000);
+    tocPos   = pMP3->vbrTOC[iTOC] * 1000 + ((iTOC < 99 ? pMP3->vbrTOC[iTOC+1] : 256) - pMP3->vbrTOC[iTOC]) * (milliPercent % 1000);
+    seekPos  = pMP3->vbrHeaderPos + tocPos * pMP3->vbrStreamBytes / 256000;
+    if (seekPos < pMP3->audioStartPos) {
+        seekPos = pMP3->audioStartPos;
+    }
+
+    if (!drmp3__on_seek_64(pMP3, seekPos, drmp3_seek_origin_start)) {
+        return DRMP3_FALSE; /* Failed to seek. */
+    }
+
+    /* Clear any cached data. Decoding resyncs on the next frame header. */
+    drmp3_reset(pMP3);
+
+    /* Which frame that is isn't known exactly, so go by the table. */
+    pMP3->currentPCMFrame = landingPCMFrame / pcmFramesPerMP3Frame * pcmFramesPerMP3Frame;
+
+    /* Update resampler, as for the seek table. */
+    pMP3->src.algo.linear.alpha = (drmp3_int64)pMP3->currentPCMFrame * ((double)pMP3->src.config.sampleRateIn / pMP3->src.config.sampleRateOut); /* <-- Cast to int64 is required for VC6. */
+    pMP3->src.algo.linear.alpha = pMP3->src.algo.linear.alpha - (drmp3_uint32)(pMP3->src.algo.linear.alpha);
+    if (pMP3->src.algo.linear.alpha > 0) {
+        pMP3->src.algo.linear.isPrevFramesLoaded = 1;
+    }
+
+    return drmp3_seek_forward_by_pcm_frames__brute_force(pMP3, frameIndex - pMP3->currentPCMFrame);
+}
+
 drmp3_bool32 drmp3_find_closest_seek_point(drmp3* pMP3, drmp3_uint64 frameIndex, drmp3_uint32* pSeekPointIndex)
 {
     drmp3_uint32 iSeekPoint;
@@ -3316,6 +4008,8 @@ drmp3_bool32 drmp3_seek_to_pcm_frame(drmp3* pMP3, drmp3_uint64 frameIndex)
     /* Use the seek table if we have one. */
     if (pMP3->pSeekPoints != NULL && pMP3->seekPointCount > 0) {
         return drmp3_seek_to_pcm_frame__seek_table(pMP3, frameIndex);
+    } else if (pMP3->hasVBRTOC) {
+        return drmp3_seek_to_pcm_frame__vbr_toc(pMP3, frameIndex);
     } else {
         return drmp3_seek_to_pcm_frame__brute_force(pMP3, frameIndex);
     }
@@ -3332,6 +4026,17 @@ drmp3_bool32 drmp3_get_mp3_and_pcm_frame_count(drmp3* pMP3, drmp3_uint64* pMP3Fr
         return DRMP3_FALSE;
     }
 
+    /* A Xing/Info or VBRI header has the counts already. */
+    if (pMP3->vbrMP3FrameCount > 0) {
+        if (pMP3FrameCount != NULL) {
+            *pMP3FrameCount = pMP3->vbrMP3FrameCount;
+        }
+        if (pPCMFrameCount != NULL) {
+            *pPCMFrameCount = drmp3__vbr_pcm_frame_count(pMP3);
+        }
+        return DRMP3_TRUE;
+    }
+
     /*
     The way this works is we move back to the start of the stream, iterate over each MP3 frame and calculate the frame count based
     on our output sample rate, the seek back to the PCM frame we were sitting on before calling this function.
@@ -3403,6 +4108,24 @@ drmp3_uint64 drmp3_get_pcm_frame_count(drmp3* pMP3)
     return totalPCMFrameCount;
 }
 
+drmp3_uint64 drmp3_get_pcm_frame_count_estimate(drmp3* pMP3, drmp3_uint64 streamSizeInBytes)
+{
+    if (pMP3 == NULL) {
+        return 0;
+    }
+
+    if (pMP3->vbrMP3FrameCount > 0) {
+        return drmp3__vbr_pcm_frame_count(pMP3);
+    }
+
+    /* Free format streams don't give their bitrate. */
+    if (pMP3->frameInfo.bitrate_kbps <= 0 || streamSizeInBytes <= pMP3->audioStartPos) {
+        return 0;
+    }
+
+    return (streamSizeInBytes - pMP3->audioStartPos) * 8 * pMP3->sampleRate / ((drmp3_uint64)pMP3->frameInfo.bitrate_kbps * 1000);
+}
+
 drmp3_uint64 drmp3_get_mp3_frame_count(drmp3* pMP3)
 {
     drmp3_uint64 totalMP3FrameCount;
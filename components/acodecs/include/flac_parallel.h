@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <dr_flac.h>
+
+/** Decodes a FLAC file a frame at a time on worker threads. The calling
+ * thread cuts the file into frames at their sync codes and queues them in a
+ * ring; the workers decode them in parallel and the frames are read back in
+ * order. FLAC frames don't depend on each other, so this is exact. */
+typedef struct FlacParallel FlacParallel;
+
+/** Open filename for decoding on the given number of worker threads. flac is
+ * an open decoder of the same file, only read during this call for the
+ * stream format and where the frames start. NULL if the stream can't be
+ * decoded this way (Ogg FLAC) or the threads can't be started. */
+FlacParallel *flac_parallel_open(const drflac *flac, const char *filename, int workers);
+
+/** About the most heap flac_parallel_open and the frames it reads take for
+ * the stream flac on that many workers, thread stacks included. */
+size_t flac_parallel_heap_size(const drflac *flac, int workers);
+
+/** Read up to frames interleaved PCM frames into out, waiting for the
+ * workers as needed. Returns the number read, less than frames only at the
+ * end of the stream. */
+size_t flac_parallel_read_s16(FlacParallel *fp, int16_t *out, size_t frames);
+
+/** Stop the workers and free everything. */
+void flac_parallel_close(FlacParallel *fp);
@@ -100,8 +100,9 @@ extern "C" {
 // temp memory). "open" may fail with a VORBIS_outofmem if you
 // do not pass in enough data; there is no way to determine how
 // much you do need except to succeed (at which point you can
-// query get_info to find the exact amount required. yes I know
-// this is lame).
+// query stb_vorbis_get_alloc_size() to find the exact amount
+// required. yes I know this is lame). A file opened without a
+// buffer reports it too, so you can probe a file that didn't fit.
 //
 // If you pass in a non-NULL buffer of the type below, allocation
 // will occur from it as described above. Otherwise just pass NULL
@@ -133,6 +134,13 @@ typedef struct
 // get general information about the file
 extern stb_vorbis_info stb_vorbis_get_info(stb_vorbis *f);
 
+// the smallest alloc_buffer_length_in_bytes that f's file can be opened and
+// decoded with, whether or not f itself was opened with an alloc_buffer. one
+// buffer of this size can be reused for every file that needs no more. the
+// setup tables are counted even if f shares them from STB_VORBIS_SETUP_CACHE,
+// so the size holds whether or not they're still cached at the next open
+extern int stb_vorbis_get_alloc_size(stb_vorbis *f);
+
 // get the last error detected (clears it, too)
 extern int stb_vorbis_get_error(stb_vorbis *f);
 
@@ -150,6 +158,27 @@ extern int stb_vorbis_get_sample_offset(stb_vorbis *f);
 // of the memory buffer. In pushdata mode it returns 0.
 extern unsigned int stb_vorbis_get_file_offset(stb_vorbis *f);
 
+// low-power decode modes for stb_vorbis_set_decode_flags()
+#define STB_VORBIS_DECODE_MONO       1   // mix all channels down to one
+#define STB_VORBIS_DECODE_HALF_RATE  2   // half the sample rate
+
+// trade output quality for decode time. MONO sums the spectra of all
+// channels before the inverse MDCT, so only one transform runs per frame.
+// HALF_RATE drops the top half of each spectrum and runs the inverse MDCT
+// and windowing at half size, so the output is band-limited to a quarter
+// of the stream's sample rate. stb_vorbis_get_info() then reports the
+// output channels and rate; sample offsets, seeks and stream lengths stay
+// in stream samples. decoding restarts at the first frame (or, in pushdata
+// mode, as if stb_vorbis_flush_pushdata() had been called). returns 0 and
+// sets VORBIS_feature_not_supported if the stream's short blocks are too
+// small to halve.
+extern int stb_vorbis_set_decode_flags(stb_vorbis *f, int flags);
+
+// free the codebooks and floor/residue setup that STB_VORBIS_SETUP_CACHE keeps
+// around after the files using them were closed, e.g. to get the memory back
+// before opening something that isn't vorbis
+extern void stb_vorbis_flush_setup_cache(void);
+
 ///////////   PUSHDATA API
 
 #ifndef STB_VORBIS_NO_PUSHDATA_API
@@ -461,6 +490,30 @@ enum STBVorbisError
 #define STB_VORBIS_FAST_HUFFMAN_LENGTH   10
 #endif
 
+// STB_VORBIS_SETUP_CACHE [number]
+//     the setup header of a file (codebooks, floors, residues, mappings)
+//     takes most of the open time to decode, and tracks of an album made
+//     with the same encoder settings share a byte-identical one. this many
+//     decoded setups are kept after their files are closed, keyed by a hash
+//     of the setup packet, so opening the next track reuses them; decoders
+//     open at the same time share one copy. 0 disables. the cache isn't
+//     locked, so use 0 if you open files from several threads at once.
+//     files opened with an alloc_buffer share a setup that's already
+//     cached. one that isn't is decoded into the alloc_buffer and neither
+//     added nor evicting one, since it goes with the buffer.
+#ifndef STB_VORBIS_SETUP_CACHE
+#define STB_VORBIS_SETUP_CACHE   1
+#endif
+
+// STB_VORBIS_FIXED_POINT
+//     run the inverse MDCT and the windowed overlap-add in 32-bit fixed
+//     point, Tremor-style, instead of float. floors and residues are still
+//     decoded in float; the spectrum is converted on its way into the
+//     inverse MDCT, and the short output functions then only need a shift
+//     per sample. the float output functions still work, converting back.
+//     useful on CPUs without an FPU.
+// #define STB_VORBIS_FIXED_POINT
+
 // STB_VORBIS_FAST_BINARY_LENGTH [number]
 //     sets the log size of the binary-search acceleration table. this
 //     is used in similar fashion to the fast-huffman size to set initial
@@ -749,6 +802,46 @@ typedef struct
    uint32 last_decoded_sample;
 } ProbedPage;
 
+#ifdef STB_VORBIS_FIXED_POINT
+// time-domain samples have 1.0 == 1 << FIX_PCM_BITS, leaving 7 bits of
+// headroom inside the inverse MDCT; twiddle factors and windows are Q31
+#define FIX_PCM_BITS   24
+typedef int32 PCMTYPE;
+typedef int32 TRIGTYPE;
+#else
+typedef float PCMTYPE;
+typedef float TRIGTYPE;
+#endif
+
+#if STB_VORBIS_SETUP_CACHE > 0
+// the decoded setup header, shared by every open file whose setup packet
+// hashes the same
+typedef struct
+{
+   uint32 crc, hash;    // two independent hashes of the setup packet
+   int length;          // setup packet length in bytes
+   int channels;        // mapping channel arrays are sized by this
+   int refcount;        // open files using this setup
+   uint32 last_used;
+   int longest_floorlist;
+   unsigned int setup_memory_required;      // of the tables alone
+   unsigned int setup_temp_memory_required;
+
+   int codebook_count;
+   Codebook *codebooks;
+   int floor_count;
+   uint16 floor_types[64];
+   Floor *floor_config;
+   int residue_count;
+   uint16 residue_types[64];
+   Residue *residue_config;
+   int mapping_count;
+   Mapping *mapping;
+   int mode_count;
+   Mode mode_config[64];
+} SetupCacheEntry;
+#endif
+
 struct stb_vorbis
 {
   // user-accessible info
@@ -758,6 +851,7 @@ struct stb_vorbis
    unsigned int setup_memory_required;
    unsigned int temp_memory_required;
    unsigned int setup_temp_memory_required;
+   unsigned int setup_temp_used; // heap-allocated temp memory in use
 
   // input config
 #ifndef STB_VORBIS_NO_STDIO
@@ -804,14 +898,25 @@ struct stb_vorbis
    Mapping *mapping;
    int mode_count;
    Mode mode_config[64];  // varies
+#if STB_VORBIS_SETUP_CACHE > 0
+   SetupCacheEntry *setup_cache; // owns the header info above when set
+#endif
 
    uint32 total_samples;
 
+  // low-power decode modes, see stb_vorbis_set_decode_flags()
+   int out_channels; // 1 when mixing down, else channels
+   int half_rate;    // 1 when the output rate is halved
+
   // decode buffer
    float *channel_buffers[STB_VORBIS_MAX_CHANNELS];
-   float *outputs        [STB_VORBIS_MAX_CHANNELS];
+   PCMTYPE *outputs      [STB_VORBIS_MAX_CHANNELS];
+   #ifdef STB_VORBIS_FIXED_POINT
+   // inverse MDCT output; channel_buffers then only hold the spectrum
+   PCMTYPE *pcm_buffers  [STB_VORBIS_MAX_CHANNELS];
+   #endif
 
-   float *previous_window[STB_VORBIS_MAX_CHANNELS];
+   PCMTYPE *previous_window[STB_VORBIS_MAX_CHANNELS];
    int previous_length;
 
    #ifndef STB_VORBIS_NO_DEFER_FLOOR
@@ -826,8 +931,8 @@ struct stb_vorbis
   // per-blocksize precomputed data
    
    // twiddle factors
-   float *A[2],*B[2],*C[2];
-   float *window[2];
+   TRIGTYPE *A[2],*B[2],*C[2];
+   TRIGTYPE *window[2];
    uint16 *bit_reverse[2];
 
   // current page/packet/segment streaming info
@@ -860,6 +965,12 @@ struct stb_vorbis
    int channel_buffer_end;
 };
 
+#ifdef STB_VORBIS_FIXED_POINT
+   #define PCM_BUFFERS(f)    ((f)->pcm_buffers)
+#else
+   #define PCM_BUFFERS(f)    ((f)->channel_buffers)
+#endif
+
 #if defined(STB_VORBIS_NO_PUSHDATA_API)
    #define IS_PUSH_MODE(f)   FALSE
 #elif defined(STB_VORBIS_NO_PULLDATA_API)
@@ -909,7 +1020,7 @@ static void *make_block_array(void *mem, int count, int size)
 
 static void *setup_malloc(vorb *f, int sz)
 {
-   sz = (sz+3) & ~3;
+   sz = (sz+7) & ~7; // round up to nearest 8 for alignment of future allocs
    f->setup_memory_required += sz;
    if (f->alloc.alloc_buffer) {
       void *p = (char *) f->alloc.alloc_buffer + f->setup_offset;
@@ -928,21 +1039,33 @@ static void setup_free(vorb *f, void *p)
 
 static void *setup_temp_malloc(vorb *f, int sz)
 {
-   sz = (sz+3) & ~3;
+   void *p;
+   unsigned int used;
+   sz = (sz+7) & ~7;
    if (f->alloc.alloc_buffer) {
       if (f->temp_offset - sz < f->setup_offset) return NULL;
       f->temp_offset -= sz;
-      return (char *) f->alloc.alloc_buffer + f->temp_offset;
-   }
-   return malloc(sz);
+      p = (char *) f->alloc.alloc_buffer + f->temp_offset;
+      used = f->alloc.alloc_buffer_length_in_bytes - f->temp_offset;
+   } else {
+      p = malloc(sz);
+      used = f->setup_temp_used += sz;
+   }
+   // the peak while parsing the headers, for stb_vorbis_get_alloc_size();
+   // temp_alloc() comes here too once decoding, but temp_memory_required
+   // already covers that
+   if (f->temp_memory_required == 0 && used > f->setup_temp_memory_required)
+      f->setup_temp_memory_required = used;
+   return p;
 }
 
 static void setup_temp_free(vorb *f, void *p, int sz)
 {
    if (f->alloc.alloc_buffer) {
-      f->temp_offset += (sz+3)&~3;
+      f->temp_offset += (sz+7)&~7;
       return;
    }
+   f->setup_temp_used -= (sz+7)&~7;
    free(p);
 }
 
@@ -1210,29 +1333,42 @@ static int lookup1_values(int entries, int dim)
    return r;
 }
 
+#ifdef STB_VORBIS_FIXED_POINT
+static int32 trig_to_fixed(double x)
+{
+   x = floor(x * 2147483648.0 + 0.5);
+   if (x >  2147483647.0) return  0x7fffffff;
+   if (x < -2147483647.0) return -0x7fffffff;
+   return (int32) x;
+}
+#define TRIG(x)   trig_to_fixed(x)
+#else
+#define TRIG(x)   ((float) (x))
+#endif
+
 // called twice per file
-static void compute_twiddle_factors(int n, float *A, float *B, float *C)
+static void compute_twiddle_factors(int n, TRIGTYPE *A, TRIGTYPE *B, TRIGTYPE *C)
 {
    int n4 = n >> 2, n8 = n >> 3;
    int k,k2;
 
    for (k=k2=0; k < n4; ++k,k2+=2) {
-      A[k2  ] = (float)  cos(4*k*M_PI/n);
-      A[k2+1] = (float) -sin(4*k*M_PI/n);
-      B[k2  ] = (float)  cos((k2+1)*M_PI/n/2) * 0.5f;
-      B[k2+1] = (float)  sin((k2+1)*M_PI/n/2) * 0.5f;
+      A[k2  ] = TRIG( cos(4*k*M_PI/n));
+      A[k2+1] = TRIG(-sin(4*k*M_PI/n));
+      B[k2  ] = TRIG( cos((k2+1)*M_PI/n/2) * 0.5);
+      B[k2+1] = TRIG( sin((k2+1)*M_PI/n/2) * 0.5);
    }
    for (k=k2=0; k < n8; ++k,k2+=2) {
-      C[k2  ] = (float)  cos(2*(k2+1)*M_PI/n);
-      C[k2+1] = (float) -sin(2*(k2+1)*M_PI/n);
+      C[k2  ] = TRIG( cos(2*(k2+1)*M_PI/n));
+      C[k2+1] = TRIG(-sin(2*(k2+1)*M_PI/n));
    }
 }
 
-static void compute_window(int n, float *window)
+static void compute_window(int n, TRIGTYPE *window)
 {
    int n2 = n >> 1, i;
    for (i=0; i < n2; ++i)
-      window[i] = (float) sin(0.5 * M_PI * square((float) sin((i - 0 + 0.5) / n2 * 0.5 * M_PI)));
+      window[i] = TRIG(sin(0.5 * M_PI * square((float) sin((i - 0 + 0.5) / n2 * 0.5 * M_PI))));
 }
 
 static void compute_bitreverse(int n, uint16 *rev)
@@ -1246,12 +1382,12 @@ static void compute_bitreverse(int n, uint16 *rev)
 static int init_blocksize(vorb *f, int b, int n)
 {
    int n2 = n >> 1, n4 = n >> 2, n8 = n >> 3;
-   f->A[b] = (float *) setup_malloc(f, sizeof(float) * n2);
-   f->B[b] = (float *) setup_malloc(f, sizeof(float) * n2);
-   f->C[b] = (float *) setup_malloc(f, sizeof(float) * n4);
+   f->A[b] = (TRIGTYPE *) setup_malloc(f, sizeof(TRIGTYPE) * n2);
+   f->B[b] = (TRIGTYPE *) setup_malloc(f, sizeof(TRIGTYPE) * n2);
+   f->C[b] = (TRIGTYPE *) setup_malloc(f, sizeof(TRIGTYPE) * n4);
    if (!f->A[b] || !f->B[b] || !f->C[b]) return error(f, VORBIS_outofmem);
    compute_twiddle_factors(n, f->A[b], f->B[b], f->C[b]);
-   f->window[b] = (float *) setup_malloc(f, sizeof(float) * n2);
+   f->window[b] = (TRIGTYPE *) setup_malloc(f, sizeof(TRIGTYPE) * n2);
    if (!f->window[b]) return error(f, VORBIS_outofmem);
    compute_window(n, f->window[b]);
    f->bit_reverse[b] = (uint16 *) setup_malloc(f, sizeof(uint16) * n8);
@@ -2391,6 +2527,7 @@ void inverse_mdct(float *buffer, int n, vorb *f, int blocktype)
 #endif
 
 
+#ifndef STB_VORBIS_FIXED_POINT
 // the following were split out into separate functions while optimizing;
 // they could be pushed back up but eh. __forceinline showed no change;
 // they're probably already being inlined.
@@ -2917,158 +3054,634 @@ static void inverse_mdct(float *buffer, int n, vorb *f, int blocktype)
    temp_free(f,buf2);
    temp_alloc_restore(f,save_point);
 }
+#else // STB_VORBIS_FIXED_POINT
 
-#if 0
-// this is the original version of the above code, if you want to optimize it from scratch
-void inverse_mdct_naive(float *buffer, int n)
+// the same kernel as the float inverse_mdct() above, step for step, with
+// Q31 twiddle factors. MULT31 drops the bottom bit of the product, which is
+// far below the 16-bit output at FIX_PCM_BITS
+
+#define MULT32(a,b)   ((int32) (((long long) (a) * (b)) >> 32))
+#define MULT31(a,b)   (MULT32(a,b) * 2)
+
+// the spectrum is float; 64.0 keeps a damaged stream from overflowing the
+// butterflies, real audio stays far below 1.0
+static __forceinline int32 spectrum_to_fixed(float x)
 {
-   float s;
-   float A[1 << 12], B[1 << 12], C[1 << 11];
-   int i,k,k2,k4, n2 = n >> 1, n4 = n >> 2, n8 = n >> 3, l;
-   int n3_4 = n - n4, ld;
-   // how can they claim this only uses N words?!
-   // oh, because they're only used sparsely, whoops
-   float u[1 << 13], X[1 << 13], v[1 << 13], w[1 << 13];
-   // set up twiddle factors
+   if (x >  64.0f) x =  64.0f;
+   if (x < -64.0f) x = -64.0f;
+   return (int32) (x * (float) (1 << FIX_PCM_BITS));
+}
 
-   for (k=k2=0; k < n4; ++k,k2+=2) {
-      A[k2  ] = (float)  cos(4*k*M_PI/n);
-      A[k2+1] = (float) -sin(4*k*M_PI/n);
-      B[k2  ] = (float)  cos((k2+1)*M_PI/n/2);
-      B[k2+1] = (float)  sin((k2+1)*M_PI/n/2);
-   }
-   for (k=k2=0; k < n8; ++k,k2+=2) {
-      C[k2  ] = (float)  cos(2*(k2+1)*M_PI/n);
-      C[k2+1] = (float) -sin(2*(k2+1)*M_PI/n);
-   }
+static void imdct_step3_iter0_loop_fixed(int n, int32 *e, int i_off, int k_off, int32 *A)
+{
+   int32 *ee0 = e + i_off;
+   int32 *ee2 = ee0 + k_off;
+   int i;
 
-   // IMDCT algorithm from "The use of multirate filter banks for coding of high quality digital audio"
-   // Note there are bugs in that pseudocode, presumably due to them attempting
-   // to rename the arrays nicely rather than representing the way their actual
-   // implementation bounces buffers back and forth. As a result, even in the
-   // "some formulars corrected" version, a direct implementation fails. These
-   // are noted below as "paper bug".
+   assert((n & 3) == 0);
+   for (i=(n>>2); i > 0; --i) {
+      int32 k00_20, k01_21;
+      k00_20  = ee0[ 0] - ee2[ 0];
+      k01_21  = ee0[-1] - ee2[-1];
+      ee0[ 0] += ee2[ 0];
+      ee0[-1] += ee2[-1];
+      ee2[ 0] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      ee2[-1] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += 8;
 
-   // copy and reflect spectral data
-   for (k=0; k < n2; ++k) u[k] = buffer[k];
-   for (   ; k < n ; ++k) u[k] = -buffer[n - k - 1];
-   // kernel from paper
-   // step 1
-   for (k=k2=k4=0; k < n4; k+=1, k2+=2, k4+=4) {
-      v[n-k4-1] = (u[k4] - u[n-k4-1]) * A[k2]   - (u[k4+2] - u[n-k4-3])*A[k2+1];
-      v[n-k4-3] = (u[k4] - u[n-k4-1]) * A[k2+1] + (u[k4+2] - u[n-k4-3])*A[k2];
-   }
-   // step 2
-   for (k=k4=0; k < n8; k+=1, k4+=4) {
-      w[n2+3+k4] = v[n2+3+k4] + v[k4+3];
-      w[n2+1+k4] = v[n2+1+k4] + v[k4+1];
-      w[k4+3]    = (v[n2+3+k4] - v[k4+3])*A[n2-4-k4] - (v[n2+1+k4]-v[k4+1])*A[n2-3-k4];
-      w[k4+1]    = (v[n2+1+k4] - v[k4+1])*A[n2-4-k4] + (v[n2+3+k4]-v[k4+3])*A[n2-3-k4];
-   }
-   // step 3
-   ld = ilog(n) - 1; // ilog is off-by-one from normal definitions
-   for (l=0; l < ld-3; ++l) {
-      int k0 = n >> (l+2), k1 = 1 << (l+3);
-      int rlim = n >> (l+4), r4, r;
-      int s2lim = 1 << (l+2), s2;
-      for (r=r4=0; r < rlim; r4+=4,++r) {
-         for (s2=0; s2 < s2lim; s2+=2) {
-            u[n-1-k0*s2-r4] = w[n-1-k0*s2-r4] + w[n-1-k0*(s2+1)-r4];
-            u[n-3-k0*s2-r4] = w[n-3-k0*s2-r4] + w[n-3-k0*(s2+1)-r4];
-            u[n-1-k0*(s2+1)-r4] = (w[n-1-k0*s2-r4] - w[n-1-k0*(s2+1)-r4]) * A[r*k1]
-                                - (w[n-3-k0*s2-r4] - w[n-3-k0*(s2+1)-r4]) * A[r*k1+1];
-            u[n-3-k0*(s2+1)-r4] = (w[n-3-k0*s2-r4] - w[n-3-k0*(s2+1)-r4]) * A[r*k1]
-                                + (w[n-1-k0*s2-r4] - w[n-1-k0*(s2+1)-r4]) * A[r*k1+1];
-         }
-      }
-      if (l+1 < ld-3) {
-         // paper bug: ping-ponging of u&w here is omitted
-         memcpy(w, u, sizeof(u));
-      }
-   }
+      k00_20  = ee0[-2] - ee2[-2];
+      k01_21  = ee0[-3] - ee2[-3];
+      ee0[-2] += ee2[-2];
+      ee0[-3] += ee2[-3];
+      ee2[-2] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      ee2[-3] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += 8;
 
-   // step 4
-   for (i=0; i < n8; ++i) {
-      int j = bit_reverse(i) >> (32-ld+3);
-      assert(j < n8);
-      if (i == j) {
-         // paper bug: original code probably swapped in place; if copying,
-         //            need to directly copy in this case
-         int i8 = i << 3;
-         v[i8+1] = u[i8+1];
-         v[i8+3] = u[i8+3];
-         v[i8+5] = u[i8+5];
-         v[i8+7] = u[i8+7];
-      } else if (i < j) {
-         int i8 = i << 3, j8 = j << 3;
-         v[j8+1] = u[i8+1], v[i8+1] = u[j8 + 1];
-         v[j8+3] = u[i8+3], v[i8+3] = u[j8 + 3];
-         v[j8+5] = u[i8+5], v[i8+5] = u[j8 + 5];
-         v[j8+7] = u[i8+7], v[i8+7] = u[j8 + 7];
-      }
-   }
-   // step 5
-   for (k=0; k < n2; ++k) {
-      w[k] = v[k*2+1];
-   }
-   // step 6
-   for (k=k2=k4=0; k < n8; ++k, k2 += 2, k4 += 4) {
-      u[n-1-k2] = w[k4];
-      u[n-2-k2] = w[k4+1];
-      u[n3_4 - 1 - k2] = w[k4+2];
-      u[n3_4 - 2 - k2] = w[k4+3];
-   }
-   // step 7
-   for (k=k2=0; k < n8; ++k, k2 += 2) {
-      v[n2 + k2 ] = ( u[n2 + k2] + u[n-2-k2] + C[k2+1]*(u[n2+k2]-u[n-2-k2]) + C[k2]*(u[n2+k2+1]+u[n-2-k2+1]))/2;
-      v[n-2 - k2] = ( u[n2 + k2] + u[n-2-k2] - C[k2+1]*(u[n2+k2]-u[n-2-k2]) - C[k2]*(u[n2+k2+1]+u[n-2-k2+1]))/2;
-      v[n2+1+ k2] = ( u[n2+1+k2] - u[n-1-k2] + C[k2+1]*(u[n2+1+k2]+u[n-1-k2]) - C[k2]*(u[n2+k2]-u[n-2-k2]))/2;
-      v[n-1 - k2] = (-u[n2+1+k2] + u[n-1-k2] + C[k2+1]*(u[n2+1+k2]+u[n-1-k2]) - C[k2]*(u[n2+k2]-u[n-2-k2]))/2;
+      k00_20  = ee0[-4] - ee2[-4];
+      k01_21  = ee0[-5] - ee2[-5];
+      ee0[-4] += ee2[-4];
+      ee0[-5] += ee2[-5];
+      ee2[-4] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      ee2[-5] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += 8;
+
+      k00_20  = ee0[-6] - ee2[-6];
+      k01_21  = ee0[-7] - ee2[-7];
+      ee0[-6] += ee2[-6];
+      ee0[-7] += ee2[-7];
+      ee2[-6] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      ee2[-7] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += 8;
+      ee0 -= 8;
+      ee2 -= 8;
    }
-   // step 8
-   for (k=k2=0; k < n4; ++k,k2 += 2) {
-      X[k]      = v[k2+n2]*B[k2  ] + v[k2+1+n2]*B[k2+1];
-      X[n2-1-k] = v[k2+n2]*B[k2+1] - v[k2+1+n2]*B[k2  ];
+}
+
+static void imdct_step3_inner_r_loop_fixed(int lim, int32 *e, int d0, int k_off, int32 *A, int k1)
+{
+   int i;
+   int32 k00_20, k01_21;
+
+   int32 *e0 = e + d0;
+   int32 *e2 = e0 + k_off;
+
+   for (i=lim >> 2; i > 0; --i) {
+      k00_20  = e0[ 0] - e2[ 0];
+      k01_21  = e0[-1] - e2[-1];
+      e0[ 0] += e2[ 0];
+      e0[-1] += e2[-1];
+      e2[ 0] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      e2[-1] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += k1;
+
+      k00_20  = e0[-2] - e2[-2];
+      k01_21  = e0[-3] - e2[-3];
+      e0[-2] += e2[-2];
+      e0[-3] += e2[-3];
+      e2[-2] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      e2[-3] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += k1;
+
+      k00_20  = e0[-4] - e2[-4];
+      k01_21  = e0[-5] - e2[-5];
+      e0[-4] += e2[-4];
+      e0[-5] += e2[-5];
+      e2[-4] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      e2[-5] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += k1;
+
+      k00_20  = e0[-6] - e2[-6];
+      k01_21  = e0[-7] - e2[-7];
+      e0[-6] += e2[-6];
+      e0[-7] += e2[-7];
+      e2[-6] = MULT31(k00_20, A[0]) - MULT31(k01_21, A[1]);
+      e2[-7] = MULT31(k01_21, A[0]) + MULT31(k00_20, A[1]);
+      A += k1;
+      e0 -= 8;
+      e2 -= 8;
    }
+}
 
-   // decode kernel to output
-   // determined the following value experimentally
-   // (by first figuring out what made inverse_mdct_slow work); then matching that here
-   // (probably vorbis encoder premultiplies by n or n/2, to save it on the decoder?)
-   s = 0.5; // theoretically would be n4
+static void imdct_step3_inner_s_loop_fixed(int n, int32 *e, int i_off, int k_off, int32 *A, int a_off, int k0)
+{
+   int i;
+   int32 A0 = A[0];
+   int32 A1 = A[0+1];
+   int32 A2 = A[0+a_off];
+   int32 A3 = A[0+a_off+1];
+   int32 A4 = A[0+a_off*2+0];
+   int32 A5 = A[0+a_off*2+1];
+   int32 A6 = A[0+a_off*3+0];
+   int32 A7 = A[0+a_off*3+1];
 
-   // [[[ note! the s value of 0.5 is compensated for by the B[] in the current code,
-   //     so it needs to use the "old" B values to behave correctly, or else
-   //     set s to 1.0 ]]]
-   for (i=0; i < n4  ; ++i) buffer[i] = s * X[i+n4];
-   for (   ; i < n3_4; ++i) buffer[i] = -s * X[n3_4 - i - 1];
-   for (   ; i < n   ; ++i) buffer[i] = -s * X[i - n3_4];
+   int32 k00,k11;
+
+   int32 *ee0 = e  +i_off;
+   int32 *ee2 = ee0+k_off;
+
+   for (i=n; i > 0; --i) {
+      k00     = ee0[ 0] - ee2[ 0];
+      k11     = ee0[-1] - ee2[-1];
+      ee0[ 0] =  ee0[ 0] + ee2[ 0];
+      ee0[-1] =  ee0[-1] + ee2[-1];
+      ee2[ 0] = MULT31(k00, A0) - MULT31(k11, A1);
+      ee2[-1] = MULT31(k11, A0) + MULT31(k00, A1);
+
+      k00     = ee0[-2] - ee2[-2];
+      k11     = ee0[-3] - ee2[-3];
+      ee0[-2] =  ee0[-2] + ee2[-2];
+      ee0[-3] =  ee0[-3] + ee2[-3];
+      ee2[-2] = MULT31(k00, A2) - MULT31(k11, A3);
+      ee2[-3] = MULT31(k11, A2) + MULT31(k00, A3);
+
+      k00     = ee0[-4] - ee2[-4];
+      k11     = ee0[-5] - ee2[-5];
+      ee0[-4] =  ee0[-4] + ee2[-4];
+      ee0[-5] =  ee0[-5] + ee2[-5];
+      ee2[-4] = MULT31(k00, A4) - MULT31(k11, A5);
+      ee2[-5] = MULT31(k11, A4) + MULT31(k00, A5);
+
+      k00     = ee0[-6] - ee2[-6];
+      k11     = ee0[-7] - ee2[-7];
+      ee0[-6] =  ee0[-6] + ee2[-6];
+      ee0[-7] =  ee0[-7] + ee2[-7];
+      ee2[-6] = MULT31(k00, A6) - MULT31(k11, A7);
+      ee2[-7] = MULT31(k11, A6) + MULT31(k00, A7);
+
+      ee0 -= k0;
+      ee2 -= k0;
+   }
 }
-#endif
 
-static float *get_window(vorb *f, int len)
+static __forceinline void iter_54_fixed(int32 *z)
 {
-   len <<= 1;
-   if (len == f->blocksize_0) return f->window[0];
-   if (len == f->blocksize_1) return f->window[1];
-   return NULL;
+   int32 k00,k11,k22,k33;
+   int32 y0,y1,y2,y3;
+
+   k00  = z[ 0] - z[-4];
+   y0   = z[ 0] + z[-4];
+   y2   = z[-2] + z[-6];
+   k22  = z[-2] - z[-6];
+
+   z[-0] = y0 + y2;
+   z[-2] = y0 - y2;
+
+   k33  = z[-3] - z[-7];
+
+   z[-4] = k00 + k33;
+   z[-6] = k00 - k33;
+
+   k11  = z[-1] - z[-5];
+   y1   = z[-1] + z[-5];
+   y3   = z[-3] + z[-7];
+
+   z[-1] = y1 + y3;
+   z[-3] = y1 - y3;
+   z[-5] = k11 - k22;
+   z[-7] = k11 + k22;
 }
 
-#ifndef STB_VORBIS_NO_DEFER_FLOOR
-typedef int16 YTYPE;
-#else
-typedef int YTYPE;
-#endif
-static int do_floor(vorb *f, Mapping *map, int i, int n, float *target, YTYPE *finalY, uint8 *step2_flag)
+static void imdct_step3_inner_s_loop_ld654_fixed(int n, int32 *e, int i_off, int32 *A, int base_n)
 {
-   int n2 = n >> 1;
-   int s = map->chan[i].mux, floor;
-   floor = map->submap_floor[s];
-   if (f->floor_types[floor] == 0) {
-      return error(f, VORBIS_invalid_stream);
-   } else {
-      Floor1 *g = &f->floor_config[floor].floor1;
-      int j,q;
+   int a_off = base_n >> 3;
+   int32 A2 = A[0+a_off];
+   int32 *z = e + i_off;
+   int32 *base = z - 16 * n;
+
+   while (z > base) {
+      int32 k00,k11;
+
+      k00   = z[-0] - z[-8];
+      k11   = z[-1] - z[-9];
+      z[-0] = z[-0] + z[-8];
+      z[-1] = z[-1] + z[-9];
+      z[-8] =  k00;
+      z[-9] =  k11 ;
+
+      k00    = z[ -2] - z[-10];
+      k11    = z[ -3] - z[-11];
+      z[ -2] = z[ -2] + z[-10];
+      z[ -3] = z[ -3] + z[-11];
+      z[-10] = MULT31(k00+k11, A2);
+      z[-11] = MULT31(k11-k00, A2);
+
+      k00    = z[-12] - z[ -4];  // reverse to avoid a unary negation
+      k11    = z[ -5] - z[-13];
+      z[ -4] = z[ -4] + z[-12];
+      z[ -5] = z[ -5] + z[-13];
+      z[-12] = k11;
+      z[-13] = k00;
+
+      k00    = z[-14] - z[ -6];  // reverse to avoid a unary negation
+      k11    = z[ -7] - z[-15];
+      z[ -6] = z[ -6] + z[-14];
+      z[ -7] = z[ -7] + z[-15];
+      z[-14] = MULT31(k00+k11, A2);
+      z[-15] = MULT31(k00-k11, A2);
+
+      iter_54_fixed(z);
+      iter_54_fixed(z-8);
+      z -= 16;
+   }
+}
+
+// transforms the float spectrum in buffer[0..n/2) into n fixed-point
+// samples in out; unlike the float version this isn't in place, which
+// keeps the two types in separate memory
+static void inverse_mdct_fixed(float *buffer, int32 *out, int n, vorb *f, int blocktype)
+{
+   int n2 = n >> 1, n4 = n >> 2, n8 = n >> 3, l;
+   int ld;
+   int save_point = temp_alloc_save(f);
+   int32 *buf2 = (int32 *) temp_alloc(f, n2 * sizeof(*buf2));
+   int32 *u=NULL,*v=NULL;
+   int32 *A = f->A[blocktype];
+
+   // copy and reflect spectral data, step 0, and conversion to fixed point
+   {
+      int32 *d, *AA;
+      float *e, *e_stop;
+      d = &buf2[n2-2];
+      AA = A;
+      e = &buffer[0];
+      e_stop = &buffer[n2];
+      while (e != e_stop) {
+         int32 e0 = spectrum_to_fixed(e[0]), e2 = spectrum_to_fixed(e[2]);
+         d[1] = MULT31(e0, AA[0]) - MULT31(e2, AA[1]);
+         d[0] = MULT31(e0, AA[1]) + MULT31(e2, AA[0]);
+         d -= 2;
+         AA += 2;
+         e += 4;
+      }
+
+      e = &buffer[n2-3];
+      while (d >= buf2) {
+         int32 e0 = spectrum_to_fixed(e[0]), e2 = spectrum_to_fixed(e[2]);
+         d[1] = MULT31(e0, AA[1]) - MULT31(e2, AA[0]);
+         d[0] = -MULT31(e2, AA[1]) - MULT31(e0, AA[0]);
+         d -= 2;
+         AA += 2;
+         e -= 4;
+      }
+   }
+
+   u = out;
+   v = buf2;
+
+   // step 2
+   {
+      int32 *AA = &A[n2-8];
+      int32 *d0,*d1, *e0, *e1;
+
+      e0 = &v[n4];
+      e1 = &v[0];
+
+      d0 = &u[n4];
+      d1 = &u[0];
+
+      while (AA >= A) {
+         int32 v40_20, v41_21;
+
+         v41_21 = e0[1] - e1[1];
+         v40_20 = e0[0] - e1[0];
+         d0[1]  = e0[1] + e1[1];
+         d0[0]  = e0[0] + e1[0];
+         d1[1]  = MULT31(v41_21, AA[4]) - MULT31(v40_20, AA[5]);
+         d1[0]  = MULT31(v40_20, AA[4]) + MULT31(v41_21, AA[5]);
+
+         v41_21 = e0[3] - e1[3];
+         v40_20 = e0[2] - e1[2];
+         d0[3]  = e0[3] + e1[3];
+         d0[2]  = e0[2] + e1[2];
+         d1[3]  = MULT31(v41_21, AA[0]) - MULT31(v40_20, AA[1]);
+         d1[2]  = MULT31(v40_20, AA[0]) + MULT31(v41_21, AA[1]);
+
+         AA -= 8;
+
+         d0 += 4;
+         d1 += 4;
+         e0 += 4;
+         e1 += 4;
+      }
+   }
+
+   // step 3
+   ld = ilog(n) - 1; // ilog is off-by-one from normal definitions
+
+   imdct_step3_iter0_loop_fixed(n >> 4, u, n2-1-n4*0, -(n >> 3), A);
+   imdct_step3_iter0_loop_fixed(n >> 4, u, n2-1-n4*1, -(n >> 3), A);
+
+   imdct_step3_inner_r_loop_fixed(n >> 5, u, n2-1 - n8*0, -(n >> 4), A, 16);
+   imdct_step3_inner_r_loop_fixed(n >> 5, u, n2-1 - n8*1, -(n >> 4), A, 16);
+   imdct_step3_inner_r_loop_fixed(n >> 5, u, n2-1 - n8*2, -(n >> 4), A, 16);
+   imdct_step3_inner_r_loop_fixed(n >> 5, u, n2-1 - n8*3, -(n >> 4), A, 16);
+
+   l=2;
+   for (; l < (ld-3)>>1; ++l) {
+      int k0 = n >> (l+2), k0_2 = k0>>1;
+      int lim = 1 << (l+1);
+      int i;
+      for (i=0; i < lim; ++i)
+         imdct_step3_inner_r_loop_fixed(n >> (l+4), u, n2-1 - k0*i, -k0_2, A, 1 << (l+3));
+   }
+
+   for (; l < ld-6; ++l) {
+      int k0 = n >> (l+2), k1 = 1 << (l+3), k0_2 = k0>>1;
+      int rlim = n >> (l+6), r;
+      int lim = 1 << (l+1);
+      int i_off;
+      int32 *A0 = A;
+      i_off = n2-1;
+      for (r=rlim; r > 0; --r) {
+         imdct_step3_inner_s_loop_fixed(lim, u, i_off, -k0_2, A0, k1, k0);
+         A0 += k1*4;
+         i_off -= 8;
+      }
+   }
+
+   imdct_step3_inner_s_loop_ld654_fixed(n >> 5, u, n2-1, A, n);
+
+   // step 4, 5, and 6
+   {
+      uint16 *bitrev = f->bit_reverse[blocktype];
+      int32 *d0 = &v[n4-4];
+      int32 *d1 = &v[n2-4];
+      while (d0 >= v) {
+         int k4;
+
+         k4 = bitrev[0];
+         d1[3] = u[k4+0];
+         d1[2] = u[k4+1];
+         d0[3] = u[k4+2];
+         d0[2] = u[k4+3];
+
+         k4 = bitrev[1];
+         d1[1] = u[k4+0];
+         d1[0] = u[k4+1];
+         d0[1] = u[k4+2];
+         d0[0] = u[k4+3];
+
+         d0 -= 4;
+         d1 -= 4;
+         bitrev += 2;
+      }
+   }
+
+   // step 7
+   {
+      int32 *C = f->C[blocktype];
+      int32 *d, *e;
+
+      d = v;
+      e = v + n2 - 4;
+
+      while (d < e) {
+         int32 a02,a11,b0,b1,b2,b3;
+
+         a02 = d[0] - e[2];
+         a11 = d[1] + e[3];
+
+         b0 = MULT31(C[1], a02) + MULT31(C[0], a11);
+         b1 = MULT31(C[1], a11) - MULT31(C[0], a02);
+
+         b2 = d[0] + e[ 2];
+         b3 = d[1] - e[ 3];
+
+         d[0] = b2 + b0;
+         d[1] = b3 + b1;
+         e[2] = b2 - b0;
+         e[3] = b1 - b3;
+
+         a02 = d[2] - e[0];
+         a11 = d[3] + e[1];
+
+         b0 = MULT31(C[3], a02) + MULT31(C[2], a11);
+         b1 = MULT31(C[3], a11) - MULT31(C[2], a02);
+
+         b2 = d[2] + e[ 0];
+         b3 = d[3] - e[ 1];
+
+         d[2] = b2 + b0;
+         d[3] = b3 + b1;
+         e[0] = b2 - b0;
+         e[1] = b1 - b3;
+
+         C += 4;
+         d += 4;
+         e -= 4;
+      }
+   }
+
+   // step 8+decode
+   {
+      int32 *d0,*d1,*d2,*d3;
+
+      int32 *B = f->B[blocktype] + n2 - 8;
+      int32 *e = buf2 + n2 - 8;
+      d0 = &out[0];
+      d1 = &out[n2-4];
+      d2 = &out[n2];
+      d3 = &out[n-4];
+      while (e >= v) {
+         int32 p0,p1,p2,p3;
+
+         p3 =  MULT31(e[6], B[7]) - MULT31(e[7], B[6]);
+         p2 = -MULT31(e[6], B[6]) - MULT31(e[7], B[7]);
+
+         d0[0] =   p3;
+         d1[3] = - p3;
+         d2[0] =   p2;
+         d3[3] =   p2;
+
+         p1 =  MULT31(e[4], B[5]) - MULT31(e[5], B[4]);
+         p0 = -MULT31(e[4], B[4]) - MULT31(e[5], B[5]);
+
+         d0[1] =   p1;
+         d1[2] = - p1;
+         d2[1] =   p0;
+         d3[2] =   p0;
+
+         p3 =  MULT31(e[2], B[3]) - MULT31(e[3], B[2]);
+         p2 = -MULT31(e[2], B[2]) - MULT31(e[3], B[3]);
+
+         d0[2] =   p3;
+         d1[1] = - p3;
+         d2[2] =   p2;
+         d3[1] =   p2;
+
+         p1 =  MULT31(e[0], B[1]) - MULT31(e[1], B[0]);
+         p0 = -MULT31(e[0], B[0]) - MULT31(e[1], B[1]);
+
+         d0[3] =   p1;
+         d1[0] = - p1;
+         d2[3] =   p0;
+         d3[0] =   p0;
+
+         B -= 8;
+         e -= 8;
+         d0 += 4;
+         d2 += 4;
+         d1 -= 4;
+         d3 -= 4;
+      }
+   }
+
+   temp_free(f,buf2);
+   temp_alloc_restore(f,save_point);
+}
+#endif // STB_VORBIS_FIXED_POINT
+
+#if 0
+// this is the original version of the above code, if you want to optimize it from scratch
+void inverse_mdct_naive(float *buffer, int n)
+{
+   float s;
+   float A[1 << 12], B[1 << 12], C[1 << 11];
+   int i,k,k2,k4, n2 = n >> 1, n4 = n >> 2, n8 = n >> 3, l;
+   int n3_4 = n - n4, ld;
+   // how can they claim this only uses N words?!
+   // oh, because they're only used sparsely, whoops
+   float u[1 << 13], X[1 << 13], v[1 << 13], w[1 << 13];
+   // set up twiddle factors
+
+   for (k=k2=0; k < n4; ++k,k2+=2) {
+      A[k2  ] = (float)  cos(4*k*M_PI/n);
+      A[k2+1] = (float) -sin(4*k*M_PI/n);
+      B[k2  ] = (float)  cos((k2+1)*M_PI/n/2);
+      B[k2+1] = (float)  sin((k2+1)*M_PI/n/2);
+   }
+   for (k=k2=0; k < n8; ++k,k2+=2) {
+      C[k2  ] = (float)  cos(2*(k2+1)*M_PI/n);
+      C[k2+1] = (float) -sin(2*(k2+1)*M_PI/n);
+   }
+
+   // IMDCT algorithm from "The use of multirate filter banks for coding of high quality digital audio"
+   // Note there are bugs in that pseudocode, presumably due to them attempting
+   // to rename the arrays nicely rather than representing the way their actual
+   // implementation bounces buffers back and forth. As a result, even in the
+   // "some formulars corrected" version, a direct implementation fails. These
+   // are noted below as "paper bug".
+
+   // copy and reflect spectral data
+   for (k=0; k < n2; ++k) u[k] = buffer[k];
+   for (   ; k < n ; ++k) u[k] = -buffer[n - k - 1];
+   // kernel from paper
+   // step 1
+   for (k=k2=k4=0; k < n4; k+=1, k2+=2, k4+=4) {
+      v[n-k4-1] = (u[k4] - u[n-k4-1]) * A[k2]   - (u[k4+2] - u[n-k4-3])*A[k2+1];
+      v[n-k4-3] = (u[k4] - u[n-k4-1]) * A[k2+1] + (u[k4+2] - u[n-k4-3])*A[k2];
+   }
+   // step 2
+   for (k=k4=0; k < n8; k+=1, k4+=4) {
+      w[n2+3+k4] = v[n2+3+k4] + v[k4+3];
+      w[n2+1+k4] = v[n2+1+k4] + v[k4+1];
+      w[k4+3]    = (v[n2+3+k4] - v[k4+3])*A[n2-4-k4] - (v[n2+1+k4]-v[k4+1])*A[n2-3-k4];
+      w[k4+1]    = (v[n2+1+k4] - v[k4+1])*A[n2-4-k4] + (v[n2+3+k4]-v[k4+3])*A[n2-3-k4];
+   }
+   // step 3
+   ld = ilog(n) - 1; // ilog is off-by-one from normal definitions
+   for (l=0; l < ld-3; ++l) {
+      int k0 = n >> (l+2), k1 = 1 << (l+3);
+      int rlim = n >> (l+4), r4, r;
+      int s2lim = 1 << (l+2), s2;
+      for (r=r4=0; r < rlim; r4+=4,++r) {
+         for (s2=0; s2 < s2lim; s2+=2) {
+            u[n-1-k0*s2-r4] = w[n-1-k0*s2-r4] + w[n-1-k0*(s2+1)-r4];
+            u[n-3-k0*s2-r4] = w[n-3-k0*s2-r4] + w[n-3-k0*(s2+1)-r4];
+            u[n-1-k0*(s2+1)-r4] = (w[n-1-k0*s2-r4] - w[n-1-k0*(s2+1)-r4]) * A[r*k1]
+                                - (w[n-3-k0*s2-r4] - w[n-3-k0*(s2+1)-r4]) * A[r*k1+1];
+            u[n-3-k0*(s2+1)-r4] = (w[n-3-k0*s2-r4] - w[n-3-k0*(s2+1)-r4]) * A[r*k1]
+                                + (w[n-1-k0*s2-r4] - w[n-1-k0*(s2+1)-r4]) * A[r*k1+1];
+         }
+      }
+      if (l+1 < ld-3) {
+         // paper bug: ping-ponging of u&w here is omitted
+         memcpy(w, u, sizeof(u));
+      }
+   }
+
+   // step 4
+   for (i=0; i < n8; ++i) {
+      int j = bit_reverse(i) >> (32-ld+3);
+      assert(j < n8);
+      if (i == j) {
+         // paper bug: original code probably swapped in place; if copying,
+         //            need to directly copy in this case
+         int i8 = i << 3;
+         v[i8+1] = u[i8+1];
+         v[i8+3] = u[i8+3];
+         v[i8+5] = u[i8+5];
+         v[i8+7] = u[i8+7];
+      } else if (i < j) {
+         int i8 = i << 3, j8 = j << 3;
+         v[j8+1] = u[i8+1], v[i8+1] = u[j8 + 1];
+         v[j8+3] = u[i8+3], v[i8+3] = u[j8 + 3];
+         v[j8+5] = u[i8+5], v[i8+5] = u[j8 + 5];
+         v[j8+7] = u[i8+7], v[i8+7] = u[j8 + 7];
+      }
+   }
+   // step 5
+   for (k=0; k < n2; ++k) {
+      w[k] = v[k*2+1];
+   }
+   // step 6
+   for (k=k2=k4=0; k < n8; ++k, k2 += 2, k4 += 4) {
+      u[n-1-k2] = w[k4];
+      u[n-2-k2] = w[k4+1];
+      u[n3_4 - 1 - k2] = w[k4+2];
+      u[n3_4 - 2 - k2] = w[k4+3];
+   }
+   // step 7
+   for (k=k2=0; k < n8; ++k, k2 += 2) {
+      v[n2 + k2 ] = ( u[n2 + k2] + u[n-2-k2] + C[k2+1]*(u[n2+k2]-u[n-2-k2]) + C[k2]*(u[n2+k2+1]+u[n-2-k2+1]))/2;
+      v[n-2 - k2] = ( u[n2 + k2] + u[n-2-k2] - C[k2+1]*(u[n2+k2]-u[n-2-k2]) - C[k2]*(u[n2+k2+1]+u[n-2-k2+1]))/2;
+      v[n2+1+ k2] = ( u[n2+1+k2] - u[n-1-k2] + C[k2+1]*(u[n2+1+k2]+u[n-1-k2]) - C[k2]*(u[n2+k2]-u[n-2-k2]))/2;
+      v[n-1 - k2] = (-u[n2+1+k2] + u[n-1-k2] + C[k2+1]*(u[n2+1+k2]+u[n-1-k2]) - C[k2]*(u[n2+k2]-u[n-2-k2]))/2;
+   }
+   // step 8
+   for (k=k2=0; k < n4; ++k,k2 += 2) {
+      X[k]      = v[k2+n2]*B[k2  ] + v[k2+1+n2]*B[k2+1];
+      X[n2-1-k] = v[k2+n2]*B[k2+1] - v[k2+1+n2]*B[k2  ];
+   }
+
+   // decode kernel to output
+   // determined the following value experimentally
+   // (by first figuring out what made inverse_mdct_slow work); then matching that here
+   // (probably vorbis encoder premultiplies by n or n/2, to save it on the decoder?)
+   s = 0.5; // theoretically would be n4
+
+   // [[[ note! the s value of 0.5 is compensated for by the B[] in the current code,
+   //     so it needs to use the "old" B values to behave correctly, or else
+   //     set s to 1.0 ]]]
+   for (i=0; i < n4  ; ++i) buffer[i] = s * X[i+n4];
+   for (   ; i < n3_4; ++i) buffer[i] = -s * X[n3_4 - i - 1];
+   for (   ; i < n   ; ++i) buffer[i] = -s * X[i - n3_4];
+}
+#endif
+
+static TRIGTYPE *get_window(vorb *f, int len)
+{
+   len <<= 1 + f->half_rate;
+   if (len == f->blocksize_0) return f->window[0];
+   if (len == f->blocksize_1) return f->window[1];
+   return NULL;
+}
+
+#ifndef STB_VORBIS_NO_DEFER_FLOOR
+typedef int16 YTYPE;
+#else
+typedef int YTYPE;
+#endif
+static int do_floor(vorb *f, Mapping *map, int i, int n, float *target, YTYPE *finalY, uint8 *step2_flag)
+{
+   int n2 = n >> 1;
+   int s = map->chan[i].mux, floor;
+   floor = map->submap_floor[s];
+   if (f->floor_types[floor] == 0) {
+      return error(f, VORBIS_invalid_stream);
+   } else {
+      Floor1 *g = &f->floor_config[floor].floor1;
+      int j,q;
       int lx = 0, ly = finalY[0] * g->floor1_multiplier;
       for (q=1; q < g->values; ++q) {
          j = g->sorted_order[q];
@@ -3357,10 +3970,29 @@ static int vorbis_decode_packet_rest(vorb *f, int *len, Mode *m, int left_start,
    }
 #endif
 
+   // mix down in the frequency domain, so one inverse MDCT serves all
+   // channels; at half rate only the lower half of the spectrum is kept
+   if (f->out_channels < f->channels) {
+      int nc = n2 >> f->half_rate;
+      float scale = 1.0f / f->channels;
+      float *out = f->channel_buffers[0];
+      for (i=1; i < f->channels; ++i) {
+         float *c = f->channel_buffers[i];
+         for (j=0; j < nc; ++j)
+            out[j] += c[j];
+      }
+      for (j=0; j < nc; ++j)
+         out[j] *= scale;
+   }
+
 // INVERSE MDCT
    CHECK(f);
-   for (i=0; i < f->channels; ++i)
-      inverse_mdct(f->channel_buffers[i], n, f, m->blockflag);
+   for (i=0; i < f->out_channels; ++i)
+      #ifdef STB_VORBIS_FIXED_POINT
+      inverse_mdct_fixed(f->channel_buffers[i], f->pcm_buffers[i], n >> f->half_rate, f, m->blockflag);
+      #else
+      inverse_mdct(f->channel_buffers[i], n >> f->half_rate, f, m->blockflag);
+      #endif
    CHECK(f);
 
    // this shouldn't be necessary, unless we exited on an error
@@ -3438,7 +4070,12 @@ static int vorbis_decode_packet(vorb *f, int *len, int *p_left, int *p_right)
 {
    int mode, left_end, right_end;
    if (!vorbis_decode_initial(f, p_left, &left_end, p_right, &right_end, &mode)) return 0;
-   return vorbis_decode_packet_rest(f, len, f->mode_config + mode, *p_left, left_end, *p_right, right_end, p_left);
+   if (!vorbis_decode_packet_rest(f, len, f->mode_config + mode, *p_left, left_end, *p_right, right_end, p_left)) return 0;
+   // everything past here works in output samples
+   *len     >>= f->half_rate;
+   *p_left  >>= f->half_rate;
+   *p_right >>= f->half_rate;
+   return 1;
 }
 
 static int vorbis_finish_frame(stb_vorbis *f, int len, int left, int right)
@@ -3455,13 +4092,18 @@ static int vorbis_finish_frame(stb_vorbis *f, int len, int left, int right)
    // mixin from previous window
    if (f->previous_length) {
       int i,j, n = f->previous_length;
-      float *w = get_window(f, n);
+      TRIGTYPE *w = get_window(f, n);
       if (w == NULL) return 0;
-      for (i=0; i < f->channels; ++i) {
+      for (i=0; i < f->out_channels; ++i) {
+         PCMTYPE *pcm = PCM_BUFFERS(f)[i];
          for (j=0; j < n; ++j)
-            f->channel_buffers[i][left+j] =
-               f->channel_buffers[i][left+j]*w[    j] +
+            #ifdef STB_VORBIS_FIXED_POINT
+            pcm[left+j] = MULT31(pcm[left+j], w[j]) + MULT31(f->previous_window[i][j], w[n-1-j]);
+            #else
+            pcm[left+j] =
+               pcm[left+j]*w[    j] +
                f->previous_window[i][     j]*w[n-1-j];
+            #endif
       }
    }
 
@@ -3476,9 +4118,9 @@ static int vorbis_finish_frame(stb_vorbis *f, int len, int left, int right)
    // channel_buffers couldn't be temp mem (although they're NOT
    // currently temp mem, they could be (unless we want to level
    // performance by spreading out the computation))
-   for (i=0; i < f->channels; ++i)
+   for (i=0; i < f->out_channels; ++i)
       for (j=0; right+j < len; ++j)
-         f->previous_window[i][j] = f->channel_buffers[i][right+j];
+         f->previous_window[i][j] = PCM_BUFFERS(f)[i][right+j];
 
    if (!prev)
       // there was no previous packet, so this data isn't valid...
@@ -3503,6 +4145,24 @@ static int vorbis_pump_first_frame(stb_vorbis *f)
    return res;
 }
 
+#ifdef STB_VORBIS_FIXED_POINT
+#define PCM_TO_FLOAT(x)   ((x) * (1.0f / (1 << FIX_PCM_BITS)))
+
+// the float output functions hand out channel_buffers, which are free
+// again once the frame's spectrum has been through the inverse MDCT
+static float **float_outputs(stb_vorbis *f, int len)
+{
+   int i,j;
+   for (i=0; i < f->out_channels; ++i)
+      for (j=0; j < len; ++j)
+         f->channel_buffers[i][j] = PCM_TO_FLOAT(f->outputs[i][j]);
+   return f->channel_buffers;
+}
+#else
+#define PCM_TO_FLOAT(x)          (x)
+#define float_outputs(f,len)     ((f)->outputs)
+#endif
+
 #ifndef STB_VORBIS_NO_PUSHDATA_API
 static int is_whole_packet_present(stb_vorbis *f, int end_page)
 {
@@ -3569,11 +4229,191 @@ static int is_whole_packet_present(stb_vorbis *f, int end_page)
 }
 #endif // !STB_VORBIS_NO_PUSHDATA_API
 
+// free the header info decoded from the setup packet
+static void free_setup_tables(vorb *p)
+{
+   int i,j;
+   if (p->residue_config) {
+      for (i=0; i < p->residue_count; ++i) {
+         Residue *r = p->residue_config+i;
+         if (r->classdata) {
+            for (j=0; j < p->codebooks[r->classbook].entries; ++j)
+               setup_free(p, r->classdata[j]);
+            setup_free(p, r->classdata);
+         }
+         setup_free(p, r->residue_books);
+      }
+   }
+
+   if (p->codebooks) {
+      CHECK(p);
+      for (i=0; i < p->codebook_count; ++i) {
+         Codebook *c = p->codebooks + i;
+         setup_free(p, c->codeword_lengths);
+         setup_free(p, c->multiplicands);
+         setup_free(p, c->codewords);
+         setup_free(p, c->sorted_codewords);
+         // c->sorted_values[-1] is the first entry in the array
+         setup_free(p, c->sorted_values ? c->sorted_values-1 : NULL);
+      }
+      setup_free(p, p->codebooks);
+   }
+   setup_free(p, p->floor_config);
+   setup_free(p, p->residue_config);
+   if (p->mapping) {
+      for (i=0; i < p->mapping_count; ++i)
+         setup_free(p, p->mapping[i].chan);
+      setup_free(p, p->mapping);
+   }
+}
+
+#if STB_VORBIS_SETUP_CACHE > 0
+static SetupCacheEntry setup_cache[STB_VORBIS_SETUP_CACHE];
+static uint32 setup_cache_clock;
+
+static void setup_cache_share(vorb *f, SetupCacheEntry *e)
+{
+   f->setup_cache = e;
+   f->codebook_count = e->codebook_count;
+   f->codebooks = e->codebooks;
+   f->floor_count = e->floor_count;
+   memcpy(f->floor_types, e->floor_types, sizeof(f->floor_types));
+   f->floor_config = e->floor_config;
+   f->residue_count = e->residue_count;
+   memcpy(f->residue_types, e->residue_types, sizeof(f->residue_types));
+   f->residue_config = e->residue_config;
+   f->mapping_count = e->mapping_count;
+   f->mapping = e->mapping;
+   f->mode_count = e->mode_count;
+   memcpy(f->mode_config, e->mode_config, sizeof(f->mode_config));
+   ++e->refcount;
+   e->last_used = ++setup_cache_clock;
+}
+
+static void setup_cache_evict(SetupCacheEntry *e)
+{
+   // free_setup_tables() only needs the tables and a heap allocator
+   vorb p;
+   memset(&p, 0, sizeof(p));
+   p.codebook_count = e->codebook_count;
+   p.codebooks = e->codebooks;
+   p.floor_config = e->floor_config;
+   p.residue_count = e->residue_count;
+   p.residue_config = e->residue_config;
+   p.mapping_count = e->mapping_count;
+   p.mapping = e->mapping;
+   free_setup_tables(&p);
+   memset(e, 0, sizeof(*e));
+}
+
+// the entry to reuse for a new setup: an empty one, else the least recently
+// used setup no open file needs
+static SetupCacheEntry *setup_cache_victim(void)
+{
+   SetupCacheEntry *e = NULL;
+   int i;
+   for (i=0; i < STB_VORBIS_SETUP_CACHE; ++i) {
+      SetupCacheEntry *c = &setup_cache[i];
+      if (c->refcount == 0 && (e == NULL || !c->codebooks || (e->codebooks && c->last_used < e->last_used)))
+         e = c;
+   }
+   return e;
+}
+
+// hash the setup packet f is at and look it up. on a hit f shares the cached
+// tables and the packet has been consumed; on a miss f is rewound to the
+// start of the packet for start_decoder() to parse, and the hashes are
+// returned for setup_cache_insert()
+static int setup_cache_lookup(vorb *f, uint32 *crc, uint32 *hash, int *length)
+{
+   vorb saved = *f;
+   unsigned int pos = stb_vorbis_get_file_offset(f);
+   SetupCacheEntry *e;
+   int i, c;
+   *crc = 0;
+   *hash = 2166136261u; // FNV-1a
+   *length = 0;
+   while ((c = get8_packet(f)) != EOP) {
+      *crc = crc32_update(*crc, (uint8) c);
+      *hash = (*hash ^ c) * 16777619u;
+      ++*length;
+   }
+   for (i=0; i < STB_VORBIS_SETUP_CACHE; ++i) {
+      e = &setup_cache[i];
+      if (e->codebooks && e->length == *length && e->crc == *crc &&
+          e->hash == *hash && e->channels == f->channels) {
+         flush_packet(f);
+         setup_cache_share(f, e);
+         // count the tables as if f had decoded them, for
+         // stb_vorbis_get_alloc_size()
+         f->setup_memory_required += e->setup_memory_required;
+         if (e->setup_temp_memory_required > f->setup_temp_memory_required)
+            f->setup_temp_memory_required = e->setup_temp_memory_required;
+         return TRUE;
+      }
+   }
+   // make room before decoding, so the old tables aren't held alongside
+   // the new ones. tables decoded into an alloc_buffer aren't cached
+   if (!f->alloc.alloc_buffer) {
+      e = setup_cache_victim();
+      if (e && e->codebooks) setup_cache_evict(e);
+   }
+   *f = saved;
+   set_file_offset(f, pos); // a no-op unless reading from a FILE
+   return FALSE;
+}
+
+// hand the tables f just decoded, setup_size bytes of setup memory, to the
+// cache
+static void setup_cache_insert(vorb *f, uint32 crc, uint32 hash, int length, int longest_floorlist,
+                               unsigned int setup_size)
+{
+   SetupCacheEntry *e = setup_cache_victim();
+   if (e == NULL) return; // every entry is in use; f keeps its own tables
+   if (e->codebooks) setup_cache_evict(e);
+   e->crc = crc;
+   e->hash = hash;
+   e->length = length;
+   e->channels = f->channels;
+   e->longest_floorlist = longest_floorlist;
+   e->setup_memory_required = setup_size;
+   e->setup_temp_memory_required = f->setup_temp_memory_required;
+   e->codebook_count = f->codebook_count;
+   e->codebooks = f->codebooks;
+   e->floor_count = f->floor_count;
+   memcpy(e->floor_types, f->floor_types, sizeof(e->floor_types));
+   e->floor_config = f->floor_config;
+   e->residue_count = f->residue_count;
+   memcpy(e->residue_types, f->residue_types, sizeof(e->residue_types));
+   e->residue_config = f->residue_config;
+   e->mapping_count = f->mapping_count;
+   e->mapping = f->mapping;
+   e->mode_count = f->mode_count;
+   memcpy(e->mode_config, f->mode_config, sizeof(e->mode_config));
+   setup_cache_share(f, e);
+}
+#endif
+
+void stb_vorbis_flush_setup_cache(void)
+{
+   #if STB_VORBIS_SETUP_CACHE > 0
+   int i;
+   for (i=0; i < STB_VORBIS_SETUP_CACHE; ++i)
+      if (setup_cache[i].codebooks && setup_cache[i].refcount == 0)
+         setup_cache_evict(&setup_cache[i]);
+   #endif
+}
+
 static int start_decoder(vorb *f)
 {
    uint8 header[6], x,y;
    int len,i,j,k, max_submaps = 0;
    int longest_floorlist=0;
+   #if STB_VORBIS_SETUP_CACHE > 0
+   uint32 setup_crc=0, setup_hash=0;
+   int setup_length=0;
+   unsigned int setup_start;
+   #endif
 
    // first page, first packet
 
@@ -3609,6 +4449,7 @@ static int start_decoder(vorb *f)
    if (get32(f) != 0)                               return error(f, VORBIS_invalid_first_page);
    f->channels = get8(f); if (!f->channels)         return error(f, VORBIS_invalid_first_page);
    if (f->channels > STB_VORBIS_MAX_CHANNELS)       return error(f, VORBIS_too_many_channels);
+   f->out_channels = f->channels;
    f->sample_rate = get32(f); if (!f->sample_rate)  return error(f, VORBIS_invalid_first_page);
    get32(f); // bitrate_maximum
    get32(f); // bitrate_nominal
@@ -3655,6 +4496,14 @@ static int start_decoder(vorb *f)
 
    crc32_init(); // always init it, to avoid multithread race conditions
 
+   #if STB_VORBIS_SETUP_CACHE > 0
+   setup_start = f->setup_memory_required;
+   if (setup_cache_lookup(f, &setup_crc, &setup_hash, &setup_length)) {
+      longest_floorlist = f->setup_cache->longest_floorlist;
+      goto setup_done;
+   }
+   #endif
+
    if (get8_packet(f) != VORBIS_packet_setup)       return error(f, VORBIS_invalid_setup);
    for (i=0; i < 6; ++i) header[i] = get8_packet(f);
    if (!vorbis_validate(header))                    return error(f, VORBIS_invalid_setup);
@@ -4076,14 +4925,27 @@ static int start_decoder(vorb *f)
 
    flush_packet(f);
 
+   #if STB_VORBIS_SETUP_CACHE > 0
+   if (!f->alloc.alloc_buffer)
+      setup_cache_insert(f, setup_crc, setup_hash, setup_length, longest_floorlist,
+                         f->setup_memory_required - setup_start);
+setup_done:
+   #endif
+
    f->previous_length = 0;
 
    for (i=0; i < f->channels; ++i) {
       f->channel_buffers[i] = (float *) setup_malloc(f, sizeof(float) * f->blocksize_1);
-      f->previous_window[i] = (float *) setup_malloc(f, sizeof(float) * f->blocksize_1/2);
-      f->finalY[i]          = (int16 *) setup_malloc(f, sizeof(int16) * longest_floorlist);
-      if (f->channel_buffers[i] == NULL || f->previous_window[i] == NULL || f->finalY[i] == NULL) return error(f, VORBIS_outofmem);
+      if (f->channel_buffers[i] == NULL) return error(f, VORBIS_outofmem);
       memset(f->channel_buffers[i], 0, sizeof(float) * f->blocksize_1);
+      #ifdef STB_VORBIS_FIXED_POINT
+      f->pcm_buffers[i]     = (int32 *) setup_malloc(f, sizeof(int32) * f->blocksize_1);
+      if (f->pcm_buffers[i] == NULL) return error(f, VORBIS_outofmem);
+      memset(f->pcm_buffers[i], 0, sizeof(int32) * f->blocksize_1);
+      #endif
+      f->previous_window[i] = (PCMTYPE *) setup_malloc(f, sizeof(PCMTYPE) * f->blocksize_1/2);
+      f->finalY[i]          = (int16 *) setup_malloc(f, sizeof(int16) * longest_floorlist);
+      if (f->previous_window[i] == NULL || f->finalY[i] == NULL) return error(f, VORBIS_outofmem);
       #ifdef STB_VORBIS_NO_DEFER_FLOOR
       f->floor_buffers[i]   = (float *) setup_malloc(f, sizeof(float) * f->blocksize_1/2);
       if (f->floor_buffers[i] == NULL) return error(f, VORBIS_outofmem);
@@ -4148,42 +5010,19 @@ static int start_decoder(vorb *f)
 
 static void vorbis_deinit(stb_vorbis *p)
 {
-   int i,j;
-   if (p->residue_config) {
-      for (i=0; i < p->residue_count; ++i) {
-         Residue *r = p->residue_config+i;
-         if (r->classdata) {
-            for (j=0; j < p->codebooks[r->classbook].entries; ++j)
-               setup_free(p, r->classdata[j]);
-            setup_free(p, r->classdata);
-         }
-         setup_free(p, r->residue_books);
-      }
-   }
-
-   if (p->codebooks) {
-      CHECK(p);
-      for (i=0; i < p->codebook_count; ++i) {
-         Codebook *c = p->codebooks + i;
-         setup_free(p, c->codeword_lengths);
-         setup_free(p, c->multiplicands);
-         setup_free(p, c->codewords);
-         setup_free(p, c->sorted_codewords);
-         // c->sorted_values[-1] is the first entry in the array
-         setup_free(p, c->sorted_values ? c->sorted_values-1 : NULL);
-      }
-      setup_free(p, p->codebooks);
-   }
-   setup_free(p, p->floor_config);
-   setup_free(p, p->residue_config);
-   if (p->mapping) {
-      for (i=0; i < p->mapping_count; ++i)
-         setup_free(p, p->mapping[i].chan);
-      setup_free(p, p->mapping);
-   }
+   int i;
+   #if STB_VORBIS_SETUP_CACHE > 0
+   if (p->setup_cache)
+      --p->setup_cache->refcount;
+   else
+   #endif
+      free_setup_tables(p);
    CHECK(p);
    for (i=0; i < p->channels && i < STB_VORBIS_MAX_CHANNELS; ++i) {
       setup_free(p, p->channel_buffers[i]);
+      #ifdef STB_VORBIS_FIXED_POINT
+      setup_free(p, p->pcm_buffers[i]);
+      #endif
       setup_free(p, p->previous_window[i]);
       #ifdef STB_VORBIS_NO_DEFER_FLOOR
       setup_free(p, p->floor_buffers[i]);
@@ -4214,7 +5053,7 @@ static void vorbis_init(stb_vorbis *p, const stb_vorbis_alloc *z)
    memset(p, 0, sizeof(*p)); // NULL out all malloc'd pointers to start
    if (z) {
       p->alloc = *z;
-      p->alloc.alloc_buffer_length_in_bytes = (p->alloc.alloc_buffer_length_in_bytes+3) & ~3;
+      p->alloc.alloc_buffer_length_in_bytes &= ~7;
       p->temp_offset = p->alloc.alloc_buffer_length_in_bytes;
    }
    p->eof = 0;
@@ -4239,15 +5078,60 @@ int stb_vorbis_get_sample_offset(stb_vorbis *f)
 stb_vorbis_info stb_vorbis_get_info(stb_vorbis *f)
 {
    stb_vorbis_info d;
-   d.channels = f->channels;
-   d.sample_rate = f->sample_rate;
+   d.channels = f->out_channels;
+   d.sample_rate = f->sample_rate >> f->half_rate;
    d.setup_memory_required = f->setup_memory_required;
    d.setup_temp_memory_required = f->setup_temp_memory_required;
    d.temp_memory_required = f->temp_memory_required;
-   d.max_frame_size = f->blocksize_1 >> 1;
+   d.max_frame_size = f->blocksize_1 >> (1 + f->half_rate);
    return d;
 }
 
+int stb_vorbis_get_alloc_size(stb_vorbis *f)
+{
+   // the setup memory (this struct included) grows up from the bottom of the
+   // buffer and the temp memory down from the top, so the buffer must hold
+   // all of the one and the most of the other in use at once
+   unsigned int temp = f->setup_temp_memory_required;
+   if (f->temp_memory_required > temp)
+      temp = f->temp_memory_required;
+   return (int) (f->setup_memory_required + ((temp+7) & ~7));
+}
+
+int stb_vorbis_set_decode_flags(stb_vorbis *f, int flags)
+{
+   int b, half = (flags & STB_VORBIS_DECODE_HALF_RATE) != 0;
+   // the inverse MDCT needs at least 64 samples
+   if (half && f->blocksize_0 < 128)
+      return error(f, VORBIS_feature_not_supported);
+
+   if (half != f->half_rate) {
+      // the tables for a half-size block fit in the ones already allocated
+      for (b=0; b < 2; ++b) {
+         int n = f->blocksize[b] >> half;
+         compute_twiddle_factors(n, f->A[b], f->B[b], f->C[b]);
+         compute_window(n, f->window[b]);
+         compute_bitreverse(n, f->bit_reverse[b]);
+      }
+      f->half_rate = half;
+   }
+   f->out_channels = (flags & STB_VORBIS_DECODE_MONO) ? 1 : f->channels;
+
+   // samples buffered so far are in the old layout
+   f->channel_buffer_start = f->channel_buffer_end = 0;
+   if (IS_PUSH_MODE(f)) {
+      #ifndef STB_VORBIS_NO_PUSHDATA_API
+      stb_vorbis_flush_pushdata(f);
+      #endif
+      return 1;
+   }
+   #ifndef STB_VORBIS_NO_PULLDATA_API
+   return stb_vorbis_seek_start(f);
+   #else
+   return 1;
+   #endif
+}
+
 int stb_vorbis_get_error(stb_vorbis *f)
 {
    int e = f->error;
@@ -4427,12 +5311,12 @@ int stb_vorbis_decode_frame_pushdata(
 
    // success!
    len = vorbis_finish_frame(f, len, left, right);
-   for (i=0; i < f->channels; ++i)
-      f->outputs[i] = f->channel_buffers[i] + left;
+   for (i=0; i < f->out_channels; ++i)
+      f->outputs[i] = PCM_BUFFERS(f)[i] + left;
 
-   if (channels) *channels = f->channels;
+   if (channels) *channels = f->out_channels;
    *samples = len;
-   *output = f->outputs;
+   *output = float_outputs(f, len);
    return (int) (f->stream - data);
 }
 
@@ -4835,18 +5719,37 @@ int stb_vorbis_seek_frame(stb_vorbis *f, unsigned int sample_number)
    return 1;
 }
 
+// decode the next frame into f->outputs
+static int vorbis_get_frame(stb_vorbis *f)
+{
+   int len, right,left,i;
+   if (IS_PUSH_MODE(f)) return error(f, VORBIS_invalid_api_mixing);
+
+   if (!vorbis_decode_packet(f, &len, &left, &right)) {
+      f->channel_buffer_start = f->channel_buffer_end = 0;
+      return 0;
+   }
+
+   len = vorbis_finish_frame(f, len, left, right);
+   for (i=0; i < f->out_channels; ++i)
+      f->outputs[i] = PCM_BUFFERS(f)[i] + left;
+
+   f->channel_buffer_start = left;
+   f->channel_buffer_end   = left+len;
+   return len;
+}
+
 int stb_vorbis_seek(stb_vorbis *f, unsigned int sample_number)
 {
    if (!stb_vorbis_seek_frame(f, sample_number))
       return 0;
 
    if (sample_number != f->current_loc) {
-      int n;
       uint32 frame_start = f->current_loc;
-      stb_vorbis_get_frame_float(f, &n, NULL);
+      vorbis_get_frame(f);
       assert(sample_number > frame_start);
-      assert(f->channel_buffer_start + (int) (sample_number-frame_start) <= f->channel_buffer_end);
-      f->channel_buffer_start += (sample_number - frame_start);
+      assert(f->channel_buffer_start + (int) ((sample_number-frame_start) >> f->half_rate) <= f->channel_buffer_end);
+      f->channel_buffer_start += (sample_number - frame_start) >> f->half_rate;
    }
 
    return 1;
@@ -4946,23 +5849,9 @@ float stb_vorbis_stream_length_in_seconds(stb_vorbis *f)
 
 int stb_vorbis_get_frame_float(stb_vorbis *f, int *channels, float ***output)
 {
-   int len, right,left,i;
-   if (IS_PUSH_MODE(f)) return error(f, VORBIS_invalid_api_mixing);
-
-   if (!vorbis_decode_packet(f, &len, &left, &right)) {
-      f->channel_buffer_start = f->channel_buffer_end = 0;
-      return 0;
-   }
-
-   len = vorbis_finish_frame(f, len, left, right);
-   for (i=0; i < f->channels; ++i)
-      f->outputs[i] = f->channel_buffers[i] + left;
-
-   f->channel_buffer_start = left;
-   f->channel_buffer_end   = left+len;
-
-   if (channels) *channels = f->channels;
-   if (output)   *output = f->outputs;
+   int len = vorbis_get_frame(f);
+   if (channels) *channels = f->out_channels;
+   if (output)   *output = float_outputs(f, len);
    return len;
 }
 
@@ -5060,7 +5949,12 @@ static int8 channel_position[7][6] =
 };
 
 
-#ifndef STB_VORBIS_NO_FAST_SCALED_FLOAT
+#ifdef STB_VORBIS_FIXED_POINT
+   // the "float" is a PCMTYPE, so this is just a rounding shift
+   #define FAST_SCALED_FLOAT_TO_INT(temp,x,s) (((x) + (1 << (FIX_PCM_BITS-(s)-1))) >> (FIX_PCM_BITS-(s)))
+   #define check_endianness()
+   #define FASTDEF(x)
+#elif !defined(STB_VORBIS_NO_FAST_SCALED_FLOAT)
    typedef union {
       float f;
       int i;
@@ -5078,7 +5972,7 @@ static int8 channel_position[7][6] =
    #define FASTDEF(x)
 #endif
 
-static void copy_samples(short *dest, float *src, int len)
+static void copy_samples(short *dest, PCMTYPE *src, int len)
 {
    int i;
    check_endianness();
@@ -5091,10 +5985,10 @@ static void copy_samples(short *dest, float *src, int len)
    }
 }
 
-static void compute_samples(int mask, short *output, int num_c, float **data, int d_offset, int len)
+static void compute_samples(int mask, short *output, int num_c, PCMTYPE **data, int d_offset, int len)
 {
    #define BUFFER_SIZE  32
-   float buffer[BUFFER_SIZE];
+   PCMTYPE buffer[BUFFER_SIZE];
    int i,j,o,n = BUFFER_SIZE;
    check_endianness();
    for (o = 0; o < len; o += BUFFER_SIZE) {
@@ -5116,10 +6010,10 @@ static void compute_samples(int mask, short *output, int num_c, float **data, in
    }
 }
 
-static void compute_stereo_samples(short *output, int num_c, float **data, int d_offset, int len)
+static void compute_stereo_samples(short *output, int num_c, PCMTYPE **data, int d_offset, int len)
 {
    #define BUFFER_SIZE  32
-   float buffer[BUFFER_SIZE];
+   PCMTYPE buffer[BUFFER_SIZE];
    int i,j,o,n = BUFFER_SIZE >> 1;
    // o is the offset in the source data
    check_endianness();
@@ -5155,7 +6049,7 @@ static void compute_stereo_samples(short *output, int num_c, float **data, int d
    }
 }
 
-static void convert_samples_short(int buf_c, short **buffer, int b_offset, int data_c, float **data, int d_offset, int samples)
+static void convert_samples_short(int buf_c, short **buffer, int b_offset, int data_c, PCMTYPE **data, int d_offset, int samples)
 {
    int i;
    if (buf_c != data_c && buf_c <= 2 && data_c <= 6) {
@@ -5173,15 +6067,14 @@ static void convert_samples_short(int buf_c, short **buffer, int b_offset, int d
 
 int stb_vorbis_get_frame_short(stb_vorbis *f, int num_c, short **buffer, int num_samples)
 {
-   float **output = NULL;
-   int len = stb_vorbis_get_frame_float(f, NULL, &output);
+   int len = vorbis_get_frame(f);
    if (len > num_samples) len = num_samples;
    if (len)
-      convert_samples_short(num_c, buffer, 0, f->channels, output, 0, len);
+      convert_samples_short(num_c, buffer, 0, f->out_channels, f->outputs, 0, len);
    return len;
 }
 
-static void convert_channels_short_interleaved(int buf_c, short *buffer, int data_c, float **data, int d_offset, int len)
+static void convert_channels_short_interleaved(int buf_c, short *buffer, int data_c, PCMTYPE **data, int d_offset, int len)
 {
    int i;
    check_endianness();
@@ -5195,7 +6088,7 @@ static void convert_channels_short_interleaved(int buf_c, short *buffer, int dat
       for (j=0; j < len; ++j) {
          for (i=0; i < limit; ++i) {
             FASTDEF(temp);
-            float f = data[i][d_offset+j];
+            PCMTYPE f = data[i][d_offset+j];
             int v = FAST_SCALED_FLOAT_TO_INT(temp, f,15);//data[i][d_offset+j],15);
             if ((unsigned int) (v + 32768) > 65535)
                v = v < 0 ? -32768 : 32767;
@@ -5209,53 +6102,50 @@ static void convert_channels_short_interleaved(int buf_c, short *buffer, int dat
 
 int stb_vorbis_get_frame_short_interleaved(stb_vorbis *f, int num_c, short *buffer, int num_shorts)
 {
-   float **output;
    int len;
    if (num_c == 1) return stb_vorbis_get_frame_short(f,num_c,&buffer, num_shorts);
-   len = stb_vorbis_get_frame_float(f, NULL, &output);
+   len = vorbis_get_frame(f);
    if (len) {
       if (len*num_c > num_shorts) len = num_shorts / num_c;
-      convert_channels_short_interleaved(num_c, buffer, f->channels, output, 0, len);
+      convert_channels_short_interleaved(num_c, buffer, f->out_channels, f->outputs, 0, len);
    }
    return len;
 }
 
 int stb_vorbis_get_samples_short_interleaved(stb_vorbis *f, int channels, short *buffer, int num_shorts)
 {
-   float **outputs;
    int len = num_shorts / channels;
    int n=0;
-   int z = f->channels;
+   int z = f->out_channels;
    if (z > channels) z = channels;
    while (n < len) {
       int k = f->channel_buffer_end - f->channel_buffer_start;
       if (n+k >= len) k = len - n;
       if (k)
-         convert_channels_short_interleaved(channels, buffer, f->channels, f->channel_buffers, f->channel_buffer_start, k);
+         convert_channels_short_interleaved(channels, buffer, f->out_channels, PCM_BUFFERS(f), f->channel_buffer_start, k);
       buffer += k*channels;
       n += k;
       f->channel_buffer_start += k;
       if (n == len) break;
-      if (!stb_vorbis_get_frame_float(f, NULL, &outputs)) break;
+      if (!vorbis_get_frame(f)) break;
    }
    return n;
 }
 
 int stb_vorbis_get_samples_short(stb_vorbis *f, int channels, short **buffer, int len)
 {
-   float **outputs;
    int n=0;
-   int z = f->channels;
+   int z = f->out_channels;
    if (z > channels) z = channels;
    while (n < len) {
       int k = f->channel_buffer_end - f->channel_buffer_start;
       if (n+k >= len) k = len - n;
       if (k)
-         convert_samples_short(channels, buffer, n, f->channels, f->channel_buffers, f->channel_buffer_start, k);
+         convert_samples_short(channels, buffer, n, f->out_channels, PCM_BUFFERS(f), f->channel_buffer_start, k);
       n += k;
       f->channel_buffer_start += k;
       if (n == len) break;
-      if (!stb_vorbis_get_frame_float(f, NULL, &outputs)) break;
+      if (!vorbis_get_frame(f)) break;
    }
    return n;
 }
@@ -5343,10 +6233,9 @@ int stb_vorbis_decode_memory(const uint8 *mem, int len, int *channels, int *samp
 
 int stb_vorbis_get_samples_float_interleaved(stb_vorbis *f, int channels, float *buffer, int num_floats)
 {
-   float **outputs;
    int len = num_floats / channels;
    int n=0;
-   int z = f->channels;
+   int z = f->out_channels;
    if (z > channels) z = channels;
    while (n < len) {
       int i,j;
@@ -5354,7 +6243,7 @@ int stb_vorbis_get_samples_float_interleaved(stb_vorbis *f, int channels, float
       if (n+k >= len) k = len - n;
       for (j=0; j < k; ++j) {
          for (i=0; i < z; ++i)
-            *buffer++ = f->channel_buffers[i][f->channel_buffer_start+j];
+            *buffer++ = PCM_TO_FLOAT(PCM_BUFFERS(f)[i][f->channel_buffer_start+j]);
          for (   ; i < channels; ++i)
             *buffer++ = 0;
       }
@@ -5362,7 +6251,7 @@ int stb_vorbis_get_samples_float_interleaved(stb_vorbis *f, int channels, float
       f->channel_buffer_start += k;
       if (n == len)
          break;
-      if (!stb_vorbis_get_frame_float(f, NULL, &outputs))
+      if (!vorbis_get_frame(f))
          break;
    }
    return n;
@@ -5370,17 +6259,23 @@ int stb_vorbis_get_samples_float_interleaved(stb_vorbis *f, int channels, float
 
 int stb_vorbis_get_samples_float(stb_vorbis *f, int channels, float **buffer, int num_samples)
 {
-   float **outputs;
    int n=0;
-   int z = f->channels;
+   int z = f->out_channels;
    if (z > channels) z = channels;
    while (n < num_samples) {
       int i;
       int k = f->channel_buffer_end - f->channel_buffer_start;
       if (n+k >= num_samples) k = num_samples - n;
       if (k) {
-         for (i=0; i < z; ++i)
+         for (i=0; i < z; ++i) {
+            #ifdef STB_VORBIS_FIXED_POINT
+            int j;
+            for (j=0; j < k; ++j)
+               buffer[i][n+j] = PCM_TO_FLOAT(f->pcm_buffers[i][f->channel_buffer_start+j]);
+            #else
             memcpy(buffer[i]+n, f->channel_buffers[i]+f->channel_buffer_start, sizeof(float)*k);
+            #endif
+         }
          for (   ; i < channels; ++i)
             memset(buffer[i]+n, 0, sizeof(float) * k);
       }
@@ -5388,7 +6283,7 @@ int stb_vorbis_get_samples_float(stb_vorbis *f, int channels, float **buffer, in
       f->channel_buffer_start += k;
       if (n == num_samples)
          break;
-      if (!stb_vorbis_get_frame_float(f, NULL, &outputs))
+      if (!vorbis_get_frame(f))
          break;
    }
    return n;
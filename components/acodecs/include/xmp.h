@@ -253,7 +253,7 @@ struct xmp_module {
 	int gvl;			/* Global volume */
 
 	struct xmp_pattern **xxp;	/* Patterns */
-	struct xmp_track **xxt;		/* Tracks */
+	struct xmp_track **xxt;		/* Tracks, events packed after load */
 	struct xmp_instrument *xxi;	/* Instruments */
 	struct xmp_sample *xxs;		/* Samples */
 	struct xmp_channel xxc[XMP_MAX_CHANNELS]; /* Channel info */
@@ -339,6 +339,9 @@ EXPORT int         xmp_channel_vol     (xmp_context, int, int);
 EXPORT int         xmp_set_player      (xmp_context, int, int);
 EXPORT int         xmp_get_player      (xmp_context, int);
 EXPORT int         xmp_set_instrument_path (xmp_context, char *);
+EXPORT int         xmp_set_scan_cache_path (xmp_context, char *);
+EXPORT int         xmp_set_sample_spill (xmp_context, char *, int);
+EXPORT int         xmp_set_seek_checkpoints (xmp_context, int, int);
 EXPORT int         xmp_load_module_from_memory (xmp_context, void *, long);
 EXPORT int         xmp_load_module_from_file (xmp_context, void *, long);
 
@@ -2,6 +2,8 @@
 #include <string.h>
 #include <stdint.h>
 #include <assert.h>
+#include <time.h>
+#include <sys/stat.h>
 
 #include <acodecs.h>
 
@@ -11,22 +13,32 @@
 #include <xmp.h>
 #include <dr_wav.h>
 #include <dr_flac.h>
+#include <flac_parallel.h>
 #include <gme.h>
 
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#include <esp_partition.h>
+#endif
+
 static int acodec_mp3_open(void **handle, const char *filename);
 static int acodec_mp3_get_info(void *handle, AudioInfo *info);
 static int acodec_mp3_decode(void *handle, int16_t *buf_out, int num_c, unsigned len);
 static int acodec_mp3_close(void *handle);
+static int acodec_mp3_seek(void *handle, unsigned ms);
+static int acodec_mp3_duration(const char *filename);
 
 static int acodec_ogg_open(void **handle, const char *filename);
 static int acodec_ogg_get_info(void *handle, AudioInfo *info);
 static int acodec_ogg_decode(void *handle, int16_t *buf_out, int num_c, unsigned len);
 static int acodec_ogg_close(void *handle);
+static void acodec_ogg_release(void);
 
 static int acodec_libxmp_open(void **handle, const char *filename);
 static int acodec_libxmp_get_info(void *handle, AudioInfo *info);
 static int acodec_libxmp_decode(void *handle, int16_t *buf_out, int num_c, unsigned len);
 static int acodec_libxmp_close(void *handle);
+static int acodec_libxmp_seek(void *handle, unsigned ms);
 
 static int acodec_drwav_open(void **handle, const char *filename);
 static int acodec_drwav_get_info(void *handle, AudioInfo *info);
@@ -42,12 +54,17 @@ static int acodec_gme_open(void **handle, const char *filename);
 static int acodec_gme_get_info(void *handle, AudioInfo *info);
 static int acodec_gme_decode(void *handle, int16_t *buf_out, int num_c, unsigned len);
 static int acodec_gme_close(void *handle);
+static int acodec_gme_open_track(void **handle, const char *filename, int track);
+static int acodec_gme_track_count(const char *filename);
+static int acodec_gme_seek(void *handle, unsigned ms);
 
 static AudioDecoder mp3_decoder = {
     .open = acodec_mp3_open,
     .get_info = acodec_mp3_get_info,
     .decode = acodec_mp3_decode,
     .close = acodec_mp3_close,
+    .seek = acodec_mp3_seek,
+    .duration = acodec_mp3_duration,
 };
 
 static AudioDecoder ogg_decoder = {
@@ -62,6 +79,7 @@ static AudioDecoder libxmp_decoder = {
     .get_info = acodec_libxmp_get_info,
     .decode = acodec_libxmp_decode,
     .close = acodec_libxmp_close,
+    .seek = acodec_libxmp_seek,
 };
 
 static AudioDecoder drwav_decoder = {
@@ -83,11 +101,22 @@ static AudioDecoder gme_decoder = {
     .get_info = acodec_gme_get_info,
     .decode = acodec_gme_decode,
     .close = acodec_gme_close,
+    .open_track = acodec_gme_open_track,
+    .track_count = acodec_gme_track_count,
+    .seek = acodec_gme_seek,
 };
 
 // TODO: Add function that describes the error
 static int acodec_error = 0;
 
+/* AudioDecodeMode flags for the next file opened */
+static unsigned acodec_mode = AudioDecodeFull;
+
+void acodec_set_mode(unsigned mode)
+{
+	acodec_mode = mode;
+}
+
 AudioDecoder *acodec_get_decoder(AudioCodec codec)
 {
 	switch (codec) {
@@ -115,9 +144,21 @@ AudioDecoder *acodec_get_decoder(AudioCodec codec)
 static int acodec_mp3_open(void **handle, const char *filename)
 {
 	assert(filename != NULL);
+	acodec_ogg_release();
+
+	drmp3_config config = {0};
+	if (acodec_mode & AudioDecodeMono) {
+		config.decodeFlags |= DRMP3_DECODE_MONO;
+	}
+	if (acodec_mode & AudioDecodeHalfRate) {
+		config.decodeFlags |= DRMP3_DECODE_HALF_RATE;
+	}
 
 	drmp3 *mp3 = malloc(sizeof(drmp3));
-	if (!drmp3_init_file(mp3, filename, NULL)) {
+	if (mp3 == NULL) {
+		return -1;
+	}
+	if (!drmp3_init_file(mp3, filename, &config)) {
 		free(mp3);
 		return -1;
 	}
@@ -139,7 +180,7 @@ static int acodec_mp3_decode(void *handle, int16_t *buf_out, int num_c, unsigned
 	(void)num_c;
 
 	drmp3 *mp3 = (drmp3 *)handle;
-	drmp3_uint64 n_frames = drmp3_read_pcm_frames_s16(mp3, ((drmp3_uint64)len / 2), buf_out);
+	drmp3_uint64 n_frames = drmp3_read_pcm_frames_s16(mp3, ((drmp3_uint64)len / mp3->channels), buf_out);
 	return (int)n_frames;
 }
 
@@ -151,21 +192,138 @@ static int acodec_mp3_close(void *handle)
 	return 0;
 }
 
+/* Jumps through the Xing/VBRI table of contents where there is one, so it
+ * lands within a few frames of the target rather than decoding up to it */
+static int acodec_mp3_seek(void *handle, unsigned ms)
+{
+	assert(handle != NULL);
+
+	drmp3 *mp3 = (drmp3 *)handle;
+	drmp3_uint64 frame = (drmp3_uint64)ms * mp3->sampleRate / 1000;
+	return drmp3_seek_to_pcm_frame(mp3, frame) ? 0 : -1;
+}
+
+/* Exact for files with a Xing/Info or VBRI header, estimated from the file
+ * size and bitrate for CBR files without one. Only the first frame is read. */
+static int acodec_mp3_duration(const char *filename)
+{
+	assert(filename != NULL);
+
+	struct stat st;
+	if (stat(filename, &st) != 0) {
+		return 0;
+	}
+
+	drmp3 *mp3 = malloc(sizeof(drmp3));
+	if (mp3 == NULL) {
+		return 0;
+	}
+	if (!drmp3_init_file(mp3, filename, NULL)) {
+		free(mp3);
+		return 0;
+	}
+
+	drmp3_uint64 frames = drmp3_get_pcm_frame_count_estimate(mp3, (drmp3_uint64)st.st_size);
+	int ms = mp3->sampleRate ? (int)(frames * 1000 / mp3->sampleRate) : 0;
+	drmp3_uninit(mp3);
+	free(mp3);
+
+	return ms;
+}
+
 /* ---------------------------------------------------------- */
 /* OGG */
 /* ---------------------------------------------------------- */
 
+/* stb_vorbis allocates everything for a file from one arena instead of
+ * making dozens of heap allocations per track. The arena is kept from track
+ * to track and only grows, to what the largest file so far needed, so the
+ * heap stays flat however many tracks are played. It has room for the setup
+ * tables too, which are decoded into it unless stb_vorbis's setup cache
+ * already holds them. It starts at this size, or 0 to size it by the first
+ * file. Opening a file of another codec frees it. */
+#ifndef OGG_ARENA_SIZE
+#define OGG_ARENA_SIZE 0
+#endif
+/* Growth is rounded up to this, so slightly bigger files don't each grow it */
+#ifndef OGG_ARENA_GRANULE
+#define OGG_ARENA_GRANULE (8 * 1024)
+#endif
+
+static stb_vorbis_alloc ogg_arena;
+static stb_vorbis *ogg_arena_user;  /* the file open in the arena, or NULL */
+
+/* The arena size filename needs: opened on the heap once to measure it. 0 if
+ * it can't be opened. */
+static int ogg_arena_probe(const char *filename)
+{
+	int error;
+	stb_vorbis *v = stb_vorbis_open_filename(filename, &error, NULL);
+	if (v == NULL) {
+		acodec_error = error;
+		return 0;
+	}
+	int size = stb_vorbis_get_alloc_size(v);
+	stb_vorbis_close(v);
+	/* don't keep the probe's setup tables on the heap */
+	stb_vorbis_flush_setup_cache();
+	return size;
+}
+
+/* Replace the arena with one of at least size bytes, or free it for 0 */
+static bool ogg_arena_resize(int size)
+{
+	size = (size + OGG_ARENA_GRANULE - 1) / OGG_ARENA_GRANULE * OGG_ARENA_GRANULE;
+	free(ogg_arena.alloc_buffer);
+	ogg_arena.alloc_buffer = size > 0 ? malloc(size) : NULL;
+	ogg_arena.alloc_buffer_length_in_bytes = ogg_arena.alloc_buffer != NULL ? size : 0;
+	return ogg_arena.alloc_buffer != NULL;
+}
+
 static int acodec_ogg_open(void **handle, const char *filename)
 {
 	assert(filename != NULL);
 
-	int error;
-	*handle = stb_vorbis_open_filename(filename, &error, NULL);
+	int error = VORBIS_outofmem;  /* until the arena has room */
+	*handle = NULL;
+	if (ogg_arena_user == NULL) {
+		if (ogg_arena.alloc_buffer == NULL && OGG_ARENA_SIZE > 0) {
+			ogg_arena_resize(OGG_ARENA_SIZE);
+		}
+		if (ogg_arena.alloc_buffer != NULL) {
+			*handle = stb_vorbis_open_filename(filename, &error, &ogg_arena);
+		}
+		if (*handle == NULL && error == VORBIS_outofmem) {
+			/* free the old arena first, so the probe has the room */
+			ogg_arena_resize(0);
+			int size = ogg_arena_probe(filename);
+			if (size > 0 && ogg_arena_resize(size)) {
+				*handle = stb_vorbis_open_filename(filename, &error, &ogg_arena);
+			}
+		}
+		ogg_arena_user = *handle;
+	}
+	/* a second file open at once, or no room for the arena: use the heap */
+	if (*handle == NULL && error == VORBIS_outofmem) {
+		*handle = stb_vorbis_open_filename(filename, &error, NULL);
+	}
 
 	if (*handle == NULL) {
 		acodec_error = error;
 		return -1;
 	}
+
+	int flags = 0;
+	if (acodec_mode & AudioDecodeMono) {
+		flags |= STB_VORBIS_DECODE_MONO;
+	}
+	if (acodec_mode & AudioDecodeHalfRate) {
+		flags |= STB_VORBIS_DECODE_HALF_RATE;
+	}
+	/* streams with blocks too short to halve keep playing at full rate */
+	if (flags && !stb_vorbis_set_decode_flags(*handle, flags)) {
+		stb_vorbis_set_decode_flags(*handle, flags & STB_VORBIS_DECODE_MONO);
+	}
 	return 0;
 }
 
@@ -196,27 +354,98 @@ static int acodec_ogg_close(void *handle)
 	assert(handle != NULL);
 
 	stb_vorbis_close(handle);
+	if (handle == ogg_arena_user) {
+		ogg_arena_user = NULL;
+	}
 	return 0;
 }
 
+/* Give the arena and the cached setups back to the heap when a file of
+ * another codec is opened. Kept while OGG tracks follow each other. */
+static void acodec_ogg_release(void)
+{
+	if (ogg_arena_user == NULL) {
+		ogg_arena_resize(0);
+	}
+	stb_vorbis_flush_setup_cache();
+}
+
 /* ---------------------------------------------------------- */
 /* libxmp-lite for .xm, .mod, .s3m and .it */
 /* ---------------------------------------------------------- */
 
 #define LIBXMP_SAMPLERATE 44100
+#ifndef LIBXMP_SCAN_CACHE_PATH
+#define LIBXMP_SCAN_CACHE_PATH "/sdcard/.xmpcache"
+#endif
+/* Modules that wouldn't fit in the heap, leaving this much for the rest of
+ * the player, page their large samples from a spill file through a cache
+ * of the given size. Others are loaded into RAM. */
+#ifndef LIBXMP_HEAP_RESERVE
+#define LIBXMP_HEAP_RESERVE (96 * 1024)
+#endif
+#ifndef LIBXMP_SAMPLE_CACHE_SIZE
+#define LIBXMP_SAMPLE_CACHE_SIZE (32 * 1024)
+#endif
+/* Seek checkpoints: at most one per interval (ms), within the budget */
+#ifndef LIBXMP_SEEK_INTERVAL
+#define LIBXMP_SEEK_INTERVAL 10000
+#endif
+#ifndef LIBXMP_SEEK_BUDGET
+#define LIBXMP_SEEK_BUDGET (32 * 1024)
+#endif
+
+typedef struct {
+	xmp_context ctx;
+	unsigned sample_rate;
+	unsigned channels;
+} LibxmpHandle;
+
+/* Whether the samples of filename might not fit in the heap. The file size
+ * stands for the sample data, doubled for IT samples, which are packed. */
+static bool libxmp_needs_spill(const char *filename)
+{
+#ifdef ESP_PLATFORM
+	struct stat st;
+	if (stat(filename, &st) != 0) {
+		return true;
+	}
+	return (size_t)st.st_size * 2 + LIBXMP_HEAP_RESERVE > heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#else
+	(void)filename;
+	return false;
+#endif
+}
 
 static int acodec_libxmp_open(void **handle, const char *filename)
 {
 	assert(filename != NULL);
+	acodec_ogg_release();
+
+	LibxmpHandle *xmp = malloc(sizeof(LibxmpHandle));
+	if (xmp == NULL) {
+		return -1;
+	}
+	/* the mixer does half the work in mono and at half the rate */
+	xmp->sample_rate = acodec_mode & AudioDecodeHalfRate ? LIBXMP_SAMPLERATE / 2 : LIBXMP_SAMPLERATE;
+	xmp->channels = acodec_mode & AudioDecodeMono ? 1 : 2;
 
 	xmp_context ctx = xmp_create_context();
+	xmp_set_scan_cache_path(ctx, LIBXMP_SCAN_CACHE_PATH);
+	if (libxmp_needs_spill(filename)) {
+		xmp_set_sample_spill(ctx, LIBXMP_SCAN_CACHE_PATH, LIBXMP_SAMPLE_CACHE_SIZE);
+	}
 	if (xmp_load_module(ctx, (char *)filename) != 0) {
 		// TODO: Add error handling
+		xmp_free_context(ctx);
+		free(xmp);
 		return -1;
 	}
 
-	xmp_start_player(ctx, LIBXMP_SAMPLERATE, 0);
-	*handle = ctx;
+	xmp_start_player(ctx, (int)xmp->sample_rate, xmp->channels == 1 ? XMP_FORMAT_MONO : 0);
+	xmp_set_seek_checkpoints(ctx, LIBXMP_SEEK_INTERVAL, LIBXMP_SEEK_BUDGET);
+	xmp->ctx = ctx;
+	*handle = xmp;
 
 	return 0;
 }
@@ -224,9 +453,10 @@ static int acodec_libxmp_open(void **handle, const char *filename)
 static int acodec_libxmp_get_info(void *handle, AudioInfo *info)
 {
 	assert(handle != NULL);
+	LibxmpHandle *xmp = (LibxmpHandle *)handle;
 
-	info->sample_rate = LIBXMP_SAMPLERATE;
-	info->channels = 2;
+	info->sample_rate = xmp->sample_rate;
+	info->channels = xmp->channels;
 	info->buf_size = 4096;
 
 	return 0;
@@ -235,38 +465,78 @@ static int acodec_libxmp_get_info(void *handle, AudioInfo *info)
 static int acodec_libxmp_decode(void *handle, int16_t *buf_out, int num_c, unsigned len)
 {
 	assert(handle != NULL);
-	xmp_context ctx = (xmp_context)handle;
+	LibxmpHandle *xmp = (LibxmpHandle *)handle;
 	(void)num_c;
 
-	if (xmp_play_buffer(ctx, buf_out, (int)(len * sizeof(uint16_t)), 1) != 0) {
+	if (xmp_play_buffer(xmp->ctx, buf_out, (int)(len * sizeof(uint16_t)), 1) != 0) {
 		// TODO: Error handling
 		fprintf(stderr, "error while playing module!\n");
 		return 0;
 	}
 
-	return len / 2;
+	return len / xmp->channels;
 }
 
 static int acodec_libxmp_close(void *handle)
 {
 	assert(handle != NULL);
 
-	xmp_context ctx = (xmp_context)handle;
-	xmp_end_player(ctx);
-	xmp_release_module(ctx); /* unload module */
-	xmp_free_context(ctx);   /* destroy the player context */
+	LibxmpHandle *xmp = (LibxmpHandle *)handle;
+	xmp_end_player(xmp->ctx);
+	xmp_release_module(xmp->ctx); /* unload module */
+	xmp_free_context(xmp->ctx);   /* destroy the player context */
+	free(xmp);
 	return 0;
 }
 
+static int acodec_libxmp_seek(void *handle, unsigned ms)
+{
+	assert(handle != NULL);
+
+	LibxmpHandle *xmp = (LibxmpHandle *)handle;
+	return xmp_seek_time(xmp->ctx, (int)ms) < 0 ? -1 : 0;
+}
+
 /* ---------------------------------------------------------- */
 /* dr_wav for wav files */
 /* ---------------------------------------------------------- */
 
 #define WAV_BUFSZ 4096
+/* 16-bit PCM is read from the file straight into the output buffer, this
+ * many samples at a time, with each read ending on a sector boundary so the
+ * card driver can transfer whole sectors without copying them */
+#ifndef WAV_PASSTHROUGH_BUFSZ
+#define WAV_PASSTHROUGH_BUFSZ 8192
+#endif
+#ifndef WAV_SECTOR_SIZE
+#define WAV_SECTOR_SIZE 512
+#endif
+
+typedef struct {
+	drwav *wav;          /* converting other formats to 16-bit, or NULL */
+	FILE *file;          /* passing 16-bit PCM through, or NULL */
+	uint64_t pos;        /* file offset of the next sample byte */
+	uint64_t remaining;  /* sample bytes left in the file */
+	unsigned channels;
+	unsigned sample_rate;
+} WavHandle;
+
+/* Samples the player can take as they are: 16-bit little-endian PCM in one
+ * or two channels, at any rate since the I2S clock follows the file */
+static bool wav_is_native(const drwav *wav)
+{
+	return wav->translatedFormatTag == DR_WAVE_FORMAT_PCM && wav->bitsPerSample == 16 &&
+	       (wav->channels == 1 || wav->channels == 2);
+}
 
 static int acodec_drwav_open(void **handle, const char *filename)
 {
+	acodec_ogg_release();
+
 	drwav *wav = malloc(sizeof(drwav));
+	if (wav == NULL) {
+		return -1;
+	}
 
 	if (!drwav_init_file(wav, filename)) {
 		fprintf(stderr, "error openinng wav file\n");
@@ -274,37 +544,96 @@ static int acodec_drwav_open(void **handle, const char *filename)
 		return -1;
 	}
 
-	*handle = wav;
+	WavHandle *h = calloc(1, sizeof(WavHandle));
+	if (h == NULL) {
+		drwav_uninit(wav);
+		free(wav);
+		return -1;
+	}
+	h->channels = wav->channels;
+	h->sample_rate = wav->sampleRate;
+	if (wav_is_native(wav)) {
+		/* dr_wav has found the sample data; read it ourselves, unbuffered so
+		 * fread() goes straight to the output buffer */
+		h->file = fopen(filename, "rb");
+		if (h->file != NULL) {
+			setvbuf(h->file, NULL, _IONBF, 0);
+			h->pos = wav->dataChunkDataPos;
+			h->remaining = wav->bytesRemaining;
+			if (fseek(h->file, (long)h->pos, SEEK_SET) != 0) {
+				fclose(h->file);
+				h->file = NULL;
+			}
+		}
+	}
+	if (h->file != NULL) {
+		drwav_uninit(wav);
+		free(wav);
+	} else {
+		h->wav = wav;
+	}
+
+	*handle = h;
 	return 0;
 }
 
 static int acodec_drwav_get_info(void *handle, AudioInfo *info)
 {
 	assert(handle != NULL);
-	drwav *wav = (drwav *)handle;
+	WavHandle *h = (WavHandle *)handle;
 
-	info->channels = wav->channels;
-	info->sample_rate = wav->sampleRate;
-	info->buf_size = WAV_BUFSZ;
+	info->channels = h->channels;
+	info->sample_rate = h->sample_rate;
+	info->buf_size = h->file != NULL ? WAV_PASSTHROUGH_BUFSZ : WAV_BUFSZ;
 
 	return 0;
 }
+
+static int wav_passthrough_read(WavHandle *h, int16_t *buf_out, unsigned frames)
+{
+	size_t frame_size = h->channels * sizeof(int16_t);
+	size_t bytes = frames * frame_size;
+	if (bytes > h->remaining) {
+		bytes = (size_t)h->remaining / frame_size * frame_size;
+	}
+	/* stop at the last sector boundary, so the next read starts on one;
+	 * unless that would split a frame, where the data chunk is misaligned */
+	size_t tail = (size_t)((h->pos + bytes) % WAV_SECTOR_SIZE);
+	if (tail < bytes && tail % frame_size == 0) {
+		bytes -= tail;
+	}
+
+	size_t n = fread(buf_out, 1, bytes, h->file);
+	h->pos += n;
+	h->remaining -= n;
+	return (int)(n / frame_size);
+}
+
 static int acodec_drwav_decode(void *handle, int16_t *buf_out, int num_c, unsigned len)
 {
 	assert(handle != NULL);
-	drwav *wav = (drwav *)handle;
+	WavHandle *h = (WavHandle *)handle;
 	(void)num_c;
 
-	return (int)drwav_read_pcm_frames_s16(wav, ((uint64_t)len / 2), buf_out);
+	if (h->file != NULL) {
+		return wav_passthrough_read(h, buf_out, len / 2);
+	}
+	return (int)drwav_read_pcm_frames_s16(h->wav, ((uint64_t)len / 2), buf_out);
 }
 
 static int acodec_drwav_close(void *handle)
 {
 
 	assert(handle != NULL);
-	drwav *wav = (drwav *)handle;
-	drwav_uninit(wav);
-	free(wav);
+	WavHandle *h = (WavHandle *)handle;
+
+	if (h->file != NULL) {
+		fclose(h->file);
+	} else {
+		drwav_uninit(h->wav);
+		free(h->wav);
+	}
+	free(h);
 	return 0;
 }
 
@@ -312,24 +641,79 @@ static int acodec_drwav_close(void *handle)
 /* dr_flac for flac files */
 /* ---------------------------------------------------------- */
 
+/* Streams of at least this PCM bitrate (88.2 kHz 16-bit stereo), which one
+ * core can't keep up with, are decoded frame-parallel on this many worker
+ * threads. 0 workers decodes everything on the player's thread. */
+#ifndef FLAC_PARALLEL_WORKERS
+#define FLAC_PARALLEL_WORKERS 2
+#endif
+#ifndef FLAC_PARALLEL_MIN_BITRATE
+#define FLAC_PARALLEL_MIN_BITRATE (88200 * 16 * 2)
+#endif
+/* Heap the frame ring and worker threads must leave free, or the stream is
+ * decoded on the player's thread after all */
+#ifndef FLAC_HEAP_RESERVE
+#define FLAC_HEAP_RESERVE (96 * 1024)
+#endif
+
+typedef struct {
+	drflac *flac;            /* decoding on the player's thread, or NULL */
+	FlacParallel *parallel;  /* decoding on worker threads, or NULL */
+	unsigned channels;
+	unsigned sample_rate;
+} FlacHandle;
+
+/* Whether decoding flac on worker threads leaves enough of the heap */
+static bool flac_parallel_fits(const drflac *flac)
+{
+#ifdef ESP_PLATFORM
+	return flac_parallel_heap_size(flac, FLAC_PARALLEL_WORKERS) + FLAC_HEAP_RESERVE <=
+	       heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#else
+	(void)flac;
+	return true;
+#endif
+}
+
 static int acodec_drflac_open(void **handle, const char *filename)
 {
+	acodec_ogg_release();
+
 	drflac *flac = drflac_open_file(filename, NULL);
 	if (flac == NULL) {
 		fprintf(stderr, "error openinng flac file\n");
 		return -1;
 	}
 
-	*handle = flac;
+	FlacHandle *h = calloc(1, sizeof(FlacHandle));
+	if (h == NULL) {
+		drflac_close(flac);
+		return -1;
+	}
+	h->channels = flac->channels;
+	h->sample_rate = flac->sampleRate;
+	if (FLAC_PARALLEL_WORKERS > 0 &&
+	    (uint64_t)flac->sampleRate * flac->bitsPerSample * flac->channels >= FLAC_PARALLEL_MIN_BITRATE &&
+	    flac_parallel_fits(flac)) {
+		/* Falls back to the player's thread where this fails, e.g. Ogg FLAC */
+		h->parallel = flac_parallel_open(flac, filename, FLAC_PARALLEL_WORKERS);
+	}
+	if (h->parallel != NULL) {
+		drflac_close(flac);
+	} else {
+		h->flac = flac;
+	}
+
+	*handle = h;
 	return 0;
 }
 static int acodec_drflac_get_info(void *handle, AudioInfo *info)
 {
 	assert(handle != NULL);
-	drflac *flac = (drflac *)handle;
+	FlacHandle *h = (FlacHandle *)handle;
 
-	info->channels = flac->channels;
-	info->sample_rate = flac->sampleRate;
+	info->channels = h->channels;
+	info->sample_rate = h->sample_rate;
 	info->buf_size = WAV_BUFSZ;
 
 	return 0;
@@ -338,18 +722,26 @@ static int acodec_drflac_get_info(void *handle, AudioInfo *info)
 static int acodec_drflac_decode(void *handle, int16_t *buf_out, int num_c, unsigned len)
 {
 	assert(handle != NULL);
-	drflac *flac = (drflac *)handle;
+	FlacHandle *h = (FlacHandle *)handle;
 	(void)num_c;
 
-	return (int)drflac_read_pcm_frames_s16(flac, ((uint64_t)len / 2), buf_out);
+	if (h->parallel != NULL) {
+		return (int)flac_parallel_read_s16(h->parallel, buf_out, len / 2);
+	}
+	return (int)drflac_read_pcm_frames_s16(h->flac, ((uint64_t)len / 2), buf_out);
 }
 
 static int acodec_drflac_close(void *handle)
 {
 	assert(handle != NULL);
-	drflac *flac = (drflac *)handle;
+	FlacHandle *h = (FlacHandle *)handle;
 
-	drflac_close(flac);
+	if (h->parallel != NULL) {
+		flac_parallel_close(h->parallel);
+	} else {
+		drflac_close(h->flac);
+	}
+	free(h);
 
 	return 0;
 }
@@ -359,48 +751,388 @@ static int acodec_drflac_close(void *handle)
 /* ---------------------------------------------------------- */
 
 #define GME_SAMPLERATE 44100
+/* Play formats with a fixed emulation rate (SPC) at that rate instead of
+ * resampling them to GME_SAMPLERATE. Needs an output that can follow. */
+#ifndef GME_NATIVE_RATE
+#define GME_NATIVE_RATE 1
+#endif
+/* YM2612 core (gme_ym2612_*) each VGM/GYM track starts with */
+#ifndef GME_YM2612_CORE
+#define GME_YM2612_CORE gme_ym2612_nuked
+#endif
+/* Render time is measured over windows of this length... */
+#ifndef GME_RENDER_WINDOW_MS
+#define GME_RENDER_WINDOW_MS 500
+#endif
+/* ...and a cheaper YM2612 core is used when it exceeds this share of it */
+#ifndef GME_RENDER_BUDGET_PERCENT
+#define GME_RENDER_BUDGET_PERCENT 75
+#endif
+/* Emulation time silence detection may run ahead of playback per call, so a
+ * silent intro or outro doesn't stall one decode call for seconds */
+#ifndef GME_SILENCE_BUDGET_MS
+#define GME_SILENCE_BUDGET_MS 25
+#endif
+/* Seek checkpoints: emulator snapshots at most one per interval (ms), within
+ * the budget. A snapshot takes 10 to 90 KB depending on the system, so the
+ * budget is further limited to what the heap has beyond the reserve. */
+#ifndef GME_SEEK_INTERVAL
+#define GME_SEEK_INTERVAL 15000
+#endif
+#ifndef GME_SEEK_BUDGET
+#define GME_SEEK_BUDGET (128 * 1024)
+#endif
+#ifndef GME_HEAP_RESERVE
+#define GME_HEAP_RESERVE (96 * 1024)
+#endif
+/* Partition holding the flash set: game music files packed by
+ * tools/flashset.py, listed under ACODEC_FLASH_DIR and played from
+ * memory-mapped flash instead of being copied to the heap */
+#ifndef GME_FLASH_PARTITION
+#define GME_FLASH_PARTITION "appfs"
+#endif
+#define GME_FLASH_MAGIC "GMESET01"
+
+/* A flash set is this header, count entries and then the files. Offsets are
+ * from the start of the partition, all fields little-endian. */
+typedef struct {
+	char magic[8];
+	uint32_t count;
+	uint32_t reserved;
+} GmeFlashHeader;
+
+typedef struct {
+	char name[56];       /* NUL-terminated */
+	uint32_t offset;
+	uint32_t size;
+} GmeFlashEntry;
+
+typedef struct {
+	bool mapped;
+#ifdef ESP_PLATFORM
+	esp_partition_mmap_handle_t handle;
+#endif
+} GmeMap;
+
+typedef struct {
+	Music_Emu *emu;
+	GmeMap map;          /* flash the file is played from, if mapped */
+	unsigned sample_rate;
+	unsigned channels;
+	int64_t render_us;   /* time spent rendering the current window */
+	unsigned rendered;   /* samples rendered in the current window */
+} GmeHandle;
+
+/* Memory seek checkpoints may take, out of what's left once a file is open */
+static long gme_seek_budget(void)
+{
+#ifdef ESP_PLATFORM
+	size_t free_size = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+	if (free_size <= GME_HEAP_RESERVE) {
+		return 0;
+	}
+	free_size -= GME_HEAP_RESERVE;
+	return free_size < GME_SEEK_BUDGET ? (long)free_size : GME_SEEK_BUDGET;
+#else
+	return GME_SEEK_BUDGET;
+#endif
+}
+
+static int64_t gme_time_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
 
 static int acodec_gme_open(void **handle, const char *filename)
 {
-	Music_Emu *emu;
+	return acodec_gme_open_track(handle, filename, 0);
+}
+
+#ifdef ESP_PLATFORM
+/* The partition holding a flash set and its number of files, NULL if the
+ * partition is missing or holds something else */
+static const esp_partition_t *gme_flash_set(uint32_t *count)
+{
+	const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_ANY,
+		ESP_PARTITION_SUBTYPE_ANY, GME_FLASH_PARTITION);
+	GmeFlashHeader h;
+
+	if (part == NULL || esp_partition_read(part, 0, &h, sizeof h) != ESP_OK ||
+	    memcmp(h.magic, GME_FLASH_MAGIC, sizeof h.magic) != 0 ||
+	    h.count > (part->size - sizeof h) / sizeof(GmeFlashEntry)) {
+		return NULL;
+	}
+	*count = h.count;
+	return part;
+}
+
+static bool gme_flash_entry(const esp_partition_t *part, uint32_t index, GmeFlashEntry *e)
+{
+	if (esp_partition_read(part, sizeof(GmeFlashHeader) + index * sizeof *e,
+			       e, sizeof *e) != ESP_OK) {
+		return false;
+	}
+	e->name[sizeof e->name - 1] = '\0';
+	return e->offset <= part->size && e->size <= part->size - e->offset;
+}
+
+static gme_err_t gme_map_flash(const char *name, const void **data, long *size, GmeMap *map)
+{
+	uint32_t count;
+	const esp_partition_t *part = gme_flash_set(&count);
+	GmeFlashEntry e;
+
+	for (uint32_t i = 0; part != NULL && i < count; i++) {
+		if (!gme_flash_entry(part, i, &e) || strcmp(e.name, name) != 0) {
+			continue;
+		}
+		if (esp_partition_mmap(part, e.offset, e.size, ESP_PARTITION_MMAP_DATA,
+				       data, &map->handle) != ESP_OK) {
+			return "Couldn't map flash";
+		}
+		map->mapped = true;
+		*size = (long)e.size;
+		return NULL;
+	}
+
+	return "File not in flash set";
+}
+#endif
+
+static void gme_unmap(GmeMap *map)
+{
+#ifdef ESP_PLATFORM
+	if (map->mapped) {
+		esp_partition_munmap(map->handle);
+	}
+#endif
+	map->mapped = false;
+}
+
+int acodec_flash_count(void)
+{
+#ifdef ESP_PLATFORM
+	uint32_t count;
+	return gme_flash_set(&count) != NULL ? (int)count : 0;
+#else
+	return 0;
+#endif
+}
+
+int acodec_flash_name(int index, char *name, size_t size)
+{
+#ifdef ESP_PLATFORM
+	uint32_t count;
+	const esp_partition_t *part = gme_flash_set(&count);
+	GmeFlashEntry e;
+
+	if (part == NULL || index < 0 || (uint32_t)index >= count ||
+	    !gme_flash_entry(part, (uint32_t)index, &e) || strlen(e.name) >= size) {
+		return -1;
+	}
+	strcpy(name, e.name);
+	return 0;
+#else
+	(void)index;
+	(void)name;
+	(void)size;
+	return -1;
+#endif
+}
+
+static Music_Emu *gme_new(gme_type_t type, int rate, bool mono)
+{
+	return mono ? gme_new_emu_mono(type, rate) : gme_new_emu(type, rate);
+}
+
+/* Like gme_open_file(), but also takes files of the flash set, which are
+ * loaded without a copy where the emulator allows it, and can ask for a
+ * mono emulator. The mapping must be released with gme_unmap() after the
+ * emulator is deleted. */
+static gme_err_t gme_open(const char *filename, Music_Emu **out, int rate, bool mono, GmeMap *map)
+{
+	gme_type_t type;
+	gme_err_t err;
+
+	map->mapped = false;
+#ifdef ESP_PLATFORM
+	size_t prefix = strlen(ACODEC_FLASH_DIR "/");
+	if (strncmp(filename, ACODEC_FLASH_DIR "/", prefix) == 0) {
+		const void *data;
+		long size;
+		if ((err = gme_map_flash(filename + prefix, &data, &size, map)) != NULL) {
+			return err;
+		}
+
+		type = gme_identify_extension(filename);
+		if (type == NULL && size >= 4) {
+			type = gme_identify_extension(gme_identify_header(data));
+		}
+		Music_Emu *emu = type != NULL ? gme_new(type, rate, mono) : NULL;
+		err = type == NULL ? gme_wrong_file_type :
+		      emu == NULL ? "Out of memory" : gme_load_data(emu, data, size);
+		if (err != NULL) {
+			gme_delete(emu);
+			gme_unmap(map);
+			return err;
+		}
+		*out = emu;
+		return NULL;
+	}
+#endif
+	if ((err = gme_identify_file(filename, &type)) != NULL) {
+		return err;
+	}
+	if (type == NULL) {
+		return gme_wrong_file_type;
+	}
+	Music_Emu *emu = gme_new(type, rate, mono);
+	if (emu == NULL) {
+		return "Out of memory";
+	}
+	if ((err = gme_load_file(emu, filename)) != NULL) {
+		gme_delete(emu);
+		return err;
+	}
+	*out = emu;
+	return NULL;
+}
+
+static int acodec_gme_open_track(void **handle, const char *filename, int track)
+{
+	assert(filename != NULL);
+	acodec_ogg_release();
+
+	Music_Emu *emu = NULL;
+	GmeMap map;
 	gme_err_t err;
-	if ((err = gme_open_file(filename, &emu, GME_SAMPLERATE)) != NULL) {
+	int rate = acodec_mode & AudioDecodeHalfRate ? GME_SAMPLERATE / 2 : GME_SAMPLERATE;
+#if GME_NATIVE_RATE
+	gme_type_t type;
+	if (gme_identify_file(filename, &type) == NULL && type != NULL &&
+	    gme_type_native_sample_rate(type) > 0) {
+		rate = gme_type_native_sample_rate(type);
+	}
+#endif
+	/* emulators that can't render mono (SPC, VGM/GYM) stay stereo */
+	if ((err = gme_open(filename, &emu, rate, (acodec_mode & AudioDecodeMono) != 0, &map)) != NULL) {
 		fprintf(stderr, "error opening gme file: %s\n", err);
 		return -1;
 	}
-	if ((err = gme_start_track(emu, 0)) != NULL) {
-		fprintf(stderr, "error starting track: %s\n", err);
+	/* fails harmlessly for files without a YM2612. Each track starts on
+	 * the default core, gme_check_budget() steps down if it's too heavy. */
+	gme_set_ym2612_core(emu, GME_YM2612_CORE);
+	gme_set_silence_policy(emu, -1, -1, GME_SILENCE_BUDGET_MS);
+	gme_set_seek_checkpoints(emu, GME_SEEK_INTERVAL, gme_seek_budget());
+	if ((err = gme_start_track(emu, track)) != NULL) {
+		fprintf(stderr, "error starting track %d: %s\n", track, err);
+		gme_delete(emu);
+		gme_unmap(&map);
 		return -1;
 	}
 
-	*handle = emu;
+	GmeHandle *gme = calloc(1, sizeof(GmeHandle));
+	if (gme == NULL) {
+		gme_delete(emu);
+		gme_unmap(&map);
+		return -1;
+	}
+	gme->emu = emu;
+	gme->map = map;
+	gme->sample_rate = (unsigned)rate;
+	gme->channels = gme_mono(emu) ? 1 : 2;
+	*handle = gme;
 
 	return 0;
 }
 
+/* Only the header and track info are read, no emulator is set up */
+static int acodec_gme_track_count(const char *filename)
+{
+	assert(filename != NULL);
+
+	Music_Emu *emu = NULL;
+	GmeMap map;
+	if (gme_open(filename, &emu, gme_info_only, false, &map) != NULL) {
+		return 0;
+	}
+
+	int count = gme_track_count(emu);
+	gme_delete(emu);
+	gme_unmap(&map);
+
+	return count;
+}
+
 static int acodec_gme_get_info(void *handle, AudioInfo *info)
 {
-	(void)handle;
-	info->channels = 2;
-	info->sample_rate = GME_SAMPLERATE;
+	GmeHandle *gme = (GmeHandle *)handle;
+	info->channels = gme->channels;
+	info->sample_rate = gme->sample_rate;
 	info->buf_size = WAV_BUFSZ;
 
 	return 0;
 }
 
+/* Step down to a cheaper YM2612 core when rendering can't keep up */
+static void gme_check_budget(GmeHandle *gme)
+{
+	const unsigned window = gme->sample_rate * gme->channels / 1000 * GME_RENDER_WINDOW_MS;
+	if (gme->rendered < window) {
+		return;
+	}
+
+	int64_t played_us = (int64_t)gme->rendered * 1000000 / (gme->sample_rate * gme->channels);
+	int core = gme_ym2612_core(gme->emu);
+	if (core >= 0 && core < gme_ym2612_gens &&
+	    gme->render_us * 100 > played_us * GME_RENDER_BUDGET_PERCENT) {
+		if (gme_set_ym2612_core(gme->emu, core + 1) == NULL) {
+			fprintf(stderr, "gme: YM2612 core %d too slow (%d%% of realtime), using %d\n",
+				core, (int)(gme->render_us * 100 / played_us), core + 1);
+		}
+	}
+
+	gme->render_us = 0;
+	gme->rendered = 0;
+}
+
 static int acodec_gme_decode(void *handle, int16_t *buf_out, int num_c, unsigned len)
 {
 	(void)num_c;
-	Music_Emu *emu = (Music_Emu *)handle;
-	if (gme_play(emu, (int)len, buf_out) != NULL) {
+	GmeHandle *gme = (GmeHandle *)handle;
+	int64_t start = gme_time_us();
+	if (gme_play(gme->emu, (int)len, buf_out) != NULL) {
 		return -1;
 	}
+	gme->render_us += gme_time_us() - start;
+	gme->rendered += len;
+	gme_check_budget(gme);
 
-	return gme_track_ended(emu) ? 0 : (int)len / 2;;
+	return gme_track_ended(gme->emu) ? 0 : (int)(len / gme->channels);
 }
 
 static int acodec_gme_close(void *handle)
 {
-	gme_delete(handle);
+	GmeHandle *gme = (GmeHandle *)handle;
+	gme_delete(gme->emu);
+	gme_unmap(&gme->map);
+	free(gme);
+	return 0;
+}
+
+static int acodec_gme_seek(void *handle, unsigned ms)
+{
+	assert(handle != NULL);
+
+	GmeHandle *gme = (GmeHandle *)handle;
+	if (gme_seek(gme->emu, (int)ms) != NULL) {
+		return -1;
+	}
+	/* emulating up to the target isn't playback time */
+	gme->render_us = 0;
+	gme->rendered = 0;
+
 	return 0;
 }
@@ -1,4 +1,5 @@
 #define DR_MP3_IMPLEMENTATION
-#define DR_MP3_NO_SIMD
+/* SIMD kernels are used when the target has SSE2 or NEON; the component
+   option MP3_SIMD=OFF defines DR_MP3_NO_SIMD to always run the scalar code. */
 
-#include <dr_mp3.h>
\ No newline at end of file
+#include <dr_mp3.h>
@@ -0,0 +1,423 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include <flac_parallel.h>
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <esp_pthread.h>
+#endif
+
+/* Frames queued per worker, so each has the next one ready when it finishes */
+#ifndef FLAC_PARALLEL_SLOTS_PER_WORKER
+#define FLAC_PARALLEL_SLOTS_PER_WORKER 2
+#endif
+
+/* Worker threads run at the player task's priority, one per core */
+#ifndef FLAC_PARALLEL_PRIORITY
+#define FLAC_PARALLEL_PRIORITY 1
+#endif
+#ifndef FLAC_PARALLEL_STACK_SIZE
+#define FLAC_PARALLEL_STACK_SIZE 6144
+#endif
+
+/* The file is read in through a buffer that starts at this size and grows to
+ * hold the largest frame. A frame longer than the limit means the stream is
+ * broken, and it ends there. */
+#define FLAC_PARALLEL_READ_SIZE (32 * 1024)
+#define FLAC_PARALLEL_MAX_READ_SIZE (1024 * 1024)
+
+/* A frame header is at most 16 bytes; one that may be cut off at the end of
+ * the buffer is looked for again after the next read */
+#define FLAC_HEADER_MAX 16
+
+typedef enum {
+	SlotFree,     /* waiting to be filled by the reader */
+	SlotPending,  /* holds a frame waiting for a worker */
+	SlotDecoding,
+	SlotDone,     /* holds decoded samples waiting to be read */
+} FlacSlotState;
+
+typedef struct {
+	FlacSlotState state;
+	uint8_t *data;
+	size_t size;
+	size_t capacity;
+	uint32_t block_size;  /* from the frame header */
+	int16_t *pcm;
+	uint32_t frames;      /* decoded PCM frames in pcm */
+} FlacSlot;
+
+typedef struct {
+	FlacParallel *fp;
+	drflac *decoder;
+	pthread_t thread;
+	bool started;
+} FlacWorker;
+
+struct FlacParallel {
+	FILE *file;
+	unsigned channels;
+
+	/* File data from the frame at start up to len. Headers are looked for
+	 * from scan on. */
+	uint8_t *buf;
+	size_t capacity;
+	size_t len;
+	size_t start;
+	size_t scan;
+	bool eof;
+	bool have_frame;  /* a frame starts at start, with header */
+	drflac_frame_header header;
+
+	/* The ring of frames. The reader fills slots at tail, the workers take
+	 * them in the same order at job, and they're read back at head. */
+	FlacSlot *slots;
+	int slot_count;
+	int head;
+	int tail;
+	int job;
+	uint32_t head_pos;  /* PCM frames already read from the head slot */
+
+	pthread_mutex_t lock;
+	pthread_cond_t job_cond;
+	pthread_cond_t done_cond;
+	bool quit;
+
+	FlacWorker *workers;
+	int worker_count;
+};
+
+static void *flac_parallel_worker(void *arg)
+{
+	FlacWorker *worker = (FlacWorker *)arg;
+	FlacParallel *fp = worker->fp;
+
+	pthread_mutex_lock(&fp->lock);
+	for (;;) {
+		while (!fp->quit && fp->slots[fp->job].state != SlotPending) {
+			pthread_cond_wait(&fp->job_cond, &fp->lock);
+		}
+		if (fp->quit) {
+			break;
+		}
+		FlacSlot *slot = &fp->slots[fp->job];
+		fp->job = (fp->job + 1) % fp->slot_count;
+		slot->state = SlotDecoding;
+		pthread_mutex_unlock(&fp->lock);
+
+		uint32_t frames = drflac_decode_frame_s16(worker->decoder, slot->data, slot->size, slot->pcm);
+		if (frames == 0) {
+			/* A damaged frame plays as silence, keeping the timing */
+			frames = slot->block_size;
+			memset(slot->pcm, 0, (size_t)frames * fp->channels * sizeof(int16_t));
+		}
+
+		pthread_mutex_lock(&fp->lock);
+		slot->frames = frames;
+		slot->state = SlotDone;
+		pthread_cond_broadcast(&fp->done_cond);
+	}
+	pthread_mutex_unlock(&fp->lock);
+	return NULL;
+}
+
+/* Drop the data before the current frame and read more after it. False when
+ * nothing more could be read. */
+static bool flac_parallel_refill(FlacParallel *fp)
+{
+	if (fp->start > 0) {
+		memmove(fp->buf, fp->buf + fp->start, fp->len - fp->start);
+		fp->len -= fp->start;
+		fp->scan -= fp->start;
+		fp->start = 0;
+	}
+	if (fp->len == fp->capacity) {
+		if (fp->capacity >= FLAC_PARALLEL_MAX_READ_SIZE) {
+			return false;
+		}
+		uint8_t *buf = realloc(fp->buf, fp->capacity * 2);
+		if (buf == NULL) {
+			return false;
+		}
+		fp->buf = buf;
+		fp->capacity *= 2;
+	}
+
+	size_t n = fread(fp->buf + fp->len, 1, fp->capacity - fp->len, fp->file);
+	fp->len += n;
+	return n > 0;
+}
+
+/* Whether header is the frame after the current one. Blocks of fixed size
+ * count frames, variable ones count samples. */
+static bool flac_parallel_follows(const FlacParallel *fp, const drflac_frame_header *header)
+{
+	const drflac_frame_header *current = &fp->header;
+
+	if (header->pcmFrameNumber == 0) {
+		return header->flacFrameNumber == current->flacFrameNumber + 1;
+	}
+	return header->flacFrameNumber == 0 &&
+		header->pcmFrameNumber == current->pcmFrameNumber + current->blockSizeInPCMFrames;
+}
+
+/* Cut the next frame out of the file into slot. It ends where the header of
+ * the frame after it is found, or at the end of the file. False at the end
+ * of the stream. */
+static bool flac_parallel_next_frame(FlacParallel *fp, FlacSlot *slot)
+{
+	const drflac *stream = fp->workers[0].decoder;
+	drflac_frame_header next;
+	size_t end = 0;
+	bool found = false;
+
+	while (!fp->have_frame) {
+		size_t offset = drflac_find_frame_header(stream, fp->buf + fp->start, fp->len - fp->start, &fp->header);
+		if (offset < fp->len - fp->start) {
+			fp->start += offset;
+			fp->scan = fp->start + 1;
+			fp->have_frame = true;
+			break;
+		}
+		if (fp->eof) {
+			return false;
+		}
+		if (fp->len - fp->start > FLAC_HEADER_MAX) {
+			fp->start = fp->len - FLAC_HEADER_MAX;
+		}
+		fp->scan = fp->start;
+		fp->eof = !flac_parallel_refill(fp);
+	}
+
+	while (!found) {
+		while (fp->scan < fp->len) {
+			size_t offset = drflac_find_frame_header(stream, fp->buf + fp->scan, fp->len - fp->scan, &next);
+			if (offset == fp->len - fp->scan) {
+				break;
+			}
+			if (flac_parallel_follows(fp, &next)) {
+				end = fp->scan + offset;
+				found = true;
+				break;
+			}
+			fp->scan += offset + 1;
+		}
+		if (found || fp->eof) {
+			break;
+		}
+		if (fp->len > fp->scan + FLAC_HEADER_MAX) {
+			fp->scan = fp->len - FLAC_HEADER_MAX;
+		}
+		fp->eof = !flac_parallel_refill(fp);
+	}
+	if (!found) {
+		end = fp->len;
+	}
+
+	size_t size = end - fp->start;
+	if (size > slot->capacity) {
+		uint8_t *data = realloc(slot->data, size);
+		if (data == NULL) {
+			return false;
+		}
+		slot->data = data;
+		slot->capacity = size;
+	}
+	memcpy(slot->data, fp->buf + fp->start, size);
+	slot->size = size;
+	slot->block_size = fp->header.blockSizeInPCMFrames;
+
+	fp->start = end;
+	if (found) {
+		fp->header = next;
+		fp->scan = end + 1;
+	} else {
+		fp->have_frame = false;
+	}
+	return true;
+}
+
+/* Queue frames into every free slot */
+static void flac_parallel_fill(FlacParallel *fp)
+{
+	for (;;) {
+		FlacSlot *slot = &fp->slots[fp->tail];
+
+		pthread_mutex_lock(&fp->lock);
+		bool free_slot = slot->state == SlotFree;
+		pthread_mutex_unlock(&fp->lock);
+		if (!free_slot || !flac_parallel_next_frame(fp, slot)) {
+			return;
+		}
+
+		pthread_mutex_lock(&fp->lock);
+		slot->state = SlotPending;
+		pthread_cond_signal(&fp->job_cond);
+		pthread_mutex_unlock(&fp->lock);
+		fp->tail = (fp->tail + 1) % fp->slot_count;
+	}
+}
+
+FlacParallel *flac_parallel_open(const drflac *flac, const char *filename, int workers)
+{
+	if (flac == NULL || workers < 1) {
+		return NULL;
+	}
+
+	FlacParallel *fp = calloc(1, sizeof(FlacParallel));
+	if (fp == NULL) {
+		return NULL;
+	}
+	fp->channels = flac->channels;
+	fp->worker_count = workers;
+	fp->slot_count = workers * FLAC_PARALLEL_SLOTS_PER_WORKER;
+	pthread_mutex_init(&fp->lock, NULL);
+	pthread_cond_init(&fp->job_cond, NULL);
+	pthread_cond_init(&fp->done_cond, NULL);
+
+	fp->file = fopen(filename, "rb");
+	fp->capacity = FLAC_PARALLEL_READ_SIZE;
+	fp->buf = malloc(fp->capacity);
+	fp->slots = calloc(fp->slot_count, sizeof(FlacSlot));
+	fp->workers = calloc(workers, sizeof(FlacWorker));
+	if (fp->file == NULL || fp->buf == NULL || fp->slots == NULL || fp->workers == NULL ||
+	    fseek(fp->file, (long)flac->firstFLACFramePosInBytes, SEEK_SET) != 0) {
+		flac_parallel_close(fp);
+		return NULL;
+	}
+
+	for (int i = 0; i < fp->slot_count; i++) {
+		fp->slots[i].pcm = malloc((size_t)flac->maxBlockSizeInPCMFrames * flac->channels * sizeof(int16_t));
+		if (fp->slots[i].pcm == NULL) {
+			flac_parallel_close(fp);
+			return NULL;
+		}
+	}
+	for (int i = 0; i < workers; i++) {
+		fp->workers[i].fp = fp;
+		fp->workers[i].decoder = drflac_open_frame_decoder(flac, NULL);
+		if (fp->workers[i].decoder == NULL) {
+			flac_parallel_close(fp);
+			return NULL;
+		}
+	}
+
+#ifdef ESP_PLATFORM
+	esp_pthread_cfg_t saved = esp_pthread_get_default_config();
+	esp_pthread_get_cfg(&saved);
+#endif
+	for (int i = 0; i < workers; i++) {
+#ifdef ESP_PLATFORM
+		esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+		cfg.stack_size = FLAC_PARALLEL_STACK_SIZE;
+		cfg.prio = FLAC_PARALLEL_PRIORITY;
+		cfg.pin_to_core = i % portNUM_PROCESSORS;
+		cfg.thread_name = "flac_worker";
+		esp_pthread_set_cfg(&cfg);
+#endif
+		fp->workers[i].started = pthread_create(&fp->workers[i].thread, NULL, flac_parallel_worker, &fp->workers[i]) == 0;
+		if (!fp->workers[i].started) {
+			break;
+		}
+	}
+#ifdef ESP_PLATFORM
+	esp_pthread_set_cfg(&saved);
+#endif
+	if (!fp->workers[workers - 1].started) {
+		flac_parallel_close(fp);
+		return NULL;
+	}
+
+	fp->eof = !flac_parallel_refill(fp);
+	return fp;
+}
+
+size_t flac_parallel_heap_size(const drflac *flac, int workers)
+{
+	size_t frame = (size_t)flac->maxBlockSizeInPCMFrames * flac->channels;
+	/* a frame's data is at most its samples stored verbatim */
+	size_t slot = sizeof(FlacSlot) + frame * sizeof(int16_t) + frame * ((flac->bitsPerSample + 7) / 8);
+	/* a decoder holds a frame of 32-bit samples */
+	size_t worker = sizeof(FlacWorker) + sizeof(drflac) + frame * sizeof(int32_t) + FLAC_PARALLEL_STACK_SIZE;
+
+	return sizeof(FlacParallel) + FLAC_PARALLEL_READ_SIZE +
+	       (size_t)workers * (FLAC_PARALLEL_SLOTS_PER_WORKER * slot + worker);
+}
+
+size_t flac_parallel_read_s16(FlacParallel *fp, int16_t *out, size_t frames)
+{
+	size_t done = 0;
+
+	while (done < frames) {
+		flac_parallel_fill(fp);
+
+		FlacSlot *slot = &fp->slots[fp->head];
+		pthread_mutex_lock(&fp->lock);
+		while (slot->state == SlotPending || slot->state == SlotDecoding) {
+			pthread_cond_wait(&fp->done_cond, &fp->lock);
+		}
+		pthread_mutex_unlock(&fp->lock);
+		if (slot->state == SlotFree) {
+			break;  /* nothing left to queue */
+		}
+
+		size_t n = slot->frames - fp->head_pos;
+		if (n > frames - done) {
+			n = frames - done;
+		}
+		memcpy(out + done * fp->channels, slot->pcm + (size_t)fp->head_pos * fp->channels,
+		       n * fp->channels * sizeof(int16_t));
+		done += n;
+		fp->head_pos += n;
+
+		if (fp->head_pos == slot->frames) {
+			pthread_mutex_lock(&fp->lock);
+			slot->state = SlotFree;
+			pthread_mutex_unlock(&fp->lock);
+			fp->head = (fp->head + 1) % fp->slot_count;
+			fp->head_pos = 0;
+		}
+	}
+	return done;
+}
+
+void flac_parallel_close(FlacParallel *fp)
+{
+	if (fp == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&fp->lock);
+	fp->quit = true;
+	pthread_cond_broadcast(&fp->job_cond);
+	pthread_mutex_unlock(&fp->lock);
+
+	if (fp->workers != NULL) {
+		for (int i = 0; i < fp->worker_count; i++) {
+			if (fp->workers[i].started) {
+				pthread_join(fp->workers[i].thread, NULL);
+			}
+			drflac_close(fp->workers[i].decoder);
+		}
+		free(fp->workers);
+	}
+	if (fp->slots != NULL) {
+		for (int i = 0; i < fp->slot_count; i++) {
+			free(fp->slots[i].data);
+			free(fp->slots[i].pcm);
+		}
+		free(fp->slots);
+	}
+	free(fp->buf);
+	if (fp->file != NULL) {
+		fclose(fp->file);
+	}
+	pthread_cond_destroy(&fp->done_cond);
+	pthread_cond_destroy(&fp->job_cond);
+	pthread_mutex_destroy(&fp->lock);
+	free(fp);
+}
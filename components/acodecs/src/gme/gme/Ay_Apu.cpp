@@ -190,7 +190,19 @@ void Ay_Apu::run_until( blip_time_t final_end_time )
 		// output
 		Blip_Buffer* const osc_output = osc->output;
 		if ( !osc_output )
+		{
+			// muted: only maintain tone's phase
+			blip_time_t const period = osc->period;
+			blip_time_t time = last_time + osc->delay;
+			if ( time < final_end_time )
+			{
+				blargg_long count = (final_end_time - time + period - 1) / period;
+				time += count * period;
+				osc->phase ^= count & 1;
+			}
+			osc->delay = time - final_end_time;
 			continue;
+		}
 		osc_output->set_modified();
 		
 		// period
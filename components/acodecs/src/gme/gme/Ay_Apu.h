@@ -7,6 +7,11 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef AY_APU_FAST_SYNTH
+	#define AY_APU_FAST_SYNTH 0
+#endif
+
 class Ay_Apu {
 public:
 	// Set buffer to generate all sound into, or disable sound if NULL
@@ -68,7 +73,7 @@ private:
 	void write_data_( int addr, int data );
 public:
 	enum { amp_range = 255 };
-	Blip_Synth<blip_good_quality,1> synth_;
+	Blip_Synth<(AY_APU_FAST_SYNTH ? blip_fast_quality : blip_good_quality),1> synth_;
 };
 
 inline void Ay_Apu::volume( double v ) { synth_.volume( 0.7 / osc_count / amp_range * v ); }
@@ -115,6 +115,12 @@ void Ay_Cpu::reset( void* m )
 #define CASE7( a, b, c, d, e, f, g    ) CASE6( a, b, c, d, e, f    ): case 0x##g
 #define CASE8( a, b, c, d, e, f, g, h ) CASE7( a, b, c, d, e, f, g ): case 0x##h
 
+// the same for the main switch, where each opcode is also a BLARGG_OP label
+#define OP_CASE5( a, b, c, d, e          ) BLARGG_OP( 0x##a ):BLARGG_OP( 0x##b ):BLARGG_OP( 0x##c ):BLARGG_OP( 0x##d ):BLARGG_OP( 0x##e )
+#define OP_CASE6( a, b, c, d, e, f       ) OP_CASE5( a, b, c, d, e       ): BLARGG_OP( 0x##f )
+#define OP_CASE7( a, b, c, d, e, f, g    ) OP_CASE6( a, b, c, d, e, f    ): BLARGG_OP( 0x##g )
+#define OP_CASE8( a, b, c, d, e, f, g, h ) OP_CASE7( a, b, c, d, e, f, g ): BLARGG_OP( 0x##h )
+
 // high four bits are $ED time - 8, low four bits are $DD/$FD time - 8
 static byte const ed_dd_timing [0x100] = {
 //0    1    2    3    4    5    6    7    8    9    A    B    C    D    E    F
@@ -136,7 +142,7 @@ static byte const ed_dd_timing [0x100] = {
 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x02,0x00,0x00,0x00,0x00,0x00,0x00,
 };
 
-bool Ay_Cpu::run( cpu_time_t end_time )
+BLARGG_CPU_RUN bool Ay_Cpu::run( cpu_time_t end_time )
 {
 	set_end_time( end_time );
 	state_t s = this->state_;
@@ -214,6 +220,7 @@ almost_out_of_time:
 				READ_PROG( pc + 1 ), READ_PROG( pc + 2 ) );
 	#endif
 	
+	BLARGG_DISPATCH( opcode );
 	switch ( opcode )
 	{
 possibly_out_of_time:
@@ -224,11 +231,11 @@ possibly_out_of_time:
 
 // Common
 
-	case 0x00: // NOP
-	CASE7( 40, 49, 52, 5B, 64, 6D, 7F ): // LD B,B etc.
+	BLARGG_OP( 0x00 ): // NOP
+	OP_CASE7( 40, 49, 52, 5B, 64, 6D, 7F ): // LD B,B etc.
 		goto loop;
 	
-	case 0x08:{// EX AF,AF'
+	BLARGG_OP( 0x08 ):{// EX AF,AF'
 		int temp = r.alt.b.a;
 		r.alt.b.a = rg.a;
 		rg.a = temp;
@@ -239,22 +246,22 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0xD3: // OUT (imm),A
+	BLARGG_OP( 0xD3 ): // OUT (imm),A
 		pc++;
 		OUT( data + rg.a * 0x100, rg.a );
 		goto loop;
 		
-	case 0x2E: // LD L,imm
+	BLARGG_OP( 0x2E ): // LD L,imm
 		pc++;
 		rg.l = data;
 		goto loop;
 	
-	case 0x3E: // LD A,imm
+	BLARGG_OP( 0x3E ): // LD A,imm
 		pc++;
 		rg.a = data;
 		goto loop;
 	
-	case 0x3A:{// LD A,(addr)
+	BLARGG_OP( 0x3A ):{// LD A,(addr)
 		uint16_t addr = GET_ADDR();
 		pc += 2;
 		rg.a = READ( addr );
@@ -278,13 +285,13 @@ possibly_out_of_time:
 	goto loop;\
 }
 	
-	case 0x20: JR( !ZERO  ) // JR NZ,disp
-	case 0x28: JR(  ZERO  ) // JR Z,disp
-	case 0x30: JR( !CARRY ) // JR NC,disp
-	case 0x38: JR(  CARRY ) // JR C,disp
-	case 0x18: JR(  true  ) // JR disp
+	BLARGG_OP( 0x20 ): JR( !ZERO  ) // JR NZ,disp
+	BLARGG_OP( 0x28 ): JR(  ZERO  ) // JR Z,disp
+	BLARGG_OP( 0x30 ): JR( !CARRY ) // JR NC,disp
+	BLARGG_OP( 0x38 ): JR(  CARRY ) // JR C,disp
+	BLARGG_OP( 0x18 ): JR(  true  ) // JR disp
 
-	case 0x10:{// DJNZ disp
+	BLARGG_OP( 0x10 ):{// DJNZ disp
 		int temp = rg.b - 1;
 		rg.b = temp;
 		JR( temp )
@@ -293,36 +300,36 @@ possibly_out_of_time:
 // JP
 #define JP( cond )  if ( !(cond) ) goto jp_not_taken; pc = GET_ADDR(); goto loop;
 	
-	case 0xC2: JP( !ZERO  ) // JP NZ,addr
-	case 0xCA: JP(  ZERO  ) // JP Z,addr
-	case 0xD2: JP( !CARRY ) // JP NC,addr
-	case 0xDA: JP(  CARRY ) // JP C,addr
-	case 0xE2: JP( !EVEN  ) // JP PO,addr
-	case 0xEA: JP(  EVEN  ) // JP PE,addr
-	case 0xF2: JP( !MINUS ) // JP P,addr
-	case 0xFA: JP(  MINUS ) // JP M,addr
+	BLARGG_OP( 0xC2 ): JP( !ZERO  ) // JP NZ,addr
+	BLARGG_OP( 0xCA ): JP(  ZERO  ) // JP Z,addr
+	BLARGG_OP( 0xD2 ): JP( !CARRY ) // JP NC,addr
+	BLARGG_OP( 0xDA ): JP(  CARRY ) // JP C,addr
+	BLARGG_OP( 0xE2 ): JP( !EVEN  ) // JP PO,addr
+	BLARGG_OP( 0xEA ): JP(  EVEN  ) // JP PE,addr
+	BLARGG_OP( 0xF2 ): JP( !MINUS ) // JP P,addr
+	BLARGG_OP( 0xFA ): JP(  MINUS ) // JP M,addr
 	
-	case 0xC3: // JP addr
+	BLARGG_OP( 0xC3 ): // JP addr
 		pc = GET_ADDR();
 		goto loop;
 	
-	case 0xE9: // JP HL
+	BLARGG_OP( 0xE9 ): // JP HL
 		pc = rp.hl;
 		goto loop;
 
 // RET
 #define RET( cond ) if ( cond ) goto ret_taken; s_time -= 6; goto loop;
 	
-	case 0xC0: RET( !ZERO  ) // RET NZ
-	case 0xC8: RET(  ZERO  ) // RET Z
-	case 0xD0: RET( !CARRY ) // RET NC
-	case 0xD8: RET(  CARRY ) // RET C
-	case 0xE0: RET( !EVEN  ) // RET PO
-	case 0xE8: RET(  EVEN  ) // RET PE
-	case 0xF0: RET( !MINUS ) // RET P
-	case 0xF8: RET(  MINUS ) // RET M
+	BLARGG_OP( 0xC0 ): RET( !ZERO  ) // RET NZ
+	BLARGG_OP( 0xC8 ): RET(  ZERO  ) // RET Z
+	BLARGG_OP( 0xD0 ): RET( !CARRY ) // RET NC
+	BLARGG_OP( 0xD8 ): RET(  CARRY ) // RET C
+	BLARGG_OP( 0xE0 ): RET( !EVEN  ) // RET PO
+	BLARGG_OP( 0xE8 ): RET(  EVEN  ) // RET PE
+	BLARGG_OP( 0xF0 ): RET( !MINUS ) // RET P
+	BLARGG_OP( 0xF8 ): RET(  MINUS ) // RET M
 	
-	case 0xC9: // RET
+	BLARGG_OP( 0xC9 ): // RET
 	ret_taken:
 		pc = READ_WORD( sp );
 		sp = uint16_t (sp + 2);
@@ -331,16 +338,16 @@ possibly_out_of_time:
 // CALL
 #define CALL( cond ) if ( cond ) goto call_taken; goto call_not_taken;
 
-	case 0xC4: CALL( !ZERO  ) // CALL NZ,addr
-	case 0xCC: CALL(  ZERO  ) // CALL Z,addr
-	case 0xD4: CALL( !CARRY ) // CALL NC,addr
-	case 0xDC: CALL(  CARRY ) // CALL C,addr
-	case 0xE4: CALL( !EVEN  ) // CALL PO,addr
-	case 0xEC: CALL(  EVEN  ) // CALL PE,addr
-	case 0xF4: CALL( !MINUS ) // CALL P,addr
-	case 0xFC: CALL(  MINUS ) // CALL M,addr
-	
-	case 0xCD:{// CALL addr
+	BLARGG_OP( 0xC4 ): CALL( !ZERO  ) // CALL NZ,addr
+	BLARGG_OP( 0xCC ): CALL(  ZERO  ) // CALL Z,addr
+	BLARGG_OP( 0xD4 ): CALL( !CARRY ) // CALL NC,addr
+	BLARGG_OP( 0xDC ): CALL(  CARRY ) // CALL C,addr
+	BLARGG_OP( 0xE4 ): CALL( !EVEN  ) // CALL PO,addr
+	BLARGG_OP( 0xEC ): CALL(  EVEN  ) // CALL PE,addr
+	BLARGG_OP( 0xF4 ): CALL( !MINUS ) // CALL P,addr
+	BLARGG_OP( 0xFC ): CALL(  MINUS ) // CALL M,addr
+	
+	BLARGG_OP( 0xCD ):{// CALL addr
 	call_taken:
 		uint16_t addr = pc + 2;
 		pc = GET_ADDR();
@@ -349,67 +356,67 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0xFF: // RST
+	BLARGG_OP( 0xFF ): // RST
 		if ( (pc - 1) > 0xFFFF )
 		{
 			pc = uint16_t (pc - 1);
 			s_time -= 11;
 			goto loop;
 		}
-	CASE7( C7, CF, D7, DF, E7, EF, F7 ):
+	OP_CASE7( C7, CF, D7, DF, E7, EF, F7 ):
 		data = pc;
 		pc = opcode & 0x38;
 		goto push_data;
 
 // PUSH/POP
-	case 0xF5: // PUSH AF
+	BLARGG_OP( 0xF5 ): // PUSH AF
 		data = rg.a * 0x100u + flags;
 		goto push_data;
 	
-	case 0xC5: // PUSH BC
-	case 0xD5: // PUSH DE
-	case 0xE5: // PUSH HL
+	BLARGG_OP( 0xC5 ): // PUSH BC
+	BLARGG_OP( 0xD5 ): // PUSH DE
+	BLARGG_OP( 0xE5 ): // PUSH HL
 		data = R16( opcode, 4, 0xC5 );
 	push_data:
 		sp = uint16_t (sp - 2);
 		WRITE_WORD( sp, data );
 		goto loop;
 	
-	case 0xF1: // POP AF
+	BLARGG_OP( 0xF1 ): // POP AF
 		flags = READ( sp );
 		rg.a = READ( sp + 1 );
 		sp = uint16_t (sp + 2);
 		goto loop;
 	
-	case 0xC1: // POP BC
-	case 0xD1: // POP DE
-	case 0xE1: // POP HL
+	BLARGG_OP( 0xC1 ): // POP BC
+	BLARGG_OP( 0xD1 ): // POP DE
+	BLARGG_OP( 0xE1 ): // POP HL
 		R16( opcode, 4, 0xC1 ) = READ_WORD( sp );
 		sp = uint16_t (sp + 2);
 		goto loop;
 	
 // ADC/ADD/SBC/SUB
-	case 0x96: // SUB (HL)
-	case 0x86: // ADD (HL)
+	BLARGG_OP( 0x96 ): // SUB (HL)
+	BLARGG_OP( 0x86 ): // ADD (HL)
 		flags &= ~C01;
-	case 0x9E: // SBC (HL)
-	case 0x8E: // ADC (HL)
+	BLARGG_OP( 0x9E ): // SBC (HL)
+	BLARGG_OP( 0x8E ): // ADC (HL)
 		data = READ( rp.hl );
 		goto adc_data;
 	
-	case 0xD6: // SUB A,imm
-	case 0xC6: // ADD imm
+	BLARGG_OP( 0xD6 ): // SUB A,imm
+	BLARGG_OP( 0xC6 ): // ADD imm
 		flags &= ~C01;
-	case 0xDE: // SBC A,imm
-	case 0xCE: // ADC imm
+	BLARGG_OP( 0xDE ): // SBC A,imm
+	BLARGG_OP( 0xCE ): // ADC imm
 		pc++;
 		goto adc_data;
 	
-	CASE7( 90, 91, 92, 93, 94, 95, 97 ): // SUB r
-	CASE7( 80, 81, 82, 83, 84, 85, 87 ): // ADD r
+	OP_CASE7( 90, 91, 92, 93, 94, 95, 97 ): // SUB r
+	OP_CASE7( 80, 81, 82, 83, 84, 85, 87 ): // ADD r
 		flags &= ~C01;
-	CASE7( 98, 99, 9A, 9B, 9C, 9D, 9F ): // SBC r
-	CASE7( 88, 89, 8A, 8B, 8C, 8D, 8F ): // ADC r
+	OP_CASE7( 98, 99, 9A, 9B, 9C, 9D, 9F ): // SBC r
+	OP_CASE7( 88, 89, 8A, 8B, 8C, 8D, 8F ): // ADC r
 		data = R8( opcode & 7, 0 );
 	adc_data: {
 		int result = data + (flags & C01);
@@ -427,15 +434,15 @@ possibly_out_of_time:
 	}
 
 // CP
-	case 0xBE: // CP (HL)
+	BLARGG_OP( 0xBE ): // CP (HL)
 		data = READ( rp.hl );
 		goto cp_data;
 	
-	case 0xFE: // CP imm
+	BLARGG_OP( 0xFE ): // CP imm
 		pc++;
 		goto cp_data;
 	
-	CASE7( B8, B9, BA, BB, BC, BD, BF ): // CP r
+	OP_CASE7( B8, B9, BA, BB, BC, BD, BF ): // CP r
 		data = R8( opcode, 0xB8 );
 	cp_data: {
 		int result = rg.a - data;
@@ -451,13 +458,13 @@ possibly_out_of_time:
 	
 // ADD HL,rp
 	
-	case 0x39: // ADD HL,SP
+	BLARGG_OP( 0x39 ): // ADD HL,SP
 		data = sp;
 		goto add_hl_data;
 	
-	case 0x09: // ADD HL,BC
-	case 0x19: // ADD HL,DE
-	case 0x29: // ADD HL,HL
+	BLARGG_OP( 0x09 ): // ADD HL,BC
+	BLARGG_OP( 0x19 ): // ADD HL,DE
+	BLARGG_OP( 0x29 ): // ADD HL,HL
 		data = R16( opcode, 4, 0x09 );
 	add_hl_data: {
 		blargg_ulong sum = rp.hl + data;
@@ -470,7 +477,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0x27:{// DAA
+	BLARGG_OP( 0x27 ):{// DAA
 		int a = rg.a;
 		if ( a > 0x99 )
 			flags |= C01;
@@ -510,12 +517,12 @@ possibly_out_of_time:
 	*/
 	
 // INC/DEC
-	case 0x34: // INC (HL)
+	BLARGG_OP( 0x34 ): // INC (HL)
 		data = READ( rp.hl ) + 1;
 		WRITE( rp.hl, data );
 		goto inc_set_flags;
 	
-	CASE7( 04, 0C, 14, 1C, 24, 2C, 3C ): // INC r
+	OP_CASE7( 04, 0C, 14, 1C, 24, 2C, 3C ): // INC r
 		data = ++R8( opcode >> 3, 0 );
 	inc_set_flags:
 		flags = (flags & C01) |
@@ -526,12 +533,12 @@ possibly_out_of_time:
 		flags |= V04;
 		goto loop;
 	
-	case 0x35: // DEC (HL)
+	BLARGG_OP( 0x35 ): // DEC (HL)
 		data = READ( rp.hl ) - 1;
 		WRITE( rp.hl, data );
 		goto dec_set_flags;
 	
-	CASE7( 05, 0D, 15, 1D, 25, 2D, 3D ): // DEC r
+	OP_CASE7( 05, 0D, 15, 1D, 25, 2D, 3D ): // DEC r
 		data = --R8( opcode >> 3, 0 );
 	dec_set_flags:
 		flags = (flags & C01) | N02 |
@@ -542,36 +549,36 @@ possibly_out_of_time:
 		flags |= V04;
 		goto loop;
 
-	case 0x03: // INC BC
-	case 0x13: // INC DE
-	case 0x23: // INC HL
+	BLARGG_OP( 0x03 ): // INC BC
+	BLARGG_OP( 0x13 ): // INC DE
+	BLARGG_OP( 0x23 ): // INC HL
 		R16( opcode, 4, 0x03 )++;
 		goto loop;
 	
-	case 0x33: // INC SP
+	BLARGG_OP( 0x33 ): // INC SP
 		sp = uint16_t (sp + 1);
 		goto loop;
 	
-	case 0x0B: // DEC BC
-	case 0x1B: // DEC DE
-	case 0x2B: // DEC HL
+	BLARGG_OP( 0x0B ): // DEC BC
+	BLARGG_OP( 0x1B ): // DEC DE
+	BLARGG_OP( 0x2B ): // DEC HL
 		R16( opcode, 4, 0x0B )--;
 		goto loop;
 	
-	case 0x3B: // DEC SP
+	BLARGG_OP( 0x3B ): // DEC SP
 		sp = uint16_t (sp - 1);
 		goto loop;
 	
 // AND
-	case 0xA6: // AND (HL)
+	BLARGG_OP( 0xA6 ): // AND (HL)
 		data = READ( rp.hl );
 		goto and_data;
 	
-	case 0xE6: // AND imm
+	BLARGG_OP( 0xE6 ): // AND imm
 		pc++;
 		goto and_data;
 	
-	CASE7( A0, A1, A2, A3, A4, A5, A7 ): // AND r
+	OP_CASE7( A0, A1, A2, A3, A4, A5, A7 ): // AND r
 		data = R8( opcode, 0xA0 );
 	and_data:
 		rg.a &= data;
@@ -579,15 +586,15 @@ possibly_out_of_time:
 		goto loop;
 	
 // OR
-	case 0xB6: // OR (HL)
+	BLARGG_OP( 0xB6 ): // OR (HL)
 		data = READ( rp.hl );
 		goto or_data;
 	
-	case 0xF6: // OR imm
+	BLARGG_OP( 0xF6 ): // OR imm
 		pc++;
 		goto or_data;
 	
-	CASE7( B0, B1, B2, B3, B4, B5, B7 ): // OR r
+	OP_CASE7( B0, B1, B2, B3, B4, B5, B7 ): // OR r
 		data = R8( opcode, 0xB0 );
 	or_data:
 		rg.a |= data;
@@ -595,15 +602,15 @@ possibly_out_of_time:
 		goto loop;
 
 // XOR
-	case 0xAE: // XOR (HL)
+	BLARGG_OP( 0xAE ): // XOR (HL)
 		data = READ( rp.hl );
 		goto xor_data;
 	
-	case 0xEE: // XOR imm
+	BLARGG_OP( 0xEE ): // XOR imm
 		pc++;
 		goto xor_data;
 	
-	CASE7( A8, A9, AA, AB, AC, AD, AF ): // XOR r
+	OP_CASE7( A8, A9, AA, AB, AC, AD, AF ): // XOR r
 		data = R8( opcode, 0xA8 );
 	xor_data:
 		rg.a ^= data;
@@ -611,84 +618,84 @@ possibly_out_of_time:
 		goto loop;
 
 // LD
-	CASE7( 70, 71, 72, 73, 74, 75, 77 ): // LD (HL),r
+	OP_CASE7( 70, 71, 72, 73, 74, 75, 77 ): // LD (HL),r
 		WRITE( rp.hl, R8( opcode, 0x70 ) );
 		goto loop;
 	
-	CASE6( 41, 42, 43, 44, 45, 47 ): // LD B,r
-	CASE6( 48, 4A, 4B, 4C, 4D, 4F ): // LD C,r
-	CASE6( 50, 51, 53, 54, 55, 57 ): // LD D,r
-	CASE6( 58, 59, 5A, 5C, 5D, 5F ): // LD E,r
-	CASE6( 60, 61, 62, 63, 65, 67 ): // LD H,r
-	CASE6( 68, 69, 6A, 6B, 6C, 6F ): // LD L,r
-	CASE6( 78, 79, 7A, 7B, 7C, 7D ): // LD A,r
+	OP_CASE6( 41, 42, 43, 44, 45, 47 ): // LD B,r
+	OP_CASE6( 48, 4A, 4B, 4C, 4D, 4F ): // LD C,r
+	OP_CASE6( 50, 51, 53, 54, 55, 57 ): // LD D,r
+	OP_CASE6( 58, 59, 5A, 5C, 5D, 5F ): // LD E,r
+	OP_CASE6( 60, 61, 62, 63, 65, 67 ): // LD H,r
+	OP_CASE6( 68, 69, 6A, 6B, 6C, 6F ): // LD L,r
+	OP_CASE6( 78, 79, 7A, 7B, 7C, 7D ): // LD A,r
 		R8( opcode >> 3 & 7, 0 ) = R8( opcode & 7, 0 );
 		goto loop;
 	
-	CASE5( 06, 0E, 16, 1E, 26 ): // LD r,imm
+	OP_CASE5( 06, 0E, 16, 1E, 26 ): // LD r,imm
 		R8( opcode >> 3, 0 ) = data;
 		pc++;
 		goto loop;
 	
-	case 0x36: // LD (HL),imm
+	BLARGG_OP( 0x36 ): // LD (HL),imm
 		pc++;
 		WRITE( rp.hl, data );
 		goto loop;
 	
-	CASE7( 46, 4E, 56, 5E, 66, 6E, 7E ): // LD r,(HL)
+	OP_CASE7( 46, 4E, 56, 5E, 66, 6E, 7E ): // LD r,(HL)
 		R8( opcode >> 3, 8 ) = READ( rp.hl );
 		goto loop;
 	
-	case 0x01: // LD rp,imm
-	case 0x11:
-	case 0x21:
+	BLARGG_OP( 0x01 ): // LD rp,imm
+	BLARGG_OP( 0x11 ):
+	BLARGG_OP( 0x21 ):
 		R16( opcode, 4, 0x01 ) = GET_ADDR();
 		pc += 2;
 		goto loop;
 	
-	case 0x31: // LD sp,imm
+	BLARGG_OP( 0x31 ): // LD sp,imm
 		sp = GET_ADDR();
 		pc += 2;
 		goto loop;
 	
-	case 0x2A:{// LD HL,(addr)
+	BLARGG_OP( 0x2A ):{// LD HL,(addr)
 		uint16_t addr = GET_ADDR();
 		pc += 2;
 		rp.hl = READ_WORD( addr );
 		goto loop;
 	}
 	
-	case 0x32:{// LD (addr),A
+	BLARGG_OP( 0x32 ):{// LD (addr),A
 		uint16_t addr = GET_ADDR();
 		pc += 2;
 		WRITE( addr, rg.a );
 		goto loop;
 	}
 	
-	case 0x22:{// LD (addr),HL
+	BLARGG_OP( 0x22 ):{// LD (addr),HL
 		uint16_t addr = GET_ADDR();
 		pc += 2;
 		WRITE_WORD( addr, rp.hl );
 		goto loop;
 	}
 	
-	case 0x02: // LD (BC),A
-	case 0x12: // LD (DE),A
+	BLARGG_OP( 0x02 ): // LD (BC),A
+	BLARGG_OP( 0x12 ): // LD (DE),A
 		WRITE( R16( opcode, 4, 0x02 ), rg.a );
 		goto loop;
 	
-	case 0x0A: // LD A,(BC)
-	case 0x1A: // LD A,(DE)
+	BLARGG_OP( 0x0A ): // LD A,(BC)
+	BLARGG_OP( 0x1A ): // LD A,(DE)
 		rg.a = READ( R16( opcode, 4, 0x0A ) );
 		goto loop;
 	
-	case 0xF9: // LD SP,HL
+	BLARGG_OP( 0xF9 ): // LD SP,HL
 		sp = rp.hl;
 		goto loop;
 	
 // Rotate
 	
-	case 0x07:{// RLCA
+	BLARGG_OP( 0x07 ):{// RLCA
 		uint16_t temp = rg.a;
 		temp = (temp << 1) | (temp >> 7);
 		flags = (flags & (S80 | Z40 | P04)) |
@@ -697,7 +704,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0x0F:{// RRCA
+	BLARGG_OP( 0x0F ):{// RRCA
 		uint16_t temp = rg.a;
 		flags = (flags & (S80 | Z40 | P04)) |
 				(temp & C01);
@@ -707,7 +714,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0x17:{// RLA
+	BLARGG_OP( 0x17 ):{// RLA
 		blargg_ulong temp = (rg.a << 1) | (flags & C01);
 		flags = (flags & (S80 | Z40 | P04)) |
 				(temp & (F20 | F08)) |
@@ -716,7 +723,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0x1F:{// RRA
+	BLARGG_OP( 0x1F ):{// RRA
 		uint16_t temp = (flags << 7) | (rg.a >> 1);
 		flags = (flags & (S80 | Z40 | P04)) |
 				(temp & (F20 | F08)) |
@@ -726,7 +733,7 @@ possibly_out_of_time:
 	}
 	
 // Misc
-	case 0x2F:{// CPL
+	BLARGG_OP( 0x2F ):{// CPL
 		uint16_t temp = ~rg.a;
 		flags = (flags & (S80 | Z40 | P04 | C01)) |
 				(temp & (F20 | F08)) |
@@ -735,38 +742,38 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0x3F:{// CCF
+	BLARGG_OP( 0x3F ):{// CCF
 		flags = ((flags & (S80 | Z40 | P04 | C01)) ^ C01) |
 				(flags << 4 & H10) |
 				(rg.a & (F20 | F08));
 		goto loop;
 	}
 	
-	case 0x37: // SCF
+	BLARGG_OP( 0x37 ): // SCF
 		flags = (flags & (S80 | Z40 | P04)) | C01 |
 				(rg.a & (F20 | F08));
 		goto loop;
 	
-	case 0xDB: // IN A,(imm)
+	BLARGG_OP( 0xDB ): // IN A,(imm)
 		pc++;
 		rg.a = IN( data + rg.a * 0x100 );
 		goto loop;
 
-	case 0xE3:{// EX (SP),HL
+	BLARGG_OP( 0xE3 ):{// EX (SP),HL
 		uint16_t temp = READ_WORD( sp );
 		WRITE_WORD( sp, rp.hl );
 		rp.hl = temp;
 		goto loop;
 	}
 	
-	case 0xEB:{// EX DE,HL
+	BLARGG_OP( 0xEB ):{// EX DE,HL
 		uint16_t temp = rp.hl;
 		rp.hl = rp.de;
 		rp.de = temp;
 		goto loop;
 	}
 	
-	case 0xD9:{// EXX DE,HL
+	BLARGG_OP( 0xD9 ):{// EXX DE,HL
 		uint16_t temp = r.alt.w.bc;
 		r.alt.w.bc = rp.bc;
 		rp.bc = temp;
@@ -781,23 +788,23 @@ possibly_out_of_time:
 		goto loop;
 	}
 	
-	case 0xF3: // DI
+	BLARGG_OP( 0xF3 ): // DI
 		r.iff1 = 0;
 		r.iff2 = 0;
 		goto loop;
 	
-	case 0xFB: // EI
+	BLARGG_OP( 0xFB ): // EI
 		r.iff1 = 1;
 		r.iff2 = 1;
 		// TODO: delayed effect
 		goto loop;
 	
-	case 0x76: // HALT
+	BLARGG_OP( 0x76 ): // HALT
 		goto halt;
 	
 //////////////////////////////////////// CB prefix
 	{
-	case 0xCB:
+	BLARGG_OP( 0xCB ):
 		unsigned data2;
 		data2 = INSTR( 1 );
 		(void) data2; // TODO is this the same as data in all cases?
@@ -1020,7 +1027,7 @@ possibly_out_of_time:
 
 //////////////////////////////////////// ED prefix
 	{
-	case 0xED:
+	BLARGG_OP( 0xED ):
 		pc++;
 		s_time += ed_dd_timing [data] >> 4;
 		switch ( data )
@@ -1289,10 +1296,10 @@ possibly_out_of_time:
 //////////////////////////////////////// DD/FD prefix
 	{
 	uint16_t ixy;
-	case 0xDD:
+	BLARGG_OP( 0xDD ):
 		ixy = ix;
 		goto ix_prefix;
-	case 0xFD:
+	BLARGG_OP( 0xFD ):
 		ixy = iy;
 	ix_prefix:
 		pc++;
@@ -2,6 +2,7 @@
 
 #include "Blip_Buffer.h"
 
+#include "Emu_State.h"
 #include <assert.h>
 #include <limits.h>
 #include <string.h>
@@ -76,6 +77,15 @@ void Blip_Buffer::clear( int entire_buffer )
 	}
 }
 
+void Blip_Buffer::copy_state( Emu_State& s )
+{
+	s.copy( offset_ );
+	s.copy( reader_accum_ );
+	s.copy( modified_ );
+	if ( buffer_ )
+		s.copy( buffer_, (samples_avail() + blip_buffer_extra_) * sizeof (buf_t_) );
+}
+
 Blip_Buffer::blargg_err_t Blip_Buffer::set_sample_rate( long new_rate, int msec )
 {
 	if ( buffer_size_ == silent_buf_size )
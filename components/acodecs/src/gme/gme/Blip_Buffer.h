@@ -20,6 +20,8 @@ typedef blip_long blip_time_t;
 typedef short blip_sample_t;
 enum { blip_sample_max = 32767 };
 
+class Emu_State;
+
 class Blip_Buffer {
 public:
 	typedef const char* blargg_err_t;
@@ -70,6 +72,10 @@ public:
 	// Remove 'count' samples from those waiting to be read
 	void remove_samples( long count );
 	
+	// Save or restore samples waiting and synthesis in progress for a seek
+	// checkpoint (see Emu_State.h)
+	void copy_state( Emu_State& );
+	
 // Experimental features
 	
 	// Count number of clocks needed until 'count' samples will be available.
@@ -148,6 +154,11 @@ private:
 	int const blip_widest_impulse_ = 16;
 	int const blip_buffer_extra_ = blip_widest_impulse_ + 2;
 	int const blip_res = 1 << BLIP_PHASE_BITS;
+	#if BLIP_BUFFER_FAST
+		int const blip_fast_phase_bits_ = BLIP_PHASE_BITS;
+	#else
+		int const blip_fast_phase_bits_ = 8; // fast synth stores no waveform
+	#endif
 	class blip_eq_t;
 	
 	class Blip_Synth_Fast_ {
@@ -158,6 +169,7 @@ private:
 		
 		void volume_unit( double );
 		Blip_Synth_Fast_();
+		Blip_Synth_Fast_( short*, int ) { *this = Blip_Synth_Fast_(); }
 		void treble_eq( blip_eq_t const& ) { }
 	};
 	
@@ -179,7 +191,13 @@ private:
 		void adjust_impulse();
 	};
 
-// Quality level. Start with blip_good_quality.
+	template<bool fast> struct blip_synth_impl_ { typedef Blip_Synth_ type; };
+	template<> struct blip_synth_impl_<true> { typedef Blip_Synth_Fast_ type; };
+
+// Quality level. Start with blip_good_quality. blip_fast_quality is what
+// BLIP_BUFFER_FAST gives every synth: a two-point step that costs much less
+// but has no treble filtering, so high notes alias.
+const int blip_fast_quality = 0;
 const int blip_med_quality  = 8;
 const int blip_good_quality = 12;
 const int blip_high_quality = 16;
@@ -227,7 +245,7 @@ private:
 #if BLIP_BUFFER_FAST
 	Blip_Synth_Fast_ impl;
 #else
-	Blip_Synth_ impl;
+	typename blip_synth_impl_<quality == blip_fast_quality>::type impl;
 	typedef short imp_t;
 	imp_t impulses [blip_res * (quality / 2) + 1];
 public:
@@ -344,22 +362,29 @@ inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t t
 	assert( (blip_long) (time >> BLIP_BUFFER_ACCURACY) < blip_buf->buffer_size_ );
 	delta *= impl.delta_factor;
 	blip_long* BLIP_RESTRICT buf = blip_buf->buffer_ + (time >> BLIP_BUFFER_ACCURACY);
-	int phase = (int) (time >> (BLIP_BUFFER_ACCURACY - BLIP_PHASE_BITS) & (blip_res - 1));
 
-#if BLIP_BUFFER_FAST
-	blip_long left = buf [0] + delta;
-	
-	// Kind of crappy, but doing shift after multiply results in overflow.
-	// Alternate way of delaying multiply by delta_factor results in worse
-	// sub-sample resolution.
-	blip_long right = (delta >> BLIP_PHASE_BITS) * phase;
-	left  -= right;
-	right += buf [1];
-	
-	buf [0] = left;
-	buf [1] = right;
-#else
+#if !BLIP_BUFFER_FAST
+	if ( quality == blip_fast_quality )
+#endif
+	{
+		int phase = (int) (time >> (BLIP_BUFFER_ACCURACY - blip_fast_phase_bits_) &
+				((1 << blip_fast_phase_bits_) - 1));
+		blip_long left = buf [0] + delta;
+		
+		// Kind of crappy, but doing shift after multiply results in overflow.
+		// Alternate way of delaying multiply by delta_factor results in worse
+		// sub-sample resolution.
+		blip_long right = (delta >> blip_fast_phase_bits_) * phase;
+		left  -= right;
+		right += buf [1];
+		
+		buf [0] = left;
+		buf [1] = right;
+		return;
+	}
 
+#if !BLIP_BUFFER_FAST
+	int phase = (int) (time >> (BLIP_BUFFER_ACCURACY - BLIP_PHASE_BITS) & (blip_res - 1));
 	int const fwd = (blip_widest_impulse_ - quality) / 2;
 	int const rev = fwd + quality - 2;
 	int const mid = quality / 2 - 1;
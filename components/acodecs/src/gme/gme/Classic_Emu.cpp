@@ -48,7 +48,13 @@ blargg_err_t Classic_Emu::set_sample_rate_( long rate )
 	if ( !buf )
 	{
 		if ( !stereo_buffer )
-			CHECK_ALLOC( stereo_buffer = BLARGG_NEW Stereo_Buffer );
+		{
+			// a single buffer is only half the synthesis and no mixing
+			if ( mono() )
+				CHECK_ALLOC( stereo_buffer = BLARGG_NEW Mono_Buffer );
+			else
+				CHECK_ALLOC( stereo_buffer = BLARGG_NEW Stereo_Buffer );
+		}
 		buf = stereo_buffer;
 	}
 	return buf->set_sample_rate( rate, 1000 / 20 );
@@ -60,6 +66,12 @@ blargg_err_t Classic_Emu::set_multi_channel ( bool is_enabled )
         return 0;
 }
 
+blargg_err_t Classic_Emu::set_mono( bool is_enabled )
+{
+	RETURN_ERR( Music_Emu::set_mono_( is_enabled ) );
+	return 0;
+}
+
 void Classic_Emu::mute_voices_( int mask )
 {
 	Music_Emu::mute_voices_( mask );
@@ -101,6 +113,8 @@ blargg_err_t Classic_Emu::start_track_( int track )
 	return 0;
 }
 
+void Classic_Emu::copy_buffer_state( Emu_State& s ) { buf->copy_state( s ); }
+
 blargg_err_t Classic_Emu::play_( long count, sample_t* out )
 {
 	long remain = count;
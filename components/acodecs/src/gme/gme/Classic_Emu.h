@@ -14,6 +14,7 @@ public:
 	~Classic_Emu();
 	void set_buffer( Multi_Buffer* );
 	blargg_err_t set_multi_channel( bool is_enabled ) override;
+	blargg_err_t set_mono( bool is_enabled ) override;
 protected:
 	// Services
 	enum { wave_type = 0x100, noise_type = 0x200, mixed_type = wave_type | noise_type };
@@ -22,6 +23,9 @@ protected:
 	long clock_rate() const { return clock_rate_; }
 	void change_clock_rate( long ); // experimental
 	
+	// Save or restore sound waiting in the output buffer, for copy_state_()
+	void copy_buffer_state( Emu_State& );
+	
 	// Overridable
 	virtual void set_voice( int index, Blip_Buffer* center,
 			Blip_Buffer* left, Blip_Buffer* right ) = 0;
@@ -35,7 +39,7 @@ protected:
 	blargg_err_t play_( long, sample_t* );
 private:
 	Multi_Buffer* buf;
-	Multi_Buffer* stereo_buffer; // NULL if using custom buffer
+	Multi_Buffer* stereo_buffer; // NULL if using custom buffer, Mono_Buffer if mono()
 	long clock_rate_;
 	unsigned buf_changed_count;
 	int const* voice_types;
@@ -6,6 +6,10 @@
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 /* Copyright (C) 2005-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -447,3 +451,123 @@ void Std_File_Reader::close()
 	}
 }
 
+// Buffered_File_Reader
+
+Buffered_File_Reader::Buffered_File_Reader()
+{
+	fd  = -1;
+	buf = 0;
+	close();
+}
+
+Buffered_File_Reader::~Buffered_File_Reader() { close(); }
+
+blargg_err_t Buffered_File_Reader::open( const char* path )
+{
+	close();
+	
+	fd = ::open( path, O_RDONLY );
+	if ( fd < 0 )
+		return "Couldn't open file";
+	
+	struct stat st;
+	if ( fstat( fd, &st ) )
+	{
+		close();
+		return "Couldn't open file";
+	}
+	size_ = st.st_size;
+	
+	buf = (char*) malloc( block_size );
+	if ( !buf )
+	{
+		close();
+		return "Out of memory";
+	}
+	return 0;
+}
+
+void Buffered_File_Reader::close()
+{
+	if ( fd >= 0 )
+		::close( fd );
+	fd = -1;
+	free( buf );
+	buf      = 0;
+	size_    = 0;
+	pos_     = 0;
+	fd_pos   = -1;
+	buf_pos  = 0;
+	buf_size = 0;
+}
+
+long Buffered_File_Reader::size() const { return size_; }
+
+long Buffered_File_Reader::tell() const { return pos_; }
+
+blargg_err_t Buffered_File_Reader::seek( long n )
+{
+	RETURN_VALIDITY_CHECK( n >= 0 );
+	if ( n > size_ )
+		return eof_error;
+	pos_ = n;
+	return 0;
+}
+
+long Buffered_File_Reader::read_at( long pos, void* p, long s )
+{
+	if ( fd_pos != pos )
+	{
+		fd_pos = -1;
+		if ( lseek( fd, pos, SEEK_SET ) < 0 )
+			return -1;
+	}
+	long result = ::read( fd, p, s );
+	fd_pos = (result > 0 ? pos + result : -1);
+	return result;
+}
+
+long Buffered_File_Reader::read_avail( void* p, long s )
+{
+	if ( fd < 0 )
+		return -1;
+	
+	char* out = (char*) p;
+	long total = 0;
+	while ( s > 0 )
+	{
+		long offset = pos_ - buf_pos;
+		if ( offset >= 0 && offset < buf_size )
+		{
+			long n = min( s, buf_size - offset );
+			memcpy( out, buf + offset, n );
+			out   += n;
+			total += n;
+			s     -= n;
+			pos_  += n;
+			continue;
+		}
+		
+		long n;
+		if ( s >= block_size )
+		{
+			n = read_at( pos_, out, s );
+			if ( n <= 0 )
+				return total ? total : n;
+			out   += n;
+			total += n;
+			s     -= n;
+			pos_  += n;
+			continue;
+		}
+		
+		// blocks are aligned, so sequential reads of any size use whole blocks
+		buf_pos  = pos_ & ~(long) (block_size - 1);
+		buf_size = 0;
+		n = read_at( buf_pos, buf, block_size );
+		if ( n <= pos_ - buf_pos )
+			return total ? total : min( n, 0l );
+		buf_size = n;
+	}
+	return total;
+}
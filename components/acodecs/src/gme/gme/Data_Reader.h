@@ -75,6 +75,32 @@ private:
 #endif /* HAVE_ZLIB_H */
 };
 
+// Disk file reader that reads whole blocks, so small reads and seeks within
+// a block don't go through the C library or file system
+class Buffered_File_Reader : public File_Reader {
+public:
+	blargg_err_t open( const char* path );
+	void close();
+	
+public:
+	Buffered_File_Reader();
+	~Buffered_File_Reader();
+	long size() const;
+	long read_avail( void*, long );
+	long tell() const;
+	blargg_err_t seek( long );
+private:
+	enum { block_size = 4096 }; // reads this large or larger bypass the buffer
+	int fd;
+	long size_;
+	long pos_;
+	long fd_pos;    // position of fd, -1 if unknown
+	char* buf;
+	long buf_pos;   // file offset of buf
+	long buf_size;  // valid bytes in buf
+	long read_at( long pos, void*, long );
+};
+
 // Treats range of memory as a file
 class Mem_File_Reader : public File_Reader {
 public:
@@ -2,6 +2,7 @@
 
 #include "Dual_Resampler.h"
 
+#include "Emu_State.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -39,6 +40,13 @@ blargg_err_t Dual_Resampler::reset( int pairs )
 	return resampler.buffer_size( resampler_size );
 }
 
+void Dual_Resampler::copy_state( Emu_State& s )
+{
+	s.copy( buf_pos );
+	s.copy( &sample_buf [buf_pos], (sample_buf_size - buf_pos) * sizeof sample_buf [0] );
+	resampler.copy_state( s );
+}
+
 void Dual_Resampler::resize( int pairs )
 {
 	int new_sample_buf_size = pairs * 2;
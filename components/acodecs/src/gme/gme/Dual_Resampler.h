@@ -21,6 +21,10 @@ public:
 	
 	void dual_play( long count, dsample_t* out, Blip_Buffer& );
 	
+	// Save or restore mixed samples not played yet and resampler input for a
+	// seek checkpoint (see Emu_State.h)
+	void copy_state( Emu_State& );
+	
 protected:
 	virtual int play_frame( blip_time_t, int pcm_count, dsample_t* pcm_out ) = 0;
 private:
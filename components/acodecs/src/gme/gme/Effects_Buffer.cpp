@@ -2,6 +2,7 @@
 
 #include "Effects_Buffer.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
@@ -123,6 +124,27 @@ void Effects_Buffer::bass_freq( int freq )
 		bufs [i].bass_freq( freq );
 }
 
+void Effects_Buffer::copy_state( Emu_State& s )
+{
+	s.copy( stereo_remain );
+	s.copy( effect_remain );
+	for ( int i = 0; i < buf_count; i++ )
+		bufs [i].copy_state( s );
+	
+	// echo and reverb history is cleared when effects are turned on, so it
+	// only needs keeping while they are
+	if ( config_.effects_enabled && echo_buf[0].size() )
+	{
+		for ( int i = 0; i < max_voices; i++ )
+		{
+			s.copy( &echo_buf[i][0], echo_size * sizeof echo_buf[i][0] );
+			s.copy( &reverb_buf[i][0], reverb_size * sizeof reverb_buf[i][0] );
+			s.copy( echo_pos[i] );
+			s.copy( reverb_pos[i] );
+		}
+	}
+}
+
 void Effects_Buffer::clear()
 {
 	stereo_remain = 0;
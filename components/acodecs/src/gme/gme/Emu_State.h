@@ -0,0 +1,59 @@
+// Emulation state snapshots, used for seek checkpoints
+
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+#ifndef EMU_STATE_H
+#define EMU_STATE_H
+
+#include "blargg_common.h"
+#include <string.h>
+
+// Emulators and sound chips list their state once, in a copy_state() function,
+// and Emu_State measures, saves or restores whatever is passed to it. State is
+// only ever restored into the emulator it was saved from, with the same file
+// loaded, so pointers into file data or between parts of the emulator can be
+// copied as they are. Output buffers and muting are not part of the state.
+class Emu_State {
+public:
+	enum mode_t { measure_mode, save_mode, load_mode };
+
+	// Copy state to or from data, which must hold size() bytes as found by a
+	// measure_mode pass
+	Emu_State( mode_t, void* data = 0 );
+
+	bool loading() const { return mode_ == load_mode; }
+
+	// Copy n bytes at p
+	void copy( void* p, long n );
+	template<class T> void copy( T& t ) { copy( &t, sizeof t ); }
+
+	// Number of bytes copied so far
+	long size() const { return size_; }
+
+	// Samples the emulator has generated but not returned yet. They are dropped
+	// when the state is restored, so the emulator reports them when saving.
+	long pending;
+
+private:
+	mode_t mode_;
+	char* data;
+	long size_;
+};
+
+inline Emu_State::Emu_State( mode_t mode, void* p )
+{
+	mode_   = mode;
+	data    = (char*) p;
+	size_   = 0;
+	pending = 0;
+}
+
+inline void Emu_State::copy( void* p, long n )
+{
+	if ( mode_ == save_mode )
+		memcpy( data + size_, p, n );
+	else if ( mode_ == load_mode )
+		memcpy( p, data + size_, n );
+	size_ += n;
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "Fir_Resampler.h"
 
+#include "Emu_State.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -77,6 +78,15 @@ void Fir_Resampler_::clear()
 	}
 }
 
+void Fir_Resampler_::copy_state( Emu_State& s )
+{
+	int written = write_pos - buf.begin();
+	s.copy( imp_phase );
+	s.copy( written );
+	write_pos = buf.begin() + written;
+	s.copy( buf.begin(), written * sizeof buf [0] );
+}
+
 blargg_err_t Fir_Resampler_::buffer_size( int new_size )
 {
 	RETURN_ERR( buf.resize( new_size + write_offset ) );
@@ -188,6 +198,8 @@ int Fir_Resampler_::skip_input( long count )
 {
 	int remain = write_pos - buf.begin();
 	int max_count = remain - width_ * stereo;
+	if ( max_count < 0 ) // less than one impulse width buffered
+		max_count = 0;
 	if ( count > max_count )
 		count = max_count;
 	
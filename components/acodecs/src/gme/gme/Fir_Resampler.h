@@ -7,6 +7,8 @@
 #include "blargg_common.h"
 #include <string.h>
 
+class Emu_State;
+
 class Fir_Resampler_ {
 public:
 	
@@ -53,6 +55,9 @@ public:
 	// Number of output samples available
 	int avail() const { return avail_( write_pos - &buf [width_ * stereo] ); }
 	
+	// Save or restore buffered input and phase for a seek checkpoint
+	void copy_state( Emu_State& );
+	
 public:
 	~Fir_Resampler_();
 protected:
@@ -2,6 +2,7 @@
 
 #include "Gb_Apu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
@@ -126,6 +127,43 @@ void Gb_Apu::reset()
 	memcpy( wave.wave, initial_wave, sizeof initial_wave );
 }
 
+void Gb_Apu::copy_state( Emu_State& s )
+{
+	s.copy( next_frame_time );
+	s.copy( last_time );
+	s.copy( frame_count );
+	s.copy( regs );
+	
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Gb_Osc& osc = *oscs [i];
+		s.copy( osc.output_select );
+		s.copy( osc.delay );
+		s.copy( osc.last_amp );
+		s.copy( osc.volume );
+		s.copy( osc.length );
+		s.copy( osc.enabled );
+		if ( s.loading() )
+			osc.output = osc.outputs [osc.output_select];
+	}
+	
+	s.copy( square1.env_delay );
+	s.copy( square1.sweep_delay );
+	s.copy( square1.sweep_freq );
+	s.copy( square1.phase );
+	s.copy( square2.env_delay );
+	s.copy( square2.sweep_delay );
+	s.copy( square2.sweep_freq );
+	s.copy( square2.phase );
+	s.copy( wave.wave_pos );
+	s.copy( wave.wave );
+	s.copy( noise.env_delay );
+	s.copy( noise.bits );
+	
+	if ( s.loading() )
+		update_volume();
+}
+
 void Gb_Apu::run_until( blip_time_t end_time )
 {
 	require( end_time >= last_time ); // end_time must not be before previous time
@@ -143,19 +181,17 @@ void Gb_Apu::run_until( blip_time_t end_time )
 		{
 			Gb_Osc& osc = *oscs [i];
 			if ( osc.output )
-			{
 				osc.output->set_modified(); // TODO: misses optimization opportunities?
-				int playing = false;
-				if ( osc.enabled && osc.volume &&
-						(!(osc.regs [4] & osc.len_enabled_mask) || osc.length) )
-					playing = -1;
-				switch ( i )
-				{
-				case 0: square1.run( last_time, time, playing ); break;
-				case 1: square2.run( last_time, time, playing ); break;
-				case 2: wave   .run( last_time, time, playing ); break;
-				case 3: noise  .run( last_time, time, playing ); break;
-				}
+			int playing = false;
+			if ( osc.enabled && osc.volume &&
+					(!(osc.regs [4] & osc.len_enabled_mask) || osc.length) )
+				playing = -1;
+			switch ( i )
+			{
+			case 0: square1.run( last_time, time, playing ); break;
+			case 1: square2.run( last_time, time, playing ); break;
+			case 2: wave   .run( last_time, time, playing ); break;
+			case 3: noise  .run( last_time, time, playing ); break;
 			}
 		}
 		last_time = time;
@@ -6,6 +6,8 @@
 
 #include "Gb_Oscs.h"
 
+class Emu_State;
+
 class Gb_Apu {
 public:
 	
@@ -50,6 +52,10 @@ public:
 	
 	void set_tempo( double );
 	
+	// Save or restore oscillator and register state for a seek checkpoint
+	// (see Emu_State.h). Outputs and volume settings are kept as they are.
+	void copy_state( Emu_State& );
+	
 public:
 	Gb_Apu();
 private:
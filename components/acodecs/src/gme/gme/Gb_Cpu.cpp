@@ -2,6 +2,7 @@
 
 #include "Gb_Cpu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 //#include "gb_cpu_log.h"
@@ -68,6 +69,13 @@ void Gb_Cpu::reset( void* unmapped )
 	blargg_verify_byte_order();
 }
 
+void Gb_Cpu::copy_state( Emu_State& s )
+{
+	require( state == &state_ );
+	s.copy( r );
+	s.copy( state_ ); // mapped pages point into file data or RAM, which don't move
+}
+
 void Gb_Cpu::map_code( gb_addr_t start, unsigned size, void* data )
 {
 	// address range must begin and end on page boundaries
@@ -89,7 +97,7 @@ unsigned const n_flag = 0x40;
 unsigned const h_flag = 0x20;
 unsigned const c_flag = 0x10;
 
-bool Gb_Cpu::run( blargg_long cycle_count )
+BLARGG_CPU_RUN bool Gb_Cpu::run( blargg_long cycle_count )
 {
 	state_.remain = blargg_ulong (cycle_count + clocks_per_instr) / clocks_per_instr;
 	state_t s;
@@ -153,6 +161,7 @@ loop:
 		gb_cpu_log( "new", pc - 1, op, data, instr [1] );
 	#endif
 	
+	BLARGG_DISPATCH( op );
 	switch ( op )
 	{
 
@@ -168,47 +177,47 @@ loop:
 
 // Most Common
 
-	case 0x20: // JR NZ
+	BLARGG_OP( 0x20 ): // JR NZ
 		BRANCH( !(flags & z_flag) )
 	
-	case 0x21: // LD HL,IMM (common)
+	BLARGG_OP( 0x21 ): // LD HL,IMM (common)
 		rp.hl = GET_ADDR();
 		pc += 2;
 		goto loop;
 	
-	case 0x28: // JR Z
+	BLARGG_OP( 0x28 ): // JR Z
 		BRANCH( flags & z_flag )
 	
 	{
 		unsigned temp;
-	case 0xF0: // LD A,(0xFF00+imm)
+	BLARGG_OP( 0xF0 ): // LD A,(0xFF00+imm)
 		temp = data | 0xFF00;
 		pc++;
 		goto ld_a_ind_comm;
 	
-	case 0xF2: // LD A,(0xFF00+C)
+	BLARGG_OP( 0xF2 ): // LD A,(0xFF00+C)
 		temp = rg.c | 0xFF00;
 		goto ld_a_ind_comm;
 	
-	case 0x0A: // LD A,(BC)
+	BLARGG_OP( 0x0A ): // LD A,(BC)
 		temp = rp.bc;
 		goto ld_a_ind_comm;
 	
-	case 0x3A: // LD A,(HL-)
+	BLARGG_OP( 0x3A ): // LD A,(HL-)
 		temp = rp.hl;
 		rp.hl = temp - 1;
 		goto ld_a_ind_comm;
 	
-	case 0x1A: // LD A,(DE)
+	BLARGG_OP( 0x1A ): // LD A,(DE)
 		temp = rp.de;
 		goto ld_a_ind_comm;
 	
-	case 0x2A: // LD A,(HL+) (common)
+	BLARGG_OP( 0x2A ): // LD A,(HL+) (common)
 		temp = rp.hl;
 		rp.hl = temp + 1;
 		goto ld_a_ind_comm;
 		
-	case 0xFA: // LD A,IND16 (common)
+	BLARGG_OP( 0xFA ): // LD A,IND16 (common)
 		temp = GET_ADDR();
 		pc += 2;
 	ld_a_ind_comm:
@@ -216,20 +225,20 @@ loop:
 		goto loop;
 	}
 	
-	case 0xBE: // CMP (HL)
+	BLARGG_OP( 0xBE ): // CMP (HL)
 		data = READ( rp.hl );
 		goto cmp_comm;
 	
-	case 0xB8: // CMP B
-	case 0xB9: // CMP C
-	case 0xBA: // CMP D
-	case 0xBB: // CMP E
-	case 0xBC: // CMP H
-	case 0xBD: // CMP L
+	BLARGG_OP( 0xB8 ): // CMP B
+	BLARGG_OP( 0xB9 ): // CMP C
+	BLARGG_OP( 0xBA ): // CMP D
+	BLARGG_OP( 0xBB ): // CMP E
+	BLARGG_OP( 0xBC ): // CMP H
+	BLARGG_OP( 0xBD ): // CMP L
 		data = R8( op & 7 );
 		goto cmp_comm;
 	
-	case 0xFE: // CMP IMM
+	BLARGG_OP( 0xFE ): // CMP IMM
 		pc++;
 	cmp_comm:
 		op = rg.a;
@@ -243,25 +252,25 @@ loop:
 		flags |= z_flag;
 		goto loop;
 
-	case 0x46: // LD B,(HL)
-	case 0x4E: // LD C,(HL)
-	case 0x56: // LD D,(HL)
-	case 0x5E: // LD E,(HL)
-	case 0x66: // LD H,(HL)
-	case 0x6E: // LD L,(HL)
-	case 0x7E:{// LD A,(HL)
+	BLARGG_OP( 0x46 ): // LD B,(HL)
+	BLARGG_OP( 0x4E ): // LD C,(HL)
+	BLARGG_OP( 0x56 ): // LD D,(HL)
+	BLARGG_OP( 0x5E ): // LD E,(HL)
+	BLARGG_OP( 0x66 ): // LD H,(HL)
+	BLARGG_OP( 0x6E ): // LD L,(HL)
+	BLARGG_OP( 0x7E ):{// LD A,(HL)
 		unsigned addr = rp.hl;
 		READ_FAST( addr, R8( (op >> 3) & 7 ) );
 		goto loop;
 	}
 	
-	case 0xC4: // CNZ (next-most-common)
+	BLARGG_OP( 0xC4 ): // CNZ (next-most-common)
 		pc += 2;
 		if ( flags & z_flag )
 			goto loop;
 	call:
 		pc -= 2;
-	case 0xCD: // CALL (most-common)
+	BLARGG_OP( 0xCD ): // CALL (most-common)
 		data = pc + 2;
 		pc = GET_ADDR();
 	push:
@@ -271,29 +280,29 @@ loop:
 		WRITE( sp, data & 0xFF );
 		goto loop;
 	
-	case 0xC8: // RNZ (next-most-common)
+	BLARGG_OP( 0xC8 ): // RNZ (next-most-common)
 		if ( !(flags & z_flag) )
 			goto loop;
-	case 0xC9: // RET (most common)
+	BLARGG_OP( 0xC9 ): // RET (most common)
 	ret:
 		pc = READ( sp );
 		pc += 0x100 * READ( sp + 1 );
 		sp = (sp + 2) & 0xFFFF;
 		goto loop;
 	
-	case 0x00: // NOP
-	case 0x40: // LD B,B
-	case 0x49: // LD C,C
-	case 0x52: // LD D,D
-	case 0x5B: // LD E,E
-	case 0x64: // LD H,H
-	case 0x6D: // LD L,L
-	case 0x7F: // LD A,A
+	BLARGG_OP( 0x00 ): // NOP
+	BLARGG_OP( 0x40 ): // LD B,B
+	BLARGG_OP( 0x49 ): // LD C,C
+	BLARGG_OP( 0x52 ): // LD D,D
+	BLARGG_OP( 0x5B ): // LD E,E
+	BLARGG_OP( 0x64 ): // LD H,H
+	BLARGG_OP( 0x6D ): // LD L,L
+	BLARGG_OP( 0x7F ): // LD A,A
 		goto loop;
 	
 // CB Instructions
 
-	case 0xCB:
+	BLARGG_OP( 0xCB ):
 		pc++;
 		// now data is the opcode
 		switch ( data ) {
@@ -449,8 +458,8 @@ loop:
 	} // CB op
 	assert( false ); // unhandled CB op
 
-	case 0x07: // RLCA
-	case 0x17: // RLA
+	BLARGG_OP( 0x07 ): // RLCA
+	BLARGG_OP( 0x17 ): // RLA
 		data = op;
 		op = rg.a;
 	rl_comm:
@@ -462,8 +471,8 @@ loop:
 		// SLA doesn't fill lower bit
 		goto shift_comm;
 	
-	case 0x0F: // RRCA
-	case 0x1F: // RRA
+	BLARGG_OP( 0x0F ): // RRCA
+	BLARGG_OP( 0x1F ): // RRA
 		data = op;
 		op = rg.a;
 	rr_comm:
@@ -485,29 +494,29 @@ loop:
 
 // Load
 
-	case 0x70: // LD (HL),B
-	case 0x71: // LD (HL),C
-	case 0x72: // LD (HL),D
-	case 0x73: // LD (HL),E
-	case 0x74: // LD (HL),H
-	case 0x75: // LD (HL),L
-	case 0x77: // LD (HL),A
+	BLARGG_OP( 0x70 ): // LD (HL),B
+	BLARGG_OP( 0x71 ): // LD (HL),C
+	BLARGG_OP( 0x72 ): // LD (HL),D
+	BLARGG_OP( 0x73 ): // LD (HL),E
+	BLARGG_OP( 0x74 ): // LD (HL),H
+	BLARGG_OP( 0x75 ): // LD (HL),L
+	BLARGG_OP( 0x77 ): // LD (HL),A
 		op = R8( op & 7 );
 	write_hl_op_ff:
 		WRITE( rp.hl, op & 0xFF );
 		goto loop;
 
-	case 0x41: case 0x42: case 0x43: case 0x44: case 0x45: case 0x47: // LD r,r
-	case 0x48: case 0x4A: case 0x4B: case 0x4C: case 0x4D: case 0x4F:
-	case 0x50: case 0x51: case 0x53: case 0x54: case 0x55: case 0x57:
-	case 0x58: case 0x59: case 0x5A: case 0x5C: case 0x5D: case 0x5F:
-	case 0x60: case 0x61: case 0x62: case 0x63: case 0x65: case 0x67:
-	case 0x68: case 0x69: case 0x6A: case 0x6B: case 0x6C: case 0x6F:
-	case 0x78: case 0x79: case 0x7A: case 0x7B: case 0x7C: case 0x7D:
+	BLARGG_OP( 0x41 ): BLARGG_OP( 0x42 ): BLARGG_OP( 0x43 ): BLARGG_OP( 0x44 ): BLARGG_OP( 0x45 ): BLARGG_OP( 0x47 ): // LD r,r
+	BLARGG_OP( 0x48 ): BLARGG_OP( 0x4A ): BLARGG_OP( 0x4B ): BLARGG_OP( 0x4C ): BLARGG_OP( 0x4D ): BLARGG_OP( 0x4F ):
+	BLARGG_OP( 0x50 ): BLARGG_OP( 0x51 ): BLARGG_OP( 0x53 ): BLARGG_OP( 0x54 ): BLARGG_OP( 0x55 ): BLARGG_OP( 0x57 ):
+	BLARGG_OP( 0x58 ): BLARGG_OP( 0x59 ): BLARGG_OP( 0x5A ): BLARGG_OP( 0x5C ): BLARGG_OP( 0x5D ): BLARGG_OP( 0x5F ):
+	BLARGG_OP( 0x60 ): BLARGG_OP( 0x61 ): BLARGG_OP( 0x62 ): BLARGG_OP( 0x63 ): BLARGG_OP( 0x65 ): BLARGG_OP( 0x67 ):
+	BLARGG_OP( 0x68 ): BLARGG_OP( 0x69 ): BLARGG_OP( 0x6A ): BLARGG_OP( 0x6B ): BLARGG_OP( 0x6C ): BLARGG_OP( 0x6F ):
+	BLARGG_OP( 0x78 ): BLARGG_OP( 0x79 ): BLARGG_OP( 0x7A ): BLARGG_OP( 0x7B ): BLARGG_OP( 0x7C ): BLARGG_OP( 0x7D ):
 		R8( (op >> 3) & 7 ) = R8( op & 7 );
 		goto loop;
 
-	case 0x08: // LD IND16,SP
+	BLARGG_OP( 0x08 ): // LD IND16,SP
 		data = GET_ADDR();
 		pc += 2;
 		WRITE( data, sp&0xFF );
@@ -515,51 +524,51 @@ loop:
 		WRITE( data, sp >> 8 );
 		goto loop;
 	
-	case 0xF9: // LD SP,HL
+	BLARGG_OP( 0xF9 ): // LD SP,HL
 		sp = rp.hl;
 		goto loop;
 
-	case 0x31: // LD SP,IMM
+	BLARGG_OP( 0x31 ): // LD SP,IMM
 		sp = GET_ADDR();
 		pc += 2;
 		goto loop;
 	
-	case 0x01: // LD BC,IMM
-	case 0x11: // LD DE,IMM
+	BLARGG_OP( 0x01 ): // LD BC,IMM
+	BLARGG_OP( 0x11 ): // LD DE,IMM
 		r16 [op >> 4] = GET_ADDR();
 		pc += 2;
 		goto loop;
 	
 	{
 		unsigned temp;
-	case 0xE0: // LD (0xFF00+imm),A
+	BLARGG_OP( 0xE0 ): // LD (0xFF00+imm),A
 		temp = data | 0xFF00;
 		pc++;
 		goto write_data_rg_a;
 	
-	case 0xE2: // LD (0xFF00+C),A
+	BLARGG_OP( 0xE2 ): // LD (0xFF00+C),A
 		temp = rg.c | 0xFF00;
 		goto write_data_rg_a;
 
-	case 0x32: // LD (HL-),A
+	BLARGG_OP( 0x32 ): // LD (HL-),A
 		temp = rp.hl;
 		rp.hl = temp - 1;
 		goto write_data_rg_a;
 	
-	case 0x02: // LD (BC),A
+	BLARGG_OP( 0x02 ): // LD (BC),A
 		temp = rp.bc;
 		goto write_data_rg_a;
 	
-	case 0x12: // LD (DE),A
+	BLARGG_OP( 0x12 ): // LD (DE),A
 		temp = rp.de;
 		goto write_data_rg_a;
 	
-	case 0x22: // LD (HL+),A
+	BLARGG_OP( 0x22 ): // LD (HL+),A
 		temp = rp.hl;
 		rp.hl = temp + 1;
 		goto write_data_rg_a;
 		
-	case 0xEA: // LD IND16,A (common)
+	BLARGG_OP( 0xEA ): // LD IND16,A (common)
 		temp = GET_ADDR();
 		pc += 2;
 	write_data_rg_a:
@@ -567,102 +576,102 @@ loop:
 		goto loop;
 	}
 	
-	case 0x06: // LD B,IMM
+	BLARGG_OP( 0x06 ): // LD B,IMM
 		rg.b = data;
 		pc++;
 		goto loop;
 	
-	case 0x0E: // LD C,IMM
+	BLARGG_OP( 0x0E ): // LD C,IMM
 		rg.c = data;
 		pc++;
 		goto loop;
 	
-	case 0x16: // LD D,IMM
+	BLARGG_OP( 0x16 ): // LD D,IMM
 		rg.d = data;
 		pc++;
 		goto loop;
 	
-	case 0x1E: // LD E,IMM
+	BLARGG_OP( 0x1E ): // LD E,IMM
 		rg.e = data;
 		pc++;
 		goto loop;
 	
-	case 0x26: // LD H,IMM
+	BLARGG_OP( 0x26 ): // LD H,IMM
 		rg.h = data;
 		pc++;
 		goto loop;
 	
-	case 0x2E: // LD L,IMM
+	BLARGG_OP( 0x2E ): // LD L,IMM
 		rg.l = data;
 		pc++;
 		goto loop;
 	
-	case 0x36: // LD (HL),IMM
+	BLARGG_OP( 0x36 ): // LD (HL),IMM
 		WRITE( rp.hl, data );
 		pc++;
 		goto loop;
 	
-	case 0x3E: // LD A,IMM
+	BLARGG_OP( 0x3E ): // LD A,IMM
 		rg.a = data;
 		pc++;
 		goto loop;
 
 // Increment/Decrement
 
-	case 0x03: // INC BC
-	case 0x13: // INC DE
-	case 0x23: // INC HL
+	BLARGG_OP( 0x03 ): // INC BC
+	BLARGG_OP( 0x13 ): // INC DE
+	BLARGG_OP( 0x23 ): // INC HL
 		r16 [op >> 4]++;
 		goto loop;
 	
-	case 0x33: // INC SP
+	BLARGG_OP( 0x33 ): // INC SP
 		sp = (sp + 1) & 0xFFFF;
 		goto loop;
 
-	case 0x0B: // DEC BC
-	case 0x1B: // DEC DE
-	case 0x2B: // DEC HL
+	BLARGG_OP( 0x0B ): // DEC BC
+	BLARGG_OP( 0x1B ): // DEC DE
+	BLARGG_OP( 0x2B ): // DEC HL
 		r16 [op >> 4]--;
 		goto loop;
 	
-	case 0x3B: // DEC SP
+	BLARGG_OP( 0x3B ): // DEC SP
 		sp = (sp - 1) & 0xFFFF;
 		goto loop;
 	
-	case 0x34: // INC (HL)
+	BLARGG_OP( 0x34 ): // INC (HL)
 		op = rp.hl;
 		data = READ( op );
 		data++;
 		WRITE( op, data & 0xFF );
 		goto inc_comm;
 	
-	case 0x04: // INC B
-	case 0x0C: // INC C (common)
-	case 0x14: // INC D
-	case 0x1C: // INC E
-	case 0x24: // INC H
-	case 0x2C: // INC L
-	case 0x3C: // INC A
+	BLARGG_OP( 0x04 ): // INC B
+	BLARGG_OP( 0x0C ): // INC C (common)
+	BLARGG_OP( 0x14 ): // INC D
+	BLARGG_OP( 0x1C ): // INC E
+	BLARGG_OP( 0x24 ): // INC H
+	BLARGG_OP( 0x2C ): // INC L
+	BLARGG_OP( 0x3C ): // INC A
 		op = (op >> 3) & 7;
 		R8( op ) = data = R8( op ) + 1;
 	inc_comm:
 		flags = (flags & c_flag) | (((data & 15) - 1) & h_flag) | ((data >> 1) & z_flag);
 		goto loop;
 	
-	case 0x35: // DEC (HL)
+	BLARGG_OP( 0x35 ): // DEC (HL)
 		op = rp.hl;
 		data = READ( op );
 		data--;
 		WRITE( op, data & 0xFF );
 		goto dec_comm;
 	
-	case 0x05: // DEC B
-	case 0x0D: // DEC C
-	case 0x15: // DEC D
-	case 0x1D: // DEC E
-	case 0x25: // DEC H
-	case 0x2D: // DEC L
-	case 0x3D: // DEC A
+	BLARGG_OP( 0x05 ): // DEC B
+	BLARGG_OP( 0x0D ): // DEC C
+	BLARGG_OP( 0x15 ): // DEC D
+	BLARGG_OP( 0x1D ): // DEC E
+	BLARGG_OP( 0x25 ): // DEC H
+	BLARGG_OP( 0x2D ): // DEC L
+	BLARGG_OP( 0x3D ): // DEC A
 		op = (op >> 3) & 7;
 		data = R8( op ) - 1;
 		R8( op ) = data;
@@ -679,7 +688,7 @@ loop:
 		blargg_ulong temp; // need more than 16 bits for carry
 		unsigned prev;
 		
-	case 0xF8: // LD HL,SP+imm
+	BLARGG_OP( 0xF8 ): // LD HL,SP+imm
 		temp = int8_t (data); // sign-extend to 16 bits
 		pc++;
 		flags = 0;
@@ -687,7 +696,7 @@ loop:
 		prev = sp;
 		goto add_16_hl;
 	
-	case 0xE8: // ADD SP,IMM
+	BLARGG_OP( 0xE8 ): // ADD SP,IMM
 		temp = int8_t (data); // sign-extend to 16 bits
 		pc++;
 		flags = 0;
@@ -696,13 +705,13 @@ loop:
 		sp = temp & 0xFFFF;
 		goto add_16_comm;
 
-	case 0x39: // ADD HL,SP
+	BLARGG_OP( 0x39 ): // ADD HL,SP
 		temp = sp;
 		goto add_hl_comm;
 	
-	case 0x09: // ADD HL,BC
-	case 0x19: // ADD HL,DE
-	case 0x29: // ADD HL,HL
+	BLARGG_OP( 0x09 ): // ADD HL,BC
+	BLARGG_OP( 0x19 ): // ADD HL,DE
+	BLARGG_OP( 0x29 ): // ADD HL,HL
 		temp = r16 [op >> 4];
 	add_hl_comm:
 		prev = rp.hl;
@@ -716,21 +725,21 @@ loop:
 		goto loop;
 	}
 	
-	case 0x86: // ADD (HL)
+	BLARGG_OP( 0x86 ): // ADD (HL)
 		data = READ( rp.hl );
 		goto add_comm;
 	
-	case 0x80: // ADD B
-	case 0x81: // ADD C
-	case 0x82: // ADD D
-	case 0x83: // ADD E
-	case 0x84: // ADD H
-	case 0x85: // ADD L
-	case 0x87: // ADD A
+	BLARGG_OP( 0x80 ): // ADD B
+	BLARGG_OP( 0x81 ): // ADD C
+	BLARGG_OP( 0x82 ): // ADD D
+	BLARGG_OP( 0x83 ): // ADD E
+	BLARGG_OP( 0x84 ): // ADD H
+	BLARGG_OP( 0x85 ): // ADD L
+	BLARGG_OP( 0x87 ): // ADD A
 		data = R8( op & 7 );
 		goto add_comm;
 	
-	case 0xC6: // ADD IMM
+	BLARGG_OP( 0xC6 ): // ADD IMM
 		pc++;
 	add_comm:
 		flags = rg.a;
@@ -745,42 +754,42 @@ loop:
 
 // Add/Subtract
 
-	case 0x8E: // ADC (HL)
+	BLARGG_OP( 0x8E ): // ADC (HL)
 		data = READ( rp.hl );
 		goto adc_comm;
 	
-	case 0x88: // ADC B
-	case 0x89: // ADC C
-	case 0x8A: // ADC D
-	case 0x8B: // ADC E
-	case 0x8C: // ADC H
-	case 0x8D: // ADC L
-	case 0x8F: // ADC A
+	BLARGG_OP( 0x88 ): // ADC B
+	BLARGG_OP( 0x89 ): // ADC C
+	BLARGG_OP( 0x8A ): // ADC D
+	BLARGG_OP( 0x8B ): // ADC E
+	BLARGG_OP( 0x8C ): // ADC H
+	BLARGG_OP( 0x8D ): // ADC L
+	BLARGG_OP( 0x8F ): // ADC A
 		data = R8( op & 7 );
 		goto adc_comm;
 	
-	case 0xCE: // ADC IMM
+	BLARGG_OP( 0xCE ): // ADC IMM
 		pc++;
 	adc_comm:
 		data += (flags >> 4) & 1;
 		data &= 0xFF; // to do: does carry get set when sum + carry = 0x100?
 		goto add_comm;
 
-	case 0x96: // SUB (HL)
+	BLARGG_OP( 0x96 ): // SUB (HL)
 		data = READ( rp.hl );
 		goto sub_comm;
 	
-	case 0x90: // SUB B
-	case 0x91: // SUB C
-	case 0x92: // SUB D
-	case 0x93: // SUB E
-	case 0x94: // SUB H
-	case 0x95: // SUB L
-	case 0x97: // SUB A
+	BLARGG_OP( 0x90 ): // SUB B
+	BLARGG_OP( 0x91 ): // SUB C
+	BLARGG_OP( 0x92 ): // SUB D
+	BLARGG_OP( 0x93 ): // SUB E
+	BLARGG_OP( 0x94 ): // SUB H
+	BLARGG_OP( 0x95 ): // SUB L
+	BLARGG_OP( 0x97 ): // SUB A
 		data = R8( op & 7 );
 		goto sub_comm;
 	
-	case 0xD6: // SUB IMM
+	BLARGG_OP( 0xD6 ): // SUB IMM
 		pc++;
 	sub_comm:
 		op = rg.a;
@@ -788,21 +797,21 @@ loop:
 		rg.a = data;
 		goto sub_set_flags;
 
-	case 0x9E: // SBC (HL)
+	BLARGG_OP( 0x9E ): // SBC (HL)
 		data = READ( rp.hl );
 		goto sbc_comm;
 	
-	case 0x98: // SBC B
-	case 0x99: // SBC C
-	case 0x9A: // SBC D
-	case 0x9B: // SBC E
-	case 0x9C: // SBC H
-	case 0x9D: // SBC L
-	case 0x9F: // SBC A
+	BLARGG_OP( 0x98 ): // SBC B
+	BLARGG_OP( 0x99 ): // SBC C
+	BLARGG_OP( 0x9A ): // SBC D
+	BLARGG_OP( 0x9B ): // SBC E
+	BLARGG_OP( 0x9C ): // SBC H
+	BLARGG_OP( 0x9D ): // SBC L
+	BLARGG_OP( 0x9F ): // SBC A
 		data = R8( op & 7 );
 		goto sbc_comm;
 	
-	case 0xDE: // SBC IMM
+	BLARGG_OP( 0xDE ): // SBC IMM
 		pc++;
 	sbc_comm:
 		data += (flags >> 4) & 1;
@@ -811,59 +820,59 @@ loop:
 
 // Logical
 
-	case 0xA0: // AND B
-	case 0xA1: // AND C
-	case 0xA2: // AND D
-	case 0xA3: // AND E
-	case 0xA4: // AND H
-	case 0xA5: // AND L
+	BLARGG_OP( 0xA0 ): // AND B
+	BLARGG_OP( 0xA1 ): // AND C
+	BLARGG_OP( 0xA2 ): // AND D
+	BLARGG_OP( 0xA3 ): // AND E
+	BLARGG_OP( 0xA4 ): // AND H
+	BLARGG_OP( 0xA5 ): // AND L
 		data = R8( op & 7 );
 		goto and_comm;
 	
-	case 0xA6: // AND (HL)
+	BLARGG_OP( 0xA6 ): // AND (HL)
 		data = READ( rp.hl );
 		pc--;
-	case 0xE6: // AND IMM
+	BLARGG_OP( 0xE6 ): // AND IMM
 		pc++;
 	and_comm:
 		rg.a &= data;
-	case 0xA7: // AND A
+	BLARGG_OP( 0xA7 ): // AND A
 		flags = h_flag | (((rg.a - 1) >> 1) & z_flag);
 		goto loop;
 
-	case 0xB0: // OR B
-	case 0xB1: // OR C
-	case 0xB2: // OR D
-	case 0xB3: // OR E
-	case 0xB4: // OR H
-	case 0xB5: // OR L
+	BLARGG_OP( 0xB0 ): // OR B
+	BLARGG_OP( 0xB1 ): // OR C
+	BLARGG_OP( 0xB2 ): // OR D
+	BLARGG_OP( 0xB3 ): // OR E
+	BLARGG_OP( 0xB4 ): // OR H
+	BLARGG_OP( 0xB5 ): // OR L
 		data = R8( op & 7 );
 		goto or_comm;
 	
-	case 0xB6: // OR (HL)
+	BLARGG_OP( 0xB6 ): // OR (HL)
 		data = READ( rp.hl );
 		pc--;
-	case 0xF6: // OR IMM
+	BLARGG_OP( 0xF6 ): // OR IMM
 		pc++;
 	or_comm:
 		rg.a |= data;
-	case 0xB7: // OR A
+	BLARGG_OP( 0xB7 ): // OR A
 		flags = ((rg.a - 1) >> 1) & z_flag;
 		goto loop;
 
-	case 0xA8: // XOR B
-	case 0xA9: // XOR C
-	case 0xAA: // XOR D
-	case 0xAB: // XOR E
-	case 0xAC: // XOR H
-	case 0xAD: // XOR L
+	BLARGG_OP( 0xA8 ): // XOR B
+	BLARGG_OP( 0xA9 ): // XOR C
+	BLARGG_OP( 0xAA ): // XOR D
+	BLARGG_OP( 0xAB ): // XOR E
+	BLARGG_OP( 0xAC ): // XOR H
+	BLARGG_OP( 0xAD ): // XOR L
 		data = R8( op & 7 );
 		goto xor_comm;
 	
-	case 0xAE: // XOR (HL)
+	BLARGG_OP( 0xAE ): // XOR (HL)
 		data = READ( rp.hl );
 		pc--;
-	case 0xEE: // XOR IMM
+	BLARGG_OP( 0xEE ): // XOR IMM
 		pc++;
 	xor_comm:
 		data ^= rg.a;
@@ -872,17 +881,17 @@ loop:
 		flags = (data >> 1) & z_flag;
 		goto loop;
 	
-	case 0xAF: // XOR A
+	BLARGG_OP( 0xAF ): // XOR A
 		rg.a = 0;
 		flags = z_flag;
 		goto loop;
 
 // Stack
 
-	case 0xF1: // POP FA
-	case 0xC1: // POP BC
-	case 0xD1: // POP DE
-	case 0xE1: // POP HL (common)
+	BLARGG_OP( 0xF1 ): // POP FA
+	BLARGG_OP( 0xC1 ): // POP BC
+	BLARGG_OP( 0xD1 ): // POP DE
+	BLARGG_OP( 0xE1 ): // POP HL (common)
 		data = READ( sp );
 		r16 [(op >> 4) & 3] = data + 0x100 * READ( sp + 1 );
 		sp = (sp + 2) & 0xFFFF;
@@ -891,94 +900,94 @@ loop:
 		flags = rg.flags & 0xF0;
 		goto loop;
 	
-	case 0xC5: // PUSH BC
+	BLARGG_OP( 0xC5 ): // PUSH BC
 		data = rp.bc;
 		goto push;
 	
-	case 0xD5: // PUSH DE
+	BLARGG_OP( 0xD5 ): // PUSH DE
 		data = rp.de;
 		goto push;
 	
-	case 0xE5: // PUSH HL
+	BLARGG_OP( 0xE5 ): // PUSH HL
 		data = rp.hl;
 		goto push;
 	
-	case 0xF5: // PUSH FA
+	BLARGG_OP( 0xF5 ): // PUSH FA
 		data = (flags << 8) | rg.a;
 		goto push;
 
 // Flow control
 	
-	case 0xFF:
+	BLARGG_OP( 0xFF ):
 		if ( pc == idle_addr + 1 )
 			goto stop;
-	case 0xC7: case 0xCF: case 0xD7: case 0xDF:  // RST
-	case 0xE7: case 0xEF: case 0xF7:
+	BLARGG_OP( 0xC7 ): BLARGG_OP( 0xCF ): BLARGG_OP( 0xD7 ): BLARGG_OP( 0xDF ):  // RST
+	BLARGG_OP( 0xE7 ): BLARGG_OP( 0xEF ): BLARGG_OP( 0xF7 ):
 		data = pc;
 		pc = (op & 0x38) + rst_base;
 		goto push;
 	
-	case 0xCC: // CZ
+	BLARGG_OP( 0xCC ): // CZ
 		pc += 2;
 		if ( flags & z_flag )
 			goto call;
 		goto loop;
 	
-	case 0xD4: // CNC
+	BLARGG_OP( 0xD4 ): // CNC
 		pc += 2;
 		if ( !(flags & c_flag) )
 			goto call;
 		goto loop;
 	
-	case 0xDC: // CC
+	BLARGG_OP( 0xDC ): // CC
 		pc += 2;
 		if ( flags & c_flag )
 			goto call;
 		goto loop;
 
-	case 0xD9: // RETI
+	BLARGG_OP( 0xD9 ): // RETI
 		//interrupts_enabled = 1;
 		goto ret;
 	
-	case 0xC0: // RZ
+	BLARGG_OP( 0xC0 ): // RZ
 		if ( !(flags & z_flag) )
 			goto ret;
 		goto loop;
 	
-	case 0xD0: // RNC
+	BLARGG_OP( 0xD0 ): // RNC
 		if ( !(flags & c_flag) )
 			goto ret;
 		goto loop;
 	
-	case 0xD8: // RC
+	BLARGG_OP( 0xD8 ): // RC
 		if ( flags & c_flag )
 			goto ret;
 		goto loop;
 
-	case 0x18: // JR
+	BLARGG_OP( 0x18 ): // JR
 		BRANCH( true )
 	
-	case 0x30: // JR NC
+	BLARGG_OP( 0x30 ): // JR NC
 		BRANCH( !(flags & c_flag) )
 	
-	case 0x38: // JR C
+	BLARGG_OP( 0x38 ): // JR C
 		BRANCH( flags & c_flag )
 	
-	case 0xE9: // JP_HL
+	BLARGG_OP( 0xE9 ): // JP_HL
 		pc = rp.hl;
 		goto loop;
 
-	case 0xC3: // JP (next-most-common)
+	BLARGG_OP( 0xC3 ): // JP (next-most-common)
 		pc = GET_ADDR();
 		goto loop;
 	
-	case 0xC2: // JP NZ
+	BLARGG_OP( 0xC2 ): // JP NZ
 		pc += 2;
 		if ( !(flags & z_flag) )
 			goto jp_taken;
 		goto loop;
 	
-	case 0xCA: // JP Z (most common)
+	BLARGG_OP( 0xCA ): // JP Z (most common)
 		pc += 2;
 		if ( !(flags & z_flag) )
 			goto loop;
@@ -987,13 +996,13 @@ loop:
 		pc = GET_ADDR();
 		goto loop;
 	
-	case 0xD2: // JP NC
+	BLARGG_OP( 0xD2 ): // JP NC
 		pc += 2;
 		if ( !(flags & c_flag) )
 			goto jp_taken;
 		goto loop;
 	
-	case 0xDA: // JP C
+	BLARGG_OP( 0xDA ): // JP C
 		pc += 2;
 		if ( flags & c_flag )
 			goto jp_taken;
@@ -1001,36 +1010,36 @@ loop:
 
 // Flags
 
-	case 0x2F: // CPL
+	BLARGG_OP( 0x2F ): // CPL
 		rg.a = ~rg.a;
 		flags |= n_flag | h_flag;
 		goto loop;
 
-	case 0x3F: // CCF
+	BLARGG_OP( 0x3F ): // CCF
 		flags = (flags ^ c_flag) & ~(n_flag | h_flag);
 		goto loop;
 
-	case 0x37: // SCF
+	BLARGG_OP( 0x37 ): // SCF
 		flags = (flags | c_flag) & ~(n_flag | h_flag);
 		goto loop;
 
-	case 0xF3: // DI
+	BLARGG_OP( 0xF3 ): // DI
 		//interrupts_enabled = 0;
 		goto loop;
 
-	case 0xFB: // EI
+	BLARGG_OP( 0xFB ): // EI
 		//interrupts_enabled = 1;
 		goto loop;
 
 // Special
 
-	case 0xDD: case 0xD3: case 0xDB: case 0xE3: case 0xE4: // ?
-	case 0xEB: case 0xEC: case 0xF4: case 0xFD: case 0xFC:
-	case 0x10: // STOP
-	case 0x27: // DAA (I'll have to implement this eventually...)
-	case 0xBF:
-	case 0xED: // Z80 prefix
-	case 0x76: // HALT
+	BLARGG_OP( 0xDD ): BLARGG_OP( 0xD3 ): BLARGG_OP( 0xDB ): BLARGG_OP( 0xE3 ): BLARGG_OP( 0xE4 ): // ?
+	BLARGG_OP( 0xEB ): BLARGG_OP( 0xEC ): BLARGG_OP( 0xF4 ): BLARGG_OP( 0xFD ): BLARGG_OP( 0xFC ):
+	BLARGG_OP( 0x10 ): // STOP
+	BLARGG_OP( 0x27 ): // DAA (I'll have to implement this eventually...)
+	BLARGG_OP( 0xBF ):
+	BLARGG_OP( 0xED ): // Z80 prefix
+	BLARGG_OP( 0x76 ): // HALT
 		s.remain++;
 		goto stop;
 	}
@@ -10,6 +10,8 @@
 
 typedef unsigned gb_addr_t; // 16-bit CPU address
 
+class Emu_State;
+
 class Gb_Cpu {
 	enum { clocks_per_instr = 4 };
 public:
@@ -60,6 +62,10 @@ public:
 	// Can read this many bytes past end of a page
 	enum { cpu_padding = 8 };
 	
+	// Save or restore registers and memory mapping for a seek checkpoint
+	// (see Emu_State.h). Must not be called from within run().
+	void copy_state( Emu_State& );
+	
 public:
 	Gb_Cpu() : rst_base( 0 ) { state = &state_; }
 	enum { page_shift = 13 };
@@ -129,6 +129,23 @@ void Gb_Square::run( blip_time_t time, blip_time_t end_time, int playing )
 		playing = false;
 	}
 	
+	if ( !output )
+	{
+		// muted or not panned anywhere: only maintain phase
+		time += delay;
+		if ( !playing )
+			time = end_time;
+		if ( time < end_time )
+		{
+			int const period = (2048 - frequency) * 4;
+			int count = (end_time - time + period - 1) / period;
+			phase = (phase + count) & 7;
+			time += count * period;
+		}
+		delay = time - end_time;
+		return;
+	}
+	
 	{
 		int delta = amp - last_amp;
 		if ( delta )
@@ -170,6 +187,21 @@ void Gb_Square::run( blip_time_t time, blip_time_t end_time, int playing )
 
 void Gb_Noise::run( blip_time_t time, blip_time_t end_time, int playing )
 {
+	static unsigned char const table [8] = { 8, 16, 32, 48, 64, 80, 96, 112 };
+	int period = table [regs [3] & 7] << (regs [3] >> 4);
+	
+	if ( !output )
+	{
+		// muted or not panned anywhere: only maintain timing
+		time += delay;
+		if ( !playing )
+			time = end_time;
+		if ( time < end_time )
+			time += (end_time - time + period - 1) / period * period;
+		delay = time - end_time;
+		return;
+	}
+	
 	int amp = volume & playing;
 	int tap = 13 - (regs [3] & 8);
 	if ( bits >> tap & 2 )
@@ -190,9 +222,6 @@ void Gb_Noise::run( blip_time_t time, blip_time_t end_time, int playing )
 	
 	if ( time < end_time )
 	{
-		static unsigned char const table [8] = { 8, 16, 32, 48, 64, 80, 96, 112 };
-		int period = table [regs [3] & 7] << (regs [3] >> 4);
-		
 		// keep parallel resampled time to eliminate time conversion in the loop
 		Blip_Buffer* const output = this->output;
 		const blip_resampled_time_t resampled_period =
@@ -266,6 +295,23 @@ void Gb_Wave::run( blip_time_t time, blip_time_t end_time, int playing )
 			playing = false;
 		}
 		
+		if ( !output )
+		{
+			// muted or not panned anywhere: only maintain wave position
+			time += delay;
+			if ( !playing )
+				time = end_time;
+			if ( time < end_time )
+			{
+				int const period = (2048 - frequency) * 2;
+				int count = (end_time - time + period - 1) / period;
+				wave_pos = (wave_pos + count) & (wave_size - 1);
+				time += count * period;
+			}
+			delay = time - end_time;
+			return;
+		}
+		
 		int delta = amp - last_amp;
 		if ( delta )
 		{
@@ -7,6 +7,11 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef GB_APU_FAST_SYNTH
+	#define GB_APU_FAST_SYNTH 0
+#endif
+
 struct Gb_Osc
 {
 	enum { trigger = 0x80 };
@@ -42,7 +47,7 @@ struct Gb_Square : Gb_Env
 	enum { period_mask = 0x70 };
 	enum { shift_mask  = 0x07 };
 	
-	typedef Blip_Synth<blip_good_quality,1> Synth;
+	typedef Blip_Synth<(GB_APU_FAST_SYNTH ? blip_fast_quality : blip_good_quality),1> Synth;
 	Synth const* synth;
 	int sweep_delay;
 	int sweep_freq;
@@ -55,7 +60,7 @@ struct Gb_Square : Gb_Env
 
 struct Gb_Noise : Gb_Env
 {
-	typedef Blip_Synth<blip_med_quality,1> Synth;
+	typedef Blip_Synth<(GB_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> Synth;
 	Synth const* synth;
 	unsigned bits;
 	
@@ -64,7 +69,7 @@ struct Gb_Noise : Gb_Env
 
 struct Gb_Wave : Gb_Osc
 {
-	typedef Blip_Synth<blip_med_quality,1> Synth;
+	typedef Blip_Synth<(GB_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> Synth;
 	Synth const* synth;
 	int wave_pos;
 	enum { wave_size = 32 };
@@ -2,6 +2,7 @@
 
 #include "Gbs_Emu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <string.h>
 
@@ -100,7 +101,7 @@ struct Gbs_File : Gme_Info_
 static Music_Emu* new_gbs_emu () { return BLARGG_NEW Gbs_Emu ; }
 static Music_Emu* new_gbs_file() { return BLARGG_NEW Gbs_File; }
 
-static gme_type_t_ const gme_gbs_type_ = { "Game Boy", 0, &new_gbs_emu, &new_gbs_file, "GBS", 1 };
+static gme_type_t_ const gme_gbs_type_ = { "Game Boy", 0, &new_gbs_emu, &new_gbs_file, "GBS", 1, 0 };
 BLARGG_EXPORT extern gme_type_t const gme_gbs_type = &gme_gbs_type_;
 
 // Setup
@@ -288,3 +289,15 @@ blargg_err_t Gbs_Emu::run_clocks( blip_time_t& duration, int )
 	
 	return 0;
 }
+
+bool Gbs_Emu::copy_state_( Emu_State& s )
+{
+	copy_buffer_state( s );
+	cpu::copy_state( s );
+	s.copy( ram );
+	s.copy( cpu_time );
+	s.copy( play_period );
+	s.copy( next_play );
+	apu.copy_state( s );
+	return true;
+}
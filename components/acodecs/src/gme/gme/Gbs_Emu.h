@@ -53,6 +53,7 @@ protected:
 	blargg_err_t load_( Data_Reader& );
 	blargg_err_t start_track_( int );
 	blargg_err_t run_clocks( blip_time_t&, int );
+	bool copy_state_( Emu_State& );
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
@@ -96,12 +96,17 @@ blargg_err_t Gme_File::load( Data_Reader& in )
 	return post_load( load_( in ) );
 }
 
-blargg_err_t Gme_File::load_file( const char* path )
+blargg_err_t Gme_File::load_file_( const char* path )
 {
-	pre_load();
 	GME_FILE_READER in;
 	RETURN_ERR( in.open( path ) );
-	return post_load( load_( in ) );
+	return load_( in );
+}
+
+blargg_err_t Gme_File::load_file( const char* path )
+{
+	pre_load();
+	return post_load( load_file_( path ) );
 }
 
 blargg_err_t Gme_File::load_remaining_( void const* h, long s, Data_Reader& in )
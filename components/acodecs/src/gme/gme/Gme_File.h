@@ -22,6 +22,7 @@ struct gme_type_t_
 	/* internal */
 	const char* extension_;
 	int flags_;
+	long native_rate_;          /* non-zero if emulator resamples from a fixed rate */
 };
 
 struct track_info_t
@@ -116,6 +117,7 @@ protected:
 	// Overridable
 	virtual void unload();  // called before loading file and if loading fails
 	virtual blargg_err_t load_( Data_Reader& ); // default loads then calls load_mem_()
+	virtual blargg_err_t load_file_( const char* path ); // default opens file and calls load_()
 	virtual blargg_err_t load_mem_( byte const* data, long size ); // use data in memory
 	virtual blargg_err_t track_info_( track_info_t* out, int track ) const = 0;
 	virtual void pre_load();
@@ -161,7 +161,7 @@ struct Gym_File : Gme_Info_
 static Music_Emu* new_gym_emu () { return BLARGG_NEW Gym_Emu ; }
 static Music_Emu* new_gym_file() { return BLARGG_NEW Gym_File; }
 
-static gme_type_t_ const gme_gym_type_ = { "Sega Genesis", 1, &new_gym_emu, &new_gym_file, "GYM", 0 };
+static gme_type_t_ const gme_gym_type_ = { "Sega Genesis", 1, &new_gym_emu, &new_gym_file, "GYM", 0, 0 };
 BLARGG_EXPORT extern gme_type_t const gme_gym_type = &gme_gym_type_;
 
 // Setup
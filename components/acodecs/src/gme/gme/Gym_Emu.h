@@ -51,6 +51,8 @@ protected:
 	blargg_err_t play_( long count, sample_t* );
 	void mute_voices_( int );
 	void set_tempo_( double );
+	blargg_err_t set_ym2612_core_( int core )   { return fm.set_core( core ); }
+	int ym2612_core_() const                    { return fm.core(); }
 	int play_frame( blip_time_t blip_time, int sample_count, sample_t* buf );
 private:
 	// sequence data begin, loop begin, current position, end
@@ -0,0 +1,171 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "Gzip_Reader.h"
+
+#include "Inflater.h"
+#include "blargg_endian.h"
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or (at
+your option) any later version. This module is distributed in the hope that
+it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+Lesser General Public License for more details. You should have received a
+copy of the GNU Lesser General Public License along with this module; if not,
+write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+Boston, MA 02110-1301 USA */
+
+#include "blargg_source.h"
+
+// gzip header flags
+enum {
+	flag_hcrc    = 0x02,
+	flag_extra   = 0x04,
+	flag_name    = 0x08,
+	flag_comment = 0x10
+};
+
+Gzip_Reader::Gzip_Reader()
+{
+	in       = 0;
+	inflater = 0;
+	kept     = 0;
+	close();
+}
+
+Gzip_Reader::~Gzip_Reader()
+{
+	close();
+}
+
+bool Gzip_Reader::is_gzip( void const* header, long size )
+{
+	unsigned char const* h = (unsigned char const*) header;
+	return size >= 2 && h [0] == 0x1F && h [1] == 0x8B;
+}
+
+static blargg_err_t skip_string( File_Reader* in )
+{
+	char c;
+	do
+		RETURN_ERR( in->read( &c, 1 ) );
+	while ( c );
+	return 0;
+}
+
+blargg_err_t Gzip_Reader::open( File_Reader* new_in )
+{
+	close();
+
+	unsigned char h [10];
+	RETURN_ERR( new_in->read( h, sizeof h ) );
+	if ( !is_gzip( h, sizeof h ) || h [2] != 8 )
+		return "Not a gzip file";
+
+	if ( h [3] & flag_extra )
+	{
+		unsigned char n [2];
+		RETURN_ERR( new_in->read( n, sizeof n ) );
+		RETURN_ERR( new_in->skip( get_le16( n ) ) );
+	}
+	if ( h [3] & flag_name )
+		RETURN_ERR( skip_string( new_in ) );
+	if ( h [3] & flag_comment )
+		RETURN_ERR( skip_string( new_in ) );
+	if ( h [3] & flag_hcrc )
+		RETURN_ERR( new_in->skip( 2 ) );
+	long begin = new_in->tell();
+
+	// uncompressed size (modulo 4 GB) is in the last four bytes
+	unsigned char n [4];
+	RETURN_ERR( new_in->seek( new_in->size() - sizeof n ) );
+	RETURN_ERR( new_in->read( n, sizeof n ) );
+	RETURN_ERR( new_in->seek( begin ) );
+
+	CHECK_ALLOC( inflater = BLARGG_NEW Inflater );
+	inflater->begin( new_in );
+	in         = new_in;
+	size_      = get_le32( n );
+	data_begin = begin;
+	return 0;
+}
+
+void Gzip_Reader::keep_state_at( long pos )
+{
+	if ( !kept )
+		kept = BLARGG_NEW Inflater;
+	kept_pos   = pos;
+	kept_valid = false;
+}
+
+void Gzip_Reader::close()
+{
+	delete inflater;
+	inflater   = 0;
+	delete kept;
+	kept       = 0;
+	kept_pos   = 0;
+	kept_valid = false;
+	in         = 0;
+	size_      = 0;
+	data_begin = 0;
+}
+
+long Gzip_Reader::size() const { return size_; }
+
+long Gzip_Reader::tell() const { return inflater ? inflater->tell() : 0; }
+
+long Gzip_Reader::read_avail( void* p, long n )
+{
+	if ( !inflater )
+		return -1;
+
+	char* out = (char*) p;
+	long total = 0;
+	while ( total < n )
+	{
+		long count = n - total;
+		long pos = inflater->tell();
+		if ( kept && !kept_valid && pos <= kept_pos )
+		{
+			// stop exactly at kept_pos so the state there can be saved
+			if ( pos == kept_pos )
+			{
+				*kept = *inflater;
+				kept_valid = true;
+			}
+			else if ( count > kept_pos - pos )
+			{
+				count = kept_pos - pos;
+			}
+		}
+
+		count = inflater->read( out + total, count );
+		if ( count <= 0 )
+			return total ? total : count;
+		total += count;
+	}
+	return total;
+}
+
+blargg_err_t Gzip_Reader::seek( long n )
+{
+	if ( !inflater )
+		return "Gzip file not open";
+
+	if ( n < inflater->tell() )
+	{
+		if ( kept_valid && n >= kept_pos )
+		{
+			*inflater = *kept;
+			RETURN_ERR( inflater->resume() );
+		}
+		else
+		{
+			RETURN_ERR( in->seek( data_begin ) );
+			inflater->begin( in );
+		}
+	}
+	return Data_Reader::skip( n - inflater->tell() );
+}
@@ -0,0 +1,48 @@
+// Gzip file reader that decompresses as it goes
+
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+#ifndef GZIP_READER_H
+#define GZIP_READER_H
+
+#include "Data_Reader.h"
+
+class Inflater;
+
+// Reads the uncompressed contents of a gzip file without holding more than the
+// 32 KB deflate window in memory. Seeking forward decompresses up to the new
+// position. Seeking back starts over from the beginning of the file, or from
+// the position given to keep_state_at() if that is closer.
+class Gzip_Reader : public File_Reader {
+public:
+	// True if header starts with the gzip signature
+	static bool is_gzip( void const* header, long size );
+
+	// Begin reading gzip file from current position of in, which must be kept
+	// open until this reader is closed
+	blargg_err_t open( File_Reader* in );
+
+	// Save decompressor state (about 37 KB) when reading reaches pos, so that
+	// later seeks back to pos or beyond continue from there. Does nothing if
+	// memory can't be allocated.
+	void keep_state_at( long pos );
+
+	void close();
+
+public:
+	Gzip_Reader();
+	~Gzip_Reader();
+	long size() const;
+	long read_avail( void*, long );
+	long tell() const;
+	blargg_err_t seek( long );
+private:
+	File_Reader* in;
+	long size_;
+	long data_begin;
+	Inflater* inflater;
+	Inflater* kept;
+	long kept_pos;
+	bool kept_valid;
+};
+
+#endif
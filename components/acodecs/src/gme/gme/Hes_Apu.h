@@ -7,6 +7,11 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef HES_APU_FAST_SYNTH
+	#define HES_APU_FAST_SYNTH 0
+#endif
+
 struct Hes_Osc
 {
 	unsigned char wave [32];
@@ -26,7 +31,7 @@ struct Hes_Osc
 	unsigned char control;
 	
 	enum { amp_range = 0x8000 };
-	typedef Blip_Synth<blip_med_quality,1> synth_t;
+	typedef Blip_Synth<(HES_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> synth_t;
 	
 	void run_until( synth_t& synth, blip_time_t );
 };
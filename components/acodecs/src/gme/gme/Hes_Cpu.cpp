@@ -87,7 +87,7 @@ void Hes_Cpu::set_mmr( int reg, int bank )
 #define GET_SP()        ((sp - 1) & 0xFF)
 #define PUSH( v )       ((sp = (sp - 1) | 0x100), WRITE_LOW( sp, v ))
 
-bool Hes_Cpu::run( hes_time_t end_time )
+BLARGG_CPU_RUN bool Hes_Cpu::run( hes_time_t end_time )
 {
 	bool illegal_encountered = false;
 	set_end_time( end_time );
@@ -201,6 +201,7 @@ almost_out_of_time:
 		//log_opcode( opcode );
 	#endif
 
+	BLARGG_DISPATCH( opcode );
 	switch ( opcode )
 	{
 possibly_out_of_time:
@@ -231,52 +232,52 @@ possibly_out_of_time:
 	goto loop;\
 }
 
-	case 0xF0: // BEQ
+	BLARGG_OP( 0xF0 ): // BEQ
 		BRANCH( !((uint8_t) nz) );
 
-	case 0xD0: // BNE
+	BLARGG_OP( 0xD0 ): // BNE
 		BRANCH( (uint8_t) nz );
 
-	case 0x10: // BPL
+	BLARGG_OP( 0x10 ): // BPL
 		BRANCH( !IS_NEG );
 
-	case 0x90: // BCC
+	BLARGG_OP( 0x90 ): // BCC
 		BRANCH( !(c & 0x100) )
 
-	case 0x30: // BMI
+	BLARGG_OP( 0x30 ): // BMI
 		BRANCH( IS_NEG )
 
-	case 0x50: // BVC
+	BLARGG_OP( 0x50 ): // BVC
 		BRANCH( !(status & st_v) )
 
-	case 0x70: // BVS
+	BLARGG_OP( 0x70 ): // BVS
 		BRANCH( status & st_v )
 
-	case 0xB0: // BCS
+	BLARGG_OP( 0xB0 ): // BCS
 		BRANCH( c & 0x100 )
 
-	case 0x80: // BRA
+	BLARGG_OP( 0x80 ): // BRA
 	branch_taken:
 		BRANCH( true );
 
-	case 0xFF:
+	BLARGG_OP( 0xFF ):
 		if ( pc == idle_addr + 1 )
 			goto idle_done;
-	case 0x0F: // BBRn
-	case 0x1F:
-	case 0x2F:
-	case 0x3F:
-	case 0x4F:
-	case 0x5F:
-	case 0x6F:
-	case 0x7F:
-	case 0x8F: // BBSn
-	case 0x9F:
-	case 0xAF:
-	case 0xBF:
-	case 0xCF:
-	case 0xDF:
-	case 0xEF: {
+	BLARGG_OP( 0x0F ): // BBRn
+	BLARGG_OP( 0x1F ):
+	BLARGG_OP( 0x2F ):
+	BLARGG_OP( 0x3F ):
+	BLARGG_OP( 0x4F ):
+	BLARGG_OP( 0x5F ):
+	BLARGG_OP( 0x6F ):
+	BLARGG_OP( 0x7F ):
+	BLARGG_OP( 0x8F ): // BBSn
+	BLARGG_OP( 0x9F ):
+	BLARGG_OP( 0xAF ):
+	BLARGG_OP( 0xBF ):
+	BLARGG_OP( 0xCF ):
+	BLARGG_OP( 0xDF ):
+	BLARGG_OP( 0xEF ): {
 		uint_fast16_t t = 0x101 * READ_LOW( data );
 		t ^= 0xFF;
 		pc++;
@@ -284,13 +285,13 @@ possibly_out_of_time:
 		BRANCH( t & (1 << (opcode >> 4)) )
 	}
 
-	case 0x4C: // JMP abs
+	BLARGG_OP( 0x4C ): // JMP abs
 		pc = GET_ADDR();
 		goto loop;
 
-	case 0x7C: // JMP (ind+X)
+	BLARGG_OP( 0x7C ): // JMP (ind+X)
 		data += x;
-	case 0x6C:{// JMP (ind)
+	BLARGG_OP( 0x6C ):{// JMP (ind)
 		data += 0x100 * GET_MSB();
 		pc = GET_LE16( &READ_PROG( data ) );
 		goto loop;
@@ -298,13 +299,13 @@ possibly_out_of_time:
 
 // Subroutine
 
-	case 0x44: // BSR
+	BLARGG_OP( 0x44 ): // BSR
 		WRITE_LOW( 0x100 | (sp - 1), pc >> 8 );
 		sp = (sp - 2) | 0x100;
 		WRITE_LOW( sp, pc );
 		goto branch_taken;
 
-	case 0x20: { // JSR
+	BLARGG_OP( 0x20 ): { // JSR
 		uint_fast16_t temp = pc + 1;
 		pc = GET_ADDR();
 		WRITE_LOW( 0x100 | (sp - 1), temp >> 8 );
@@ -313,18 +314,18 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x60: // RTS
+	BLARGG_OP( 0x60 ): // RTS
 		pc = 0x100 * READ_LOW( 0x100 | (sp - 0xFF) );
 		pc += 1 + READ_LOW( sp );
 		sp = (sp - 0xFE) | 0x100;
 		goto loop;
 
-	case 0x00: // BRK
+	BLARGG_OP( 0x00 ): // BRK
 		goto handle_brk;
 
 // Common
 
-	case 0xBD:{// LDA abs,X
+	BLARGG_OP( 0xBD ):{// LDA abs,X
 		PAGE_CROSS_PENALTY( data + x );
 		uint_fast16_t addr = GET_ADDR() + x;
 		pc += 2;
@@ -333,21 +334,21 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x9D:{// STA abs,X
+	BLARGG_OP( 0x9D ):{// STA abs,X
 		uint_fast16_t addr = GET_ADDR() + x;
 		pc += 2;
 		CPU_WRITE_FAST( this, addr, a, TIME );
 		goto loop;
 	}
 
-	case 0x95: // STA zp,x
+	BLARGG_OP( 0x95 ): // STA zp,x
 		data = uint8_t (data + x);
-	case 0x85: // STA zp
+	BLARGG_OP( 0x85 ): // STA zp
 		pc++;
 		WRITE_LOW( data, a );
 		goto loop;
 
-	case 0xAE:{// LDX abs
+	BLARGG_OP( 0xAE ):{// LDX abs
 		uint_fast16_t addr = GET_ADDR();
 		pc += 2;
 		CPU_READ_FAST( this, addr, TIME, nz );
@@ -355,7 +356,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0xA5: // LDA zp
+	BLARGG_OP( 0xA5 ): // LDA zp
 		a = nz = READ_LOW( data );
 		pc++;
 		goto loop;
@@ -364,23 +365,23 @@ possibly_out_of_time:
 
 	{
 		uint_fast16_t addr;
-	case 0x91: // STA (ind),Y
+	BLARGG_OP( 0x91 ): // STA (ind),Y
 		addr = 0x100 * READ_LOW( uint8_t (data + 1) );
 		addr += READ_LOW( data ) + y;
 		pc++;
 		goto sta_ptr;
 
-	case 0x81: // STA (ind,X)
+	BLARGG_OP( 0x81 ): // STA (ind,X)
 		data = uint8_t (data + x);
-	case 0x92: // STA (ind)
+	BLARGG_OP( 0x92 ): // STA (ind)
 		addr = 0x100 * READ_LOW( uint8_t (data + 1) );
 		addr += READ_LOW( data );
 		pc++;
 		goto sta_ptr;
 
-	case 0x99: // STA abs,Y
+	BLARGG_OP( 0x99 ): // STA abs,Y
 		data += y;
-	case 0x8D: // STA abs
+	BLARGG_OP( 0x8D ): // STA abs
 		addr = data + 0x100 * GET_MSB();
 		pc += 2;
 	sta_ptr:
@@ -390,25 +391,25 @@ possibly_out_of_time:
 
 	{
 		uint_fast16_t addr;
-	case 0xA1: // LDA (ind,X)
+	BLARGG_OP( 0xA1 ): // LDA (ind,X)
 		data = uint8_t (data + x);
-	case 0xB2: // LDA (ind)
+	BLARGG_OP( 0xB2 ): // LDA (ind)
 		addr = 0x100 * READ_LOW( uint8_t (data + 1) );
 		addr += READ_LOW( data );
 		pc++;
 		goto a_nz_read_addr;
 
-	case 0xB1:// LDA (ind),Y
+	BLARGG_OP( 0xB1 ):// LDA (ind),Y
 		addr = READ_LOW( data ) + y;
 		PAGE_CROSS_PENALTY( addr );
 		addr += 0x100 * READ_LOW( (uint8_t) (data + 1) );
 		pc++;
 		goto a_nz_read_addr;
 
-	case 0xB9: // LDA abs,Y
+	BLARGG_OP( 0xB9 ): // LDA abs,Y
 		data += y;
 		PAGE_CROSS_PENALTY( data );
-	case 0xAD: // LDA abs
+	BLARGG_OP( 0xAD ): // LDA abs
 		addr = data + 0x100 * GET_MSB();
 		pc += 2;
 	a_nz_read_addr:
@@ -417,7 +418,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0xBE:{// LDX abs,y
+	BLARGG_OP( 0xBE ):{// LDX abs,y
 		PAGE_CROSS_PENALTY( data + y );
 		uint_fast16_t addr = GET_ADDR() + y;
 		pc += 2;
@@ -427,12 +428,12 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0xB5: // LDA zp,x
+	BLARGG_OP( 0xB5 ): // LDA zp,x
 		a = nz = READ_LOW( uint8_t (data + x) );
 		pc++;
 		goto loop;
 
-	case 0xA9: // LDA #imm
+	BLARGG_OP( 0xA9 ): // LDA #imm
 		pc++;
 		a  = data;
 		nz = data;
@@ -440,9 +441,9 @@ possibly_out_of_time:
 
 // Bit operations
 
-	case 0x3C: // BIT abs,x
+	BLARGG_OP( 0x3C ): // BIT abs,x
 		data += x;
-	case 0x2C:{// BIT abs
+	BLARGG_OP( 0x2C ):{// BIT abs
 		uint_fast16_t addr;
 		ADD_PAGE( addr );
 		FLUSH_TIME();
@@ -450,11 +451,11 @@ possibly_out_of_time:
 		CACHE_TIME();
 		goto bit_common;
 	}
-	case 0x34: // BIT zp,x
+	BLARGG_OP( 0x34 ): // BIT zp,x
 		data = uint8_t (data + x);
-	case 0x24: // BIT zp
+	BLARGG_OP( 0x24 ): // BIT zp
 		data = READ_LOW( data );
-	case 0x89: // BIT imm
+	BLARGG_OP( 0x89 ): // BIT imm
 		nz = data;
 	bit_common:
 		pc++;
@@ -468,11 +469,11 @@ possibly_out_of_time:
 	{
 		uint_fast16_t addr;
 
-	case 0xB3: // TST abs,x
+	BLARGG_OP( 0xB3 ): // TST abs,x
 		addr = GET_MSB() + x;
 		goto tst_abs;
 
-	case 0x93: // TST abs
+	BLARGG_OP( 0x93 ): // TST abs
 		addr = GET_MSB();
 	tst_abs:
 		addr += 0x100 * instr [2];
@@ -483,11 +484,11 @@ possibly_out_of_time:
 		goto tst_common;
 	}
 
-	case 0xA3: // TST zp,x
+	BLARGG_OP( 0xA3 ): // TST zp,x
 		nz = READ_LOW( uint8_t (GET_MSB() + x) );
 		goto tst_common;
 
-	case 0x83: // TST zp
+	BLARGG_OP( 0x83 ): // TST zp
 		nz = READ_LOW( GET_MSB() );
 	tst_common:
 		pc += 2;
@@ -500,15 +501,15 @@ possibly_out_of_time:
 
 	{
 		uint_fast16_t addr;
-	case 0x0C: // TSB abs
-	case 0x1C: // TRB abs
+	BLARGG_OP( 0x0C ): // TSB abs
+	BLARGG_OP( 0x1C ): // TRB abs
 		addr = GET_ADDR();
 		pc++;
 		goto txb_addr;
 
 	// TODO: everyone lists different behaviors for the status flags, ugh
-	case 0x04: // TSB zp
-	case 0x14: // TRB zp
+	BLARGG_OP( 0x04 ): // TSB zp
+	BLARGG_OP( 0x14 ): // TRB zp
 		addr = data + ram_addr;
 	txb_addr:
 		FLUSH_TIME();
@@ -523,35 +524,35 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x07: // RMBn
-	case 0x17:
-	case 0x27:
-	case 0x37:
-	case 0x47:
-	case 0x57:
-	case 0x67:
-	case 0x77:
+	BLARGG_OP( 0x07 ): // RMBn
+	BLARGG_OP( 0x17 ):
+	BLARGG_OP( 0x27 ):
+	BLARGG_OP( 0x37 ):
+	BLARGG_OP( 0x47 ):
+	BLARGG_OP( 0x57 ):
+	BLARGG_OP( 0x67 ):
+	BLARGG_OP( 0x77 ):
 		pc++;
 		READ_LOW( data ) &= ~(1 << (opcode >> 4));
 		goto loop;
 
-	case 0x87: // SMBn
-	case 0x97:
-	case 0xA7:
-	case 0xB7:
-	case 0xC7:
-	case 0xD7:
-	case 0xE7:
-	case 0xF7:
+	BLARGG_OP( 0x87 ): // SMBn
+	BLARGG_OP( 0x97 ):
+	BLARGG_OP( 0xA7 ):
+	BLARGG_OP( 0xB7 ):
+	BLARGG_OP( 0xC7 ):
+	BLARGG_OP( 0xD7 ):
+	BLARGG_OP( 0xE7 ):
+	BLARGG_OP( 0xF7 ):
 		pc++;
 		READ_LOW( data ) |= 1 << ((opcode >> 4) - 8);
 		goto loop;
 
 // Load/store
 
-	case 0x9E: // STZ abs,x
+	BLARGG_OP( 0x9E ): // STZ abs,x
 		data += x;
-	case 0x9C: // STZ abs
+	BLARGG_OP( 0x9C ): // STZ abs
 		ADD_PAGE( data );
 		pc++;
 		FLUSH_TIME();
@@ -559,51 +560,51 @@ possibly_out_of_time:
 		CACHE_TIME();
 		goto loop;
 
-	case 0x74: // STZ zp,x
+	BLARGG_OP( 0x74 ): // STZ zp,x
 		data = uint8_t (data + x);
-	case 0x64: // STZ zp
+	BLARGG_OP( 0x64 ): // STZ zp
 		pc++;
 		WRITE_LOW( data, 0 );
 		goto loop;
 
-	case 0x94: // STY zp,x
+	BLARGG_OP( 0x94 ): // STY zp,x
 		data = uint8_t (data + x);
-	case 0x84: // STY zp
+	BLARGG_OP( 0x84 ): // STY zp
 		pc++;
 		WRITE_LOW( data, y );
 		goto loop;
 
-	case 0x96: // STX zp,y
+	BLARGG_OP( 0x96 ): // STX zp,y
 		data = uint8_t (data + y);
-	case 0x86: // STX zp
+	BLARGG_OP( 0x86 ): // STX zp
 		pc++;
 		WRITE_LOW( data, x );
 		goto loop;
 
-	case 0xB6: // LDX zp,y
+	BLARGG_OP( 0xB6 ): // LDX zp,y
 		data = uint8_t (data + y);
-	case 0xA6: // LDX zp
+	BLARGG_OP( 0xA6 ): // LDX zp
 		data = READ_LOW( data );
-	case 0xA2: // LDX #imm
+	BLARGG_OP( 0xA2 ): // LDX #imm
 		pc++;
 		x = data;
 		nz = data;
 		goto loop;
 
-	case 0xB4: // LDY zp,x
+	BLARGG_OP( 0xB4 ): // LDY zp,x
 		data = uint8_t (data + x);
-	case 0xA4: // LDY zp
+	BLARGG_OP( 0xA4 ): // LDY zp
 		data = READ_LOW( data );
-	case 0xA0: // LDY #imm
+	BLARGG_OP( 0xA0 ): // LDY #imm
 		pc++;
 		y = data;
 		nz = data;
 		goto loop;
 
-	case 0xBC: // LDY abs,X
+	BLARGG_OP( 0xBC ): // LDY abs,X
 		data += x;
 		PAGE_CROSS_PENALTY( data );
-	case 0xAC:{// LDY abs
+	BLARGG_OP( 0xAC ):{// LDY abs
 		uint_fast16_t addr = data + 0x100 * GET_MSB();
 		pc += 2;
 		FLUSH_TIME();
@@ -614,11 +615,11 @@ possibly_out_of_time:
 
 	{
 		uint_fast8_t temp;
-	case 0x8C: // STY abs
+	BLARGG_OP( 0x8C ): // STY abs
 		temp = y;
 		goto store_abs;
 
-	case 0x8E: // STX abs
+	BLARGG_OP( 0x8E ): // STX abs
 		temp = x;
 	store_abs:
 		uint_fast16_t addr = GET_ADDR();
@@ -631,7 +632,7 @@ possibly_out_of_time:
 
 // Compare
 
-	case 0xEC:{// CPX abs
+	BLARGG_OP( 0xEC ):{// CPX abs
 		uint_fast16_t addr = GET_ADDR();
 		pc++;
 		FLUSH_TIME();
@@ -640,9 +641,9 @@ possibly_out_of_time:
 		goto cpx_data;
 	}
 
-	case 0xE4: // CPX zp
+	BLARGG_OP( 0xE4 ): // CPX zp
 		data = READ_LOW( data );
-	case 0xE0: // CPX #imm
+	BLARGG_OP( 0xE0 ): // CPX #imm
 	cpx_data:
 		nz = x - data;
 		pc++;
@@ -650,7 +651,7 @@ possibly_out_of_time:
 		nz &= 0xFF;
 		goto loop;
 
-	case 0xCC:{// CPY abs
+	BLARGG_OP( 0xCC ):{// CPY abs
 		uint_fast16_t addr = GET_ADDR();
 		pc++;
 		FLUSH_TIME();
@@ -659,9 +660,9 @@ possibly_out_of_time:
 		goto cpy_data;
 	}
 
-	case 0xC4: // CPY zp
+	BLARGG_OP( 0xC4 ): // CPY zp
 		data = READ_LOW( data );
-	case 0xC0: // CPY #imm
+	BLARGG_OP( 0xC0 ): // CPY #imm
 	cpy_data:
 		nz = y - data;
 		pc++;
@@ -671,68 +672,70 @@ possibly_out_of_time:
 
 // Logical
 
-#define ARITH_ADDR_MODES( op )\
-	case op - 0x04: /* (ind,x) */\
+// Opcodes 0xH1 to 0xHD and 0xL1 to 0xLD of an instruction with zp opcode 0xH5,
+// where L is the next row H + 1
+#define ARITH_ADDR_MODES( h, l )\
+	BLARGG_OP( 0x##h##1 ): /* (ind,x) */\
 		data = uint8_t (data + x);\
-	case op + 0x0D: /* (ind) */\
+	BLARGG_OP( 0x##l##2 ): /* (ind) */\
 		data = 0x100 * READ_LOW( uint8_t (data + 1) ) + READ_LOW( data );\
-		goto ptr##op;\
-	case op + 0x0C:{/* (ind),y */\
+		goto ptr##h;\
+	BLARGG_OP( 0x##l##1 ):{/* (ind),y */\
 		uint_fast16_t temp = READ_LOW( data ) + y;\
 		PAGE_CROSS_PENALTY( temp );\
 		data = temp + 0x100 * READ_LOW( uint8_t (data + 1) );\
-		goto ptr##op;\
+		goto ptr##h;\
 	}\
-	case op + 0x10: /* zp,X */\
+	BLARGG_OP( 0x##l##5 ): /* zp,X */\
 		data = uint8_t (data + x);\
-	case op + 0x00: /* zp */\
+	BLARGG_OP( 0x##h##5 ): /* zp */\
 		data = READ_LOW( data );\
-		goto imm##op;\
-	case op + 0x14: /* abs,Y */\
+		goto imm##h;\
+	BLARGG_OP( 0x##l##9 ): /* abs,Y */\
 		data += y;\
-		goto ind##op;\
-	case op + 0x18: /* abs,X */\
+		goto ind##h;\
+	BLARGG_OP( 0x##l##D ): /* abs,X */\
 		data += x;\
-	ind##op:\
+	ind##h:\
 		PAGE_CROSS_PENALTY( data );\
-	case op + 0x08: /* abs */\
+	BLARGG_OP( 0x##h##D ): /* abs */\
 		ADD_PAGE( data );\
-	ptr##op:\
+	ptr##h:\
 		FLUSH_TIME();\
 		data = READ( data );\
 		CACHE_TIME();\
-	case op + 0x04: /* imm */\
-	imm##op:
+	BLARGG_OP( 0x##h##9 ): /* imm */\
+	imm##h:
 
-	ARITH_ADDR_MODES( 0xC5 ) // CMP
+	ARITH_ADDR_MODES( C, D ) // CMP
 		nz = a - data;
 		pc++;
 		c = ~nz;
 		nz &= 0xFF;
 		goto loop;
 
-	ARITH_ADDR_MODES( 0x25 ) // AND
+	ARITH_ADDR_MODES( 2, 3 ) // AND
 		nz = (a &= data);
 		pc++;
 		goto loop;
 
-	ARITH_ADDR_MODES( 0x45 ) // EOR
+	ARITH_ADDR_MODES( 4, 5 ) // EOR
 		nz = (a ^= data);
 		pc++;
 		goto loop;
 
-	ARITH_ADDR_MODES( 0x05 ) // ORA
+	ARITH_ADDR_MODES( 0, 1 ) // ORA
 		nz = (a |= data);
 		pc++;
 		goto loop;
 
 // Add/subtract
 
-	ARITH_ADDR_MODES( 0xE5 ) // SBC
+	ARITH_ADDR_MODES( E, F ) // SBC
 		data ^= 0xFF;
 		goto adc_imm;
 
-	ARITH_ADDR_MODES( 0x65 ) // ADC
+	ARITH_ADDR_MODES( 6, 7 ) // ADC
 	adc_imm: {
 		if ( status & st_d )
 			debug_printf( "Decimal mode not supported\n" );
@@ -748,22 +751,22 @@ possibly_out_of_time:
 
 // Shift/rotate
 
-	case 0x4A: // LSR A
+	BLARGG_OP( 0x4A ): // LSR A
 		c = 0;
-	case 0x6A: // ROR A
+	BLARGG_OP( 0x6A ): // ROR A
 		nz = c >> 1 & 0x80;
 		c = a << 8;
 		nz |= a >> 1;
 		a = nz;
 		goto loop;
 
-	case 0x0A: // ASL A
+	BLARGG_OP( 0x0A ): // ASL A
 		nz = a << 1;
 		c = nz;
 		a = (uint8_t) nz;
 		goto loop;
 
-	case 0x2A: { // ROL A
+	BLARGG_OP( 0x2A ): { // ROL A
 		nz = a << 1;
 		int_fast16_t temp = c >> 8 & 1;
 		c = nz;
@@ -772,11 +775,11 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x5E: // LSR abs,X
+	BLARGG_OP( 0x5E ): // LSR abs,X
 		data += x;
-	case 0x4E: // LSR abs
+	BLARGG_OP( 0x4E ): // LSR abs
 		c = 0;
-	case 0x6E: // ROR abs
+	BLARGG_OP( 0x6E ): // ROR abs
 	ror_abs: {
 		ADD_PAGE( data );
 		FLUSH_TIME();
@@ -786,15 +789,15 @@ possibly_out_of_time:
 		goto rotate_common;
 	}
 
-	case 0x3E: // ROL abs,X
+	BLARGG_OP( 0x3E ): // ROL abs,X
 		data += x;
 		goto rol_abs;
 
-	case 0x1E: // ASL abs,X
+	BLARGG_OP( 0x1E ): // ASL abs,X
 		data += x;
-	case 0x0E: // ASL abs
+	BLARGG_OP( 0x0E ): // ASL abs
 		c = 0;
-	case 0x2E: // ROL abs
+	BLARGG_OP( 0x2E ): // ROL abs
 	rol_abs:
 		ADD_PAGE( data );
 		nz = c >> 8 & 1;
@@ -806,19 +809,19 @@ possibly_out_of_time:
 		CACHE_TIME();
 		goto loop;
 
-	case 0x7E: // ROR abs,X
+	BLARGG_OP( 0x7E ): // ROR abs,X
 		data += x;
 		goto ror_abs;
 
-	case 0x76: // ROR zp,x
+	BLARGG_OP( 0x76 ): // ROR zp,x
 		data = uint8_t (data + x);
 		goto ror_zp;
 
-	case 0x56: // LSR zp,x
+	BLARGG_OP( 0x56 ): // LSR zp,x
 		data = uint8_t (data + x);
-	case 0x46: // LSR zp
+	BLARGG_OP( 0x46 ): // LSR zp
 		c = 0;
-	case 0x66: // ROR zp
+	BLARGG_OP( 0x66 ): // ROR zp
 	ror_zp: {
 		int temp = READ_LOW( data );
 		nz = (c >> 1 & 0x80) | (temp >> 1);
@@ -826,15 +829,15 @@ possibly_out_of_time:
 		goto write_nz_zp;
 	}
 
-	case 0x36: // ROL zp,x
+	BLARGG_OP( 0x36 ): // ROL zp,x
 		data = uint8_t (data + x);
 		goto rol_zp;
 
-	case 0x16: // ASL zp,x
+	BLARGG_OP( 0x16 ): // ASL zp,x
 		data = uint8_t (data + x);
-	case 0x06: // ASL zp
+	BLARGG_OP( 0x06 ): // ASL zp
 		c = 0;
-	case 0x26: // ROL zp
+	BLARGG_OP( 0x26 ): // ROL zp
 	rol_zp:
 		nz = c >> 8 & 1;
 		nz |= (c = READ_LOW( data ) << 1);
@@ -844,33 +847,33 @@ possibly_out_of_time:
 
 #define INC_DEC_AXY( reg, n ) reg = uint8_t (nz = reg + n); goto loop;
 
-	case 0x1A: // INA
+	BLARGG_OP( 0x1A ): // INA
 		INC_DEC_AXY( a, +1 )
 
-	case 0xE8: // INX
+	BLARGG_OP( 0xE8 ): // INX
 		INC_DEC_AXY( x, +1 )
 
-	case 0xC8: // INY
+	BLARGG_OP( 0xC8 ): // INY
 		INC_DEC_AXY( y, +1 )
 
-	case 0x3A: // DEA
+	BLARGG_OP( 0x3A ): // DEA
 		INC_DEC_AXY( a, -1 )
 
-	case 0xCA: // DEX
+	BLARGG_OP( 0xCA ): // DEX
 		INC_DEC_AXY( x, -1 )
 
-	case 0x88: // DEY
+	BLARGG_OP( 0x88 ): // DEY
 		INC_DEC_AXY( y, -1 )
 
-	case 0xF6: // INC zp,x
+	BLARGG_OP( 0xF6 ): // INC zp,x
 		data = uint8_t (data + x);
-	case 0xE6: // INC zp
+	BLARGG_OP( 0xE6 ): // INC zp
 		nz = 1;
 		goto add_nz_zp;
 
-	case 0xD6: // DEC zp,x
+	BLARGG_OP( 0xD6 ): // DEC zp,x
 		data = uint8_t (data + x);
-	case 0xC6: // DEC zp
+	BLARGG_OP( 0xC6 ): // DEC zp
 		nz = (unsigned) -1;
 	add_nz_zp:
 		nz += READ_LOW( data );
@@ -879,21 +882,21 @@ possibly_out_of_time:
 		WRITE_LOW( data, nz );
 		goto loop;
 
-	case 0xFE: // INC abs,x
+	BLARGG_OP( 0xFE ): // INC abs,x
 		data = x + GET_ADDR();
 		goto inc_ptr;
 
-	case 0xEE: // INC abs
+	BLARGG_OP( 0xEE ): // INC abs
 		data = GET_ADDR();
 	inc_ptr:
 		nz = 1;
 		goto inc_common;
 
-	case 0xDE: // DEC abs,x
+	BLARGG_OP( 0xDE ): // DEC abs,x
 		data = x + GET_ADDR();
 		goto dec_ptr;
 
-	case 0xCE: // DEC abs
+	BLARGG_OP( 0xCE ): // DEC abs
 		data = GET_ADDR();
 	dec_ptr:
 		nz = (unsigned) -1;
@@ -907,31 +910,31 @@ possibly_out_of_time:
 
 // Transfer
 
-	case 0xA8: // TAY
+	BLARGG_OP( 0xA8 ): // TAY
 		y  = a;
 		nz = a;
 		goto loop;
 
-	case 0x98: // TYA
+	BLARGG_OP( 0x98 ): // TYA
 		a  = y;
 		nz = y;
 		goto loop;
 
-	case 0xAA: // TAX
+	BLARGG_OP( 0xAA ): // TAX
 		x  = a;
 		nz = a;
 		goto loop;
 
-	case 0x8A: // TXA
+	BLARGG_OP( 0x8A ): // TXA
 		a  = x;
 		nz = x;
 		goto loop;
 
-	case 0x9A: // TXS
+	BLARGG_OP( 0x9A ): // TXS
 		SET_SP( x ); // verified (no flag change)
 		goto loop;
 
-	case 0xBA: // TSX
+	BLARGG_OP( 0xBA ): // TSX
 		x = nz = GET_SP();
 		goto loop;
 
@@ -942,42 +945,42 @@ possibly_out_of_time:
 		goto loop;\
 	}
 
-	case 0x02: // SXY
+	BLARGG_OP( 0x02 ): // SXY
 		SWAP_REGS( x, y );
 
-	case 0x22: // SAX
+	BLARGG_OP( 0x22 ): // SAX
 		SWAP_REGS( a, x );
 
-	case 0x42: // SAY
+	BLARGG_OP( 0x42 ): // SAY
 		SWAP_REGS( a, y );
 
-	case 0x62: // CLA
+	BLARGG_OP( 0x62 ): // CLA
 		a = 0;
 		goto loop;
 
-	case 0x82: // CLX
+	BLARGG_OP( 0x82 ): // CLX
 		x = 0;
 		goto loop;
 
-	case 0xC2: // CLY
+	BLARGG_OP( 0xC2 ): // CLY
 		y = 0;
 		goto loop;
 
 // Stack
 
-	case 0x48: // PHA
+	BLARGG_OP( 0x48 ): // PHA
 		PUSH( a );
 		goto loop;
 
-	case 0xDA: // PHX
+	BLARGG_OP( 0xDA ): // PHX
 		PUSH( x );
 		goto loop;
 
-	case 0x5A: // PHY
+	BLARGG_OP( 0x5A ): // PHY
 		PUSH( y );
 		goto loop;
 
-	case 0x40:{// RTI
+	BLARGG_OP( 0x40 ):{// RTI
 		uint_fast8_t temp = READ_LOW( sp );
 		pc  = READ_LOW( 0x100 | (sp - 0xFF) );
 		pc |= READ_LOW( 0x100 | (sp - 0xFE) ) * 0x100;
@@ -999,19 +1002,19 @@ possibly_out_of_time:
 
 	#define POP()  READ_LOW( sp ); sp = (sp - 0xFF) | 0x100
 
-	case 0x68: // PLA
+	BLARGG_OP( 0x68 ): // PLA
 		a = nz = POP();
 		goto loop;
 
-	case 0xFA: // PLX
+	BLARGG_OP( 0xFA ): // PLX
 		x = nz = POP();
 		goto loop;
 
-	case 0x7A: // PLY
+	BLARGG_OP( 0x7A ): // PLY
 		y = nz = POP();
 		goto loop;
 
-	case 0x28:{// PLP
+	BLARGG_OP( 0x28 ):{// PLP
 		uint_fast8_t temp = POP();
 		uint_fast8_t changed = status ^ temp;
 		SET_STATUS( temp );
@@ -1023,7 +1026,7 @@ possibly_out_of_time:
 	}
 	#undef POP
 
-	case 0x08: { // PHP
+	BLARGG_OP( 0x08 ): { // PHP
 		uint_fast8_t temp;
 		CALC_STATUS( temp );
 		PUSH( temp | st_b );
@@ -1032,27 +1035,27 @@ possibly_out_of_time:
 
 // Flags
 
-	case 0x38: // SEC
+	BLARGG_OP( 0x38 ): // SEC
 		c = (unsigned) ~0;
 		goto loop;
 
-	case 0x18: // CLC
+	BLARGG_OP( 0x18 ): // CLC
 		c = 0;
 		goto loop;
 
-	case 0xB8: // CLV
+	BLARGG_OP( 0xB8 ): // CLV
 		status &= ~st_v;
 		goto loop;
 
-	case 0xD8: // CLD
+	BLARGG_OP( 0xD8 ): // CLD
 		status &= ~st_d;
 		goto loop;
 
-	case 0xF8: // SED
+	BLARGG_OP( 0xF8 ): // SED
 		status |= st_d;
 		goto loop;
 
-	case 0x58: // CLI
+	BLARGG_OP( 0x58 ): // CLI
 		if ( !(status & st_i) )
 			goto loop;
 		status &= ~st_i;
@@ -1083,7 +1086,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x78: // SEI
+	BLARGG_OP( 0x78 ): // SEI
 		if ( status & st_i )
 			goto loop;
 		status |= st_i;
@@ -1100,7 +1103,7 @@ possibly_out_of_time:
 
 // Special
 
-	case 0x53:{// TAM
+	BLARGG_OP( 0x53 ):{// TAM
 		uint_fast8_t const bits = data; // avoid using data across function call
 		pc++;
 		for ( int i = 0; i < 8; i++ )
@@ -1109,7 +1112,7 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x43:{// TMA
+	BLARGG_OP( 0x43 ):{// TMA
 		pc++;
 		byte const* in = mmr;
 		do
@@ -1122,9 +1125,9 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0x03: // ST0
-	case 0x13: // ST1
-	case 0x23:{// ST2
+	BLARGG_OP( 0x03 ): // ST0
+	BLARGG_OP( 0x13 ): // ST1
+	BLARGG_OP( 0x23 ):{// ST2
 		uint_fast16_t addr = opcode >> 4;
 		if ( addr )
 			addr++;
@@ -1135,18 +1138,18 @@ possibly_out_of_time:
 		goto loop;
 	}
 
-	case 0xEA: // NOP
+	BLARGG_OP( 0xEA ): // NOP
 		goto loop;
 
-	case 0x54: // CSL
+	BLARGG_OP( 0x54 ): // CSL
 		debug_printf( "CSL not supported\n" );
 		illegal_encountered = true;
 		goto loop;
 
-	case 0xD4: // CSH
+	BLARGG_OP( 0xD4 ): // CSH
 		goto loop;
 
-	case 0xF4: { // SET
+	BLARGG_OP( 0xF4 ): { // SET
 		//fuint16 operand = GET_MSB();
 		debug_printf( "SET not handled\n" );
 		//switch ( data )
@@ -1164,11 +1167,11 @@ possibly_out_of_time:
 		uint_fast16_t out_alt;
 		int_fast16_t out_inc;
 
-	case 0xE3: // TIA
+	BLARGG_OP( 0xE3 ): // TIA
 		in_alt  = 0;
 		goto bxfer_alt;
 
-	case 0xF3: // TAI
+	BLARGG_OP( 0xF3 ): // TAI
 		in_alt  = 1;
 	bxfer_alt:
 		in_inc  = in_alt ^ 1;
@@ -1176,17 +1179,17 @@ possibly_out_of_time:
 		out_inc = in_alt;
 		goto bxfer;
 
-	case 0xD3: // TIN
+	BLARGG_OP( 0xD3 ): // TIN
 		in_inc  = 1;
 		out_inc = 0;
 		goto bxfer_no_alt;
 
-	case 0xC3: // TDD
+	BLARGG_OP( 0xC3 ): // TDD
 		in_inc  = -1;
 		out_inc = -1;
 		goto bxfer_no_alt;
 
-	case 0x73: // TII
+	BLARGG_OP( 0x73 ): // TII
 		in_inc  = 1;
 		out_inc = 1;
 	bxfer_no_alt:
@@ -1225,6 +1228,11 @@ possibly_out_of_time:
 
 // Illegal
 
+	BLARGG_OP( 0x0B ): BLARGG_OP( 0x1B ): BLARGG_OP( 0x2B ): BLARGG_OP( 0x33 ): BLARGG_OP( 0x3B ):
+	BLARGG_OP( 0x4B ): BLARGG_OP( 0x5B ): BLARGG_OP( 0x5C ): BLARGG_OP( 0x63 ): BLARGG_OP( 0x6B ):
+	BLARGG_OP( 0x7B ): BLARGG_OP( 0x8B ): BLARGG_OP( 0x9B ): BLARGG_OP( 0xAB ): BLARGG_OP( 0xBB ):
+	BLARGG_OP( 0xCB ): BLARGG_OP( 0xDB ): BLARGG_OP( 0xDC ): BLARGG_OP( 0xE2 ): BLARGG_OP( 0xEB ):
+	BLARGG_OP( 0xFB ): BLARGG_OP( 0xFC ):
 	default:
 		debug_printf( "Illegal opcode $%02X at $%04X\n", (int) opcode, (int) pc - 1 );
 		illegal_encountered = true;
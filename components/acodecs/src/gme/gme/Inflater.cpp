@@ -0,0 +1,374 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "Inflater.h"
+
+#include <string.h>
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or (at
+your option) any later version. This module is distributed in the hope that
+it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+Lesser General Public License for more details. You should have received a
+copy of the GNU Lesser General Public License along with this module; if not,
+write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+Boston, MA 02110-1301 USA */
+
+#include "blargg_source.h"
+
+// Base values and extra bits of length and distance codes
+static unsigned short const length_base [29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static unsigned char const length_extra [29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static unsigned short const dist_base [30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static unsigned char const dist_extra [30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+void Inflater::begin( File_Reader* new_in )
+{
+	in            = new_in;
+	in_next       = in ? in->tell() : 0;
+	in_buf_pos    = 0;
+	in_buf_end    = 0;
+	overrun       = 0;
+	bit_buf       = 0;
+	bit_count     = 0;
+	state         = state_header;
+	last_block    = false;
+	stored_remain = 0;
+	match_remain  = 0;
+	match_dist    = 0;
+	out_pos       = 0;
+}
+
+blargg_err_t Inflater::resume()
+{
+	return in->seek( in_next );
+}
+
+int Inflater::next_byte()
+{
+	if ( in_buf_pos >= in_buf_end )
+	{
+		long n = in->read_avail( in_buf, in_buf_size );
+		if ( n <= 0 )
+		{
+			// supply zeros; read() fails if any of them are used
+			overrun++;
+			return 0;
+		}
+		in_next   += n;
+		in_buf_pos = 0;
+		in_buf_end = n;
+	}
+	return in_buf [in_buf_pos++];
+}
+
+inline int Inflater::bits( int n )
+{
+	while ( bit_count < n )
+	{
+		bit_buf |= (unsigned long) next_byte() << bit_count;
+		bit_count += 8;
+	}
+	int result = bit_buf & ((1L << n) - 1);
+	bit_buf >>= n;
+	bit_count -= n;
+	return result;
+}
+
+int Inflater::decode( huffman_t const& h )
+{
+	while ( bit_count < max_bits )
+	{
+		bit_buf |= (unsigned long) next_byte() << bit_count;
+		bit_count += 8;
+	}
+
+	int entry = h.fast [bit_buf & ((1 << fast_bits) - 1)];
+	if ( entry )
+	{
+		bit_buf >>= entry & 0x0F;
+		bit_count -= entry & 0x0F;
+		return entry >> 4;
+	}
+
+	// longer codes are decoded a bit at a time
+	int code  = 0;
+	int first = 0;
+	int index = 0;
+	for ( int len = 1; len <= max_bits; len++ )
+	{
+		code |= (bit_buf >> (len - 1)) & 1;
+		int count = h.count [len];
+		if ( code - count < first )
+		{
+			bit_buf >>= len;
+			bit_count -= len;
+			return h.symbol [index + code - first];
+		}
+		index += count;
+		first  = (first + count) << 1;
+		code <<= 1;
+	}
+	return -1; // code isn't in incomplete table
+}
+
+bool Inflater::build( huffman_t& h, short const* lengths, int n )
+{
+	memset( h.count, 0, sizeof h.count );
+	for ( int sym = 0; sym < n; sym++ )
+		h.count [lengths [sym]]++;
+
+	int left = 1;
+	for ( int len = 1; len <= max_bits; len++ )
+	{
+		left = (left << 1) - h.count [len];
+		if ( left < 0 )
+			return false; // over-subscribed
+	}
+
+	short offs [max_bits + 1];
+	offs [1] = 0;
+	for ( int len = 1; len < max_bits; len++ )
+		offs [len + 1] = offs [len] + h.count [len];
+	for ( int sym = 0; sym < n; sym++ )
+	{
+		if ( lengths [sym] )
+			h.symbol [offs [lengths [sym]]++] = sym;
+	}
+
+	// codes are stored most significant bit first, so the table is indexed
+	// by their bits in reverse
+	memset( h.fast, 0, sizeof h.fast );
+	int code  = 0;
+	int index = 0;
+	for ( int len = 1; len <= fast_bits; len++ )
+	{
+		for ( int i = h.count [len]; i > 0; i-- )
+		{
+			int rev = 0;
+			for ( int b = 0; b < len; b++ )
+				rev |= (code >> b & 1) << (len - 1 - b);
+			for ( int j = rev; j < (1 << fast_bits); j += 1 << len )
+				h.fast [j] = h.symbol [index] << 4 | len;
+			code++;
+			index++;
+		}
+		code <<= 1;
+	}
+	return true;
+}
+
+void Inflater::fixed_tables()
+{
+	int i = 0;
+	for ( ; i < 144; i++ ) lengths [i] = 8;
+	for ( ; i < 256; i++ ) lengths [i] = 9;
+	for ( ; i < 280; i++ ) lengths [i] = 7;
+	for ( ; i < 288; i++ ) lengths [i] = 8;
+	build( lencode, lengths, 288 );
+
+	for ( i = 0; i < 30; i++ )
+		lengths [i] = 5;
+	build( distcode, lengths, 30 );
+}
+
+bool Inflater::read_dynamic()
+{
+	int nlen  = bits( 5 ) + 257;
+	int ndist = bits( 5 ) + 1;
+	int ncode = bits( 4 ) + 4;
+	if ( nlen > 286 || ndist > 30 )
+		return false;
+
+	static byte const order [19] = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+	};
+	int i;
+	for ( i = 0; i < ncode; i++ )
+		lengths [order [i]] = bits( 3 );
+	for ( ; i < 19; i++ )
+		lengths [order [i]] = 0;
+
+	// code length code goes in lencode, which is rebuilt below
+	if ( !build( lencode, lengths, 19 ) )
+		return false;
+
+	for ( i = 0; i < nlen + ndist; )
+	{
+		int sym = decode( lencode );
+		if ( sym < 0 )
+			return false;
+		if ( sym < 16 )
+		{
+			lengths [i++] = sym;
+			continue;
+		}
+
+		int len = 0;
+		int rep;
+		if ( sym == 16 )
+		{
+			if ( !i )
+				return false;
+			len = lengths [i - 1];
+			rep = 3 + bits( 2 );
+		}
+		else if ( sym == 17 )
+		{
+			rep = 3 + bits( 3 );
+		}
+		else
+		{
+			rep = 11 + bits( 7 );
+		}
+		if ( i + rep > nlen + ndist )
+			return false;
+		while ( rep-- )
+			lengths [i++] = len;
+	}
+
+	if ( !lengths [256] )
+		return false; // no end of block code
+
+	return build( lencode, lengths, nlen ) && build( distcode, lengths + nlen, ndist );
+}
+
+bool Inflater::read_header()
+{
+	last_block = bits( 1 ) != 0;
+	switch ( bits( 2 ) )
+	{
+	case 0: {
+		bits( bit_count & 7 ); // stored data starts on byte boundary
+		int len = bits( 16 );
+		if ( bits( 16 ) != (~len & 0xFFFF) )
+			return false;
+		stored_remain = len;
+		state = state_stored;
+		return true;
+	}
+
+	case 1:
+		fixed_tables();
+		state = state_codes;
+		return true;
+
+	case 2:
+		if ( !read_dynamic() )
+			return false;
+		state = state_codes;
+		return true;
+	}
+	return false;
+}
+
+long Inflater::read( void* p, long n )
+{
+	byte* out = (byte*) p;
+	long remain = n;
+	while ( remain > 0 )
+	{
+		if ( match_remain )
+		{
+			int count = match_remain;
+			if ( count > remain )
+				count = (int) remain;
+			match_remain -= count;
+			remain -= count;
+			unsigned long from = out_pos - match_dist;
+			do
+			{
+				byte b = window [from++ & (window_size - 1)];
+				window [out_pos++ & (window_size - 1)] = b;
+				*out++ = b;
+			}
+			while ( --count );
+			continue;
+		}
+
+		switch ( state )
+		{
+		case state_header:
+			if ( last_block )
+				state = state_done;
+			else if ( !read_header() )
+				state = state_error;
+			break;
+
+		case state_stored:
+			if ( !stored_remain )
+			{
+				state = state_header;
+				break;
+			}
+			stored_remain--;
+			remain--;
+			*out = window [out_pos++ & (window_size - 1)] = bits( 8 );
+			out++;
+			break;
+
+		case state_codes: {
+			int sym = decode( lencode );
+			if ( (unsigned) sym < 256 )
+			{
+				remain--;
+				*out = window [out_pos++ & (window_size - 1)] = sym;
+				out++;
+				break;
+			}
+			if ( sym == 256 )
+			{
+				state = state_header;
+				break;
+			}
+
+			sym -= 257;
+			if ( (unsigned) sym >= 29 )
+			{
+				state = state_error;
+				break;
+			}
+			int len = length_base [sym] + bits( length_extra [sym] );
+
+			int dsym = decode( distcode );
+			if ( (unsigned) dsym >= 30 )
+			{
+				state = state_error;
+				break;
+			}
+			unsigned long dist = dist_base [dsym] + bits( dist_extra [dsym] );
+			if ( dist > out_pos )
+			{
+				state = state_error;
+				break;
+			}
+			match_remain = len;
+			match_dist   = dist;
+			break;
+		}
+
+		case state_done:
+			return n - remain;
+
+		case state_error:
+			return -1;
+		}
+
+		if ( bit_count < overrun * 8 )
+			state = state_error; // used bits past end of input
+	}
+	return n;
+}
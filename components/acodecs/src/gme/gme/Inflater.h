@@ -0,0 +1,76 @@
+// Deflate (RFC 1951) decompressor that can stop and resume anywhere in its output
+
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+#ifndef INFLATER_H
+#define INFLATER_H
+
+#include "Data_Reader.h"
+
+// Decompresses a raw deflate stream read from a File_Reader. All state lives
+// in the object itself, so copying an Inflater with assignment and calling
+// resume() on the copy continues decompression from the point it was copied.
+class Inflater {
+public:
+	// Begin decompressing deflate data at the current position of in
+	void begin( File_Reader* in );
+
+	// Decompress at most n bytes into out. Returns number of bytes written,
+	// 0 at end of data, or -1 if data is corrupt or truncated.
+	long read( void* out, long n );
+
+	// Number of bytes decompressed so far
+	long tell() const { return (long) out_pos; }
+
+	// Continue from the state of an Inflater that was assigned to this one.
+	// Both must read from the same input.
+	blargg_err_t resume();
+
+public:
+	Inflater() { begin( 0 ); }
+	typedef unsigned char byte;
+private:
+	enum { max_bits = 15 };
+	enum { fast_bits = 9 };
+	struct huffman_t
+	{
+		short count [max_bits + 1];     // number of codes of each length
+		short symbol [288];             // symbols ordered by code
+		unsigned short fast [1 << fast_bits]; // symbol << 4 | length, 0 if code is longer
+	};
+
+	enum { window_size = 0x8000 }; // maximum distance of a match
+	enum { in_buf_size = 512 };
+	enum state_t { state_header, state_stored, state_codes, state_done, state_error };
+
+	File_Reader* in;
+	long in_next;           // input offset of in_buf_end
+	int in_buf_pos;
+	int in_buf_end;
+	int overrun;            // bytes past the end of input supplied as zero
+
+	unsigned long bit_buf;
+	int bit_count;
+
+	state_t state;
+	bool last_block;
+	long stored_remain;
+	int match_remain;
+	int match_dist;
+	unsigned long out_pos;
+
+	huffman_t lencode;
+	huffman_t distcode;
+	short lengths [320];
+	byte in_buf [in_buf_size];
+	byte window [window_size];
+
+	int next_byte();
+	int bits( int n );
+	int decode( huffman_t const& );
+	bool build( huffman_t&, short const* lengths, int n );
+	bool read_header();
+	bool read_dynamic();
+	void fixed_tables();
+};
+
+#endif
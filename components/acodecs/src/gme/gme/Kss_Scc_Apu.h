@@ -6,6 +6,11 @@
 
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
+
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef SCC_APU_FAST_SYNTH
+	#define SCC_APU_FAST_SYNTH 0
+#endif
 #include <string.h>
 
 class Scc_Apu {
@@ -52,7 +57,7 @@ private:
 	osc_t oscs [osc_count];
 	blip_time_t last_time;
 	unsigned char regs [reg_count];
-	Blip_Synth<blip_med_quality,1> synth;
+	Blip_Synth<(SCC_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> synth;
 	
 	void run_until( blip_time_t );
 };
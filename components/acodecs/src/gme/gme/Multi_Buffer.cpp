@@ -2,6 +2,8 @@
 
 #include "Multi_Buffer.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -28,6 +30,14 @@ Multi_Buffer::Multi_Buffer( int spf ) : samples_per_frame_( spf )
 
 blargg_err_t Multi_Buffer::set_channel_count( int ) { return 0; }
 
+void Multi_Buffer::copy_state( Emu_State& s )
+{
+	if ( s.loading() )
+		clear();
+	else
+		s.pending = samples_avail();
+}
+
 // Silent_Buffer
 
 Silent_Buffer::Silent_Buffer() : Multi_Buffer( 1 ) // 0 channels would probably confuse
@@ -93,6 +103,14 @@ void Stereo_Buffer::clear()
 		bufs [i].clear();
 }
 
+void Stereo_Buffer::copy_state( Emu_State& s )
+{
+	s.copy( stereo_added );
+	s.copy( was_stereo );
+	for ( int i = 0; i < buf_count; i++ )
+		bufs [i].copy_state( s );
+}
+
 void Stereo_Buffer::end_frame( blip_time_t clock_count )
 {
 	stereo_added = 0;
@@ -3,6 +3,8 @@
 #include "Music_Emu.h"
 
 #include "Multi_Buffer.h"
+#include "Emu_State.h"
+#include <stdlib.h>
 #include <string.h>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
@@ -37,7 +39,9 @@ void Music_Emu::clear_track_vars()
 	fade_step        = 1;
 	silence_time     = 0;
 	silence_count    = 0;
+	initial_silence  = 0;
 	buf_remain       = 0;
+	play_time        = 0;
 	warning(); // clear warning
 }
 
@@ -45,6 +49,7 @@ void Music_Emu::unload()
 {
 	voice_count_ = 0;
 	clear_track_vars();
+	clear_checkpoints();
 	Gme_File::unload();
 }
 
@@ -52,19 +57,26 @@ Music_Emu::Music_Emu()
 {
 	effects_buffer = 0;
 	multi_channel_ = false;
+	mono_        = false;
 	sample_rate_ = 0;
 	mute_mask_   = 0;
 	tempo_       = 1.0;
 	gain_        = 1.0;
 	
 	// defaults
-	max_initial_silence = 2;
+	max_initial_silence = 2000;
 	silence_lookahead   = 3;
+	silence_budget      = 0;
 	ignore_silence_     = false;
 	equalizer_.treble   = -1.0;
 	equalizer_.bass     = 60;
 	
 	emu_autoload_playback_limit_ = true;
+	
+	checkpoints         = 0;
+	checkpoint_interval = 0;
+	checkpoint_budget   = 0;
+	checkpoint_used     = 0;
 
 	static const char* const names [] = {
 		"Voice 1", "Voice 2", "Voice 3", "Voice 4",
@@ -74,7 +86,11 @@ Music_Emu::Music_Emu()
 	Music_Emu::unload(); // non-virtual
 }
 
-Music_Emu::~Music_Emu() { delete effects_buffer; }
+Music_Emu::~Music_Emu()
+{
+	clear_checkpoints();
+	delete effects_buffer;
+}
 
 blargg_err_t Music_Emu::set_sample_rate( long rate )
 {
@@ -116,6 +132,25 @@ blargg_err_t Music_Emu::set_multi_channel_( bool isEnabled )
 	return 0;
 }
 
+bool Music_Emu::mono() const
+{
+	return mono_;
+}
+
+blargg_err_t Music_Emu::set_mono( bool )
+{
+	// by default not supported, derived may override this
+	return "unsupported for this emulator type";
+}
+
+blargg_err_t Music_Emu::set_mono_( bool isEnabled )
+{
+	// output buffer is chosen when the sample rate is set
+	require( !sample_rate() );
+	mono_ = isEnabled;
+	return 0;
+}
+
 void Music_Emu::mute_voice( int index, bool mute )
 {
 	require( (unsigned) index < (unsigned) voice_count() );
@@ -142,6 +177,16 @@ void Music_Emu::set_tempo( double t )
 	if ( t > max ) t = max;
 	tempo_ = t;
 	set_tempo_( t );
+	clear_checkpoints(); // timing of saved state no longer matches
+}
+
+blargg_err_t Music_Emu::set_ym2612_core( int core )
+{
+	int old = ym2612_core();
+	RETURN_ERR( set_ym2612_core_( core ) );
+	if ( core != old )
+		clear_checkpoints(); // saved state is for the old core
+	return 0;
 }
 
 void Music_Emu::post_load_()
@@ -151,6 +196,12 @@ void Music_Emu::post_load_()
 }
 
 blargg_err_t Music_Emu::start_track( int track )
+{
+	clear_checkpoints();
+	return begin_track( track );
+}
+
+blargg_err_t Music_Emu::begin_track( int track )
 {
 	clear_track_vars();
 	
@@ -164,22 +215,47 @@ blargg_err_t Music_Emu::start_track( int track )
 	
 	if ( !ignore_silence_ )
 	{
-		// play until non-silence or end of track
-		for ( long end = max_initial_silence * out_channels() * sample_rate(); emu_time < end; )
-		{
-			fill_buf();
-			if ( buf_remain | (int) emu_track_ended_ )
-				break;
-		}
-		
-		emu_time      = buf_remain;
-		out_time      = 0;
-		silence_time  = 0;
-		silence_count = 0;
+		initial_silence = msec_to_samples( max_initial_silence );
+		skip_initial_silence( 0 );
 	}
 	return track_ended() ? warning() : 0;
 }
 
+void Music_Emu::set_silence_policy( int lookahead, long max_initial_msec, long budget_msec )
+{
+	if ( lookahead > 0 )
+		silence_lookahead = lookahead;
+	if ( max_initial_msec >= 0 )
+		max_initial_silence = max_initial_msec;
+	if ( budget_msec >= 0 )
+		silence_budget = budget_msec;
+}
+
+// play until non-silence or end of track, at most count samples plus silence_budget
+void Music_Emu::skip_initial_silence( long count )
+{
+	long end = emu_time + initial_silence;
+	if ( silence_budget )
+		end = min( end, emu_time + count + msec_to_samples( silence_budget ) );
+	
+	long const start = emu_time;
+	while ( emu_time < end )
+	{
+		fill_buf();
+		if ( buf_remain | (int) emu_track_ended_ )
+			break;
+	}
+	
+	initial_silence -= emu_time - start;
+	if ( initial_silence <= 0 || buf_remain || emu_track_ended_ )
+		initial_silence = 0;
+	
+	// skipped silence is dropped from output
+	emu_time      = out_time + buf_remain;
+	silence_time  = out_time;
+	silence_count = 0;
+}
+
 void Music_Emu::end_track_if_error( blargg_err_t err )
 {
 	if ( err )
@@ -222,8 +298,9 @@ long Music_Emu::tell() const
 
 blargg_err_t Music_Emu::seek_samples( long time )
 {
-	if ( time < out_time )
-		RETURN_ERR( start_track( current_track_ ) );
+	require( current_track() >= 0 ); // start_track() must have been called already
+	if ( !restore_checkpoint( time ) && time < out_time )
+		RETURN_ERR( begin_track( current_track_ ) ); // keeps checkpoints
 	return skip( time - out_time );
 }
 
@@ -236,6 +313,7 @@ blargg_err_t Music_Emu::skip( long count )
 {
 	require( current_track() >= 0 ); // start_track() must have been called already
 	out_time += count;
+	initial_silence = 0;
 	
 	// remove from silence and buf first
 	{
@@ -251,7 +329,19 @@ blargg_err_t Music_Emu::skip( long count )
 	if ( count && !emu_track_ended_ )
 	{
 		emu_time += count;
-		end_track_if_error( skip_( count ) );
+		do
+		{
+			// stop at next checkpoint
+			long n = count;
+			if ( checkpoint_interval && next_checkpoint > play_time )
+				n = min( n, (long) (next_checkpoint - play_time) );
+			count     -= n;
+			play_time += n;
+			end_track_if_error( skip_( n ) );
+			if ( checkpoint_interval && play_time >= next_checkpoint && !emu_track_ended_ )
+				save_checkpoint();
+		}
+		while ( count && !emu_track_ended_ );
 	}
 	
 	if ( !(silence_count | buf_remain) ) // caught up to emulator, so update track ended
@@ -289,6 +379,95 @@ blargg_err_t Music_Emu::skip_( long count )
 	return 0;
 }
 
+// Seek checkpoints
+
+struct Music_Emu::checkpoint_t
+{
+	checkpoint_t* next;
+	blargg_long time; // play_time
+	// followed by emulator state
+};
+
+void Music_Emu::set_seek_checkpoints( long interval_msec, long budget )
+{
+	clear_checkpoints();
+	checkpoint_interval = max( interval_msec, 0L );
+	checkpoint_budget   = budget;
+	next_checkpoint     = msec_to_samples( checkpoint_interval );
+}
+
+void Music_Emu::clear_checkpoints()
+{
+	while ( checkpoints )
+	{
+		checkpoint_t* next = checkpoints->next;
+		free( checkpoints );
+		checkpoints = next;
+	}
+	checkpoint_used = 0;
+	next_checkpoint = msec_to_samples( checkpoint_interval );
+}
+
+void Music_Emu::save_checkpoint()
+{
+	next_checkpoint = play_time + msec_to_samples( checkpoint_interval );
+	
+	Emu_State measure( Emu_State::measure_mode );
+	if ( !copy_state_( measure ) )
+	{
+		checkpoint_interval = 0; // not supported
+		return;
+	}
+	
+	long size = sizeof (checkpoint_t) + measure.size();
+	if ( checkpoint_used + size > checkpoint_budget )
+		return;
+	
+	checkpoint_t* c = (checkpoint_t*) malloc( size );
+	if ( !c )
+	{
+		checkpoint_interval = 0; // memory is short, keep what we have
+		return;
+	}
+	
+	Emu_State state( Emu_State::save_mode, c + 1 );
+	copy_state_( state );
+	c->time = play_time + state.pending;
+	c->next = checkpoints;
+	checkpoints = c;
+	checkpoint_used += size;
+}
+
+// Continue from the latest checkpoint at or before output time 'out' if that
+// saves emulating from the current position
+bool Music_Emu::restore_checkpoint( blargg_long out )
+{
+	blargg_long const offset = play_time - emu_time; // leading silence skipped
+	
+	checkpoint_t* c = checkpoints;
+	while ( c && (c->time > out + offset || c->time < offset) )
+		c = c->next;
+	
+	if ( !c || (out >= out_time && c->time <= play_time) )
+		return false;
+	
+	Emu_State state( Emu_State::load_mode, c + 1 );
+	copy_state_( state );
+	remute_voices();
+	
+	play_time        = c->time;
+	emu_time         = c->time - offset;
+	out_time         = emu_time;
+	silence_time     = emu_time;
+	silence_count    = 0;
+	buf_remain       = 0;
+	initial_silence  = 0;
+	emu_track_ended_ = false;
+	track_ended_     = false;
+	next_checkpoint  = checkpoints->time + msec_to_samples( checkpoint_interval );
+	return true;
+}
+
 // Fading
 
 void Music_Emu::set_fade( long start_msec, long length_msec )
@@ -332,9 +511,16 @@ void Music_Emu::emu_play( long count, sample_t* out )
 	check( current_track_ >= 0 );
 	emu_time += count;
 	if ( current_track_ >= 0 && !emu_track_ended_ )
+	{
+		play_time += count;
 		end_track_if_error( play_( count, out ) );
+		if ( checkpoint_interval && play_time >= next_checkpoint && !emu_track_ended_ )
+			save_checkpoint();
+	}
 	else
+	{
 		memset( out, 0, count * sizeof *out );
+	}
 }
 
 // number of consecutive silent samples at end
@@ -382,11 +568,26 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 		// prints nifty graph of how far ahead we are when searching for silence
 		//debug_printf( "%*s \n", int ((emu_time - out_time) * 7 / sample_rate()), "*" );
 		
+		if ( initial_silence )
+		{
+			skip_initial_silence( out_count );
+			if ( initial_silence )
+			{
+				// still looking for the start of the track
+				memset( out, 0, out_count * sizeof *out );
+				out_time += out_count;
+				emu_time  = out_time;
+				return 0;
+			}
+		}
+		
 		long pos = 0;
 		if ( silence_count )
 		{
 			// during a run of silence, run emulator at >=2x speed so it gets ahead
 			long ahead_time = silence_lookahead * (out_time + out_count - silence_time) + silence_time;
+			if ( silence_budget )
+				ahead_time = min( ahead_time, emu_time + out_count + msec_to_samples( silence_budget ) );
 			while ( emu_time < ahead_time && !(buf_remain | emu_track_ended_) )
 				fill_buf();
 			
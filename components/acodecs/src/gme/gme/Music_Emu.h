@@ -6,6 +6,7 @@
 
 #include "Gme_File.h"
 class Multi_Buffer;
+class Emu_State;
 
 struct Music_Emu : public Gme_File {
 public:
@@ -19,11 +20,17 @@ public:
 	// derived emus must override this if they support multichannel rendering
 	virtual blargg_err_t set_multi_channel( bool is_enabled );
 	
+	// Generate mono samples instead of stereo pairs. Must be called before
+	// set_sample_rate(). Default implementation returns not supported error;
+	// derived emus that can mix all voices into one buffer override this.
+	virtual blargg_err_t set_mono( bool is_enabled );
+	
 	// Start a track, where 0 is the first track. Also clears warning string.
 	blargg_err_t start_track( int );
 	
-	// Generate 'count' samples info 'buf'. Output is in stereo. Any emulation
-	// errors set warning string, and major errors also end track.
+	// Generate 'count' samples info 'buf'. Output is in stereo, or mono if
+	// set_mono() succeeded. Any emulation errors set warning string, and major
+	// errors also end track.
 	typedef short sample_t;
 	blargg_err_t play( long count, sample_t* buf );
 	
@@ -43,6 +50,8 @@ public:
 
 	bool multi_channel() const;
 	
+	bool mono() const;
+	
 // Track status/control
 
 	// Number of milliseconds (1000 msec = 1 second) played since beginning of track
@@ -60,6 +69,12 @@ public:
 	// Skip n samples
 	blargg_err_t skip( long n );
 	
+	// Keep snapshots of emulation state every interval_msec of playback, using at
+	// most budget bytes, so seeks resume from the closest one instead of emulating
+	// from the start of the track. Only some emulators support this. An interval
+	// of 0 disables snapshots, as does a snapshot failing to allocate.
+	void set_seek_checkpoints( long interval_msec, long budget );
+	
 	// True if a track has reached its end
 	bool track_ended() const;
 	
@@ -77,6 +92,14 @@ public:
 	// Disable automatic end-of-track detection and skipping of silence at beginning
 	void ignore_silence( bool disable = true );
 	
+	// Limit work done by silence detection. During silence the emulator runs
+	// lookahead times faster than playback to find the end of the track, and up to
+	// max_initial_msec of silence is skipped when a track starts. A non-zero
+	// budget_msec caps the emulation each start_track() and play() call may do
+	// beyond the samples it outputs, spreading the search over several calls.
+	// Negative values keep the current setting.
+	void set_silence_policy( int lookahead, long max_initial_msec, long budget_msec );
+	
 	// Info for current track
 	using Gme_File::track_info;
 	blargg_err_t track_info( track_info_t* out ) const;
@@ -106,6 +129,13 @@ public:
 	// equalizer settings.
 	void enable_accuracy( bool enable = true );
 	
+	// Select YM2612 FM emulation core (see Ym2612_Emu.h) for files using that chip.
+	// Can be changed while a track is playing. Returns error if file has no YM2612.
+	blargg_err_t set_ym2612_core( int core );
+	
+	// Current YM2612 emulation core, or -1 if file has no YM2612
+	int ym2612_core() const                     { return ym2612_core_(); }
+	
 // Sound equalization (treble/bass)
 
 	// Frequency equalizer parameters (see gme.txt)
@@ -133,7 +163,7 @@ public:
 	Music_Emu();
 	~Music_Emu();
 protected:
-	void set_max_initial_silence( int n )       { max_initial_silence = n; }
+	void set_max_initial_silence( int n )       { max_initial_silence = n * 1000L; }
 	void set_silence_lookahead( int n )         { silence_lookahead = n; }
 	void set_voice_count( int n )               { voice_count_ = n; }
 	void set_voice_names( const char* const* names );
@@ -142,15 +172,23 @@ protected:
 	double tempo() const                        { return tempo_; }
 	void remute_voices();
 	blargg_err_t set_multi_channel_( bool is_enabled );
+	blargg_err_t set_mono_( bool is_enabled );
 	
 	virtual blargg_err_t set_sample_rate_( long sample_rate ) = 0;
 	virtual void set_equalizer_( equalizer_t const& ) { }
 	virtual void enable_accuracy_( bool /* enable */ ) { }
+	virtual blargg_err_t set_ym2612_core_( int ) { return "No YM2612 in this file"; }
+	virtual int ym2612_core_() const { return -1; }
 	virtual void mute_voices_( int mask ) = 0;
 	virtual void set_tempo_( double ) = 0;
 	virtual blargg_err_t start_track_( int ) = 0; // tempo is set before this
 	virtual blargg_err_t play_( long count, sample_t* out ) = 0;
 	virtual blargg_err_t skip_( long count );
+	
+	// Pass all emulation state to 'state' (see Emu_State.h). Samples generated
+	// but not yet returned by play_() go in state.pending when saving and are
+	// discarded when loading. Returns false if checkpoints aren't supported.
+	virtual bool copy_state_( Emu_State& ) { return false; }
 protected:
 	virtual void unload();
 	virtual void pre_load();
@@ -158,16 +196,16 @@ protected:
 private:
 	// general
 	equalizer_t equalizer_;
-	int max_initial_silence;
 	const char** voice_names_;
 	int voice_count_;
 	int mute_mask_;
 	double tempo_;
 	double gain_;
 	bool multi_channel_;
+	bool mono_;
 
-	// returns the number of output channels, i.e. usually 2 for stereo, unlesss multi_channel_ == true
-	int out_channels() const { return this->multi_channel() ? 2*8 : 2; }
+	// returns the number of output channels, i.e. usually 2 for stereo, unlesss multi_channel_ or mono_ == true
+	int out_channels() const { return this->multi_channel() ? 2*8 : mono_ ? 1 : 2; }
 
 	long sample_rate_;
 	blargg_long msec_to_samples( blargg_long msec ) const;
@@ -179,6 +217,7 @@ private:
 	bool emu_track_ended_; // emulator has reached end of track
 	bool emu_autoload_playback_limit_; // whether to load and obey track length by default
 	volatile bool track_ended_;
+	blargg_err_t begin_track( int );
 	void clear_track_vars();
 	void end_track_if_error( blargg_err_t );
 	
@@ -189,6 +228,9 @@ private:
 	
 	// silence detection
 	int silence_lookahead; // speed to run emulator when looking ahead for silence
+	long max_initial_silence; // msec
+	long silence_budget;   // msec of extra emulation allowed per call, 0 if unlimited
+	long initial_silence;  // samples of leading silence that may still be skipped
 	bool ignore_silence_;
 	long silence_time;     // number of samples where most recent silence began
 	long silence_count;    // number of samples of silence to play before using buf
@@ -196,10 +238,23 @@ private:
 	enum { buf_size = 2048 };
 	blargg_vector<sample_t> buf;
 	void fill_buf();
+	void skip_initial_silence( long count );
 	void emu_play( long count, sample_t* out );
 	
+	// seek checkpoints
+	struct checkpoint_t;
+	checkpoint_t* checkpoints; // most recent first
+	long checkpoint_interval;  // msec, 0 if disabled
+	long checkpoint_budget;
+	long checkpoint_used;
+	blargg_long play_time;       // samples emulator has generated, never rebased
+	blargg_long next_checkpoint; // play_time of next checkpoint
+	void save_checkpoint();
+	bool restore_checkpoint( blargg_long out );
+	void clear_checkpoints();
+	
 	Multi_Buffer* effects_buffer;
-	friend Music_Emu* gme_internal_new_emu_( gme_type_t, int, bool );
+	friend Music_Emu* gme_internal_new_emu_( gme_type_t, int, bool, bool );
 	friend void gme_set_stereo_depth( Music_Emu*, double );
 };
 
@@ -2,6 +2,8 @@
 
 #include "Nes_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -389,3 +391,53 @@ int Nes_Apu::read_status( nes_time_t time )
 	
 	return result;
 }
+
+void Nes_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Nes_Osc& osc = *oscs [i];
+		s.copy( osc.regs );
+		s.copy( osc.reg_written );
+		s.copy( osc.length_counter );
+		s.copy( osc.delay );
+		s.copy( osc.last_amp );
+	}
+	
+	s.copy( square1.envelope );
+	s.copy( square1.env_delay );
+	s.copy( square1.phase );
+	s.copy( square1.sweep_delay );
+	s.copy( square2.envelope );
+	s.copy( square2.env_delay );
+	s.copy( square2.phase );
+	s.copy( square2.sweep_delay );
+	s.copy( triangle.phase );
+	s.copy( triangle.linear_counter );
+	s.copy( noise.envelope );
+	s.copy( noise.env_delay );
+	s.copy( noise.noise );
+	
+	s.copy( dmc.address );
+	s.copy( dmc.period );
+	s.copy( dmc.buf );
+	s.copy( dmc.bits_remain );
+	s.copy( dmc.bits );
+	s.copy( dmc.buf_full );
+	s.copy( dmc.silence );
+	s.copy( dmc.dac );
+	s.copy( dmc.next_irq );
+	s.copy( dmc.irq_enabled );
+	s.copy( dmc.irq_flag );
+	
+	s.copy( last_time );
+	s.copy( last_dmc_time );
+	s.copy( earliest_irq_ );
+	s.copy( next_irq );
+	s.copy( frame_period );
+	s.copy( frame_delay );
+	s.copy( frame );
+	s.copy( osc_enables );
+	s.copy( frame_mode );
+	s.copy( irq_flag );
+}
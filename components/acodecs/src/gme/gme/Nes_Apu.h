@@ -13,6 +13,7 @@ typedef unsigned nes_addr_t; // 16-bit memory address
 
 struct apu_state_t;
 class Nes_Buffer;
+class Emu_State;
 
 class Nes_Apu {
 public:
@@ -57,6 +58,9 @@ public:
 	void save_state( apu_state_t* out ) const;
 	void load_state( apu_state_t const& );
 	
+	// Save or restore state for a seek checkpoint (see Emu_State.h)
+	void copy_state( Emu_State& );
+	
 	// Set overall volume (default is 1.0)
 	void volume( double );
 	
@@ -2,6 +2,7 @@
 
 #include "Nes_Cpu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <limits.h>
 
@@ -102,6 +103,16 @@ void Nes_Cpu::map_code( nes_addr_t start, unsigned size, void const* data, bool
 	}
 }
 
+void Nes_Cpu::copy_state( Emu_State& s )
+{
+	require( state == &state_ );
+	s.copy( low_mem );
+	s.copy( r );
+	s.copy( state_ ); // mapped pages point into file data, which doesn't move
+	s.copy( irq_time_ );
+	s.copy( end_time_ );
+}
+
 #define TIME    (s_time + s.base)
 #define READ_LIKELY_PPU( addr, out )    {CPU_READ_PPU( this, (addr), out, TIME );}
 #define READ( addr )                    CPU_READ( this, (addr), TIME )
@@ -114,7 +125,7 @@ void Nes_Cpu::map_code( nes_addr_t start, unsigned size, void const* data, bool
 #define GET_SP()        ((sp - 1) & 0xFF)
 #define PUSH( v )       ((sp = (sp - 1) | 0x100), WRITE_LOW( sp, v ))
 
-bool Nes_Cpu::run( nes_time_t end_time )
+BLARGG_CPU_RUN bool Nes_Cpu::run( nes_time_t end_time )
 {
 	set_end_time( end_time );
 	state_t s = this->state_;
@@ -210,6 +221,7 @@ loop:
 	
 	data = *instr;
 	
+	BLARGG_DISPATCH( opcode );
 	switch ( opcode )
 	{
 #else
@@ -221,6 +233,7 @@ almost_out_of_time:
 	
 	data = *instr;
 	
+	BLARGG_DISPATCH( opcode );
 	switch ( opcode )
 	{
 possibly_out_of_time:
@@ -252,33 +265,35 @@ possibly_out_of_time:
 		out = 0x100 * READ_LOW( uint8_t (temp + 1) ) + READ_LOW( uint8_t (temp) );\
 	}
 	
-#define ARITH_ADDR_MODES( op )\
-case op - 0x04: /* (ind,x) */\
+// Opcodes 0xH1 to 0xHD and 0xL1 to 0xLD of an instruction with zp opcode 0xH5,
+// where L is the next row H + 1
+#define ARITH_ADDR_MODES( h, l )\
+BLARGG_OP( 0x##h##1 ): /* (ind,x) */\
 	IND_X( data )\
-	goto ptr##op;\
-case op + 0x0C: /* (ind),y */\
+	goto ptr##h;\
+BLARGG_OP( 0x##l##1 ): /* (ind),y */\
 	IND_Y( HANDLE_PAGE_CROSSING, data )\
-	goto ptr##op;\
-case op + 0x10: /* zp,X */\
+	goto ptr##h;\
+BLARGG_OP( 0x##l##5 ): /* zp,X */\
 	data = uint8_t (data + x);\
-case op + 0x00: /* zp */\
+BLARGG_OP( 0x##h##5 ): /* zp */\
 	data = READ_LOW( data );\
-	goto imm##op;\
-case op + 0x14: /* abs,Y */\
+	goto imm##h;\
+BLARGG_OP( 0x##l##9 ): /* abs,Y */\
 	data += y;\
-	goto ind##op;\
-case op + 0x18: /* abs,X */\
+	goto ind##h;\
+BLARGG_OP( 0x##l##D ): /* abs,X */\
 	data += x;\
-ind##op:\
+ind##h:\
 	HANDLE_PAGE_CROSSING( data );\
-case op + 0x08: /* abs */\
+BLARGG_OP( 0x##h##D ): /* abs */\
 	ADD_PAGE();\
-ptr##op:\
+ptr##h:\
 	FLUSH_TIME();\
 	data = READ( data );\
 	CACHE_TIME();\
-case op + 0x04: /* imm */\
-imm##op:
+BLARGG_OP( 0x##h##9 ): /* imm */\
+imm##h:
 
 // TODO: more efficient way to handle negative branch that wraps PC around
 #define BRANCH( cond )\
@@ -293,20 +308,20 @@ imm##op:
 
 // Often-Used
 
-	case 0xB5: // LDA zp,x
+	BLARGG_OP( 0xB5 ): // LDA zp,x
 		a = nz = READ_LOW( uint8_t (data + x) );
 		pc++;
 		goto loop;
 	
-	case 0xA5: // LDA zp
+	BLARGG_OP( 0xA5 ): // LDA zp
 		a = nz = READ_LOW( data );
 		pc++;
 		goto loop;
 	
-	case 0xD0: // BNE
+	BLARGG_OP( 0xD0 ): // BNE
 		BRANCH( (uint8_t) nz );
 	
-	case 0x20: { // JSR
+	BLARGG_OP( 0x20 ): { // JSR
 		uint16_t temp = pc + 1;
 		pc = GET_ADDR();
 		WRITE_LOW( 0x100 | (sp - 1), temp >> 8 );
@@ -315,50 +330,50 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x4C: // JMP abs
+	BLARGG_OP( 0x4C ): // JMP abs
 		pc = GET_ADDR();
 		goto loop;
 	
-	case 0xE8: // INX
+	BLARGG_OP( 0xE8 ): // INX
 		INC_DEC_XY( x, 1 )
 	
-	case 0x10: // BPL
+	BLARGG_OP( 0x10 ): // BPL
 		BRANCH( !IS_NEG )
 	
-	ARITH_ADDR_MODES( 0xC5 ) // CMP
+	ARITH_ADDR_MODES( C, D ) // CMP
 		nz = a - data;
 		pc++;
 		c = ~nz;
 		nz &= 0xFF;
 		goto loop;
 	
-	case 0x30: // BMI
+	BLARGG_OP( 0x30 ): // BMI
 		BRANCH( IS_NEG )
 	
-	case 0xF0: // BEQ
+	BLARGG_OP( 0xF0 ): // BEQ
 		BRANCH( !(uint8_t) nz );
 	
-	case 0x95: // STA zp,x
+	BLARGG_OP( 0x95 ): // STA zp,x
 		data = uint8_t (data + x);
-	case 0x85: // STA zp
+	BLARGG_OP( 0x85 ): // STA zp
 		pc++;
 		WRITE_LOW( data, a );
 		goto loop;
 	
-	case 0xC8: // INY
+	BLARGG_OP( 0xC8 ): // INY
 		INC_DEC_XY( y, 1 )
 
-	case 0xA8: // TAY
+	BLARGG_OP( 0xA8 ): // TAY
 		y  = a;
 		nz = a;
 		goto loop;
 	
-	case 0x98: // TYA
+	BLARGG_OP( 0x98 ): // TYA
 		a  = y;
 		nz = y;
 		goto loop;
 	
-	case 0xAD:{// LDA abs
+	BLARGG_OP( 0xAD ):{// LDA abs
 		unsigned addr = GET_ADDR();
 		pc += 2;
 		READ_LIKELY_PPU( addr, nz );
@@ -366,7 +381,7 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x60: // RTS
+	BLARGG_OP( 0x60 ): // RTS
 		pc = 1 + READ_LOW( sp );
 		pc += 0x100 * READ_LOW( 0x100 | (sp - 0xFF) );
 		sp = (sp - 0xFE) | 0x100;
@@ -375,7 +390,7 @@ imm##op:
 	{
 		uint16_t addr;
 		
-	case 0x99: // STA abs,Y
+	BLARGG_OP( 0x99 ): // STA abs,Y
 		addr = y + GET_ADDR();
 		pc += 2;
 		if ( addr <= 0x7FF )
@@ -385,7 +400,7 @@ imm##op:
 		}
 		goto sta_ptr;
 	
-	case 0x8D: // STA abs
+	BLARGG_OP( 0x8D ): // STA abs
 		addr = GET_ADDR();
 		pc += 2;
 		if ( addr <= 0x7FF )
@@ -395,7 +410,7 @@ imm##op:
 		}
 		goto sta_ptr;
 	
-	case 0x9D: // STA abs,X (slightly more common than STA abs)
+	BLARGG_OP( 0x9D ): // STA abs,X (slightly more common than STA abs)
 		addr = x + GET_ADDR();
 		pc += 2;
 		if ( addr <= 0x7FF )
@@ -409,19 +424,19 @@ imm##op:
 		CACHE_TIME();
 		goto loop;
 		
-	case 0x91: // STA (ind),Y
+	BLARGG_OP( 0x91 ): // STA (ind),Y
 		IND_Y( NO_PAGE_CROSSING, addr )
 		pc++;
 		goto sta_ptr;
 	
-	case 0x81: // STA (ind,X)
+	BLARGG_OP( 0x81 ): // STA (ind,X)
 		IND_X( addr )
 		pc++;
 		goto sta_ptr;
 	
 	}
 	
-	case 0xA9: // LDA #imm
+	BLARGG_OP( 0xA9 ): // LDA #imm
 		pc++;
 		a  = data;
 		nz = data;
@@ -431,12 +446,12 @@ imm##op:
 	{
 		uint16_t addr;
 		
-	case 0xA1: // LDA (ind,X)
+	BLARGG_OP( 0xA1 ): // LDA (ind,X)
 		IND_X( addr )
 		pc++;
 		goto a_nz_read_addr;
 	
-	case 0xB1:// LDA (ind),Y
+	BLARGG_OP( 0xB1 ):// LDA (ind),Y
 		addr = READ_LOW( data ) + y;
 		HANDLE_PAGE_CROSSING( addr );
 		addr += 0x100 * READ_LOW( (uint8_t) (data + 1) );
@@ -446,7 +461,7 @@ imm##op:
 			goto loop;
 		goto a_nz_read_addr;
 	
-	case 0xB9: // LDA abs,Y
+	BLARGG_OP( 0xB9 ): // LDA abs,Y
 		HANDLE_PAGE_CROSSING( data + y );
 		addr = GET_ADDR() + y;
 		pc += 2;
@@ -455,7 +470,7 @@ imm##op:
 			goto loop;
 		goto a_nz_read_addr;
 	
-	case 0xBD: // LDA abs,X
+	BLARGG_OP( 0xBD ): // LDA abs,X
 		HANDLE_PAGE_CROSSING( data + x );
 		addr = GET_ADDR() + x;
 		pc += 2;
@@ -472,58 +487,58 @@ imm##op:
 
 // Branch
 
-	case 0x50: // BVC
+	BLARGG_OP( 0x50 ): // BVC
 		BRANCH( !(status & st_v) )
 	
-	case 0x70: // BVS
+	BLARGG_OP( 0x70 ): // BVS
 		BRANCH( status & st_v )
 	
-	case 0xB0: // BCS
+	BLARGG_OP( 0xB0 ): // BCS
 		BRANCH( c & 0x100 )
 	
-	case 0x90: // BCC
+	BLARGG_OP( 0x90 ): // BCC
 		BRANCH( !(c & 0x100) )
 	
 // Load/store
 	
-	case 0x94: // STY zp,x
+	BLARGG_OP( 0x94 ): // STY zp,x
 		data = uint8_t (data + x);
-	case 0x84: // STY zp
+	BLARGG_OP( 0x84 ): // STY zp
 		pc++;
 		WRITE_LOW( data, y );
 		goto loop;
 	
-	case 0x96: // STX zp,y
+	BLARGG_OP( 0x96 ): // STX zp,y
 		data = uint8_t (data + y);
-	case 0x86: // STX zp
+	BLARGG_OP( 0x86 ): // STX zp
 		pc++;
 		WRITE_LOW( data, x );
 		goto loop;
 	
-	case 0xB6: // LDX zp,y
+	BLARGG_OP( 0xB6 ): // LDX zp,y
 		data = uint8_t (data + y);
-	case 0xA6: // LDX zp
+	BLARGG_OP( 0xA6 ): // LDX zp
 		data = READ_LOW( data );
-	case 0xA2: // LDX #imm
+	BLARGG_OP( 0xA2 ): // LDX #imm
 		pc++;
 		x = data;
 		nz = data;
 		goto loop;
 	
-	case 0xB4: // LDY zp,x
+	BLARGG_OP( 0xB4 ): // LDY zp,x
 		data = uint8_t (data + x);
-	case 0xA4: // LDY zp
+	BLARGG_OP( 0xA4 ): // LDY zp
 		data = READ_LOW( data );
-	case 0xA0: // LDY #imm
+	BLARGG_OP( 0xA0 ): // LDY #imm
 		pc++;
 		y = data;
 		nz = data;
 		goto loop;
 	
-	case 0xBC: // LDY abs,X
+	BLARGG_OP( 0xBC ): // LDY abs,X
 		data += x;
 		HANDLE_PAGE_CROSSING( data );
-	case 0xAC:{// LDY abs
+	BLARGG_OP( 0xAC ):{// LDY abs
 		unsigned addr = data + 0x100 * GET_MSB();
 		pc += 2;
 		FLUSH_TIME();
@@ -532,10 +547,10 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0xBE: // LDX abs,y
+	BLARGG_OP( 0xBE ): // LDX abs,y
 		data += y;
 		HANDLE_PAGE_CROSSING( data );
-	case 0xAE:{// LDX abs
+	BLARGG_OP( 0xAE ):{// LDX abs
 		unsigned addr = data + 0x100 * GET_MSB();
 		pc += 2;
 		FLUSH_TIME();
@@ -546,11 +561,11 @@ imm##op:
 	
 	{
 		uint8_t temp;
-	case 0x8C: // STY abs
+	BLARGG_OP( 0x8C ): // STY abs
 		temp = y;
 		goto store_abs;
 	
-	case 0x8E: // STX abs
+	BLARGG_OP( 0x8E ): // STX abs
 		temp = x;
 	store_abs:
 		unsigned addr = GET_ADDR();
@@ -568,7 +583,7 @@ imm##op:
 
 // Compare
 
-	case 0xEC:{// CPX abs
+	BLARGG_OP( 0xEC ):{// CPX abs
 		unsigned addr = GET_ADDR();
 		pc++;
 		FLUSH_TIME();
@@ -577,9 +592,9 @@ imm##op:
 		goto cpx_data;
 	}
 	
-	case 0xE4: // CPX zp
+	BLARGG_OP( 0xE4 ): // CPX zp
 		data = READ_LOW( data );
-	case 0xE0: // CPX #imm
+	BLARGG_OP( 0xE0 ): // CPX #imm
 	cpx_data:
 		nz = x - data;
 		pc++;
@@ -587,7 +602,7 @@ imm##op:
 		nz &= 0xFF;
 		goto loop;
 	
-	case 0xCC:{// CPY abs
+	BLARGG_OP( 0xCC ):{// CPY abs
 		unsigned addr = GET_ADDR();
 		pc++;
 		FLUSH_TIME();
@@ -596,9 +611,9 @@ imm##op:
 		goto cpy_data;
 	}
 	
-	case 0xC4: // CPY zp
+	BLARGG_OP( 0xC4 ): // CPY zp
 		data = READ_LOW( data );
-	case 0xC0: // CPY #imm
+	BLARGG_OP( 0xC0 ): // CPY #imm
 	cpy_data:
 		nz = y - data;
 		pc++;
@@ -608,22 +623,22 @@ imm##op:
 	
 // Logical
 
-	ARITH_ADDR_MODES( 0x25 ) // AND
+	ARITH_ADDR_MODES( 2, 3 ) // AND
 		nz = (a &= data);
 		pc++;
 		goto loop;
 	
-	ARITH_ADDR_MODES( 0x45 ) // EOR
+	ARITH_ADDR_MODES( 4, 5 ) // EOR
 		nz = (a ^= data);
 		pc++;
 		goto loop;
 	
-	ARITH_ADDR_MODES( 0x05 ) // ORA
+	ARITH_ADDR_MODES( 0, 1 ) // ORA
 		nz = (a |= data);
 		pc++;
 		goto loop;
 	
-	case 0x2C:{// BIT abs
+	BLARGG_OP( 0x2C ):{// BIT abs
 		unsigned addr = GET_ADDR();
 		pc += 2;
 		status &= ~st_v;
@@ -635,7 +650,7 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x24: // BIT zp
+	BLARGG_OP( 0x24 ): // BIT zp
 		nz = READ_LOW( data );
 		pc++;
 		status &= ~st_v;
@@ -647,12 +662,12 @@ imm##op:
 		
 // Add/subtract
 
-	ARITH_ADDR_MODES( 0xE5 ) // SBC
-	case 0xEB: // unofficial equivalent
+	ARITH_ADDR_MODES( E, F ) // SBC
+	BLARGG_OP( 0xEB ): // unofficial equivalent
 		data ^= 0xFF;
 		goto adc_imm;
 	
-	ARITH_ADDR_MODES( 0x65 ) // ADC
+	ARITH_ADDR_MODES( 6, 7 ) // ADC
 	adc_imm: {
 		int16_t carry = c >> 8 & 1;
 		int16_t ov = (a ^ 0x80) + carry + (int8_t) data; // sign-extend
@@ -666,22 +681,22 @@ imm##op:
 	
 // Shift/rotate
 
-	case 0x4A: // LSR A
+	BLARGG_OP( 0x4A ): // LSR A
 		c = 0;
-	case 0x6A: // ROR A
+	BLARGG_OP( 0x6A ): // ROR A
 		nz = c >> 1 & 0x80;
 		c = a << 8;
 		nz |= a >> 1;
 		a = nz;
 		goto loop;
 
-	case 0x0A: // ASL A
+	BLARGG_OP( 0x0A ): // ASL A
 		nz = a << 1;
 		c = nz;
 		a = (uint8_t) nz;
 		goto loop;
 
-	case 0x2A: { // ROL A
+	BLARGG_OP( 0x2A ): { // ROL A
 		nz = a << 1;
 		int16_t temp = c >> 8 & 1;
 		c = nz;
@@ -690,11 +705,11 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x5E: // LSR abs,X
+	BLARGG_OP( 0x5E ): // LSR abs,X
 		data += x;
-	case 0x4E: // LSR abs
+	BLARGG_OP( 0x4E ): // LSR abs
 		c = 0;
-	case 0x6E: // ROR abs
+	BLARGG_OP( 0x6E ): // ROR abs
 	ror_abs: {
 		ADD_PAGE();
 		FLUSH_TIME();
@@ -704,15 +719,15 @@ imm##op:
 		goto rotate_common;
 	}
 	
-	case 0x3E: // ROL abs,X
+	BLARGG_OP( 0x3E ): // ROL abs,X
 		data += x;
 		goto rol_abs;
 	
-	case 0x1E: // ASL abs,X
+	BLARGG_OP( 0x1E ): // ASL abs,X
 		data += x;
-	case 0x0E: // ASL abs
+	BLARGG_OP( 0x0E ): // ASL abs
 		c = 0;
-	case 0x2E: // ROL abs
+	BLARGG_OP( 0x2E ): // ROL abs
 	rol_abs:
 		ADD_PAGE();
 		nz = c >> 8 & 1;
@@ -724,19 +739,19 @@ imm##op:
 		CACHE_TIME();
 		goto loop;
 	
-	case 0x7E: // ROR abs,X
+	BLARGG_OP( 0x7E ): // ROR abs,X
 		data += x;
 		goto ror_abs;
 	
-	case 0x76: // ROR zp,x
+	BLARGG_OP( 0x76 ): // ROR zp,x
 		data = uint8_t (data + x);
 		goto ror_zp;
 	
-	case 0x56: // LSR zp,x
+	BLARGG_OP( 0x56 ): // LSR zp,x
 		data = uint8_t (data + x);
-	case 0x46: // LSR zp
+	BLARGG_OP( 0x46 ): // LSR zp
 		c = 0;
-	case 0x66: // ROR zp
+	BLARGG_OP( 0x66 ): // ROR zp
 	ror_zp: {
 		int temp = READ_LOW( data );
 		nz = (c >> 1 & 0x80) | (temp >> 1);
@@ -744,15 +759,15 @@ imm##op:
 		goto write_nz_zp;
 	}
 	
-	case 0x36: // ROL zp,x
+	BLARGG_OP( 0x36 ): // ROL zp,x
 		data = uint8_t (data + x);
 		goto rol_zp;
 	
-	case 0x16: // ASL zp,x
+	BLARGG_OP( 0x16 ): // ASL zp,x
 		data = uint8_t (data + x);
-	case 0x06: // ASL zp
+	BLARGG_OP( 0x06 ): // ASL zp
 		c = 0;
-	case 0x26: // ROL zp
+	BLARGG_OP( 0x26 ): // ROL zp
 	rol_zp:
 		nz = c >> 8 & 1;
 		nz |= (c = READ_LOW( data ) << 1);
@@ -760,21 +775,21 @@ imm##op:
 	
 // Increment/decrement
 
-	case 0xCA: // DEX
+	BLARGG_OP( 0xCA ): // DEX
 		INC_DEC_XY( x, -1 )
 	
-	case 0x88: // DEY
+	BLARGG_OP( 0x88 ): // DEY
 		INC_DEC_XY( y, -1 )
 	
-	case 0xF6: // INC zp,x
+	BLARGG_OP( 0xF6 ): // INC zp,x
 		data = uint8_t (data + x);
-	case 0xE6: // INC zp
+	BLARGG_OP( 0xE6 ): // INC zp
 		nz = 1;
 		goto add_nz_zp;
 	
-	case 0xD6: // DEC zp,x
+	BLARGG_OP( 0xD6 ): // DEC zp,x
 		data = uint8_t (data + x);
-	case 0xC6: // DEC zp
+	BLARGG_OP( 0xC6 ): // DEC zp
 		nz = (uint16_t) -1;
 	add_nz_zp:
 		nz += READ_LOW( data );
@@ -783,21 +798,21 @@ imm##op:
 		WRITE_LOW( data, nz );
 		goto loop;
 	
-	case 0xFE: // INC abs,x
+	BLARGG_OP( 0xFE ): // INC abs,x
 		data = x + GET_ADDR();
 		goto inc_ptr;
 	
-	case 0xEE: // INC abs
+	BLARGG_OP( 0xEE ): // INC abs
 		data = GET_ADDR();
 	inc_ptr:
 		nz = 1;
 		goto inc_common;
 	
-	case 0xDE: // DEC abs,x
+	BLARGG_OP( 0xDE ): // DEC abs,x
 		data = x + GET_ADDR();
 		goto dec_ptr;
 	
-	case 0xCE: // DEC abs
+	BLARGG_OP( 0xCE ): // DEC abs
 		data = GET_ADDR();
 	dec_ptr:
 		nz = (uint16_t) -1;
@@ -811,36 +826,36 @@ imm##op:
 		
 // Transfer
 
-	case 0xAA: // TAX
+	BLARGG_OP( 0xAA ): // TAX
 		x  = a;
 		nz = a;
 		goto loop;
 		
-	case 0x8A: // TXA
+	BLARGG_OP( 0x8A ): // TXA
 		a  = x;
 		nz = x;
 		goto loop;
 
-	case 0x9A: // TXS
+	BLARGG_OP( 0x9A ): // TXS
 		SET_SP( x ); // verified (no flag change)
 		goto loop;
 	
-	case 0xBA: // TSX
+	BLARGG_OP( 0xBA ): // TSX
 		x = nz = GET_SP();
 		goto loop;
 	
 // Stack
 	
-	case 0x48: // PHA
+	BLARGG_OP( 0x48 ): // PHA
 		PUSH( a ); // verified
 		goto loop;
 		
-	case 0x68: // PLA
+	BLARGG_OP( 0x68 ): // PLA
 		a = nz = READ_LOW( sp );
 		sp = (sp - 0xFF) | 0x100;
 		goto loop;
 		
-	case 0x40:{// RTI
+	BLARGG_OP( 0x40 ):{// RTI
 		uint8_t temp = READ_LOW( sp );
 		pc  = READ_LOW( 0x100 | (sp - 0xFF) );
 		pc |= READ_LOW( 0x100 | (sp - 0xFE) ) * 0x100;
@@ -857,7 +872,7 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x28:{// PLP
+	BLARGG_OP( 0x28 ):{// PLP
 		uint8_t temp = READ_LOW( sp );
 		sp = (sp - 0xFF) | 0x100;
 		uint8_t changed = status ^ temp;
@@ -869,14 +884,14 @@ imm##op:
 		goto handle_cli;
 	}
 	
-	case 0x08: { // PHP
+	BLARGG_OP( 0x08 ): { // PHP
 		uint8_t temp;
 		CALC_STATUS( temp );
 		PUSH( temp | (st_b | st_r) );
 		goto loop;
 	}
 	
-	case 0x6C:{// JMP (ind)
+	BLARGG_OP( 0x6C ):{// JMP (ind)
 		data = GET_ADDR();
 		check( unsigned (data - 0x2000) >= 0x4000 ); // ensure it's outside I/O space
 		uint8_t const* page = s.code_map [data >> page_bits];
@@ -886,32 +901,32 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x00: // BRK
+	BLARGG_OP( 0x00 ): // BRK
 		goto handle_brk;
 	
 // Flags
 
-	case 0x38: // SEC
+	BLARGG_OP( 0x38 ): // SEC
 		c = (uint16_t) ~0;
 		goto loop;
 	
-	case 0x18: // CLC
+	BLARGG_OP( 0x18 ): // CLC
 		c = 0;
 		goto loop;
 		
-	case 0xB8: // CLV
+	BLARGG_OP( 0xB8 ): // CLV
 		status &= ~st_v;
 		goto loop;
 	
-	case 0xD8: // CLD
+	BLARGG_OP( 0xD8 ): // CLD
 		status &= ~st_d;
 		goto loop;
 	
-	case 0xF8: // SED
+	BLARGG_OP( 0xF8 ): // SED
 		status |= st_d;
 		goto loop;
 	
-	case 0x58: // CLI
+	BLARGG_OP( 0x58 ): // CLI
 		if ( !(status & st_i) )
 			goto loop;
 		status &= ~st_i;
@@ -943,7 +958,7 @@ imm##op:
 		goto loop;
 	}
 	
-	case 0x78: // SEI
+	BLARGG_OP( 0x78 ): // SEI
 		if ( status & st_i )
 			goto loop;
 		status |= st_i;
@@ -962,30 +977,48 @@ imm##op:
 // Unofficial
 	
 	// SKW - Skip word
-	case 0x1C: case 0x3C: case 0x5C: case 0x7C: case 0xDC: case 0xFC:
+	BLARGG_OP( 0x1C ): BLARGG_OP( 0x3C ): BLARGG_OP( 0x5C ): BLARGG_OP( 0x7C ): BLARGG_OP( 0xDC ):
+	BLARGG_OP( 0xFC ):
 		HANDLE_PAGE_CROSSING( data + x );
-	case 0x0C:
+	BLARGG_OP( 0x0C ):
 		pc++;
 	// SKB - Skip byte
-	case 0x74: case 0x04: case 0x14: case 0x34: case 0x44: case 0x54: case 0x64:
-	case 0x80: case 0x82: case 0x89: case 0xC2: case 0xD4: case 0xE2: case 0xF4:
+	BLARGG_OP( 0x74 ): BLARGG_OP( 0x04 ): BLARGG_OP( 0x14 ): BLARGG_OP( 0x34 ): BLARGG_OP( 0x44 ):
+	BLARGG_OP( 0x54 ): BLARGG_OP( 0x64 ):
+	BLARGG_OP( 0x80 ): BLARGG_OP( 0x82 ): BLARGG_OP( 0x89 ): BLARGG_OP( 0xC2 ): BLARGG_OP( 0xD4 ):
+	BLARGG_OP( 0xE2 ): BLARGG_OP( 0xF4 ):
 		pc++;
 		goto loop;
 	
 	// NOP
-	case 0xEA: case 0x1A: case 0x3A: case 0x5A: case 0x7A: case 0xDA: case 0xFA:
+	BLARGG_OP( 0xEA ): BLARGG_OP( 0x1A ): BLARGG_OP( 0x3A ): BLARGG_OP( 0x5A ): BLARGG_OP( 0x7A ):
+	BLARGG_OP( 0xDA ): BLARGG_OP( 0xFA ):
 		goto loop;
 
-	case bad_opcode: // HLT
+	BLARGG_OP( 0xF2 ): // HLT, bad_opcode
 		pc--;
-	case 0x02: case 0x12: case 0x22: case 0x32: case 0x42: case 0x52:
-	case 0x62: case 0x72: case 0x92: case 0xB2: case 0xD2:
+	BLARGG_OP( 0x02 ): BLARGG_OP( 0x12 ): BLARGG_OP( 0x22 ): BLARGG_OP( 0x32 ): BLARGG_OP( 0x42 ):
+	BLARGG_OP( 0x52 ):
+	BLARGG_OP( 0x62 ): BLARGG_OP( 0x72 ): BLARGG_OP( 0x92 ): BLARGG_OP( 0xB2 ): BLARGG_OP( 0xD2 ):
 		goto stop;
 	
 // Unimplemented
 	
-	case 0xFF: // force 256-entry jump table for optimization purposes
+	BLARGG_OP( 0xFF ): // force 256-entry jump table for optimization purposes
 		c |= 1;
+	BLARGG_OP( 0x03 ): BLARGG_OP( 0x07 ): BLARGG_OP( 0x0B ): BLARGG_OP( 0x0F ): BLARGG_OP( 0x13 ):
+	BLARGG_OP( 0x17 ): BLARGG_OP( 0x1B ): BLARGG_OP( 0x1F ): BLARGG_OP( 0x23 ): BLARGG_OP( 0x27 ):
+	BLARGG_OP( 0x2B ): BLARGG_OP( 0x2F ): BLARGG_OP( 0x33 ): BLARGG_OP( 0x37 ): BLARGG_OP( 0x3B ):
+	BLARGG_OP( 0x3F ): BLARGG_OP( 0x43 ): BLARGG_OP( 0x47 ): BLARGG_OP( 0x4B ): BLARGG_OP( 0x4F ):
+	BLARGG_OP( 0x53 ): BLARGG_OP( 0x57 ): BLARGG_OP( 0x5B ): BLARGG_OP( 0x5F ): BLARGG_OP( 0x63 ):
+	BLARGG_OP( 0x67 ): BLARGG_OP( 0x6B ): BLARGG_OP( 0x6F ): BLARGG_OP( 0x73 ): BLARGG_OP( 0x77 ):
+	BLARGG_OP( 0x7B ): BLARGG_OP( 0x7F ): BLARGG_OP( 0x83 ): BLARGG_OP( 0x87 ): BLARGG_OP( 0x8B ):
+	BLARGG_OP( 0x8F ): BLARGG_OP( 0x93 ): BLARGG_OP( 0x97 ): BLARGG_OP( 0x9B ): BLARGG_OP( 0x9C ):
+	BLARGG_OP( 0x9E ): BLARGG_OP( 0x9F ): BLARGG_OP( 0xA3 ): BLARGG_OP( 0xA7 ): BLARGG_OP( 0xAB ):
+	BLARGG_OP( 0xAF ): BLARGG_OP( 0xB3 ): BLARGG_OP( 0xB7 ): BLARGG_OP( 0xBB ): BLARGG_OP( 0xBF ):
+	BLARGG_OP( 0xC3 ): BLARGG_OP( 0xC7 ): BLARGG_OP( 0xCB ): BLARGG_OP( 0xCF ): BLARGG_OP( 0xD3 ):
+	BLARGG_OP( 0xD7 ): BLARGG_OP( 0xDB ): BLARGG_OP( 0xDF ): BLARGG_OP( 0xE3 ): BLARGG_OP( 0xE7 ):
+	BLARGG_OP( 0xEF ): BLARGG_OP( 0xF3 ): BLARGG_OP( 0xF7 ): BLARGG_OP( 0xFB ):
 	default:
 		check( (unsigned) opcode <= 0xFF );
 		// skip over proper number of bytes
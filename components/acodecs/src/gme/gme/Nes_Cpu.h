@@ -10,6 +10,8 @@ typedef blargg_long nes_time_t; // clock cycle count
 typedef unsigned nes_addr_t; // 16-bit address
 enum { future_nes_time = INT_MAX / 2 + 1 };
 
+class Emu_State;
+
 class Nes_Cpu {
 public:
 	// Clear registers, map low memory and its three mirrors to address 0,
@@ -61,6 +63,10 @@ public:
 	// CPU invokes bad opcode handler if it encounters this
 	enum { bad_opcode = 0xF2 };
 	
+	// Save or restore registers, RAM and memory mapping for a seek checkpoint
+	// (see Emu_State.h). Must not be called from within run().
+	void copy_state( Emu_State& );
+	
 public:
 	Nes_Cpu() { state = &state_; }
 	enum { page_bits = 11 };
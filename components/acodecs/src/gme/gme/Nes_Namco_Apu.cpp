@@ -2,6 +2,8 @@
 
 #include "Nes_Namco_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -64,6 +66,19 @@ void Nes_Namco_Apu::reflect_state( Tagged_Data& data )
 }
 */
 
+void Nes_Namco_Apu::copy_state( Emu_State& s )
+{
+	s.copy( last_time );
+	s.copy( addr_reg );
+	s.copy( reg );
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		s.copy( oscs [i].delay );
+		s.copy( oscs [i].last_amp );
+		s.copy( oscs [i].wave_pos );
+	}
+}
+
 void Nes_Namco_Apu::end_frame( blip_time_t time )
 {
 	if ( time > last_time )
@@ -8,6 +8,7 @@
 #include "Blip_Buffer.h"
 
 struct namco_state_t;
+class Emu_State;
 
 class Nes_Namco_Apu {
 public:
@@ -33,6 +34,9 @@ public:
 	void save_state( namco_state_t* out ) const;
 	void load_state( namco_state_t const& );
 	
+	// Save or restore state for a seek checkpoint (see Emu_State.h)
+	void copy_state( Emu_State& );
+	
 public:
 	Nes_Namco_Apu();
 	BLARGG_DISABLE_NOTHROW
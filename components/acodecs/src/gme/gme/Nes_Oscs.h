@@ -7,6 +7,11 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef NES_APU_FAST_SYNTH
+	#define NES_APU_FAST_SYNTH 0
+#endif
+
 class Nes_Apu;
 
 struct Nes_Osc
@@ -56,7 +61,7 @@ struct Nes_Square : Nes_Envelope
 	int phase;
 	int sweep_delay;
 	
-	typedef Blip_Synth<blip_good_quality,1> Synth;
+	typedef Blip_Synth<(NES_APU_FAST_SYNTH ? blip_fast_quality : blip_good_quality),1> Synth;
 	Synth const& synth; // shared between squares
 	
 	Nes_Square( Synth const* s ) : synth( *s ) { }
@@ -77,7 +82,7 @@ struct Nes_Triangle : Nes_Osc
 	enum { phase_range = 16 };
 	int phase;
 	int linear_counter;
-	Blip_Synth<blip_med_quality,1> synth;
+	Blip_Synth<(NES_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> synth;
 	
 	int calc_amp() const;
 	void run( nes_time_t, nes_time_t );
@@ -95,7 +100,7 @@ struct Nes_Triangle : Nes_Osc
 struct Nes_Noise : Nes_Envelope
 {
 	int noise;
-	Blip_Synth<blip_med_quality,1> synth;
+	Blip_Synth<(NES_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> synth;
 	
 	void run( nes_time_t, nes_time_t );
 	void reset() {
@@ -131,7 +136,7 @@ struct Nes_Dmc : Nes_Osc
 	
 	Nes_Apu* apu;
 	
-	Blip_Synth<blip_med_quality,1> synth;
+	Blip_Synth<(NES_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> synth;
 	
 	void start();
 	void write_register( int, int );
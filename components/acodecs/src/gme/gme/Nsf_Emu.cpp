@@ -2,6 +2,7 @@
 
 #include "Nsf_Emu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <string.h>
 #include <stdio.h>
@@ -129,7 +130,7 @@ struct Nsf_File : Gme_Info_
 static Music_Emu* new_nsf_emu () { return BLARGG_NEW Nsf_Emu ; }
 static Music_Emu* new_nsf_file() { return BLARGG_NEW Nsf_File; }
 
-static gme_type_t_ const gme_nsf_type_ = { "Nintendo NES", 0, &new_nsf_emu, &new_nsf_file, "NSF", 1 };
+static gme_type_t_ const gme_nsf_type_ = { "Nintendo NES", 0, &new_nsf_emu, &new_nsf_file, "NSF", 1, 0 };
 BLARGG_EXPORT extern gme_type_t const gme_nsf_type = &gme_nsf_type_;
 
 
@@ -559,3 +560,44 @@ blargg_err_t Nsf_Emu::run_clocks( blip_time_t& duration, int )
 	
 	return 0;
 }
+
+bool Nsf_Emu::copy_state_( Emu_State& s )
+{
+	copy_buffer_state( s );
+	cpu::copy_state( s );
+	s.copy( sram );
+	s.copy( saved_state );
+	s.copy( next_play );
+	s.copy( play_extra );
+	s.copy( play_ready );
+	apu.copy_state( s );
+	
+	#if !NSF_EMU_APU_ONLY
+	{
+		if ( namco )
+			namco->copy_state( s );
+		
+		if ( vrc6 )
+		{
+			vrc6_apu_state_t st;
+			if ( !s.loading() )
+				vrc6->save_state( &st );
+			s.copy( st );
+			if ( s.loading() )
+				vrc6->load_state( st );
+		}
+		
+		if ( fme7 )
+		{
+			fme7_apu_state_t st;
+			if ( !s.loading() )
+				fme7->save_state( &st );
+			s.copy( st );
+			if ( s.loading() )
+				fme7->load_state( st );
+		}
+	}
+	#endif
+	
+	return true;
+}
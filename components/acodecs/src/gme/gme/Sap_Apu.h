@@ -7,6 +7,11 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef SAP_APU_FAST_SYNTH
+	#define SAP_APU_FAST_SYNTH 0
+#endif
+
 class Sap_Apu_Impl;
 
 class Sap_Apu {
@@ -55,7 +60,7 @@ private:
 // Common tables and Blip_Synth that can be shared among multiple Sap_Apu objects
 class Sap_Apu_Impl {
 public:
-	Blip_Synth<blip_good_quality,1> synth;
+	Blip_Synth<(SAP_APU_FAST_SYNTH ? blip_fast_quality : blip_good_quality),1> synth;
 	
 	Sap_Apu_Impl();
 	void volume( double d ) { synth.volume( 1.0 / Sap_Apu::osc_count / 30 * d ); }
@@ -235,7 +235,7 @@ struct Sap_File : Gme_Info_
 static Music_Emu* new_sap_emu () { return BLARGG_NEW Sap_Emu ; }
 static Music_Emu* new_sap_file() { return BLARGG_NEW Sap_File; }
 
-static gme_type_t_ const gme_sap_type_ = { "Atari XL", 0, &new_sap_emu, &new_sap_file, "SAP", 1 };
+static gme_type_t_ const gme_sap_type_ = { "Atari XL", 0, &new_sap_emu, &new_sap_file, "SAP", 1, 0 };
 BLARGG_EXPORT extern gme_type_t const gme_sap_type = &gme_sap_type_;
 
 // Setup
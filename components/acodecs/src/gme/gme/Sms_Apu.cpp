@@ -2,6 +2,8 @@
 
 #include "Sms_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -46,10 +48,10 @@ inline void Sms_Square::reset()
 
 void Sms_Square::run( blip_time_t time, blip_time_t end_time )
 {
-	if ( !volume || period <= 128 )
+	if ( !volume || period <= 128 || !output )
 	{
-		// ignore 16kHz and higher
-		if ( last_amp )
+		// ignore 16kHz and higher, and only maintain phase when muted
+		if ( last_amp && output )
 		{
 			synth->offset( time, -last_amp, output );
 			last_amp = 0;
@@ -112,6 +114,19 @@ inline void Sms_Noise::reset()
 
 void Sms_Noise::run( blip_time_t time, blip_time_t end_time )
 {
+	if ( !output )
+	{
+		// muted: only maintain timing
+		int period = *this->period * 2;
+		if ( !period )
+			period = 16;
+		time += delay;
+		if ( time < end_time )
+			time += (end_time - time + period - 1) / period * period;
+		delay = time - end_time;
+		return;
+	}
+	
 	int amp = volume;
 	if ( shifter & 1 )
 		amp = -amp;
@@ -231,6 +246,34 @@ void Sms_Apu::reset( unsigned feedback, int noise_width )
 	noise.reset();
 }
 
+void Sms_Apu::copy_state( Emu_State& s )
+{
+	s.copy( last_time );
+	s.copy( latch );
+	s.copy( noise_feedback );
+	s.copy( looped_feedback );
+	
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Sms_Osc& osc = *oscs [i];
+		s.copy( osc.output_select );
+		s.copy( osc.delay );
+		s.copy( osc.last_amp );
+		s.copy( osc.volume );
+		if ( s.loading() )
+			osc.output = osc.outputs [osc.output_select];
+	}
+	
+	for ( int i = 0; i < 3; i++ )
+	{
+		s.copy( squares [i].period );
+		s.copy( squares [i].phase );
+	}
+	s.copy( noise.period ); // points to a table or to squares [2].period
+	s.copy( noise.shifter );
+	s.copy( noise.feedback );
+}
+
 void Sms_Apu::run_until( blip_time_t end_time )
 {
 	require( end_time >= last_time ); // end_time must not be before previous time
@@ -242,13 +285,11 @@ void Sms_Apu::run_until( blip_time_t end_time )
 		{
 			Sms_Osc& osc = *oscs [i];
 			if ( osc.output )
-			{
 				osc.output->set_modified();
-				if ( i < 3 )
-					squares [i].run( last_time, end_time );
-				else
-					noise.run( last_time, end_time );
-			}
+			if ( i < 3 )
+				squares [i].run( last_time, end_time );
+			else
+				noise.run( last_time, end_time );
 		}
 		
 		last_time = end_time;
@@ -6,6 +6,8 @@
 
 #include "Sms_Oscs.h"
 
+class Emu_State;
+
 class Sms_Apu {
 public:
 	// Set overall volume of all oscillators, where 1.0 is full volume
@@ -41,6 +43,10 @@ public:
 	// Run all oscillators up to specified time, end current frame, then
 	// start a new frame at time 0.
 	void end_frame( blip_time_t );
+	
+	// Save or restore oscillator state for a seek checkpoint (see Emu_State.h).
+	// Outputs and volume are kept as they are.
+	void copy_state( Emu_State& );
 
 public:
 	Sms_Apu();
@@ -7,6 +7,11 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+// Define as 1 to trade treble accuracy for speed (see blip_fast_quality)
+#ifndef SMS_APU_FAST_SYNTH
+	#define SMS_APU_FAST_SYNTH 0
+#endif
+
 struct Sms_Osc
 {
 	Blip_Buffer* outputs [4]; // NULL, right, left, center
@@ -26,7 +31,7 @@ struct Sms_Square : Sms_Osc
 	int period;
 	int phase;
 	
-	typedef Blip_Synth<blip_good_quality,1> Synth;
+	typedef Blip_Synth<(SMS_APU_FAST_SYNTH ? blip_fast_quality : blip_good_quality),1> Synth;
 	const Synth* synth;
 	
 	void reset();
@@ -39,7 +44,7 @@ struct Sms_Noise : Sms_Osc
 	unsigned shifter;
 	unsigned feedback;
 	
-	typedef Blip_Synth<blip_med_quality,1> Synth;
+	typedef Blip_Synth<(SMS_APU_FAST_SYNTH ? blip_fast_quality : blip_med_quality),1> Synth;
 	Synth synth;
 	
 	void reset();
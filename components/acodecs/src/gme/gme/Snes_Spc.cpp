@@ -4,6 +4,7 @@
 
 #include "Snes_Spc.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2004-2007 Shay Green. This module is free software; you
@@ -262,6 +263,14 @@ void Snes_Spc::clear_echo()
 }
 
 
+void Snes_Spc::copy_state( Emu_State& s )
+{
+	// output buffer pointers are set again by play()
+	s.copy( m );
+	dsp.copy_state( s );
+}
+
+
 //// Sample output
 
 void Snes_Spc::reset_buf()
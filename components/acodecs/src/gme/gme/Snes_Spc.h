@@ -84,6 +84,10 @@ public:
 	// Skips count samples. Several times faster than play() when using fast DSP.
 	blargg_err_t skip( int count );
 	
+	// Saves or restores all SPC and DSP state for a seek checkpoint (about
+	// 67K). Unlike copy_state() below, works with the fast DSP too.
+	void copy_state( Emu_State& );
+	
 // State save/load (only available with accurate DSP)
 
 #if !SPC_NO_COPY_STATE_FUNCS
@@ -195,6 +195,7 @@ loop:
 	// TODO: if PC is at end of memory, this will get wrong operand (very obscure)
 	pc++;
 	data = ram [pc];
+	BLARGG_DISPATCH( opcode );
 	switch ( opcode )
 	{
 	
@@ -211,20 +212,20 @@ loop:
 	goto loop;\
 }
 
-	case 0xF0: // BEQ
+	BLARGG_OP( 0xF0 ): // BEQ
 		BRANCH( !(uint8_t) nz ) // 89% taken
 	
-	case 0xD0: // BNE
+	BLARGG_OP( 0xD0 ): // BNE
 		BRANCH( (uint8_t) nz )
 	
-	case 0x3F:{// CALL
+	BLARGG_OP( 0x3F ):{// CALL
 		int old_addr = GET_PC() + 2;
 		SET_PC( READ_PC16( pc ) );
 		PUSH16( old_addr );
 		goto loop;
 	}
 	
-	case 0x6F:// RET
+	BLARGG_OP( 0x6F ):// RET
 		{
 			uint8_t l, h;
 			POP( l );
@@ -233,19 +234,19 @@ loop:
 		}
 		goto loop;
 	
-	case 0xE4: // MOV a,dp
+	BLARGG_OP( 0xE4 ): // MOV a,dp
 		++pc;
 		// 80% from timer
 		READ_DP_TIMER( 0, data, a = nz );
 		goto loop;
 	
-	case 0xFA:{// MOV dp,dp
+	BLARGG_OP( 0xFA ):{// MOV dp,dp
 		int temp;
 		READ_DP_TIMER( -2, data, temp );
 		data = temp + no_read_before_write ;
 	}
-	// fall through
-	case 0x8F:{// MOV dp,#imm
+	BLARGG_FALLTHROUGH;
+	BLARGG_OP( 0x8F ):{// MOV dp,#imm
 		int temp = READ_PC( pc + 1 );
 		pc += 2;
 		
@@ -269,7 +270,7 @@ loop:
 		goto loop;
 	}
 	
-	case 0xC4: // MOV dp,a
+	BLARGG_OP( 0xC4 ): // MOV dp,a
 		++pc;
 		#if !SPC_MORE_ACCURACY
 		{
@@ -292,86 +293,88 @@ loop:
 		#endif
 		goto loop;
 	
-#define CASE( n )   case n:
+// Case for opcode 0xRC
+#define CASE( r, c )    BLARGG_OP( 0x##r##c ):
 
-// Define common address modes based on opcode for immediate mode. Execution
-// ends with data set to the address of the operand.
-#define ADDR_MODES_( op )\
-	CASE( op - 0x02 ) /* (X) */\
+// Define common address modes based on opcode 0xH8 for immediate mode, where
+// L is the next row H + 1. Execution ends with data set to the address of the
+// operand.
+#define ADDR_MODES_( h, l )\
+	CASE( h, 6 ) /* (X) */\
 		data = x + dp;\
 		pc--;\
-		goto end_##op;\
-	CASE( op + 0x0F ) /* (dp)+Y */\
+		goto end_##h;\
+	CASE( l, 7 ) /* (dp)+Y */\
 		data = READ_PROG16( data + dp ) + y;\
-		goto end_##op;\
-	CASE( op - 0x01 ) /* (dp+X) */\
+		goto end_##h;\
+	CASE( h, 7 ) /* (dp+X) */\
 		data = READ_PROG16( ((uint8_t) (data + x)) + dp );\
-		goto end_##op;\
-	CASE( op + 0x0E ) /* abs+Y */\
+		goto end_##h;\
+	CASE( l, 6 ) /* abs+Y */\
 		data += y;\
-		goto abs_##op;\
-	CASE( op + 0x0D ) /* abs+X */\
+		goto abs_##h;\
+	CASE( l, 5 ) /* abs+X */\
 		data += x;\
-	CASE( op - 0x03 ) /* abs */\
-	abs_##op:\
+	CASE( h, 5 ) /* abs */\
+	abs_##h:\
 		data += 0x100 * READ_PC( ++pc );\
-		goto end_##op;\
-	CASE( op + 0x0C ) /* dp+X */\
+		goto end_##h;\
+	CASE( l, 4 ) /* dp+X */\
 		data = (uint8_t) (data + x);
 
-#define ADDR_MODES_NO_DP( op )\
-	ADDR_MODES_( op )\
+#define ADDR_MODES_NO_DP( h, l )\
+	ADDR_MODES_( h, l )\
 		data += dp;\
-	end_##op:
+	end_##h:
 
-#define ADDR_MODES( op )\
-	ADDR_MODES_( op )\
-	CASE( op - 0x04 ) /* dp */\
+#define ADDR_MODES( h, l )\
+	ADDR_MODES_( h, l )\
+	CASE( h, 4 ) /* dp */\
 		data += dp;\
-	end_##op:
+	end_##h:
 
 // 1. 8-bit Data Transmission Commands. Group I
 
-	ADDR_MODES_NO_DP( 0xE8 ) // MOV A,addr
+	ADDR_MODES_NO_DP( E, F ) // MOV A,addr
 		a = nz = READ( 0, data );
 		goto inc_pc_loop;
 	
-	case 0xBF:{// MOV A,(X)+
+	BLARGG_OP( 0xBF ):{// MOV A,(X)+
 		int temp = x + dp;
 		x = (uint8_t) (x + 1);
 		a = nz = READ( -1, temp );
 		goto loop;
 	}
 	
-	case 0xE8: // MOV A,imm
+	BLARGG_OP( 0xE8 ): // MOV A,imm
 		a  = data;
 		nz = data;
 		goto inc_pc_loop;
 	
-	case 0xF9: // MOV X,dp+Y
+	BLARGG_OP( 0xF9 ): // MOV X,dp+Y
 		data = (uint8_t) (data + y);
-	case 0xF8: // MOV X,dp
+	BLARGG_OP( 0xF8 ): // MOV X,dp
 		READ_DP_TIMER( 0, data, x = nz );
 		goto inc_pc_loop;
 	
-	case 0xE9: // MOV X,abs
+	BLARGG_OP( 0xE9 ): // MOV X,abs
 		data = READ_PC16( pc );
 		++pc;
 		data = READ( 0, data );
-	case 0xCD: // MOV X,imm
+	BLARGG_OP( 0xCD ): // MOV X,imm
 		x  = data;
 		nz = data;
 		goto inc_pc_loop;
 	
-	case 0xFB: // MOV Y,dp+X
+	BLARGG_OP( 0xFB ): // MOV Y,dp+X
 		data = (uint8_t) (data + x);
-	case 0xEB: // MOV Y,dp
+	BLARGG_OP( 0xEB ): // MOV Y,dp
 		// 70% from timer
 		pc++;
 		READ_DP_TIMER( 0, data, y = nz );
 		goto loop;
 	
-	case 0xEC:{// MOV Y,abs
+	BLARGG_OP( 0xEC ):{// MOV Y,abs
 		int temp = READ_PC16( pc );
 		pc += 2;
 		READ_TIMER( 0, temp, y = nz );
@@ -379,23 +382,23 @@ loop:
 		goto loop;
 	}
 	
-	case 0x8D: // MOV Y,imm
+	BLARGG_OP( 0x8D ): // MOV Y,imm
 		y  = data;
 		nz = data;
 		goto inc_pc_loop;
 	
 // 2. 8-BIT DATA TRANSMISSION COMMANDS, GROUP 2
 
-	ADDR_MODES_NO_DP( 0xC8 ) // MOV addr,A
+	ADDR_MODES_NO_DP( C, D ) // MOV addr,A
 		WRITE( 0, data, a );
 		goto inc_pc_loop;
 	
 	{
 		int temp;
-	case 0xCC: // MOV abs,Y
+	BLARGG_OP( 0xCC ): // MOV abs,Y
 		temp = y;
 		goto mov_abs_temp;
-	case 0xC9: // MOV abs,X
+	BLARGG_OP( 0xC9 ): // MOV abs,X
 		temp = x;
 	mov_abs_temp:
 		WRITE( 0, READ_PC16( pc ), temp );
@@ -403,135 +406,135 @@ loop:
 		goto loop;
 	}
 	
-	case 0xD9: // MOV dp+Y,X
+	BLARGG_OP( 0xD9 ): // MOV dp+Y,X
 		data = (uint8_t) (data + y);
-	case 0xD8: // MOV dp,X
+	BLARGG_OP( 0xD8 ): // MOV dp,X
 		WRITE( 0, data + dp, x );
 		goto inc_pc_loop;
 	
-	case 0xDB: // MOV dp+X,Y
+	BLARGG_OP( 0xDB ): // MOV dp+X,Y
 		data = (uint8_t) (data + x);
-	case 0xCB: // MOV dp,Y
+	BLARGG_OP( 0xCB ): // MOV dp,Y
 		WRITE( 0, data + dp, y );
 		goto inc_pc_loop;
 
 // 3. 8-BIT DATA TRANSMISSIN COMMANDS, GROUP 3.
 	
-	case 0x7D: // MOV A,X
+	BLARGG_OP( 0x7D ): // MOV A,X
 		a  = x;
 		nz = x;
 		goto loop;
 	
-	case 0xDD: // MOV A,Y
+	BLARGG_OP( 0xDD ): // MOV A,Y
 		a  = y;
 		nz = y;
 		goto loop;
 	
-	case 0x5D: // MOV X,A
+	BLARGG_OP( 0x5D ): // MOV X,A
 		x  = a;
 		nz = a;
 		goto loop;
 	
-	case 0xFD: // MOV Y,A
+	BLARGG_OP( 0xFD ): // MOV Y,A
 		y  = a;
 		nz = a;
 		goto loop;
 	
-	case 0x9D: // MOV X,SP
+	BLARGG_OP( 0x9D ): // MOV X,SP
 		x = nz = GET_SP();
 		goto loop;
 	
-	case 0xBD: // MOV SP,X
+	BLARGG_OP( 0xBD ): // MOV SP,X
 		SET_SP( x );
 		goto loop;
 	
-	//case 0xC6: // MOV (X),A (handled by MOV addr,A in group 2)
+	//BLARGG_OP( 0xC6 ): // MOV (X),A (handled by MOV addr,A in group 2)
 	
-	case 0xAF: // MOV (X)+,A
+	BLARGG_OP( 0xAF ): // MOV (X)+,A
 		WRITE_DP( 0, x, a + no_read_before_write  );
 		x = (uint8_t) (x + 1);
 		goto loop;
 	
 // 5. 8-BIT LOGIC OPERATION COMMANDS
 	
-#define LOGICAL_OP( op, func )\
-	ADDR_MODES( op ) /* addr */\
+#define LOGICAL_OP( h, l, func )\
+	ADDR_MODES( h, l ) /* addr */\
 		data = READ( 0, data );\
-	case op: /* imm */\
+	CASE( h, 8 ) /* imm */\
 		nz = a func##= data;\
 		goto inc_pc_loop;\
 	{   unsigned addr;\
-	case op + 0x11: /* X,Y */\
+	CASE( l, 9 ) /* X,Y */\
 		data = READ_DP( -2, y );\
 		addr = x + dp;\
-		goto addr_##op;\
-	case op + 0x01: /* dp,dp */\
+		goto addr_##h;\
+	CASE( h, 9 ) /* dp,dp */\
 		data = READ_DP( -3, data );\
-	case op + 0x10:{/*dp,imm*/\
+	CASE( l, 8 ){/*dp,imm*/\
 		uint16_t addr2 = pc + 1;\
 		pc += 2;\
 		addr = READ_PC( addr2 ) + dp;\
 	}\
-	addr_##op:\
+	addr_##h:\
 		nz = data func READ( -1, addr );\
 		WRITE( 0, addr, nz );\
 		goto loop;\
 	}
 	
-	LOGICAL_OP( 0x28, & ); // AND
+	LOGICAL_OP( 2, 3, & ); // AND
 	
-	LOGICAL_OP( 0x08, | ); // OR
+	LOGICAL_OP( 0, 1, | ); // OR
 	
-	LOGICAL_OP( 0x48, ^ ); // EOR
+	LOGICAL_OP( 4, 5, ^ ); // EOR
 	
 // 4. 8-BIT ARITHMETIC OPERATION COMMANDS
 
-	ADDR_MODES( 0x68 ) // CMP addr
+	ADDR_MODES( 6, 7 ) // CMP addr
 		data = READ( 0, data );
-	case 0x68: // CMP imm
+	BLARGG_OP( 0x68 ): // CMP imm
 		nz = a - data;
 		c = ~nz;
 		nz &= 0xFF;
 		goto inc_pc_loop;
 	
-	case 0x79: // CMP (X),(Y)
+	BLARGG_OP( 0x79 ): // CMP (X),(Y)
 		data = READ_DP( -2, y );
 		nz = READ_DP( -1, x ) - data;
 		c = ~nz;
 		nz &= 0xFF;
 		goto loop;
 	
-	case 0x69: // CMP dp,dp
+	BLARGG_OP( 0x69 ): // CMP dp,dp
 		data = READ_DP( -3, data );
-	case 0x78: // CMP dp,imm
+	BLARGG_OP( 0x78 ): // CMP dp,imm
 		nz = READ_DP( -1, READ_PC( ++pc ) ) - data;
 		c = ~nz;
 		nz &= 0xFF;
 		goto inc_pc_loop;
 	
-	case 0x3E: // CMP X,dp
+	BLARGG_OP( 0x3E ): // CMP X,dp
 		data += dp;
 		goto cmp_x_addr;
-	case 0x1E: // CMP X,abs
+	BLARGG_OP( 0x1E ): // CMP X,abs
 		data = READ_PC16( pc );
 		pc++;
 	cmp_x_addr:
 		data = READ( 0, data );
-	case 0xC8: // CMP X,imm
+	BLARGG_OP( 0xC8 ): // CMP X,imm
 		nz = x - data;
 		c = ~nz;
 		nz &= 0xFF;
 		goto inc_pc_loop;
 	
-	case 0x7E: // CMP Y,dp
+	BLARGG_OP( 0x7E ): // CMP Y,dp
 		data += dp;
 		goto cmp_y_addr;
-	case 0x5E: // CMP Y,abs
+	BLARGG_OP( 0x5E ): // CMP Y,abs
 		data = READ_PC16( pc );
 		pc++;
 	cmp_y_addr:
 		data = READ( 0, data );
-	case 0xAD: // CMP Y,imm
+	BLARGG_OP( 0xAD ): // CMP Y,imm
 		nz = y - data;
 		c = ~nz;
 		nz &= 0xFF;
@@ -539,17 +542,17 @@ loop:
 	
 	{
 		int addr;
-	case 0xB9: // SBC (x),(y)
-	case 0x99: // ADC (x),(y)
+	BLARGG_OP( 0xB9 ): // SBC (x),(y)
+	BLARGG_OP( 0x99 ): // ADC (x),(y)
 		pc--; // compensate for inc later
 		data = READ_DP( -2, y );
 		addr = x + dp;
 		goto adc_addr;
-	case 0xA9: // SBC dp,dp
-	case 0x89: // ADC dp,dp
+	BLARGG_OP( 0xA9 ): // SBC dp,dp
+	BLARGG_OP( 0x89 ): // ADC dp,dp
 		data = READ_DP( -3, data );
-	case 0xB8: // SBC dp,imm
-	case 0x98: // ADC dp,imm
+	BLARGG_OP( 0xB8 ): // SBC dp,imm
+	BLARGG_OP( 0x98 ): // ADC dp,imm
 		addr = READ_PC( ++pc ) + dp;
 	adc_addr:
 		nz = READ( -1, addr );
@@ -557,11 +560,13 @@ loop:
 		
 // catch ADC and SBC together, then decode later based on operand
 #undef CASE
-#define CASE( n ) case n: case (n) + 0x20:
-	ADDR_MODES( 0x88 ) // ADC/SBC addr
+#define CASE( r, c )    BLARGG_OP( 0x##r##c ): SBC_CASE_##r( c )
+#define SBC_CASE_8( c ) BLARGG_OP( 0xA##c ):
+#define SBC_CASE_9( c ) BLARGG_OP( 0xB##c ):
+	ADDR_MODES( 8, 9 ) // ADC/SBC addr
 		data = READ( 0, data );
-	case 0xA8: // SBC imm
-	case 0x88: // ADC imm
+	BLARGG_OP( 0xA8 ): // SBC imm
+	BLARGG_OP( 0x88 ): // ADC imm
 		addr = -1; // A
 		nz = a;
 	adc_data: {
@@ -595,23 +600,23 @@ loop:
 		reg = (uint8_t) nz;\
 		goto loop;
 
-	case 0xBC: INC_DEC_REG( a, + 1 ) // INC A
-	case 0x3D: INC_DEC_REG( x, + 1 ) // INC X
-	case 0xFC: INC_DEC_REG( y, + 1 ) // INC Y
+	BLARGG_OP( 0xBC ): INC_DEC_REG( a, + 1 ) // INC A
+	BLARGG_OP( 0x3D ): INC_DEC_REG( x, + 1 ) // INC X
+	BLARGG_OP( 0xFC ): INC_DEC_REG( y, + 1 ) // INC Y
 	
-	case 0x9C: INC_DEC_REG( a, - 1 ) // DEC A
-	case 0x1D: INC_DEC_REG( x, - 1 ) // DEC X
-	case 0xDC: INC_DEC_REG( y, - 1 ) // DEC Y
+	BLARGG_OP( 0x9C ): INC_DEC_REG( a, - 1 ) // DEC A
+	BLARGG_OP( 0x1D ): INC_DEC_REG( x, - 1 ) // DEC X
+	BLARGG_OP( 0xDC ): INC_DEC_REG( y, - 1 ) // DEC Y
 
-	case 0x9B: // DEC dp+X
-	case 0xBB: // INC dp+X
+	BLARGG_OP( 0x9B ): // DEC dp+X
+	BLARGG_OP( 0xBB ): // INC dp+X
 		data = (uint8_t) (data + x);
-	case 0x8B: // DEC dp
-	case 0xAB: // INC dp
+	BLARGG_OP( 0x8B ): // DEC dp
+	BLARGG_OP( 0xAB ): // INC dp
 		data += dp;
 		goto inc_abs;
-	case 0x8C: // DEC abs
-	case 0xAC: // INC abs
+	BLARGG_OP( 0x8C ): // DEC abs
+	BLARGG_OP( 0xAC ): // INC abs
 		data = READ_PC16( pc );
 		pc++;
 	inc_abs:
@@ -622,18 +627,18 @@ loop:
 	
 // 7. SHIFT, ROTATION COMMANDS
 
-	case 0x5C: // LSR A
+	BLARGG_OP( 0x5C ): // LSR A
 		c = 0;
-	case 0x7C:{// ROR A
+	BLARGG_OP( 0x7C ):{// ROR A
 		nz = (c >> 1 & 0x80) | (a >> 1);
 		c = a << 8;
 		a = nz;
 		goto loop;
 	}
 	
-	case 0x1C: // ASL A
+	BLARGG_OP( 0x1C ): // ASL A
 		c = 0;
-	case 0x3C:{// ROL A
+	BLARGG_OP( 0x3C ):{// ROL A
 		int temp = c >> 8 & 1;
 		c = a << 1;
 		nz = c | temp;
@@ -641,20 +646,20 @@ loop:
 		goto loop;
 	}
 	
-	case 0x0B: // ASL dp
+	BLARGG_OP( 0x0B ): // ASL dp
 		c = 0;
 		data += dp;
 		goto rol_mem;
-	case 0x1B: // ASL dp+X
+	BLARGG_OP( 0x1B ): // ASL dp+X
 		c = 0;
-	case 0x3B: // ROL dp+X
+	BLARGG_OP( 0x3B ): // ROL dp+X
 		data = (uint8_t) (data + x);
-	case 0x2B: // ROL dp
+	BLARGG_OP( 0x2B ): // ROL dp
 		data += dp;
 		goto rol_mem;
-	case 0x0C: // ASL abs
+	BLARGG_OP( 0x0C ): // ASL abs
 		c = 0;
-	case 0x2C: // ROL abs
+	BLARGG_OP( 0x2C ): // ROL abs
 		data = READ_PC16( pc );
 		pc++;
 	rol_mem:
@@ -663,20 +668,20 @@ loop:
 		WRITE( 0, data, /*(uint8_t)*/ nz );
 		goto inc_pc_loop;
 	
-	case 0x4B: // LSR dp
+	BLARGG_OP( 0x4B ): // LSR dp
 		c = 0;
 		data += dp;
 		goto ror_mem;
-	case 0x5B: // LSR dp+X
+	BLARGG_OP( 0x5B ): // LSR dp+X
 		c = 0;
-	case 0x7B: // ROR dp+X
+	BLARGG_OP( 0x7B ): // ROR dp+X
 		data = (uint8_t) (data + x);
-	case 0x6B: // ROR dp
+	BLARGG_OP( 0x6B ): // ROR dp
 		data += dp;
 		goto ror_mem;
-	case 0x4C: // LSR abs
+	BLARGG_OP( 0x4C ): // LSR abs
 		c = 0;
-	case 0x6C: // ROR abs
+	BLARGG_OP( 0x6C ): // ROR abs
 		data = READ_PC16( pc );
 		pc++;
 	ror_mem: {
@@ -687,28 +692,28 @@ loop:
 		goto inc_pc_loop;
 	}
 
-	case 0x9F: // XCN
+	BLARGG_OP( 0x9F ): // XCN
 		nz = a = (a >> 4) | (uint8_t) (a << 4);
 		goto loop;
 
 // 8. 16-BIT TRANSMISION COMMANDS
 
-	case 0xBA: // MOVW YA,dp
+	BLARGG_OP( 0xBA ): // MOVW YA,dp
 		a = READ_DP( -2, data );
 		nz = (a & 0x7F) | (a >> 1);
 		y = READ_DP( 0, (uint8_t) (data + 1) );
 		nz |= y;
 		goto inc_pc_loop;
 	
-	case 0xDA: // MOVW dp,YA
+	BLARGG_OP( 0xDA ): // MOVW dp,YA
 		WRITE_DP( -1, data, a );
 		WRITE_DP( 0, (uint8_t) (data + 1), y + no_read_before_write  );
 		goto inc_pc_loop;
 	
 // 9. 16-BIT OPERATION COMMANDS
 
-	case 0x3A: // INCW dp
-	case 0x1A:{// DECW dp
+	BLARGG_OP( 0x3A ): // INCW dp
+	BLARGG_OP( 0x1A ):{// DECW dp
 		int temp;
 		// low byte
 		data += dp;
@@ -726,8 +731,8 @@ loop:
 		goto inc_pc_loop;
 	}
 		
-	case 0x7A: // ADDW YA,dp
-	case 0x9A:{// SUBW YA,dp
+	BLARGG_OP( 0x7A ): // ADDW YA,dp
+	BLARGG_OP( 0x9A ):{// SUBW YA,dp
 		int lo = READ_DP( -2, data );
 		int hi = READ_DP( 0, (uint8_t) (data + 1) );
 		int result;
@@ -755,7 +760,7 @@ loop:
 		goto inc_pc_loop;
 	}
 	
-	case 0x5A: { // CMPW YA,dp
+	BLARGG_OP( 0x5A ): { // CMPW YA,dp
 		int temp = a - READ_DP( -1, data );
 		nz = ((temp >> 1) | temp) & 0x7F;
 		temp = y + (temp >> 8);
@@ -768,7 +773,7 @@ loop:
 	
 // 10. MULTIPLICATION & DIVISON COMMANDS
 
-	case 0xCF: { // MUL YA
+	BLARGG_OP( 0xCF ): { // MUL YA
 		unsigned temp = y * a;
 		a = (uint8_t) temp;
 		nz = ((temp >> 1) | temp) & 0x7F;
@@ -777,7 +782,7 @@ loop:
 		goto loop;
 	}
 	
-	case 0x9E: // DIV YA,X
+	BLARGG_OP( 0x9E ): // DIV YA,X
 	{
 		unsigned ya = y * 0x100 + a;
 		
@@ -809,7 +814,7 @@ loop:
 	
 // 11. DECIMAL COMPENSATION COMMANDS
 	
-	case 0xDF: // DAA
+	BLARGG_OP( 0xDF ): // DAA
 		SUSPICIOUS_OPCODE( "DAA" );
 		if ( a > 0x99 || c & 0x100 )
 		{
@@ -824,7 +829,7 @@ loop:
 		a = (uint8_t) a;
 		goto loop;
 	
-	case 0xBE: // DAS
+	BLARGG_OP( 0xBE ): // DAS
 		SUSPICIOUS_OPCODE( "DAS" );
 		if ( a > 0x99 || !(c & 0x100) )
 		{
@@ -841,26 +846,26 @@ loop:
 	
 // 12. BRANCHING COMMANDS
 
-	case 0x2F: // BRA rel
+	BLARGG_OP( 0x2F ): // BRA rel
 		pc += (int8_t) data;
 		goto inc_pc_loop;
 	
-	case 0x30: // BMI
+	BLARGG_OP( 0x30 ): // BMI
 		BRANCH( (nz & nz_neg_mask) )
 	
-	case 0x10: // BPL
+	BLARGG_OP( 0x10 ): // BPL
 		BRANCH( !(nz & nz_neg_mask) )
 	
-	case 0xB0: // BCS
+	BLARGG_OP( 0xB0 ): // BCS
 		BRANCH( c & 0x100 )
 	
-	case 0x90: // BCC
+	BLARGG_OP( 0x90 ): // BCC
 		BRANCH( !(c & 0x100) )
 	
-	case 0x70: // BVS
+	BLARGG_OP( 0x70 ): // BVS
 		BRANCH( psw & v40 )
 	
-	case 0x50: // BVC
+	BLARGG_OP( 0x50 ): // BVC
 		BRANCH( !(psw & v40) )
 	
 	#define CBRANCH( cond )\
@@ -872,56 +877,56 @@ loop:
 		goto inc_pc_loop;\
 	}
 	
-	case 0x03: // BBS dp.bit,rel
-	case 0x23:
-	case 0x43:
-	case 0x63:
-	case 0x83:
-	case 0xA3:
-	case 0xC3:
-	case 0xE3:
+	BLARGG_OP( 0x03 ): // BBS dp.bit,rel
+	BLARGG_OP( 0x23 ):
+	BLARGG_OP( 0x43 ):
+	BLARGG_OP( 0x63 ):
+	BLARGG_OP( 0x83 ):
+	BLARGG_OP( 0xA3 ):
+	BLARGG_OP( 0xC3 ):
+	BLARGG_OP( 0xE3 ):
 		CBRANCH( READ_DP( -4, data ) >> (opcode >> 5) & 1 )
 	
-	case 0x13: // BBC dp.bit,rel
-	case 0x33:
-	case 0x53:
-	case 0x73:
-	case 0x93:
-	case 0xB3:
-	case 0xD3:
-	case 0xF3:
+	BLARGG_OP( 0x13 ): // BBC dp.bit,rel
+	BLARGG_OP( 0x33 ):
+	BLARGG_OP( 0x53 ):
+	BLARGG_OP( 0x73 ):
+	BLARGG_OP( 0x93 ):
+	BLARGG_OP( 0xB3 ):
+	BLARGG_OP( 0xD3 ):
+	BLARGG_OP( 0xF3 ):
 		CBRANCH( !(READ_DP( -4, data ) >> (opcode >> 5) & 1) )
 	
-	case 0xDE: // CBNE dp+X,rel
+	BLARGG_OP( 0xDE ): // CBNE dp+X,rel
 		data = (uint8_t) (data + x);
-		// fall through
-	case 0x2E:{// CBNE dp,rel
+		BLARGG_FALLTHROUGH;
+	BLARGG_OP( 0x2E ):{// CBNE dp,rel
 		int temp;
 		// 61% from timer
 		READ_DP_TIMER( -4, data, temp );
 		CBRANCH( temp != a )
 	}
 	
-	case 0x6E: { // DBNZ dp,rel
+	BLARGG_OP( 0x6E ): { // DBNZ dp,rel
 		unsigned temp = READ_DP( -4, data ) - 1;
 		WRITE_DP( -3, (uint8_t) data, /*(uint8_t)*/ temp + no_read_before_write  );
 		CBRANCH( temp )
 	}
 	
-	case 0xFE: // DBNZ Y,rel
+	BLARGG_OP( 0xFE ): // DBNZ Y,rel
 		y = (uint8_t) (y - 1);
 		BRANCH( y )
 	
-	case 0x1F: // JMP [abs+X]
+	BLARGG_OP( 0x1F ): // JMP [abs+X]
 		SET_PC( READ_PC16( pc ) + x );
-		// fall through
-	case 0x5F: // JMP abs
+		BLARGG_FALLTHROUGH;
+	BLARGG_OP( 0x5F ): // JMP abs
 		SET_PC( READ_PC16( pc ) );
 		goto loop;
 	
 // 13. SUB-ROUTINE CALL RETURN COMMANDS
 	
-	case 0x0F:{// BRK
+	BLARGG_OP( 0x0F ):{// BRK
 		int temp;
 		int ret_addr = GET_PC();
 		SUSPICIOUS_OPCODE( "BRK" );
@@ -933,29 +938,29 @@ loop:
 		goto loop;
 	}
 	
-	case 0x4F:{// PCALL offset
+	BLARGG_OP( 0x4F ):{// PCALL offset
 		int ret_addr = GET_PC() + 1;
 		SET_PC( 0xFF00 | data );
 		PUSH16( ret_addr );
 		goto loop;
 	}
 	
-	case 0x01: // TCALL n
-	case 0x11:
-	case 0x21:
-	case 0x31:
-	case 0x41:
-	case 0x51:
-	case 0x61:
-	case 0x71:
-	case 0x81:
-	case 0x91:
-	case 0xA1:
-	case 0xB1:
-	case 0xC1:
-	case 0xD1:
-	case 0xE1:
-	case 0xF1: {
+	BLARGG_OP( 0x01 ): // TCALL n
+	BLARGG_OP( 0x11 ):
+	BLARGG_OP( 0x21 ):
+	BLARGG_OP( 0x31 ):
+	BLARGG_OP( 0x41 ):
+	BLARGG_OP( 0x51 ):
+	BLARGG_OP( 0x61 ):
+	BLARGG_OP( 0x71 ):
+	BLARGG_OP( 0x81 ):
+	BLARGG_OP( 0x91 ):
+	BLARGG_OP( 0xA1 ):
+	BLARGG_OP( 0xB1 ):
+	BLARGG_OP( 0xC1 ):
+	BLARGG_OP( 0xD1 ):
+	BLARGG_OP( 0xE1 ):
+	BLARGG_OP( 0xF1 ): {
 		int ret_addr = GET_PC();
 		SET_PC( READ_PROG16( 0xFFDE - (opcode >> 3) ) );
 		PUSH16( ret_addr );
@@ -967,68 +972,68 @@ loop:
 	{
 		int temp;
 		uint8_t l, h;
-	case 0x7F: // RET1
+	BLARGG_OP( 0x7F ): // RET1
 		POP (temp);
 		POP (l);
 		POP (h);
 		SET_PC( l | (h << 8) );
 		goto set_psw;
-	case 0x8E: // POP PSW
+	BLARGG_OP( 0x8E ): // POP PSW
 		POP( temp );
 	set_psw:
 		SET_PSW( temp );
 		goto loop;
 	}
 	
-	case 0x0D: { // PUSH PSW
+	BLARGG_OP( 0x0D ): { // PUSH PSW
 		int temp;
 		GET_PSW( temp );
 		PUSH( temp );
 		goto loop;
 	}
 
-	case 0x2D: // PUSH A
+	BLARGG_OP( 0x2D ): // PUSH A
 		PUSH( a );
 		goto loop;
 	
-	case 0x4D: // PUSH X
+	BLARGG_OP( 0x4D ): // PUSH X
 		PUSH( x );
 		goto loop;
 	
-	case 0x6D: // PUSH Y
+	BLARGG_OP( 0x6D ): // PUSH Y
 		PUSH( y );
 		goto loop;
 	
-	case 0xAE: // POP A
+	BLARGG_OP( 0xAE ): // POP A
 		POP( a );
 		goto loop;
 	
-	case 0xCE: // POP X
+	BLARGG_OP( 0xCE ): // POP X
 		POP( x );
 		goto loop;
 	
-	case 0xEE: // POP Y
+	BLARGG_OP( 0xEE ): // POP Y
 		POP( y );
 		goto loop;
 	
 // 15. BIT OPERATION COMMANDS
 
-	case 0x02: // SET1
-	case 0x22:
-	case 0x42:
-	case 0x62:
-	case 0x82:
-	case 0xA2:
-	case 0xC2:
-	case 0xE2:
-	case 0x12: // CLR1
-	case 0x32:
-	case 0x52:
-	case 0x72:
-	case 0x92:
-	case 0xB2:
-	case 0xD2:
-	case 0xF2: {
+	BLARGG_OP( 0x02 ): // SET1
+	BLARGG_OP( 0x22 ):
+	BLARGG_OP( 0x42 ):
+	BLARGG_OP( 0x62 ):
+	BLARGG_OP( 0x82 ):
+	BLARGG_OP( 0xA2 ):
+	BLARGG_OP( 0xC2 ):
+	BLARGG_OP( 0xE2 ):
+	BLARGG_OP( 0x12 ): // CLR1
+	BLARGG_OP( 0x32 ):
+	BLARGG_OP( 0x52 ):
+	BLARGG_OP( 0x72 ):
+	BLARGG_OP( 0x92 ):
+	BLARGG_OP( 0xB2 ):
+	BLARGG_OP( 0xD2 ):
+	BLARGG_OP( 0xF2 ): {
 		int bit = 1 << (opcode >> 5);
 		int mask = ~bit;
 		if ( opcode & 0x10 )
@@ -1038,8 +1043,8 @@ loop:
 		goto inc_pc_loop;
 	}
 		
-	case 0x0E: // TSET1 abs
-	case 0x4E: // TCLR1 abs
+	BLARGG_OP( 0x0E ): // TSET1 abs
+	BLARGG_OP( 0x4E ): // TCLR1 abs
 		data = READ_PC16( pc );
 		pc += 2;
 		{
@@ -1052,32 +1057,32 @@ loop:
 		}
 		goto loop;
 	
-	case 0x4A: // AND1 C,mem.bit
+	BLARGG_OP( 0x4A ): // AND1 C,mem.bit
 		c &= MEM_BIT( 0 );
 		pc += 2;
 		goto loop;
 	
-	case 0x6A: // AND1 C,/mem.bit
+	BLARGG_OP( 0x6A ): // AND1 C,/mem.bit
 		c &= ~MEM_BIT( 0 );
 		pc += 2;
 		goto loop;
 	
-	case 0x0A: // OR1 C,mem.bit
+	BLARGG_OP( 0x0A ): // OR1 C,mem.bit
 		c |= MEM_BIT( -1 );
 		pc += 2;
 		goto loop;
 	
-	case 0x2A: // OR1 C,/mem.bit
+	BLARGG_OP( 0x2A ): // OR1 C,/mem.bit
 		c |= ~MEM_BIT( -1 );
 		pc += 2;
 		goto loop;
 	
-	case 0x8A: // EOR1 C,mem.bit
+	BLARGG_OP( 0x8A ): // EOR1 C,mem.bit
 		c ^= MEM_BIT( -1 );
 		pc += 2;
 		goto loop;
 	
-	case 0xEA: // NOT1 mem.bit
+	BLARGG_OP( 0xEA ): // NOT1 mem.bit
 		data = READ_PC16( pc );
 		pc += 2;
 		{
@@ -1087,7 +1092,7 @@ loop:
 		}
 		goto loop;
 	
-	case 0xCA: // MOV1 mem.bit,C
+	BLARGG_OP( 0xCA ): // MOV1 mem.bit,C
 		data = READ_PC16( pc );
 		pc += 2;
 		{
@@ -1098,53 +1103,53 @@ loop:
 		}
 		goto loop;
 	
-	case 0xAA: // MOV1 C,mem.bit
+	BLARGG_OP( 0xAA ): // MOV1 C,mem.bit
 		c = MEM_BIT( 0 );
 		pc += 2;
 		goto loop;
 	
 // 16. PROGRAM PSW FLAG OPERATION COMMANDS
 
-	case 0x60: // CLRC
+	BLARGG_OP( 0x60 ): // CLRC
 		c = 0;
 		goto loop;
 		
-	case 0x80: // SETC
+	BLARGG_OP( 0x80 ): // SETC
 		c = ~0;
 		goto loop;
 	
-	case 0xED: // NOTC
+	BLARGG_OP( 0xED ): // NOTC
 		c ^= 0x100;
 		goto loop;
 		
-	case 0xE0: // CLRV
+	BLARGG_OP( 0xE0 ): // CLRV
 		psw &= ~(v40 | h08);
 		goto loop;
 	
-	case 0x20: // CLRP
+	BLARGG_OP( 0x20 ): // CLRP
 		dp = 0;
 		goto loop;
 	
-	case 0x40: // SETP
+	BLARGG_OP( 0x40 ): // SETP
 		dp = 0x100;
 		goto loop;
 	
-	case 0xA0: // EI
+	BLARGG_OP( 0xA0 ): // EI
 		SUSPICIOUS_OPCODE( "EI" );
 		psw |= i04;
 		goto loop;
 	
-	case 0xC0: // DI
+	BLARGG_OP( 0xC0 ): // DI
 		SUSPICIOUS_OPCODE( "DI" );
 		psw &= ~i04;
 		goto loop;
 	
 // 17. OTHER COMMANDS
 
-	case 0x00: // NOP
+	BLARGG_OP( 0x00 ): // NOP
 		goto loop;
 	
-	case 0xFF:{// STOP
+	BLARGG_OP( 0xFF ):{// STOP
 		// handle PC wrap-around
 		if ( pc == 0x0000 )
 		{
@@ -1152,8 +1157,8 @@ loop:
 			goto loop;
 		}
 	}
-	// fall through
-	case 0xEF: // SLEEP
+	BLARGG_FALLTHROUGH;
+	BLARGG_OP( 0xEF ): // SLEEP
 		SUSPICIOUS_OPCODE( "STOP/SLEEP" );
 		--pc;
 		rel_time = 0;
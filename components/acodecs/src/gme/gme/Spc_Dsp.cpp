@@ -3,6 +3,7 @@
 #include "Spc_Dsp.h"
 
 #include "blargg_endian.h"
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2007 Shay Green. This module is free software; you
@@ -313,17 +314,21 @@ void Spc_Dsp::run( int clock_count )
 						output = (output * env) >> 11 & ~1;
 					}
 					
-					// Output
-					int l = output * v->volume [0];
-					int r = output * v->volume [1];
-					
-					main_out_l += l;
-					main_out_r += r;
-					
-					if ( REG(eon) & vbit )
+					// Output. A muted voice still sets OUTX, which the SPC700
+					// can read, and still modulates the next voice's pitch.
+					if ( v->enabled )
 					{
-						echo_out_l += l;
-						echo_out_r += r;
+						int l = output * v->volume [0];
+						int r = output * v->volume [1];
+						
+						main_out_l += l;
+						main_out_r += r;
+						
+						if ( REG(eon) & vbit )
+						{
+							echo_out_l += l;
+							echo_out_r += r;
+						}
 					}
 				}
 				
@@ -710,3 +715,17 @@ void Spc_Dsp::load( uint8_t const regs [register_count] )
 }
 
 void Spc_Dsp::reset() { load( initial_regs ); }
+
+void Spc_Dsp::copy_state( Emu_State& s )
+{
+	// all pointers are into m or the shared RAM, and output is set again
+	// before the next run
+	int const mute_mask = m.mute_mask;
+	int const surround_threshold = m.surround_threshold;
+	s.copy( m );
+	if ( s.loading() )
+	{
+		m.surround_threshold = surround_threshold;
+		mute_voices( mute_mask );
+	}
+}
@@ -6,6 +6,8 @@
 
 #include "blargg_common.h"
 
+class Emu_State;
+
 struct Spc_Dsp {
 public:
 // Setup
@@ -55,6 +57,10 @@ public:
 	// Resets DSP and uses supplied values to initialize registers
 	enum { register_count = 128 };
 	void load( uint8_t const regs [register_count] );
+	
+	// Saves or restores all DSP state for a seek checkpoint. Muting and
+	// surround settings are kept as they are.
+	void copy_state( Emu_State& );
 
 // DSP register addresses
 
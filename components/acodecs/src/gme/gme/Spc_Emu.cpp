@@ -243,7 +243,8 @@ struct Spc_File : Gme_Info_
 static Music_Emu* new_spc_emu () { return BLARGG_NEW Spc_Emu ; }
 static Music_Emu* new_spc_file() { return BLARGG_NEW Spc_File; }
 
-static gme_type_t_ const gme_spc_type_ = { "Super Nintendo", 1, &new_spc_emu, &new_spc_file, "SPC", 0 };
+static gme_type_t_ const gme_spc_type_ = { "Super Nintendo", 1, &new_spc_emu, &new_spc_file, "SPC", 0,
+		Spc_Emu::native_sample_rate };
 BLARGG_EXPORT extern gme_type_t const gme_spc_type = &gme_spc_type_;
 
 
@@ -286,6 +287,15 @@ blargg_err_t Spc_Emu::load_mem_( byte const* in, long size )
 
 // Emulation
 
+bool Spc_Emu::copy_state_( Emu_State& s )
+{
+	apu.copy_state( s );
+	filter.copy_state( s );
+	if ( sample_rate() != native_sample_rate )
+		resampler.copy_state( s );
+	return true;
+}
+
 void Spc_Emu::set_tempo_( double t )
 {
 	apu.set_tempo( (int) (t * apu.tempo_unit) );
@@ -317,23 +327,25 @@ blargg_err_t Spc_Emu::play_and_filter( long count, sample_t out [] )
 
 blargg_err_t Spc_Emu::skip_( long count )
 {
+	// the last samples are played to eliminate pop due to resampler
+	const int resampler_latency = 64;
+	sample_t buf [resampler_latency];
+	if ( count <= resampler_latency )
+		return play_( count, buf );
+	count -= resampler_latency;
+	
 	if ( sample_rate() != native_sample_rate )
 	{
 		count = long (count * resampler.ratio()) & ~1;
 		count -= resampler.skip_input( count );
 	}
 	
-	// TODO: shouldn't skip be adjusted for the 64 samples read afterwards?
-	
 	if ( count > 0 )
 	{
 		RETURN_ERR( apu.skip( count ) );
 		filter.clear();
 	}
 	
-	// eliminate pop due to resampler
-	const int resampler_latency = 64;
-	sample_t buf [resampler_latency];
 	return play_( resampler_latency, buf );
 }
 
@@ -6,6 +6,8 @@
 
 #include "blargg_common.h"
 
+class Emu_State;
+
 struct SPC_Filter {
 public:
 	
@@ -32,6 +34,9 @@ public:
 	enum { bass_max  = 31 };
 	void set_bass( int bass );
 	
+	// Saves or restores filter history for a seek checkpoint
+	void copy_state( Emu_State& );
+	
 public:
 	SPC_Filter();
 	BLARGG_DISABLE_NOTHROW
@@ -2,6 +2,7 @@
 
 #include "Vgm_Emu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <string.h>
 #include <math.h>
@@ -27,6 +28,8 @@ Vgm_Emu::Vgm_Emu()
 {
 	disable_oversampling_ = false;
 	psg_rate   = 0;
+	mem_reader = 0;
+	file       = 0;
 	set_type( gme_vgm_type );
 	
 	static int const types [8] = {
@@ -39,7 +42,10 @@ Vgm_Emu::Vgm_Emu()
 	set_equalizer( make_equalizer( -14.0, 80 ) );
 }
 
-Vgm_Emu::~Vgm_Emu() { }
+Vgm_Emu::~Vgm_Emu()
+{
+	delete mem_reader;
+}
 
 // Track info
 
@@ -101,21 +107,9 @@ static long check_gd3_header( byte const* h, long remain )
 byte const* Vgm_Emu::gd3_data( int* size ) const
 {
 	if ( size )
-		*size = 0;
+		*size = gd3.size();
 	
-	long gd3_offset = get_le32( header().gd3_offset ) - 0x2C;
-	if ( gd3_offset < 0 )
-		return 0;
-	
-	byte const* gd3 = data + header_size + gd3_offset;
-	long gd3_size = check_gd3_header( gd3, data_end - gd3 );
-	if ( !gd3_size )
-		return 0;
-	
-	if ( size )
-		*size = gd3_size + gd3_header_size;
-	
-	return gd3;
+	return gd3.size() ? gd3.begin() : 0;
 }
 
 static void get_vgm_length( Vgm_Emu::header_t const& h, track_info_t* out )
@@ -164,6 +158,23 @@ struct Vgm_File : Gme_Info_
 	
 	Vgm_File() { set_type( gme_vgm_type ); }
 	
+	blargg_err_t load_file_( const char* path )
+	{
+		GME_FILE_READER in;
+		RETURN_ERR( in.open( path ) );
+		
+		byte sig [2];
+		if ( in.read( sig, sizeof sig ) )
+			return gme_wrong_file_type;
+		RETURN_ERR( in.seek( 0 ) );
+		if ( !Gzip_Reader::is_gzip( sig, sizeof sig ) )
+			return load_( in );
+		
+		Gzip_Reader gz;
+		RETURN_ERR( gz.open( &in ) );
+		return load_( gz );
+	}
+	
 	blargg_err_t load_( Data_Reader& in )
 	{
 		long file_size = in.remain();
@@ -202,10 +213,10 @@ struct Vgm_File : Gme_Info_
 static Music_Emu* new_vgm_emu () { return BLARGG_NEW Vgm_Emu ; }
 static Music_Emu* new_vgm_file() { return BLARGG_NEW Vgm_File; }
 
-static gme_type_t_ const gme_vgm_type_ = { "Sega SMS/Genesis", 1, &new_vgm_emu, &new_vgm_file, "VGM", 1 };
+static gme_type_t_ const gme_vgm_type_ = { "Sega SMS/Genesis", 1, &new_vgm_emu, &new_vgm_file, "VGM", 1, 0 };
 BLARGG_EXPORT extern gme_type_t const gme_vgm_type = &gme_vgm_type_;
 
-static gme_type_t_ const gme_vgz_type_ = { "Sega SMS/Genesis", 1, &new_vgm_emu, &new_vgm_file, "VGZ", 1 };
+static gme_type_t_ const gme_vgz_type_ = { "Sega SMS/Genesis", 1, &new_vgm_emu, &new_vgm_file, "VGZ", 1, 0 };
 BLARGG_EXPORT extern gme_type_t const gme_vgz_type = &gme_vgz_type_;
 
 
@@ -252,6 +263,12 @@ blargg_err_t Vgm_Emu::set_multi_channel ( bool is_enabled )
 	}
 }
 
+blargg_err_t Vgm_Emu::set_mono( bool )
+{
+	// the FM resampler mixes into stereo, and whether FM is used isn't known yet
+	return "mono rendering not supported for YM2*** FM sound chip emulators";
+}
+
 void Vgm_Emu::update_eq( blip_eq_t const& eq )
 {
 	psg[0].treble_eq( eq );
@@ -318,14 +335,96 @@ void Vgm_Emu::mute_voices_( int mask )
 	}
 }
 
+blargg_err_t Vgm_Emu::set_ym2612_core_( int core )
+{
+	if ( !ym2612[0].enabled() )
+		return Music_Emu::set_ym2612_core_( core );
+	int const old = ym2612[0].core();
+	RETURN_ERR( ym2612[0].set_core( core ) );
+	if ( ym2612[1].enabled() )
+	{
+		blargg_err_t err = ym2612[1].set_core( core );
+		if ( err )
+		{
+			// keep both chips on the same core
+			ym2612[0].set_core( old );
+			return err;
+		}
+	}
+	return 0;
+}
+
+int Vgm_Emu::ym2612_core_() const
+{
+	return ym2612[0].enabled() ? ym2612[0].core() : -1;
+}
+
+void Vgm_Emu::unload()
+{
+	gzip_reader.close();
+	file_reader.close();
+	delete mem_reader;
+	mem_reader = 0;
+	file = 0;
+	gd3.clear();
+	pcm_block.clear();
+	Classic_Emu::unload();
+}
+
+blargg_err_t Vgm_Emu::load_file_( const char* path )
+{
+	RETURN_ERR( file_reader.open( path ) );
+	return load_stream( &file_reader );
+}
+
 blargg_err_t Vgm_Emu::load_mem_( byte const* new_data, long new_size )
+{
+	CHECK_ALLOC( mem_reader = BLARGG_NEW Mem_File_Reader( new_data, new_size ) );
+	return load_stream( mem_reader );
+}
+
+blargg_err_t Vgm_Emu::load_gd3()
+{
+	long gd3_offset = get_le32( header_.gd3_offset ) - 0x2C;
+	long offset = header_size + gd3_offset;
+	if ( gd3_offset < 0 || data_end - offset < gd3_header_size )
+		return 0;
+	
+	byte h [gd3_header_size];
+	RETURN_ERR( file->seek( offset ) );
+	RETURN_ERR( file->read( h, sizeof h ) );
+	long gd3_size = check_gd3_header( h, data_end - offset );
+	if ( gd3_size )
+	{
+		RETURN_ERR( gd3.resize( gd3_header_size + gd3_size ) );
+		memcpy( gd3.begin(), h, sizeof h );
+		RETURN_ERR( file->read( gd3.begin() + gd3_header_size, gd3_size ) );
+	}
+	return 0;
+}
+
+blargg_err_t Vgm_Emu::load_stream( File_Reader* in )
 {
 	assert( offsetof (header_t,unused2 [8]) == header_size );
 	
-	if ( new_size <= header_size )
+	file = in;
+	buffer_pcm = false;
+	if ( file->size() <= header_size )
 		return gme_wrong_file_type;
+	RETURN_ERR( file->read( &header_, header_size ) );
+	
+	if ( Gzip_Reader::is_gzip( &header_, header_size ) )
+	{
+		RETURN_ERR( in->seek( 0 ) );
+		RETURN_ERR( gzip_reader.open( in ) );
+		file = &gzip_reader;
+		buffer_pcm = true; // PCM reads jump around, which would mean decompressing again
+		if ( file->size() <= header_size )
+			return gme_wrong_file_type;
+		RETURN_ERR( file->read( &header_, header_size ) );
+	}
 	
-	header_t const& h = *(header_t const*) new_data;
+	header_t const& h = header_;
 	
 	RETURN_ERR( check_vgm_header( h ) );
 	
@@ -340,13 +439,22 @@ blargg_err_t Vgm_Emu::load_mem_( byte const* new_data, long new_size )
 	psg_rate &= 0x0FFFFFFF;
 	blip_buf.clock_rate( psg_rate );
 	
-	data     = new_data;
-	data_end = new_data + new_size;
+	data_end = file->size();
 	
 	// get loop
 	loop_begin = data_end;
 	if ( get_le32( h.loop_offset ) )
-		loop_begin = &data [get_le32( h.loop_offset ) + offsetof (header_t,loop_offset)];
+		loop_begin = get_le32( h.loop_offset ) + offsetof (header_t,loop_offset);
+	if ( buffer_pcm && loop_begin < data_end )
+		gzip_reader.keep_state_at( loop_begin ); // so looping doesn't decompress from beginning
+	
+	RETURN_ERR( load_gd3() );
+	
+	window_pos   = 0;
+	window_end   = window;
+	pcm_buf      = 0;
+	pcm_buf_pos  = 0;
+	pcm_buf_size = 0;
 	
 	set_voice_count( psg[0].osc_count );
 	
@@ -445,18 +553,20 @@ blargg_err_t Vgm_Emu::start_track_( int track )
 		psg[1].reset( get_le16( header().noise_feedback ), header().noise_width );
 	
 	dac_disabled = -1;
-	pos          = data + header_size;
-	pcm_data     = pos;
-	pcm_pos      = pos;
+	pcm_data     = header_size;
+	pcm_size     = 0;
+	pcm_pos      = pcm_data;
 	dac_amp      = -1;
 	vgm_time     = 0;
+	long data_begin = header_size;
 	if ( get_le32( header().version ) >= 0x150 )
 	{
 		long data_offset = get_le32( header().data_offset );
 		check( data_offset );
 		if ( data_offset )
-			pos += data_offset + offsetof (header_t,data_offset) - 0x40;
+			data_begin = data_offset + offsetof (header_t,data_offset);
 	}
+	pos = seek_window( data_begin );
 	
 	if ( uses_fm )
 	{
@@ -496,3 +606,48 @@ blargg_err_t Vgm_Emu::play_( long count, sample_t* out )
 	Dual_Resampler::dual_play( count, out, blip_buf );
 	return 0;
 }
+
+bool Vgm_Emu::copy_state_( Emu_State& s )
+{
+	if ( uses_fm )
+	{
+		Dual_Resampler::copy_state( s );
+		blip_buf.copy_state( s );
+	}
+	else
+	{
+		copy_buffer_state( s );
+	}
+	
+	long cmd_pos = window_offset( pos );
+	s.copy( vgm_time );
+	s.copy( cmd_pos );
+	s.copy( pcm_data );
+	s.copy( pcm_size );
+	s.copy( pcm_pos );
+	s.copy( dac_amp );
+	s.copy( dac_disabled );
+	s.copy( fm_time_offset );
+	
+	psg[0].copy_state( s );
+	if ( psg_dual )
+		psg[1].copy_state( s );
+	
+	// YM2413 support is stubbed out, so it has no state
+	for ( int i = 0; i < 2; i++ )
+	{
+		if ( ym2612[i].enabled() )
+			ym2612[i].copy_state( s );
+	}
+	
+	if ( s.loading() )
+	{
+		if ( buffer_pcm && pcm_size && pcm_buf_pos != pcm_data )
+		{
+			if ( load_pcm_block( pcm_data, pcm_size ) )
+				set_warning( "Couldn't load PCM data" );
+		}
+		pos = seek_window( cmd_pos );
+	}
+	return true;
+}
@@ -5,6 +5,7 @@
 #define VGM_EMU_H
 
 #include "Vgm_Emu_Impl.h"
+#include "Gzip_Reader.h"
 
 // Emulates VGM music using SN76489/SN76496 PSG, YM2612, and YM2413 FM sound chips.
 // Supports custom sound buffer and frequency equalization when VGM uses just the PSG.
@@ -18,6 +19,7 @@ public:
 	bool is_classic_emu() const { return !uses_fm; }
 	
 	blargg_err_t set_multi_channel ( bool is_enabled ) override;
+	blargg_err_t set_mono( bool is_enabled ) override;
 	
 	// Disable running FM chips at higher than normal rate. Will result in slightly
 	// more aliasing of high notes.
@@ -47,7 +49,7 @@ public:
 	};
 	
 	// Header for currently loaded file
-	header_t const& header() const { return *(header_t const*) data; }
+	header_t const& header() const { return header_; }
 	
 	static gme_type_t static_type() { return gme_vgm_type; }
 	
@@ -63,13 +65,18 @@ public:
 	~Vgm_Emu();
 protected:
 	blargg_err_t track_info_( track_info_t*, int track ) const;
+	blargg_err_t load_file_( const char* );
 	blargg_err_t load_mem_( byte const*, long );
+	void unload();
 	blargg_err_t set_sample_rate_( long sample_rate );
 	blargg_err_t start_track_( int );
 	blargg_err_t play_( long count, sample_t* );
 	blargg_err_t run_clocks( blip_time_t&, int );
+	bool copy_state_( Emu_State& );
 	void set_tempo_( double );
 	void mute_voices_( int mask );
+	blargg_err_t set_ym2612_core_( int );
+	int ym2612_core_() const;
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 private:
@@ -81,6 +88,14 @@ private:
 	bool disable_oversampling_;
 	bool uses_fm;
 	blargg_err_t setup_fm();
+	
+	header_t header_;
+	blargg_vector<byte> gd3;
+	GME_FILE_READER file_reader;
+	Mem_File_Reader* mem_reader;
+	Gzip_Reader gzip_reader;
+	blargg_err_t load_stream( File_Reader* );
+	blargg_err_t load_gd3();
 };
 
 #endif
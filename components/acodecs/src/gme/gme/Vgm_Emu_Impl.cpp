@@ -118,25 +118,141 @@ void Vgm_Emu_Impl::write_pcm( vgm_time_t vgm_time, int amp )
 		dac_amp |= dac_disabled;
 }
 
+// File window
+
+// Moves unread part of window to beginning and reads more of file after it.
+// Returns new location of pos.
+byte const* Vgm_Emu_Impl::fill_window( byte const* pos )
+{
+	if ( pos > window_end )
+		return pos; // last command was cut off by end of file
+	
+	long next = window_offset( window_end );
+	long keep = window_end - pos;
+	memmove( window, pos, keep );
+	window_pos = window_offset( pos );
+	window_end = window + keep;
+	
+	long count = min( (long) window_size - keep, data_end - next );
+	if ( count > 0 && (file->tell() == next || !file->seek( next )) )
+	{
+		count = file->read_avail( window + keep, count );
+		if ( count > 0 )
+			window_end += count;
+	}
+	
+	// commands cut off by end of file read zeros
+	memset( window + (window_end - window), 0, max_command_size );
+	return window;
+}
+
+byte const* Vgm_Emu_Impl::seek_window( long offset )
+{
+	if ( offset >= window_pos && offset <= window_offset( window_end ) )
+		return window + (offset - window_pos);
+	
+	window_pos = offset;
+	window_end = window;
+	return fill_window( window );
+}
+
+// PCM data
+
+inline int Vgm_Emu_Impl::read_pcm()
+{
+	unsigned long i = pcm_pos++ - pcm_buf_pos;
+	if ( i < (unsigned long) pcm_buf_size )
+		return pcm_buf [i];
+	return fill_pcm( pcm_pos - 1 );
+}
+
+int Vgm_Emu_Impl::fill_pcm( long offset )
+{
+	if ( !buffer_pcm && !file->seek( offset ) )
+	{
+		long count = file->read_avail( pcm_window, pcm_window_size );
+		if ( count > 0 )
+		{
+			pcm_buf      = pcm_window;
+			pcm_buf_pos  = offset;
+			pcm_buf_size = count;
+			return pcm_window [0];
+		}
+	}
+	return 0x80; // outside file or PCM block
+}
+
+blargg_err_t Vgm_Emu_Impl::load_pcm_block( long offset, long size )
+{
+	pcm_buf_size = 0;
+	RETURN_ERR( pcm_block.resize( size ) );
+	
+	// take what the window already has so a compressed file isn't
+	// decompressed again from the beginning
+	long copied = 0;
+	long next = window_offset( window_end );
+	if ( offset >= window_pos && offset < next )
+	{
+		copied = min( size, next - offset );
+		memcpy( pcm_block.begin(), window + (offset - window_pos), copied );
+	}
+	if ( copied < size )
+	{
+		RETURN_ERR( file->seek( offset + copied ) );
+		RETURN_ERR( file->read( pcm_block.begin() + copied, size - copied ) );
+	}
+	
+	pcm_buf      = pcm_block.begin();
+	pcm_buf_pos  = offset;
+	pcm_buf_size = size;
+	return 0;
+}
+
+byte const* Vgm_Emu_Impl::data_block( byte const* pos, int type, long size )
+{
+	long offset = window_offset( pos );
+	if ( type == pcm_block_type )
+	{
+		pcm_data = offset;
+		pcm_size = size;
+		if ( buffer_pcm && pcm_buf_pos != offset )
+		{
+			if ( load_pcm_block( offset, size ) )
+				set_warning( "Couldn't load PCM data" );
+		}
+	}
+	return seek_window( offset + size );
+}
+
+// Commands
+
 blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 {
 	vgm_time_t vgm_time = this->vgm_time; 
 	byte const* pos = this->pos;
-	if ( pos >= data_end )
+	if ( window_end - pos < max_command_size )
+		pos = fill_window( pos );
+	if ( pos >= window_end )
 	{
 		set_track_ended();
-		if ( pos > data_end )
+		if ( pos > window_end )
 			set_warning( "Stream lacked end event" );
 	}
 	
-	while ( vgm_time < end_time && pos < data_end )
+	while ( vgm_time < end_time && pos < window_end )
 	{
-		// TODO: be sure there are enough bytes left in stream for particular command
-		// so we don't read past end
+		// the window always holds a whole command unless the file ends first
+		if ( window_end - pos < max_command_size )
+		{
+			pos = fill_window( pos );
+			if ( pos >= window_end )
+				break;
+		}
+		
 		switch ( *pos++ )
 		{
 		case cmd_end:
-			pos = loop_begin; // if not looped, loop_begin == data_end
+			pos = seek_window( loop_begin ); // if not looped, loop_begin == data_end
 			break;
 		
 		case cmd_delay_735:
@@ -234,10 +350,7 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			check( *pos == cmd_end );
 			int type = pos [1];
 			long size = get_le32( pos + 2 );
-			pos += 6;
-			if ( type == pcm_block_type )
-				pcm_data = pos;
-			pos += size;
+			pos = data_block( pos + 6, type, size );
 			break;
 		}
 		
@@ -252,7 +365,7 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			switch ( cmd & 0xF0 )
 			{
 				case cmd_pcm_delay:
-					write_pcm( vgm_time, *pcm_pos++ );
+					write_pcm( vgm_time, read_pcm() );
 					vgm_time += cmd & 0x0F;
 					break;
 				
@@ -327,11 +440,18 @@ int Vgm_Emu_Impl::play_frame( blip_time_t blip_time, int sample_count, sample_t*
 }
 
 // Update pre-1.10 header FM rates by scanning commands
-void Vgm_Emu_Impl::update_fm_rates( long* ym2413_rate, long* ym2612_rate ) const
+void Vgm_Emu_Impl::update_fm_rates( long* ym2413_rate, long* ym2612_rate )
 {
-	byte const* p = data + 0x40;
-	while ( p < data_end )
+	byte const* p = seek_window( 0x40 );
+	while ( true )
 	{
+		if ( window_end - p < max_command_size )
+		{
+			p = fill_window( p );
+			if ( p >= window_end )
+				return;
+		}
+		
 		switch ( *p )
 		{
 		case cmd_end:
@@ -347,7 +467,7 @@ void Vgm_Emu_Impl::update_fm_rates( long* ym2413_rate, long* ym2612_rate ) const
 			break;
 		
 		case cmd_data_block:
-			p += 7 + get_le32( p + 3 );
+			p = seek_window( window_offset( p ) + 7 + get_le32( p + 3 ) );
 			break;
 		
 		case cmd_ym2413:
@@ -42,18 +42,44 @@ protected:
 	int blip_time_factor;
 	blip_time_t to_blip_time( vgm_time_t ) const;
 	
-	byte const* data;
-	byte const* loop_begin;
-	byte const* data_end;
-	void update_fm_rates( long* ym2413_rate, long* ym2612_rate ) const;
+	// Commands are read from the file through a window rather than loaded
+	// into memory. Positions in the file are byte offsets.
+	File_Reader* file;
+	long loop_begin;
+	long data_end;
+	void update_fm_rates( long* ym2413_rate, long* ym2612_rate );
+	
+	enum { window_size = 4096 };
+	enum { max_command_size = 7 }; // data block header
+	byte window [window_size + max_command_size];
+	byte const* window_end;
+	long window_pos; // file offset of window [0]
+	byte const* fill_window( byte const* pos );
+	byte const* seek_window( long offset );
+	long window_offset( byte const* p ) const { return window_pos + (p - window); }
 	
 	vgm_time_t vgm_time;
 	byte const* pos;
 	blip_time_t run_commands( vgm_time_t );
 	int play_frame( blip_time_t blip_time, int sample_count, sample_t* buf );
 	
-	byte const* pcm_data;
-	byte const* pcm_pos;
+	// PCM data is read through its own window, or kept in memory if reading
+	// the file out of order is slow (compressed)
+	enum { pcm_window_size = 1024 };
+	bool buffer_pcm;
+	long pcm_data;
+	long pcm_size;
+	long pcm_pos;
+	byte const* pcm_buf;
+	long pcm_buf_pos;
+	long pcm_buf_size;
+	blargg_vector<byte> pcm_block;
+	byte pcm_window [pcm_window_size];
+	int read_pcm();
+	int fill_pcm( long offset );
+	byte const* data_block( byte const* pos, int type, long size );
+	blargg_err_t load_pcm_block( long offset, long size );
+	
 	int dac_amp;
 	int dac_disabled; // -1 if disabled
 	void write_pcm( vgm_time_t, int amp );
@@ -0,0 +1,248 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "Ym2612_Emu.h"
+
+#include "Ym2612_Nuked.h"
+#include "Ym2612_MAME.h"
+#include "Ym2612_GENS.h"
+#include "Emu_State.h"
+#include <string.h>
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or (at
+your option) any later version. This module is distributed in the hope that
+it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+Lesser General Public License for more details. You should have received a
+copy of the GNU Lesser General Public License along with this module; if not,
+write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+Boston, MA 02110-1301 USA */
+
+#include "blargg_source.h"
+
+#if defined (VGM_YM2612_GENS)
+	int const Ym2612_Emu::default_core = gens_core;
+#elif defined (VGM_YM2612_MAME)
+	int const Ym2612_Emu::default_core = mame_core;
+#else
+	int const Ym2612_Emu::default_core = nuked_core;
+#endif
+
+enum { key_reg = 0x28 };
+
+Ym2612_Emu::Ym2612_Emu()
+{
+	core_ = default_core;
+	nuked = 0;
+	mame = 0;
+	gens = 0;
+	sample_rate_ = 0;
+	clock_rate_ = 0;
+	mute_mask_ = 0;
+	clear_regs();
+}
+
+Ym2612_Emu::~Ym2612_Emu()
+{
+	delete nuked;
+	delete mame;
+	delete gens;
+}
+
+// Frees all but the current core
+void Ym2612_Emu::close_cores()
+{
+	if ( core_ != nuked_core ) { delete nuked; nuked = 0; }
+	if ( core_ != mame_core  ) { delete mame;  mame  = 0; }
+	if ( core_ != gens_core  ) { delete gens;  gens  = 0; }
+}
+
+blargg_err_t Ym2612_Emu::open_core()
+{
+	switch ( core_ )
+	{
+	case nuked_core:
+		if ( !nuked )
+			CHECK_ALLOC( nuked = BLARGG_NEW Ym2612_Nuked_Emu );
+		RETURN_ERR( nuked->set_rate( sample_rate_, clock_rate_ ) );
+		nuked->mute_voices( mute_mask_ );
+		break;
+
+	case mame_core:
+		if ( !mame )
+			CHECK_ALLOC( mame = BLARGG_NEW Ym2612_MAME_Emu );
+		RETURN_ERR( mame->set_rate( sample_rate_, clock_rate_ ) );
+		mame->mute_voices( mute_mask_ );
+		break;
+
+	case gens_core:
+		if ( !gens )
+			CHECK_ALLOC( gens = BLARGG_NEW Ym2612_GENS_Emu );
+		RETURN_ERR( gens->set_rate( sample_rate_, clock_rate_ ) );
+		gens->mute_voices( mute_mask_ );
+		break;
+	}
+	return 0;
+}
+
+blargg_err_t Ym2612_Emu::set_core( int core )
+{
+	if ( (unsigned) core >= core_count )
+		return "Invalid YM2612 core";
+	if ( core == core_ )
+		return 0;
+
+	int const old_core = core_;
+	core_ = core;
+	if ( sample_rate_ )
+	{
+		blargg_err_t err = open_core();
+		if ( err )
+		{
+			core_ = old_core;
+			return err;
+		}
+		close_cores();
+		reset_core();
+		restore_regs();
+	}
+	return 0;
+}
+
+const char* Ym2612_Emu::set_rate( double sample_rate, double clock_rate )
+{
+	sample_rate_ = sample_rate;
+	clock_rate_ = clock_rate;
+	clear_regs();
+	blargg_err_t err = open_core();
+	if ( err )
+		sample_rate_ = 0;
+	return err;
+}
+
+void Ym2612_Emu::clear_regs()
+{
+	memset( regs, 0xFF, sizeof regs );
+	memset( keys, 0, sizeof keys );
+}
+
+// Replays the register writes seen so far into a freshly opened core
+void Ym2612_Emu::restore_regs()
+{
+	for ( int port = 0; port < 2; port++ )
+	{
+		for ( int addr = 0x21; addr < 0x100; addr++ )
+		{
+			// frequency registers are done below
+			if ( addr != key_reg && (addr & 0xF0) != 0xA0 && regs [port] [addr] >= 0 )
+				write( port, addr, regs [port] [addr] );
+		}
+
+		// high byte of frequency is latched by the write to the low byte
+		for ( int addr = 0xA0; addr < 0xB0; addr++ )
+		{
+			if ( (addr & 4) || regs [port] [addr] < 0 )
+				continue;
+			if ( regs [port] [addr + 4] >= 0 )
+				write( port, addr + 4, regs [port] [addr + 4] );
+			write( port, addr, regs [port] [addr] );
+		}
+	}
+
+	for ( int i = 0; i < channel_count; i++ )
+	{
+		if ( keys [i] )
+			write( 0, key_reg, keys [i] | (i < 3 ? i : i + 1) );
+	}
+}
+
+void Ym2612_Emu::write( int port, int addr, int data )
+{
+	switch ( core_ )
+	{
+	case nuked_core:
+		port ? nuked->write1( addr, data ) : nuked->write0( addr, data );
+		break;
+
+	case mame_core:
+		port ? mame->write1( addr, data ) : mame->write0( addr, data );
+		break;
+
+	case gens_core:
+		port ? gens->write1( addr, data ) : gens->write0( addr, data );
+		break;
+	}
+}
+
+void Ym2612_Emu::reset()
+{
+	clear_regs();
+	reset_core();
+}
+
+void Ym2612_Emu::reset_core()
+{
+	switch ( core_ )
+	{
+	case nuked_core: if ( nuked ) nuked->reset(); break;
+	case mame_core:  if ( mame  ) mame->reset();  break;
+	case gens_core:  if ( gens  ) gens->reset();  break;
+	}
+}
+
+void Ym2612_Emu::mute_voices( int mask )
+{
+	mute_mask_ = mask;
+	switch ( core_ )
+	{
+	case nuked_core: if ( nuked ) nuked->mute_voices( mask ); break;
+	case mame_core:  if ( mame  ) mame->mute_voices( mask );  break;
+	case gens_core:  if ( gens  ) gens->mute_voices( mask );  break;
+	}
+}
+
+void Ym2612_Emu::write0( int addr, int data )
+{
+	if ( addr == key_reg )
+	{
+		int chan = data & 3;
+		if ( chan < 3 )
+			keys [chan + (data & 4 ? 3 : 0)] = data & 0xF0;
+	}
+	else
+	{
+		regs [0] [addr & 0xFF] = data & 0xFF;
+	}
+	write( 0, addr, data );
+}
+
+void Ym2612_Emu::write1( int addr, int data )
+{
+	regs [1] [addr & 0xFF] = data & 0xFF;
+	write( 1, addr, data );
+}
+
+void Ym2612_Emu::run( int pair_count, sample_t* out )
+{
+	switch ( core_ )
+	{
+	case nuked_core: nuked->run( pair_count, out ); break;
+	case mame_core:  mame->run( pair_count, out );  break;
+	case gens_core:  gens->run( pair_count, out );  break;
+	}
+}
+
+void Ym2612_Emu::copy_state( Emu_State& s )
+{
+	s.copy( regs );
+	s.copy( keys );
+	switch ( core_ )
+	{
+	case nuked_core: nuked->copy_state( s ); break;
+	case mame_core:  mame->copy_state( s );  break;
+	case gens_core:  gens->copy_state( s );  break;
+	}
+	if ( s.loading() )
+		mute_voices( mute_mask_ );
+}
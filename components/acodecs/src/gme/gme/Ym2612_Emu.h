@@ -1,19 +1,85 @@
 // YM2612 FM sound chip emulator interface
 
 // Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+#ifndef YM2612_EMU_H
+#define YM2612_EMU_H
 
-#ifdef VGM_YM2612_GENS // LGPL v2.1+ license
-#include "Ym2612_GENS.h"
-typedef Ym2612_GENS_Emu Ym2612_Emu;
-#endif
+#include "blargg_common.h"
 
-#ifdef VGM_YM2612_NUKED // LGPL v2.1+ license
-#include "Ym2612_Nuked.h"
-typedef Ym2612_Nuked_Emu Ym2612_Emu;
-#endif
+class Ym2612_Nuked_Emu;
+class Ym2612_MAME_Emu;
+class Ym2612_GENS_Emu;
+class Emu_State;
 
-#ifdef VGM_YM2612_MAME // GPL v2+ license
-#include "Ym2612_MAME.h"
-typedef Ym2612_MAME_Emu Ym2612_Emu;
-#endif
+// Runs one of the available YM2612 emulators, selectable at run time
+class Ym2612_Emu {
+public:
+	// Emulation cores, from most accurate (and expensive) to cheapest
+	enum core_t {
+		nuked_core, // LGPL v2.1+ license
+		mame_core,  // GPL v2+ license
+		gens_core,  // LGPL v2.1+ license
+		core_count
+	};
+
+	// Core used unless set_core() is called. VGM_YM2612_* picks it at build time.
+	static int const default_core;
+
+	// Select emulation core. If the chip is running, its registers and keyed
+	// notes are handed over to the new core so a track can switch mid-play.
+	blargg_err_t set_core( int );
+
+	// Current emulation core
+	int core() const { return core_; }
+
+	// Set output sample rate and chip clock rates, in Hz. Returns non-zero
+	// if error.
+	const char* set_rate( double sample_rate, double clock_rate );
+
+	// Reset to power-up state
+	void reset();
 
+	// Mute voice n if bit n (1 << n) of mask is set
+	enum { channel_count = 6 };
+	void mute_voices( int mask );
+
+	// Write addr to register 0 then data to register 1
+	void write0( int addr, int data );
+
+	// Write addr to register 2 then data to register 3
+	void write1( int addr, int data );
+
+	// Run and add pair_count samples into current output buffer contents
+	typedef short sample_t;
+	enum { out_chan_count = 2 }; // stereo
+	void run( int pair_count, sample_t* out );
+	
+	// Save or restore state of the current core for a seek checkpoint (see
+	// Emu_State.h). Muting is kept as it is.
+	void copy_state( Emu_State& );
+
+public:
+	Ym2612_Emu();
+	~Ym2612_Emu();
+private:
+	int core_;
+	Ym2612_Nuked_Emu* nuked;
+	Ym2612_MAME_Emu* mame;
+	Ym2612_GENS_Emu* gens;
+	double sample_rate_;
+	double clock_rate_;
+	int mute_mask_;
+
+	// register writes kept for handing over to another core, -1 if not written
+	short regs [2] [0x100];
+	unsigned char keys [channel_count];
+
+	blargg_err_t open_core();
+	void close_cores();
+	void clear_regs();
+	void reset_core();
+	void restore_regs();
+	void write( int port, int addr, int data );
+};
+
+#endif
@@ -4,6 +4,8 @@
 
 #include "Ym2612_GENS.h"
 
+#include "Emu_State.h"
+
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
@@ -885,6 +887,12 @@ void Ym2612_GENS_Emu::reset()
 	impl->reset();
 }
 
+void Ym2612_GENS_Emu::copy_state( Emu_State& s )
+{
+	// tables only depend on sample and clock rates
+	s.copy( impl->YM2612 );
+}
+
 void Ym2612_GENS_Impl::reset()
 {
 	g.LFOcnt = 0;
@@ -4,6 +4,8 @@
 
 #include "Ym2612_MAME.h"
 
+#include "Emu_State.h"
+
 /*
 **
 ** File: fm2612.c -- software implementation of Yamaha YM2612 FM sound generator
@@ -3106,3 +3108,9 @@ void Ym2612_MAME_Emu::run(int pair_count, Ym2612_MAME_Emu::sample_t *out)
 {
 	if ( impl ) Ym2612_MameImpl::ym2612_generate( impl, out, pair_count, 1);
 }
+
+void Ym2612_MAME_Emu::copy_state( Emu_State& s )
+{
+	// internal pointers all point within the chip, so it can be copied whole
+	if ( impl ) s.copy( impl, sizeof (Ym2612_MameImpl::YM2612) );
+}
@@ -1,10 +1,11 @@
 // YM2612 FM sound chip emulator interface
 
 // Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
-#ifndef YM2612_EMU_H
-#define YM2612_EMU_H
+#ifndef YM2612_MAME_H
+#define YM2612_MAME_H
 
 typedef void Ym2612_MAME_Impl;
+class Emu_State;
 
 class Ym2612_MAME_Emu  {
 	Ym2612_MAME_Impl* impl;
@@ -33,6 +34,9 @@ public:
 	typedef short sample_t;
 	enum { out_chan_count = 2 }; // stereo
 	void run( int pair_count, sample_t* out );
+
+	// Save or restore chip state for a seek checkpoint (see Emu_State.h)
+	void copy_state( Emu_State& );
 };
 
 #endif
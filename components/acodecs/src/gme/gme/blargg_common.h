@@ -76,6 +76,49 @@ public:
 	#define BLARGG_NEW new (std::nothrow)
 #endif
 
+// Puts a CPU emulator's main loop in the linker section BLARGG_CPU_SECTION if
+// defined, for example one placed in fast internal RAM
+#ifdef BLARGG_CPU_SECTION
+	#define BLARGG_CPU_RUN __attribute__ ((section (BLARGG_CPU_SECTION)))
+#else
+	#define BLARGG_CPU_RUN
+#endif
+
+// BLARGG_OP( n ): Case label for opcode n, written 0xHH in upper case, in a CPU
+// emulator's main switch. If BLARGG_CPU_THREADED is 1 and the compiler has
+// label addresses (GCC, Clang), it's also label op_0xHH, and
+// BLARGG_DISPATCH( opcode ) just before the switch jumps straight to it
+// through a table rather than through the switch. Every opcode then needs
+// its own BLARGG_OP, even ones handled by the default case.
+#if BLARGG_CPU_THREADED && defined (__GNUC__)
+	#define BLARGG_OP( n ) case n: op_##n
+	#define BLARGG_OP_ROW( h ) \
+		&&op_0x##h##0, &&op_0x##h##1, &&op_0x##h##2, &&op_0x##h##3,\
+		&&op_0x##h##4, &&op_0x##h##5, &&op_0x##h##6, &&op_0x##h##7,\
+		&&op_0x##h##8, &&op_0x##h##9, &&op_0x##h##A, &&op_0x##h##B,\
+		&&op_0x##h##C, &&op_0x##h##D, &&op_0x##h##E, &&op_0x##h##F
+	#define BLARGG_DISPATCH( opcode ) {\
+		static void* const blargg_op_table [256] = {\
+			BLARGG_OP_ROW( 0 ), BLARGG_OP_ROW( 1 ), BLARGG_OP_ROW( 2 ), BLARGG_OP_ROW( 3 ),\
+			BLARGG_OP_ROW( 4 ), BLARGG_OP_ROW( 5 ), BLARGG_OP_ROW( 6 ), BLARGG_OP_ROW( 7 ),\
+			BLARGG_OP_ROW( 8 ), BLARGG_OP_ROW( 9 ), BLARGG_OP_ROW( A ), BLARGG_OP_ROW( B ),\
+			BLARGG_OP_ROW( C ), BLARGG_OP_ROW( D ), BLARGG_OP_ROW( E ), BLARGG_OP_ROW( F )\
+		};\
+		goto *blargg_op_table [opcode];\
+	}
+#else
+	#define BLARGG_OP( n ) case n
+	#define BLARGG_DISPATCH( opcode )
+#endif
+
+// BLARGG_FALLTHROUGH: Ends a case that runs on into the next BLARGG_OP, where
+// the compiler can't see a fall through comment past the macro
+#if __GNUC__ >= 7
+	#define BLARGG_FALLTHROUGH __attribute__ ((fallthrough))
+#else
+	#define BLARGG_FALLTHROUGH
+#endif
+
 // BLARGG_4CHAR('a','b','c','d') = 'abcd' (four character integer constant)
 #define BLARGG_4CHAR( a, b, c, d ) \
 	((a&0xFF)*0x1000000L + (b&0xFF)*0x10000L + (c&0xFF)*0x100L + (d&0xFF))
@@ -165,29 +165,16 @@ BLARGG_EXPORT gme_err_t gme_open_file( const char* path, Music_Emu** out, int sa
 	require( path && out );
 	*out = 0;
 
-	GME_FILE_READER in;
-	RETURN_ERR( in.open( path ) );
-
-	char header [4];
-	int header_size = 0;
-
-	gme_type_t file_type = gme_identify_extension( path );
-	if ( !file_type )
-	{
-		header_size = sizeof header;
-		RETURN_ERR( in.read( header, sizeof header ) );
-		file_type = gme_identify_extension( gme_identify_header( header ) );
-	}
+	gme_type_t file_type = 0;
+	RETURN_ERR( gme_identify_file( path, &file_type ) );
 	if ( !file_type )
 		return gme_wrong_file_type;
 
 	Music_Emu* emu = gme_new_emu( file_type, sample_rate );
 	CHECK_ALLOC( emu );
 
-	// optimization: avoids seeking/re-reading header
-	Remaining_Reader rem( header, header_size, &in );
-	gme_err_t err = emu->load( rem );
-	in.close();
+	// lets emulators that stream from the file keep it open
+	gme_err_t err = emu->load_file( path );
 
 	if ( err )
 		delete emu;
@@ -207,8 +194,8 @@ BLARGG_EXPORT int gme_autoload_playback_limit( Music_Emu *const emu )
 	return emu->autoload_playback_limit();
 }
 
-// Used to implement gme_new_emu and gme_new_emu_multi_channel
-Music_Emu* gme_internal_new_emu_( gme_type_t type, int rate, bool multi_channel )
+// Used to implement gme_new_emu, gme_new_emu_multi_channel and gme_new_emu_mono
+Music_Emu* gme_internal_new_emu_( gme_type_t type, int rate, bool multi_channel, bool mono )
 {
 	if ( type )
 	{
@@ -218,10 +205,12 @@ Music_Emu* gme_internal_new_emu_( gme_type_t type, int rate, bool multi_channel
 		Music_Emu* me = type->new_emu();
 		if ( me )
 		{
+			if ( mono )
+				me->set_mono( true ); // stays stereo if not supported
 		#if !GME_DISABLE_STEREO_DEPTH
 			me->set_multi_channel( multi_channel );
 
-			if ( type->flags_ & 1 )
+			if ( type->flags_ & 1 && !me->mono() )
 			{
 				if ( me->multi_channel() )
 				{
@@ -235,7 +224,7 @@ Music_Emu* gme_internal_new_emu_( gme_type_t type, int rate, bool multi_channel
 					me->set_buffer( me->effects_buffer );
 			}
 
-			if ( !(type->flags_ & 1) || me->effects_buffer )
+			if ( !(type->flags_ & 1) || me->mono() || me->effects_buffer )
 		#endif
 			{
 				if ( !me->set_sample_rate( rate ) )
@@ -252,13 +241,18 @@ Music_Emu* gme_internal_new_emu_( gme_type_t type, int rate, bool multi_channel
 
 BLARGG_EXPORT Music_Emu* gme_new_emu( gme_type_t type, int rate )
 {
-    return gme_internal_new_emu_( type, rate, false /* no multichannel */);
+    return gme_internal_new_emu_( type, rate, false /* no multichannel */, false );
 }
 
 BLARGG_EXPORT Music_Emu* gme_new_emu_multi_channel( gme_type_t type, int rate )
 {
     // multi-channel emulator (if possible, not all emu types support multi-channel)
-    return gme_internal_new_emu_( type, rate, true /* multichannel */);
+    return gme_internal_new_emu_( type, rate, true /* multichannel */, false );
+}
+
+BLARGG_EXPORT Music_Emu* gme_new_emu_mono( gme_type_t type, int rate )
+{
+	return gme_internal_new_emu_( type, rate, false, true /* mono if possible */ );
 }
 
 BLARGG_EXPORT gme_err_t gme_load_file( Music_Emu* me, const char* path ) { return me->load_file( path ); }
@@ -381,15 +375,27 @@ BLARGG_EXPORT int       gme_tell           ( Music_Emu const* me )
 BLARGG_EXPORT int       gme_tell_samples   ( Music_Emu const* me )                { return me->tell_samples(); }
 BLARGG_EXPORT gme_err_t gme_seek           ( Music_Emu* me, int msec )            { return me->seek( msec ); }
 BLARGG_EXPORT gme_err_t gme_seek_samples   ( Music_Emu* me, int n )               { return me->seek_samples( n ); }
+BLARGG_EXPORT void      gme_set_seek_checkpoints( Music_Emu* me, int interval_msec, long budget )
+{
+	me->set_seek_checkpoints( interval_msec, budget );
+}
 BLARGG_EXPORT int       gme_voice_count    ( Music_Emu const* me )                { return me->voice_count(); }
 BLARGG_EXPORT void      gme_ignore_silence ( Music_Emu* me, int disable )         { me->ignore_silence( disable != 0 ); }
+BLARGG_EXPORT void      gme_set_silence_policy( Music_Emu* me, int lookahead, int max_initial_msec, int budget_msec )
+{
+	me->set_silence_policy( lookahead, max_initial_msec, budget_msec );
+}
 BLARGG_EXPORT void      gme_set_tempo      ( Music_Emu* me, double t )            { me->set_tempo( t ); }
 BLARGG_EXPORT void      gme_mute_voice     ( Music_Emu* me, int index, int mute ) { me->mute_voice( index, mute != 0 ); }
 BLARGG_EXPORT void      gme_mute_voices    ( Music_Emu* me, int mask )            { me->mute_voices( mask ); }
 BLARGG_EXPORT void      gme_enable_accuracy( Music_Emu* me, int enabled )         { me->enable_accuracy( enabled ); }
 BLARGG_EXPORT void      gme_clear_playlist ( Music_Emu* me )                      { me->clear_playlist(); }
+BLARGG_EXPORT gme_err_t gme_set_ym2612_core( Music_Emu* me, int core )            { return me->set_ym2612_core( core ); }
+BLARGG_EXPORT int       gme_ym2612_core    ( Music_Emu const* me )                { return me->ym2612_core(); }
 BLARGG_EXPORT int       gme_type_multitrack( gme_type_t t )                       { return t->track_count != 1; }
+BLARGG_EXPORT int       gme_type_native_sample_rate( gme_type_t t )               { return (int) t->native_rate_; }
 BLARGG_EXPORT int       gme_multi_channel  ( Music_Emu const* me )                { return me->multi_channel(); }
+BLARGG_EXPORT int       gme_mono           ( Music_Emu const* me )                { return me->mono(); }
 
 BLARGG_EXPORT void      gme_set_equalizer  ( Music_Emu* me, gme_equalizer_t const* eq )
 {
@@ -28,7 +28,8 @@ int gme_track_count( Music_Emu const* );
 /* Start a track, where 0 is the first track */
 gme_err_t gme_start_track( Music_Emu*, int index );
 
-/* Generate 'count' 16-bit signed samples info 'out'. Output is in stereo. */
+/* Generate 'count' 16-bit signed samples info 'out'. Output is in stereo, or mono
+if gme_mono() is true. */
 gme_err_t gme_play( Music_Emu*, int count, short out [] );
 
 /* Finish using emulator and free memory */
@@ -75,6 +76,12 @@ gme_err_t gme_seek( Music_Emu*, int msec );
 /* Equivalent to restarting track then skipping n samples */
 gme_err_t gme_seek_samples( Music_Emu*, int n );
 
+/* Keep snapshots of emulation state every 'interval_msec' of playback, using at most
+'budget' bytes, so seeks resume from the closest one instead of emulating from the
+start of the track. Supported for NSF, NSFE, SPC, GBS and VGM. An interval of 0
+disables snapshots. */
+void gme_set_seek_checkpoints( Music_Emu*, int interval_msec, long budget );
+
 
 /******** Informational ********/
 
@@ -137,6 +144,13 @@ void gme_set_stereo_depth( Music_Emu*, double depth );
 if ignore is true */
 void gme_ignore_silence( Music_Emu*, int ignore );
 
+/* Limit work done by silence detection. During silence the emulator runs 'lookahead'
+times faster than playback to find the end of the track, and up to 'max_initial_msec'
+of silence is skipped when a track starts. A non-zero 'budget_msec' caps the emulation
+each gme_start_track() and gme_play() call may do beyond the samples it outputs,
+spreading the search over several calls. Negative values keep the current setting. */
+void gme_set_silence_policy( Music_Emu*, int lookahead, int max_initial_msec, int budget_msec );
+
 /* Adjust song tempo, where 1.0 = normal, 0.5 = half speed, 2.0 = double speed.
 Track length as returned by track_info() assumes a tempo of 1.0. */
 void gme_set_tempo( Music_Emu*, double tempo );
@@ -173,6 +187,17 @@ void gme_set_equalizer( Music_Emu*, gme_equalizer_t const* eq );
 /* Enables/disables most accurate sound emulation options */
 void gme_enable_accuracy( Music_Emu*, int enabled );
 
+/* YM2612 FM emulation cores used by VGM and GYM, from most accurate (and
+expensive) to cheapest */
+enum { gme_ym2612_nuked = 0, gme_ym2612_mame = 1, gme_ym2612_gens = 2 };
+
+/* Select YM2612 emulation core. Can be changed while a track is playing, in which
+case the chip state is handed over. Returns error if file doesn't use a YM2612. */
+gme_err_t gme_set_ym2612_core( Music_Emu*, int core );
+
+/* Current YM2612 emulation core, or -1 if file doesn't use a YM2612 */
+int gme_ym2612_core( Music_Emu const* );
+
 
 /******** Game music types ********/
 
@@ -206,11 +231,18 @@ const char* gme_type_system( gme_type_t );
 /* True if this music file type supports multiple tracks */
 int gme_type_multitrack( gme_type_t );
 
+/* Rate the emulator for this music file type generates samples at, or 0 if it
+synthesizes directly at any rate. Opening a file at this rate skips resampling. */
+int gme_type_native_sample_rate( gme_type_t );
+
 /* whether the pcm output retrieved by gme_play() will have all 8 voices rendered to their
  * individual stereo channel or (if false) these voices get mixed into one single stereo channel
  * @since 0.6.2 */
 int gme_multi_channel( Music_Emu const* );
 
+/* True if the pcm output retrieved by gme_play() has one channel instead of stereo pairs */
+int gme_mono( Music_Emu const* );
+
 /******** Advanced file loading ********/
 
 /* Error returned if file type is not supported */
@@ -251,6 +283,11 @@ Music_Emu* gme_new_emu( gme_type_t, int sample_rate );
  */
 Music_Emu* gme_new_emu_multi_channel( gme_type_t, int sample_rate );
 
+/* Create new emulator that generates mono output if its type supports it, which
+ * needs less synthesis and no stereo mixing. Other types are created as with
+ * gme_new_emu(), so check gme_mono() to see which output you get. */
+Music_Emu* gme_new_emu_mono( gme_type_t, int sample_rate );
+
 /* Load music file into emulator */
 gme_err_t gme_load_file( Music_Emu*, const char path [] );
 
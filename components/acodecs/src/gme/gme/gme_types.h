@@ -4,8 +4,10 @@
 /*
  * This is a default gme_types.h for use when *not* using
  * CMake.  If CMake is in use gme_types.h.in will be
- * processed instead.
+ * processed instead. Builds that pass their own USE_GME_*
+ * definitions also define GME_CUSTOM_TYPES.
  */
+#ifndef GME_CUSTOM_TYPES
 #define USE_GME_AY
 #define USE_GME_GBS
 #define USE_GME_GYM
@@ -17,5 +19,6 @@
 #define USE_GME_SPC
 /* VGM and VGZ are a package deal */
 #define USE_GME_VGM
+#endif
 
 #endif /* GME_TYPES_H */
@@ -0,0 +1,392 @@
+/* Extended Module Player
+ * Copyright (C) 1996-2016 Claudio Matsuoka and Hipolito Carraro Jr
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Seek checkpoints
+ *
+ * Jumping to an order resets all channels, so effect memories, tempo
+ * changes and ringing notes from earlier orders are lost and playback
+ * resumes in a state the module never actually reaches. Instead we take
+ * a snapshot of the player, channel and voice state whenever playback
+ * enters a new order, at most once per interval and within a memory
+ * budget. A seek restores the closest snapshot before the target (or
+ * restarts the sequence if there is none) and plays frames without
+ * mixing until the target time is reached.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "common.h"
+#include "player.h"
+#include "mixer.h"
+
+#define	FREE	-1
+
+struct checkpoint {
+	struct checkpoint *next;
+	int sequence;
+	int ord;
+	int pos;
+	int row;
+	int frame;
+	int speed;
+	int bpm;
+	int gvol;
+	int loop_count;
+	double current_time;
+	double frame_time;
+	struct flow_control flow;
+	int virt_used;
+	int dtright;
+	int dtleft;
+	int filter;
+#ifndef LIBXMP_CORE_PLAYER
+	int st26_speed;
+#endif
+	int num_virt;		/* mapped virtual channels stored */
+	int num_voices;		/* active voices stored */
+	/* followed by pattern loop, virtual channel map and track channel
+	 * data, then the mapped virtual channels and active voices */
+};
+
+struct saved_channel {
+	int chn;
+	struct channel_data xc;
+};
+
+struct saved_voice {
+	int voc;
+	struct mixer_voice vi;
+};
+
+#define LOOP_DATA(c)	((struct pattern_loop *)((c) + 1))
+#define VIRT_DATA(c,p)	((struct virt_channel *)(LOOP_DATA(c) + (p)->virt.virt_channels))
+#define XC_DATA(c,p)	((struct channel_data *)(VIRT_DATA(c,p) + (p)->virt.virt_channels))
+#define CHN_DATA(c,p)	((struct saved_channel *)(XC_DATA(c,p) + (p)->virt.num_tracks))
+#define VOICE_DATA(c,p)	((struct saved_voice *)(CHN_DATA(c,p) + (c)->num_virt))
+
+/* A module with new note actions can have a hundred or more virtual
+ * channels and voices, but only the ones holding a ringing note carry
+ * state that matters. Unmapped virtual channels are overwritten when a
+ * note is moved to them, and free voices are reset when allocated.
+ */
+static int count_virt(struct player_data *p)
+{
+	int i, num = 0;
+
+	for (i = p->virt.num_tracks; i < p->virt.virt_channels; i++) {
+		if (p->virt.virt_channel[i].map != FREE)
+			num++;
+	}
+
+	return num;
+}
+
+static int count_voices(struct player_data *p)
+{
+	int i, num = 0;
+
+	for (i = 0; i < p->virt.maxvoc; i++) {
+		if (p->virt.voice_array[i].chn != FREE)
+			num++;
+	}
+
+	return num;
+}
+
+static int checkpoint_size(struct player_data *p, int num_virt, int num_voices)
+{
+	int vc = p->virt.virt_channels;
+
+	return sizeof (struct checkpoint) +
+		vc * sizeof (struct pattern_loop) +
+		vc * sizeof (struct virt_channel) +
+		p->virt.num_tracks * sizeof (struct channel_data) +
+		num_virt * sizeof (struct saved_channel) +
+		num_voices * sizeof (struct saved_voice);
+}
+
+/* Called after each frame is played */
+void libxmp_checkpoint_save(struct context_data *ctx)
+{
+	struct player_data *p = &ctx->p;
+	struct mixer_data *s = &ctx->s;
+	struct checkpoint *c;
+	struct saved_channel *sc;
+	struct saved_voice *sv;
+	int vc = p->virt.virt_channels;
+	int num_virt, num_voices;
+	int i, size;
+
+	if (p->ord == p->ckpt.ord)
+		return;
+	p->ckpt.ord = p->ord;
+
+	/* After the module loops, channels carry state over from its end */
+	if (p->loop_count > 0)
+		return;
+
+	/* Keep checkpoints at least one interval apart */
+	for (c = p->ckpt.list; c != NULL; c = c->next) {
+		if (c->sequence == p->sequence && fabs(c->current_time -
+				p->current_time) < p->ckpt.interval) {
+			return;
+		}
+	}
+
+	num_virt = count_virt(p);
+	num_voices = count_voices(p);
+	size = checkpoint_size(p, num_virt, num_voices);
+	if (p->ckpt.used + size > p->ckpt.budget) {
+		D_(D_WARN "checkpoint at order %d needs %d bytes, %d left",
+				p->ord, size, p->ckpt.budget - p->ckpt.used);
+		return;
+	}
+
+	if ((c = malloc(size)) == NULL)
+		return;
+
+	c->sequence = p->sequence;
+	c->ord = p->ord;
+	c->pos = p->pos;
+	c->row = p->row;
+	c->frame = p->frame;
+	c->speed = p->speed;
+	c->bpm = p->bpm;
+	c->gvol = p->gvol;
+	c->loop_count = p->loop_count;
+	c->current_time = p->current_time;
+	c->frame_time = p->frame_time;
+	c->flow = p->flow;
+	c->virt_used = p->virt.virt_used;
+	c->dtright = s->dtright;
+	c->dtleft = s->dtleft;
+	c->filter = p->filter;
+#ifndef LIBXMP_CORE_PLAYER
+	c->st26_speed = p->st26_speed;
+#endif
+	c->num_virt = num_virt;
+	c->num_voices = num_voices;
+
+	memcpy(LOOP_DATA(c), p->flow.loop, vc * sizeof (struct pattern_loop));
+	memcpy(VIRT_DATA(c, p), p->virt.virt_channel,
+				vc * sizeof (struct virt_channel));
+	memcpy(XC_DATA(c, p), p->xc_data,
+				p->virt.num_tracks * sizeof (struct channel_data));
+
+	sc = CHN_DATA(c, p);
+	for (i = p->virt.num_tracks; i < vc; i++) {
+		if (p->virt.virt_channel[i].map != FREE) {
+			sc->chn = i;
+			sc->xc = p->xc_data[i];
+			sc++;
+		}
+	}
+
+	sv = VOICE_DATA(c, p);
+	for (i = 0; i < p->virt.maxvoc; i++) {
+		if (p->virt.voice_array[i].chn != FREE) {
+			sv->voc = i;
+			sv->vi = p->virt.voice_array[i];
+			sv++;
+		}
+	}
+
+	c->next = p->ckpt.list;
+	p->ckpt.list = c;
+	p->ckpt.used += size;
+
+	D_(D_INFO "checkpoint at %d ms (order %d, %d bytes)",
+				(int)c->current_time, c->ord, size);
+}
+
+static void restore_channel(struct player_data *p, int chn,
+					const struct channel_data *xc)
+{
+#ifndef LIBXMP_CORE_PLAYER
+	void *extra = p->xc_data[chn].extra;
+#endif
+	if (xc != NULL) {
+		p->xc_data[chn] = *xc;
+	} else {
+		memset(&p->xc_data[chn], 0, sizeof (struct channel_data));
+	}
+#ifndef LIBXMP_CORE_PLAYER
+	p->xc_data[chn].extra = extra;
+#endif
+}
+
+static void restore_voice(struct player_data *p, int voc,
+					const struct mixer_voice *vi)
+{
+#ifdef LIBXMP_PAULA_SIMULATOR
+	struct paula_state *paula = p->virt.voice_array[voc].paula;
+#endif
+	if (vi != NULL) {
+		p->virt.voice_array[voc] = *vi;
+	} else {
+		memset(&p->virt.voice_array[voc], 0, sizeof (struct mixer_voice));
+		p->virt.voice_array[voc].chn = FREE;
+		p->virt.voice_array[voc].root = FREE;
+	}
+#ifdef LIBXMP_PAULA_SIMULATOR
+	p->virt.voice_array[voc].paula = paula;
+#endif
+}
+
+static void restore(struct context_data *ctx, struct checkpoint *c)
+{
+	struct player_data *p = &ctx->p;
+	struct mixer_data *s = &ctx->s;
+	struct pattern_loop *loop = p->flow.loop;
+	struct saved_channel *sc;
+	struct saved_voice *sv;
+	int vc = p->virt.virt_channels;
+	int i;
+
+	p->sequence = c->sequence;
+	p->ord = c->ord;
+	p->pos = c->pos;
+	p->row = c->row;
+	p->frame = c->frame;
+	p->speed = c->speed;
+	p->bpm = c->bpm;
+	p->gvol = c->gvol;
+	p->loop_count = c->loop_count;
+	p->current_time = c->current_time;
+	p->frame_time = c->frame_time;
+	p->flow = c->flow;
+	p->flow.loop = loop;
+	p->virt.virt_used = c->virt_used;
+	s->dtright = c->dtright;
+	s->dtleft = c->dtleft;
+	p->filter = c->filter;
+#ifndef LIBXMP_CORE_PLAYER
+	p->st26_speed = c->st26_speed;
+#endif
+
+	memcpy(p->flow.loop, LOOP_DATA(c), vc * sizeof (struct pattern_loop));
+	memcpy(p->virt.virt_channel, VIRT_DATA(c, p),
+				vc * sizeof (struct virt_channel));
+
+	for (i = 0; i < p->virt.num_tracks; i++) {
+		restore_channel(p, i, &XC_DATA(c, p)[i]);
+	}
+
+	sc = CHN_DATA(c, p);
+	for (i = p->virt.num_tracks; i < vc; i++) {
+		if (sc < CHN_DATA(c, p) + c->num_virt && sc->chn == i) {
+			restore_channel(p, i, &sc->xc);
+			sc++;
+		} else {
+			restore_channel(p, i, NULL);
+		}
+	}
+
+	sv = VOICE_DATA(c, p);
+	for (i = 0; i < p->virt.maxvoc; i++) {
+		if (sv < VOICE_DATA(c, p) + c->num_voices && sv->voc == i) {
+			restore_voice(p, i, &sv->vi);
+			sv++;
+		} else {
+			restore_voice(p, i, NULL);
+		}
+	}
+
+	p->ckpt.ord = p->ord;
+}
+
+/* Start the sequence over with the flow state of a fresh player */
+static void restart(struct context_data *ctx)
+{
+	struct player_data *p = &ctx->p;
+	struct flow_control *f = &p->flow;
+
+	f->delay = 0;
+	f->jump = -1;
+	f->pbreak = 0;
+	f->loop_chn = 0;
+	f->rowdelay = 0;
+	f->rowdelay_set = 0;
+	memset(f->loop, 0, p->virt.virt_channels * sizeof (struct pattern_loop));
+
+	p->loop_count = 0;
+	p->pos = -1;
+}
+
+void libxmp_checkpoint_seek(struct context_data *ctx, int time)
+{
+	struct player_data *p = &ctx->p;
+	struct mixer_data *s = &ctx->s;
+	struct checkpoint *c, *best = NULL;
+	int loop;
+
+	for (c = p->ckpt.list; c != NULL; c = c->next) {
+		if (c->sequence != p->sequence || c->current_time > time)
+			continue;
+		if (best == NULL || c->current_time > best->current_time)
+			best = c;
+	}
+
+	/* Go on from where we are unless a checkpoint is closer, or the
+	 * module has looped and still rings with notes from its end
+	 */
+	if (p->current_time > time || p->ord != p->pos || p->loop_count > 0 ||
+		(best != NULL && best->current_time > p->current_time)) {
+		if (best != NULL) {
+			restore(ctx, best);
+		} else {
+			restart(ctx);
+		}
+	}
+
+	/* Fast forward without mixing, except for the last frame so that
+	 * the anticlick state of the voices is in place when playback
+	 * resumes
+	 */
+	loop = p->loop_count;
+	do {
+		s->dry = p->current_time + p->frame_time < time;
+		if (xmp_play_frame((xmp_context)ctx) < 0)
+			break;
+	} while (p->current_time < time && p->loop_count == loop);
+	s->dry = 0;
+
+	p->buffer_data.consumed = 0;
+	p->buffer_data.in_size = 0;
+}
+
+void libxmp_checkpoint_release(struct context_data *ctx)
+{
+	struct player_data *p = &ctx->p;
+	struct checkpoint *c, *next;
+
+	for (c = p->ckpt.list; c != NULL; c = next) {
+		next = c->next;
+		free(c);
+	}
+
+	p->ckpt.list = NULL;
+	p->ckpt.used = 0;
+	p->ckpt.ord = -1;
+}
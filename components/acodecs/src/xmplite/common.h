@@ -266,6 +266,11 @@ struct module_data {
 	int num_sequences;
 	struct xmp_sequence seq_data[MAX_SEQUENCES];
 	char *instrument_path;
+	char *scan_cache_path;		/* scan result cache directory */
+	char *sample_spill_path;	/* sample spill file directory */
+	int sample_cache_size;		/* RAM for spilled sample windows */
+	struct sample_spill *spill;	/* spilled sample data */
+	uint8 *trk_packed;		/* tracks stored in packed form */
 	void *extra;			/* format-specific extra fields */
 	char **scan_cnt;		/* scan counters */
 	struct extra_sample_data *xtra;
@@ -343,6 +348,14 @@ struct player_data {
 
 	struct xmp_event inject_event[XMP_MAX_CHANNELS];
 
+	struct {
+		int interval;		/* min. time between checkpoints in ms */
+		int budget;		/* memory available for checkpoints */
+		int used;
+		int ord;		/* order of the last frame played */
+		struct checkpoint *list;
+	} ckpt;
+
 	struct {		
 		int consumed;
 		int in_size;
@@ -366,6 +379,7 @@ struct mixer_data {
 	int32* buf32;		/* temporary buffer for 32 bit samples */
 	int numvoc;		/* default softmixer voices number */
 	int ticksize;
+	int dry;		/* advance voices without mixing */
 	int dtright;		/* anticlick control, right channel */
 	int dtleft;		/* anticlick control, left channel */
 	double pbase;		/* period base */
@@ -387,6 +401,19 @@ int	libxmp_exclude_match	(char *);
 int	libxmp_prepare_scan	(struct context_data *);
 int	libxmp_scan_sequences	(struct context_data *);
 int	libxmp_get_sequence	(struct context_data *, int);
+int	libxmp_scan_cache_load	(struct context_data *);
+void	libxmp_scan_cache_save	(struct context_data *);
+void	libxmp_sample_spill	(struct module_data *, struct xmp_sample *, int);
+int	libxmp_sample_spilled	(struct module_data *, int);
+void	*libxmp_sample_fetch	(struct module_data *, int, int, int, int *);
+void	libxmp_sample_invert	(struct module_data *, int, int);
+void	libxmp_sample_spill_release (struct module_data *);
+void	libxmp_pack_pattern	(struct module_data *, int);
+void	libxmp_pack_tracks	(struct module_data *);
+void	libxmp_get_event	(struct module_data *, int, int, struct xmp_event *);
+void	libxmp_checkpoint_save	(struct context_data *);
+void	libxmp_checkpoint_seek	(struct context_data *, int);
+void	libxmp_checkpoint_release (struct context_data *);
 int	libxmp_set_player_mode	(struct context_data *);
 
 int8	read8s			(FILE *, int *err);
@@ -56,6 +56,8 @@ void xmp_free_context(xmp_context opaque)
 	if (ctx->state > XMP_STATE_UNLOADED)
 		xmp_release_module(opaque);
 
+	free(ctx->m.scan_cache_path);
+	free(ctx->m.sample_spill_path);
 	free(opaque);
 }
 
@@ -207,6 +209,11 @@ int xmp_seek_time(xmp_context opaque, int time)
 	if (ctx->state < XMP_STATE_PLAYING)
 		return -XMP_ERROR_STATE;
 
+	if (p->ckpt.interval > 0) {
+		libxmp_checkpoint_seek(ctx, time);
+		return p->pos < 0 ? 0 : p->pos;
+	}
+
 	for (i = m->mod.len - 1; i >= 0; i--) {
 		int pat = m->mod.xxo[i];
 		if (pat >= m->mod.pat) {
@@ -525,3 +532,60 @@ int xmp_set_instrument_path(xmp_context opaque, char *path)
 
 	return 0;
 }
+
+int xmp_set_scan_cache_path(xmp_context opaque, char *path)
+{
+	struct context_data *ctx = (struct context_data *)opaque;
+	struct module_data *m = &ctx->m;
+
+	free(m->scan_cache_path);
+	m->scan_cache_path = NULL;
+
+	if (path == NULL)
+		return 0;
+
+	m->scan_cache_path = strdup(path);
+	if (m->scan_cache_path == NULL) {
+		return -XMP_ERROR_SYSTEM;
+	}
+
+	return 0;
+}
+
+int xmp_set_sample_spill(xmp_context opaque, char *path, int cache_size)
+{
+	struct context_data *ctx = (struct context_data *)opaque;
+	struct module_data *m = &ctx->m;
+
+	if (ctx->state > XMP_STATE_UNLOADED)
+		return -XMP_ERROR_STATE;
+
+	free(m->sample_spill_path);
+	m->sample_spill_path = NULL;
+
+	if (path == NULL)
+		return 0;
+
+	m->sample_spill_path = strdup(path);
+	if (m->sample_spill_path == NULL) {
+		return -XMP_ERROR_SYSTEM;
+	}
+	m->sample_cache_size = cache_size;
+
+	return 0;
+}
+
+int xmp_set_seek_checkpoints(xmp_context opaque, int interval, int budget)
+{
+	struct context_data *ctx = (struct context_data *)opaque;
+	struct player_data *p = &ctx->p;
+
+	if (interval < 0 || budget < 0)
+		return -XMP_ERROR_INVALID;
+
+	/* Shrinking the budget only takes effect for new checkpoints */
+	p->ckpt.interval = interval;
+	p->ckpt.budget = budget;
+
+	return 0;
+}
@@ -47,16 +47,83 @@ static long get_size(FILE *f)
 	}
 }
 
+/*
+ * Buffered file access
+ *
+ * The physical file position is always buf_offset + buf_len. Requests
+ * larger than the buffer (sample data, mostly) bypass it and go straight
+ * to fread().
+ */
+
+static void buf_set_error(HIO_HANDLE *h)
+{
+	FILE *f = h->handle.file;
+
+	h->eof = 1;
+	h->error = ferror(f) ? errno : EOF;
+}
+
+static size_t buf_read(HIO_HANDLE *h, void *dest, size_t len)
+{
+	uint8 *d = (uint8 *)dest;
+	size_t done = 0;
+
+	while (done < len) {
+		size_t avail = h->buf_len - h->buf_pos;
+
+		if (avail > 0) {
+			size_t n = MIN(avail, len - done);
+			memcpy(d + done, h->buf + h->buf_pos, n);
+			h->buf_pos += n;
+			done += n;
+		} else if (len - done >= HIO_BUFFER_SIZE) {
+			size_t n = fread(d + done, 1, len - done, h->handle.file);
+			h->buf_offset += h->buf_len + n;
+			h->buf_pos = h->buf_len = 0;
+			done += n;
+			break;
+		} else {
+			h->buf_offset += h->buf_len;
+			h->buf_pos = 0;
+			h->buf_len = fread(h->buf, 1, HIO_BUFFER_SIZE, h->handle.file);
+			if (h->buf_len == 0) {
+				break;
+			}
+		}
+	}
+
+	if (done < len) {
+		h->eof = 1;
+	}
+
+	return done;
+}
+
+static inline int buf_read_bytes(HIO_HANDLE *h, uint8 *b, int n)
+{
+	if (h->buf_len - h->buf_pos >= n) {
+		memcpy(b, h->buf + h->buf_pos, n);
+		h->buf_pos += n;
+		return 0;
+	}
+
+	if (buf_read(h, b, n) != (size_t)n) {
+		buf_set_error(h);
+		return -1;
+	}
+
+	return 0;
+}
+
 int8 hio_read8s(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[1];
 	int8 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read8s(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
+		if (buf_read_bytes(h, b, 1) == 0) {
+			ret = (int8)b[0];
 		}
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
@@ -69,15 +136,12 @@ int8 hio_read8s(HIO_HANDLE *h)
 
 uint8 hio_read8(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[1];
 	uint8 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read8(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 1) == 0 ? b[0] : 0xff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread8(h->handle.mem);
@@ -89,15 +153,12 @@ uint8 hio_read8(HIO_HANDLE *h)
 
 uint16 hio_read16l(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[2];
 	uint16 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read16l(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 2) == 0 ? readmem16l(b) : 0xffff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread16l(h->handle.mem);
@@ -109,15 +170,12 @@ uint16 hio_read16l(HIO_HANDLE *h)
 
 uint16 hio_read16b(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[2];
 	uint16 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read16b(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 2) == 0 ? readmem16b(b) : 0xffff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread16b(h->handle.mem);
@@ -129,15 +187,12 @@ uint16 hio_read16b(HIO_HANDLE *h)
 
 uint32 hio_read24l(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[3];
 	uint32 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read24l(h->handle.file, &err); 
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 3) == 0 ? readmem24l(b) : 0xffffff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread24l(h->handle.mem); 
@@ -149,15 +204,12 @@ uint32 hio_read24l(HIO_HANDLE *h)
 
 uint32 hio_read24b(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[3];
 	uint32 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read24b(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 3) == 0 ? readmem24b(b) : 0xffffff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread24b(h->handle.mem);
@@ -169,15 +221,12 @@ uint32 hio_read24b(HIO_HANDLE *h)
 
 uint32 hio_read32l(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[4];
 	uint32 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read32l(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 4) == 0 ? readmem32l(b) : 0xffffffff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread32l(h->handle.mem);
@@ -189,15 +238,12 @@ uint32 hio_read32l(HIO_HANDLE *h)
 
 uint32 hio_read32b(HIO_HANDLE *h)
 {
-	int err;
+	uint8 b[4];
 	uint32 ret = 0;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = read32b(h->handle.file, &err);
-		if (err != 0) {
-			h->error = err;
-		}
+		ret = buf_read_bytes(h, b, 4) == 0 ? readmem32b(b) : 0xffffffff;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mread32b(h->handle.mem);
@@ -212,12 +258,15 @@ size_t hio_read(void *buf, size_t size, size_t num, HIO_HANDLE *h)
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = fread(buf, size, num, h->handle.file);
+		if (size == 0 || num == 0) {
+			break;
+		}
+		ret = buf_read(h, buf, size * num) / size;
 		if (ret != num) {
 			if (ferror(h->handle.file)) {
 				h->error = errno;
 			} else {
-				h->error = feof(h->handle.file) ? EOF : -2;
+				h->error = h->eof ? EOF : -2;
 			}
 		}
 		break;
@@ -232,15 +281,78 @@ size_t hio_read(void *buf, size_t size, size_t num, HIO_HANDLE *h)
 	return ret;
 }
 
+/* Read an array of little-endian values in one request. Elements past
+ * the end of file are set to zero. Returns the number of elements read.
+ */
+size_t hio_read16l_array(uint16 *buf, size_t num, HIO_HANDLE *h)
+{
+	size_t i, ret;
+
+	ret = hio_read(buf, 2, num, h);
+	for (i = 0; i < ret; i++) {
+		buf[i] = readmem16l((uint8 *)&buf[i]);
+	}
+	for (; i < num; i++) {
+		buf[i] = 0;
+	}
+
+	return ret;
+}
+
+size_t hio_read32l_array(uint32 *buf, size_t num, HIO_HANDLE *h)
+{
+	size_t i, ret;
+
+	ret = hio_read(buf, 4, num, h);
+	for (i = 0; i < ret; i++) {
+		buf[i] = readmem32l((uint8 *)&buf[i]);
+	}
+	for (; i < num; i++) {
+		buf[i] = 0;
+	}
+
+	return ret;
+}
+
 int hio_seek(HIO_HANDLE *h, long offset, int whence)
 {
 	int ret = -1;
+	long pos;
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = fseek(h->handle.file, offset, whence);
+		switch (whence) {
+		default:
+		case SEEK_SET:
+			pos = offset;
+			break;
+		case SEEK_CUR:
+			pos = h->buf_offset + h->buf_pos + offset;
+			break;
+		case SEEK_END:
+			if (h->size < 0) {
+				h->error = EINVAL;
+				return -1;
+			}
+			pos = h->size + offset;
+			break;
+		}
+
+		/* Stay inside the current block if we can */
+		if (pos >= h->buf_offset && pos <= h->buf_offset + h->buf_len) {
+			h->buf_pos = pos - h->buf_offset;
+			h->eof = 0;
+			ret = 0;
+			break;
+		}
+
+		ret = fseek(h->handle.file, pos, SEEK_SET);
 		if (ret < 0) {
 			h->error = errno;
+		} else {
+			h->buf_offset = pos;
+			h->buf_pos = h->buf_len = 0;
+			h->eof = 0;
 		}
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
@@ -260,10 +372,7 @@ long hio_tell(HIO_HANDLE *h)
 
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		ret = ftell(h->handle.file);
-		if (ret < 0) {
-			h->error = errno;
-		}
+		ret = h->buf_offset + h->buf_pos;
 		break;
 	case HIO_HANDLE_TYPE_MEMORY:
 		ret = mtell(h->handle.mem);
@@ -280,7 +389,7 @@ int hio_eof(HIO_HANDLE *h)
 {
 	switch (HIO_HANDLE_TYPE(h)) {
 	case HIO_HANDLE_TYPE_FILE:
-		return feof(h->handle.file);
+		return h->eof;
 	case HIO_HANDLE_TYPE_MEMORY:
 		return meof(h->handle.mem);
 	default:
@@ -295,18 +404,43 @@ int hio_error(HIO_HANDLE *h)
 	return error;
 }
 
-HIO_HANDLE *hio_open(void *path, char *mode)
+/* File handles carry their block buffer in the same allocation */
+static HIO_HANDLE *alloc_file_handle(FILE *f)
 {
 	HIO_HANDLE *h;
+	long pos;
 
-	h = (HIO_HANDLE *)malloc(sizeof (HIO_HANDLE));
+	h = (HIO_HANDLE *)malloc(sizeof (HIO_HANDLE) + HIO_BUFFER_SIZE);
 	if (h == NULL)
-		goto err;
-	
+		return NULL;
+
+	pos = ftell(f);
+
 	h->error = 0;
 	h->type = HIO_HANDLE_TYPE_FILE;
-	h->handle.file = fopen(path, mode);
-	if (h->handle.file == NULL)
+	h->handle.file = f;
+	h->buf = (unsigned char *)(h + 1);
+	h->buf_offset = pos > 0 ? pos : 0;
+	h->buf_pos = h->buf_len = 0;
+	h->eof = 0;
+
+	return h;
+}
+
+HIO_HANDLE *hio_open(void *path, char *mode)
+{
+	HIO_HANDLE *h;
+	FILE *f;
+
+	f = fopen(path, mode);
+	if (f == NULL)
+		goto err;
+
+	/* We do our own buffering */
+	setvbuf(f, NULL, _IONBF, 0);
+
+	h = alloc_file_handle(f);
+	if (h == NULL)
 		goto err2;
 
 	h->size = get_size(h->handle.file);
@@ -316,9 +450,9 @@ HIO_HANDLE *hio_open(void *path, char *mode)
 	return h;
 
     err3:
-	fclose(h->handle.file);
-    err2:
 	free(h);
+    err2:
+	fclose(f);
     err:
 	return NULL;
 }
@@ -335,6 +469,7 @@ HIO_HANDLE *hio_open_mem(void *ptr, long size)
 	h->type = HIO_HANDLE_TYPE_MEMORY;
 	h->handle.mem = mopen(ptr, size);
 	h->size = size;
+	h->buf = NULL;
 
 	return h;
 }
@@ -343,13 +478,10 @@ HIO_HANDLE *hio_open_file(FILE *f)
 {
 	HIO_HANDLE *h;
 
-	h = (HIO_HANDLE *)malloc(sizeof (HIO_HANDLE));
+	h = alloc_file_handle(f /*fdopen(fileno(f), "rb")*/);
 	if (h == NULL)
 		return NULL;
 	
-	h->error = 0;
-	h->type = HIO_HANDLE_TYPE_FILE;
-	h->handle.file = f /*fdopen(fileno(f), "rb")*/;
 	h->size = get_size(f);
 
 	return h;
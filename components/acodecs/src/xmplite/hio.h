@@ -8,6 +8,12 @@
 
 #define HIO_HANDLE_TYPE(x) ((x)->type)
 
+/* File handles are read through a block buffer of this size, so the
+ * loaders' many small field reads don't each go through stdio */
+#ifndef HIO_BUFFER_SIZE
+#define HIO_BUFFER_SIZE	4096
+#endif
+
 typedef struct {
 #define HIO_HANDLE_TYPE_FILE	0
 #define HIO_HANDLE_TYPE_MEMORY	1
@@ -18,6 +24,13 @@ typedef struct {
 		MFILE *mem;
 	} handle;
 	int error;
+
+	/* Block buffer, file handles only */
+	unsigned char *buf;
+	long buf_offset;		/* File offset of buf[0] */
+	int buf_pos;			/* Read position in buf */
+	int buf_len;			/* Valid bytes in buf */
+	int eof;			/* Read past end of file */
 } HIO_HANDLE;
 
 int8	hio_read8s	(HIO_HANDLE *);
@@ -29,6 +42,8 @@ uint32	hio_read24b	(HIO_HANDLE *);
 uint32	hio_read32l	(HIO_HANDLE *);
 uint32	hio_read32b	(HIO_HANDLE *);
 size_t	hio_read	(void *, size_t, size_t, HIO_HANDLE *);	
+size_t	hio_read16l_array (uint16 *, size_t, HIO_HANDLE *);
+size_t	hio_read32l_array (uint32 *, size_t, HIO_HANDLE *);
 int	hio_seek	(HIO_HANDLE *, long, int);
 long	hio_tell	(HIO_HANDLE *);
 int	hio_eof		(HIO_HANDLE *);
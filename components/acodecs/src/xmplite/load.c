@@ -40,9 +40,9 @@
 #if !defined(HAVE_POPEN) && defined(WIN32)
 #include "win32/ptpopen.h"
 #endif
-#include "md5.h"
 #include "extras.h"
 #endif
+#include "md5.h"
 
 
 extern struct format_loader *format_loader[];
@@ -78,8 +78,6 @@ static struct depacker *depacker_list[] = {
 
 int test_oxm		(FILE *);
 
-#define BUFLEN 16384
-
 static int execute_command(char *cmd, char *filename, FILE *t)
 {
 	char line[1024], buf[BUFLEN];
@@ -217,26 +215,6 @@ static int decrunch(HIO_HANDLE **h, char *filename, char **temp)
 	return -1;
 }
 
-static void set_md5sum(HIO_HANDLE *f, unsigned char *digest)
-{
-	unsigned char buf[BUFLEN];
-	MD5_CTX ctx;
-	int bytes_read;
-
-	if (hio_size(f) <= 0) {
-		memset(digest, 0, 16);
-		return;
-	}
-
-	hio_seek(f, 0, SEEK_SET);
-
-	MD5Init(&ctx);
-	while ((bytes_read = hio_read(buf, 1, BUFLEN, f)) > 0) {
-		MD5Update(&ctx, buf, bytes_read);
-	}
-	MD5Final(digest, &ctx);
-}
-
 static char *get_dirname(char *name)
 {
 	char *div, *dirname;
@@ -270,6 +248,28 @@ static char *get_basename(char *name)
 }
 #endif /* LIBXMP_CORE_PLAYER */
 
+#define BUFLEN 16384
+
+static void set_md5sum(HIO_HANDLE *f, unsigned char *digest)
+{
+	unsigned char buf[BUFLEN];
+	MD5_CTX ctx;
+	int bytes_read;
+
+	if (hio_size(f) <= 0) {
+		memset(digest, 0, 16);
+		return;
+	}
+
+	hio_seek(f, 0, SEEK_SET);
+
+	MD5Init(&ctx);
+	while ((bytes_read = hio_read(buf, 1, BUFLEN, f)) > 0) {
+		MD5Update(&ctx, buf, bytes_read);
+	}
+	MD5Final(digest, &ctx);
+}
+
 int xmp_test_module(char *path, struct xmp_test_info *info)
 {
 	HIO_HANDLE *h;
@@ -325,7 +325,7 @@ int xmp_test_module(char *path, struct xmp_test_info *info)
 			}
 #endif
 
-			fclose(h->handle.file);
+			hio_close(h);
 
 #ifndef LIBXMP_CORE_PLAYER
 			unlink_temp_file(temp);
@@ -381,6 +381,10 @@ static int load_module(xmp_context opaque, HIO_HANDLE *h)
 #ifndef LIBXMP_CORE_PLAYER
 	if (test_result == 0 && load_result == 0)
 		set_md5sum(h, m->md5);
+#else
+	/* The digest is only needed to key the scan cache */
+	if (test_result == 0 && load_result == 0 && m->scan_cache_path != NULL)
+		set_md5sum(h, m->md5);
 #endif
 
 	if (test_result < 0) {
@@ -424,6 +428,9 @@ static int load_module(xmp_context opaque, HIO_HANDLE *h)
 		}
 	}
 
+	/* Pack whatever the loader left expanded */
+	libxmp_pack_tracks(m);
+
 	libxmp_adjust_string(mod->name);
 	for (i = 0; i < mod->ins; i++) {
 		libxmp_adjust_string(mod->xxi[i].name);
@@ -440,7 +447,10 @@ static int load_module(xmp_context opaque, HIO_HANDLE *h)
 		return ret;
 	}
 
-	libxmp_scan_sequences(ctx);
+	if (libxmp_scan_cache_load(ctx) < 0) {
+		libxmp_scan_sequences(ctx);
+		libxmp_scan_cache_save(ctx);
+	}
 
 	ctx->state = XMP_STATE_LOADED;
 
@@ -616,6 +626,8 @@ void xmp_release_module(xmp_context opaque)
 		}
 		free(mod->xxt);
 	}
+	free(m->trk_packed);
+	m->trk_packed = NULL;
 
 	if (mod->xxp != NULL) {
 		for (i = 0; i < mod->pat; i++) {
@@ -653,6 +665,8 @@ void xmp_release_module(xmp_context opaque)
 	}
 #endif
 
+	libxmp_sample_spill_release(m);
+
 	if (m->scan_cnt) {
 		for (i = 0; i < mod->len; i++)
 			free(m->scan_cnt[i]);
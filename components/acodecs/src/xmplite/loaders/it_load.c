@@ -1153,12 +1153,9 @@ static int it_load(struct module_data *m, HIO_HANDLE *f, const int start)
 
 	new_fx = ifh.flags & IT_OLD_FX ? 0 : 1;
 
-	for (i = 0; i < mod->ins; i++)
-		pp_ins[i] = hio_read32l(f);
-	for (i = 0; i < mod->smp; i++)
-		pp_smp[i] = hio_read32l(f);
-	for (i = 0; i < mod->pat; i++)
-		pp_pat[i] = hio_read32l(f);
+	hio_read32l_array(pp_ins, mod->ins, f);
+	hio_read32l_array(pp_smp, mod->smp, f);
+	hio_read32l_array(pp_pat, mod->pat, f);
 
 	m->c4rate = C4_NTSC_RATE;
 
@@ -1309,6 +1306,7 @@ static int it_load(struct module_data *m, HIO_HANDLE *f, const int start)
 					goto err4;
 				mod->xxp[i]->index[j] = tnum;
 			}
+			libxmp_pack_pattern(m, i);
 			continue;
 		}
 
@@ -1319,6 +1317,7 @@ static int it_load(struct module_data *m, HIO_HANDLE *f, const int start)
 		if (load_it_pattern(m, i, new_fx, f) < 0) {
 			goto err4;
 		}
+		libxmp_pack_pattern(m, i);
 	}
 
 	free(pp_pat);
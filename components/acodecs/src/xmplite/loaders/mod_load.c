@@ -204,6 +204,7 @@ static int mod_load(struct module_data *m, HIO_HANDLE *f, const int start)
 	    hio_read (mod_event, 1, 4, f);
 	    libxmp_decode_protracker_event(event, mod_event);
 	}
+	libxmp_pack_pattern(m, i);
     }
 
     /* Load samples */
@@ -359,11 +359,8 @@ static int s3m_load(struct module_data *m, HIO_HANDLE * f, const int start)
 	mod->ins = sfh.insnum;
 	mod->smp = mod->ins;
 
-	for (i = 0; i < sfh.insnum; i++)
-		pp_ins[i] = hio_read16l(f);
-
-	for (i = 0; i < sfh.patnum; i++)
-		pp_pat[i] = hio_read16l(f);
+	hio_read16l_array(pp_ins, sfh.insnum, f);
+	hio_read16l_array(pp_pat, sfh.patnum, f);
 
 	/* Default pan positions */
 
@@ -445,8 +442,10 @@ static int s3m_load(struct module_data *m, HIO_HANDLE * f, const int start)
 		if (libxmp_alloc_pattern_tracks(mod, i, 64) < 0)
 			goto err3;
 
-		if (pp_pat[i] == 0)
+		if (pp_pat[i] == 0) {
+			libxmp_pack_pattern(m, i);
 			continue;
+		}
 
 		hio_seek(f, start + pp_pat[i] * 16, SEEK_SET);
 		r = 0;
@@ -496,6 +495,8 @@ static int s3m_load(struct module_data *m, HIO_HANDLE * f, const int start)
 				pat_len -= 2;
 			}
 		}
+
+		libxmp_pack_pattern(m, i);
 	}
 
 	D_(D_INFO "Stereo enabled: %s", sfh.mv & 0x80 ? "yes" : "no");
@@ -405,6 +405,9 @@ int libxmp_load_sample(struct module_data *m, HIO_HANDLE *f, int flags, struct x
 		}
 	}
 
+	/* Move the finished sample out of RAM if spilling is enabled */
+	libxmp_sample_spill(m, xxs, bytelen + extralen + 4);
+
 	return 0;
 
 #ifndef LIBXMP_CORE_PLAYER
@@ -312,6 +312,7 @@ static int load_patterns(struct module_data *m, int version, HIO_HANDLE *f)
 		if (load_xm_pattern(m, i, version, f) < 0) {
 			goto err;
 		}
+		libxmp_pack_pattern(m, i);
 	}
 
 	/* Alloc one extra pattern */
@@ -407,10 +408,8 @@ static int load_instruments(struct module_data *m, int version, HIO_HANDLE *f)
 		hio_seek(f, xih.size - XM_INST_HEADER_SIZE, SEEK_CUR);
 	    } else {
 		hio_read(&xi.sample, 96, 1, f);	/* Sample map */
-		for (j = 0; j < 24; j++)
-		    xi.v_env[j] = hio_read16l(f); /* Points for volume envelope */
-		for (j = 0; j < 24; j++)
-		    xi.p_env[j] = hio_read16l(f); /* Points for pan envelope */
+		hio_read16l_array(xi.v_env, 24, f); /* Points for volume envelope */
+		hio_read16l_array(xi.p_env, 24, f); /* Points for pan envelope */
 		xi.v_pts = hio_read8(f);	/* Number of volume points */
 		xi.p_pts = hio_read8(f);	/* Number of pan points */
 		xi.v_sus = hio_read8(f);	/* Volume sustain point */
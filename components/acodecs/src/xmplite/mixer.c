@@ -324,6 +324,72 @@ void libxmp_mixer_prepare(struct context_data *ctx)
 	}
 	memset(s->buf32, 0, bytelen);
 }
+/* Mix a voice playing a spilled sample. The sample is paged in through
+ * windows that may be shorter than the span read in this call, so mixing
+ * is split into runs that fit, restarting each run at the exact position
+ * and ramp volume the mixer would have reached on its own.
+ */
+static void mix_spilled(struct context_data *ctx, struct mixer_voice *vi,
+	void (*mix_fn)(struct mixer_voice *, int *, int, int, int, int, int, int, int),
+	int *buf, int count, int vl, int vr, int step, int ramp,
+	int delta_l, int delta_r)
+{
+	struct module_data *m = &ctx->m;
+	struct mixer_data *s = &ctx->s;
+	double pos = vi->pos;
+	int old_vl = vi->old_vl;
+	int old_vr = vi->old_vr;
+	int ipos = (int)pos;
+	int frac = (1 << SMIX_SHIFT) * (pos - ipos);
+	int nramp = count - ramp;
+	int nch = s->format & XMP_FORMAT_MONO ? 1 : 2;
+	int hi, done;
+
+	hi = ipos + (int)((frac + (int64)(count - 1) * step) >> SMIX_SHIFT) + 2;
+
+	for (done = 0; done < count; ) {
+		int64 t = frac + (int64)done * step;
+		int lo = ipos + (int)(t >> SMIX_SHIFT);
+		int f = t & SMIX_MASK;
+		int n, r, avail;
+
+		vi->sptr = libxmp_sample_fetch(m, vi->smp, lo - 1, hi, &avail);
+		if (vi->sptr == NULL) {
+			break;
+		}
+
+		/* Frames whose interpolation taps are all in the window */
+		n = (((int64)(avail - 4) << SMIX_SHIFT) - f) / step + 1;
+		if (n < 1) {
+			n = 1;
+		} else if (n > count - done) {
+			n = count - done;
+		}
+
+		/* sptr points at frame lo - 1, the first interpolation tap */
+		r = done < nramp ? done : nramp;
+		vi->pos = 1 + (double)f / (1 << SMIX_SHIFT);
+		vi->old_vl = old_vl + r * delta_l;
+		vi->old_vr = old_vr + r * delta_r;
+
+		r = nramp - done;
+		if (r < 0) {
+			r = 0;
+		} else if (r > n) {
+			r = n;
+		}
+
+		mix_fn(vi, buf + done * nch, n, vl, vr, step, n - r,
+							delta_l, delta_r);
+		done += n;
+	}
+
+	vi->pos = pos;
+	vi->old_vl = old_vl;
+	vi->old_vr = old_vr;
+	vi->sptr = NULL;
+}
+
 /* Fill the output buffer calling one of the handlers. The buffer contains
  * sound for one tick (a PAL frame or 1/50s for standard vblank-timed mods)
  */
@@ -503,10 +569,11 @@ void libxmp_mixer_softmixer(struct context_data *ctx)
 				}
 #endif
 
-				mix_fn = (*mixers)[mixer];
+				mix_fn = s->dry ? NULL : (*mixers)[mixer];
 
 				/* Call the output handler */
-				if (samples > 0 && vi->sptr != NULL) {
+				if (samples > 0 && (vi->sptr != NULL ||
+					libxmp_sample_spilled(m, vi->smp))) {
 					int rsize = 0;
 
 					if (rampsize > samples) {
@@ -521,9 +588,12 @@ void libxmp_mixer_softmixer(struct context_data *ctx)
 						rsize = samples;
 					}
 
-					if (mix_fn != NULL) {
+					if (mix_fn != NULL && vi->sptr != NULL) {
 						mix_fn(vi, buf_pos, samples,
 							vol_l >> 8, vol_r >> 8, step * (1 << SMIX_SHIFT), rsize, delta_l, delta_r);
+					} else if (mix_fn != NULL) {
+						mix_spilled(ctx, vi, mix_fn, buf_pos, samples,
+							vol_l >> 8, vol_r >> 8, step * (1 << SMIX_SHIFT), rsize, delta_l, delta_r);
 					}
 
 					buf_pos += mix_size;
@@ -570,6 +640,11 @@ void libxmp_mixer_softmixer(struct context_data *ctx)
 
 	/* Render final frame */
 
+	if (s->dry) {
+		s->dtright = s->dtleft = 0;
+		return;
+	}
+
 	size = s->ticksize;
 	if (~s->format & XMP_FORMAT_MONO) {
 		size *= 2;
@@ -0,0 +1,214 @@
+/* Extended Module Player
+ * Copyright (C) 1996-2016 Claudio Matsuoka and Hipolito Carraro Jr
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Packed tracks
+ *
+ * Loaders expand patterns into arrays of 8-byte events, one per row and
+ * channel. Most of those are empty, so once a pattern is loaded its tracks
+ * are packed in the spirit of the XM/IT file formats: each row starts with
+ * a mask byte telling which event fields follow, and a zero mask is
+ * followed by a count of empty rows. Events are unpacked one row at a time
+ * as the player and the scanner read them. Each track remembers where the
+ * last read row starts, so sequential reads don't walk the track from the
+ * top.
+ */
+
+#include <stdlib.h>
+#include <stddef.h>
+#include "common.h"
+
+/* A packed track replaces struct xmp_track, keeping the rows field */
+struct packed_track {
+	int rows;
+	uint16 row;		/* first row of the code at pos */
+	uint16 pos;
+	uint8 data[1];
+};
+
+static int pack_row(uint8 *b, struct xmp_event *e)
+{
+	uint8 *f = (uint8 *)e;
+	int i, len = 1;
+
+	b[0] = 0;
+	for (i = 0; i < sizeof (struct xmp_event); i++) {
+		if (f[i] != 0) {
+			b[0] |= 1 << i;
+			b[len++] = f[i];
+		}
+	}
+
+	return len;
+}
+
+/* Pack one track, writing to b if not NULL. Returns the packed size. */
+static int pack_events(uint8 *b, struct xmp_track *xxt)
+{
+	uint8 row[1 + sizeof (struct xmp_event)];
+	int r, n, len = 0;
+
+	for (r = 0; r < xxt->rows; ) {
+		n = pack_row(row, &xxt->event[r]);
+
+		if (row[0] == 0) {
+			for (n = 1; r + n < xxt->rows && n < 256; n++) {
+				pack_row(row, &xxt->event[r + n]);
+				if (row[0] != 0)
+					break;
+			}
+			if (b != NULL) {
+				b[len] = 0;
+				b[len + 1] = n - 1;
+			}
+			len += 2;
+			r += n;
+		} else {
+			if (b != NULL)
+				memcpy(b + len, row, n);
+			len += n;
+			r++;
+		}
+	}
+
+	return len;
+}
+
+static void pack_track(struct module_data *m, int num)
+{
+	struct xmp_module *mod = &m->mod;
+	struct xmp_track *xxt = mod->xxt[num];
+	struct packed_track *pt;
+	int len, size;
+
+	if (xxt == NULL || m->trk_packed[num])
+		return;
+
+	len = pack_events(NULL, xxt);
+	size = offsetof(struct packed_track, data) + len;
+	if (size < sizeof (struct xmp_track))
+		size = sizeof (struct xmp_track);
+
+	/* Keep the expanded track if we're out of memory */
+	if ((pt = malloc(size)) == NULL)
+		return;
+
+	pt->rows = xxt->rows;
+	pt->row = 0;
+	pt->pos = 0;
+	pack_events(pt->data, xxt);
+
+	free(xxt);
+	mod->xxt[num] = (struct xmp_track *)pt;
+	m->trk_packed[num] = 1;
+}
+
+static int alloc_packed(struct module_data *m)
+{
+	if (m->trk_packed == NULL) {
+		m->trk_packed = calloc(1, m->mod.trk);
+		if (m->trk_packed == NULL)
+			return -1;
+	}
+
+	return 0;
+}
+
+void libxmp_pack_pattern(struct module_data *m, int num)
+{
+	struct xmp_module *mod = &m->mod;
+	int i;
+
+	if (mod->xxp[num] == NULL || alloc_packed(m) < 0)
+		return;
+
+	for (i = 0; i < mod->chn; i++) {
+		int t = mod->xxp[num]->index[i];
+		if (t >= 0 && t < mod->trk)
+			pack_track(m, t);
+	}
+}
+
+void libxmp_pack_tracks(struct module_data *m)
+{
+	struct xmp_module *mod = &m->mod;
+	int i;
+
+	if (mod->trk <= 0 || alloc_packed(m) < 0)
+		return;
+
+	for (i = 0; i < mod->trk; i++) {
+		pack_track(m, i);
+	}
+}
+
+void libxmp_get_event(struct module_data *m, int num, int row, struct xmp_event *e)
+{
+	struct packed_track *pt;
+	uint8 *b, *f = (uint8 *)e;
+	int r, pos, mask, i;
+
+	if (m->trk_packed == NULL || !m->trk_packed[num]) {
+		memcpy(e, &m->mod.xxt[num]->event[row], sizeof (struct xmp_event));
+		return;
+	}
+
+	pt = (struct packed_track *)m->mod.xxt[num];
+	memset(e, 0, sizeof (struct xmp_event));
+
+	/* Resume from the last row read unless we went backwards */
+	if (row >= pt->row) {
+		r = pt->row;
+		pos = pt->pos;
+	} else {
+		r = pos = 0;
+	}
+
+	b = pt->data;
+	for (;;) {
+		mask = b[pos];
+
+		if (mask == 0) {
+			if (row <= r + b[pos + 1])
+				break;
+			r += b[pos + 1] + 1;
+			pos += 2;
+			continue;
+		}
+
+		if (row == r) {
+			for (i = 0, b += pos + 1; mask; i++, mask >>= 1) {
+				if (mask & 1)
+					f[i] = *b++;
+			}
+			break;
+		}
+
+		for (pos++; mask; mask >>= 1) {
+			pos += mask & 1;
+		}
+		r++;
+	}
+
+	pt->row = r;
+	pt->pos = pos;
+}
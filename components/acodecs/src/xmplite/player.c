@@ -286,7 +286,12 @@ static void update_invloop(struct module_data *m, struct channel_data *xc)
 		}
 
 		if (~xxs->flg & XMP_SAMPLE_16BIT) {
-			xxs->data[xxs->lps + xc->invloop.pos] ^= 0xff;
+			if (libxmp_sample_spilled(m, xc->smp)) {
+				libxmp_sample_invert(m, xc->smp,
+						xxs->lps + xc->invloop.pos);
+			} else {
+				xxs->data[xxs->lps + xc->invloop.pos] ^= 0xff;
+			}
 		}
 	}
 }
@@ -488,7 +493,7 @@ static inline void read_row(struct context_data *ctx, int pat, int row)
 	for (chn = 0; chn < mod->chn; chn++) {
 		const int num_rows = mod->xxt[TRACK_NUM(pat, chn)]->rows;
 		if (row < num_rows) {
-			memcpy(&ev, &EVENT(pat, chn, row), sizeof(ev));
+			libxmp_get_event(m, TRACK_NUM(pat, chn), row, &ev);
 		} else {
 			memset(&ev, 0, sizeof(ev));
 		}
@@ -1541,6 +1546,9 @@ int xmp_start_player(xmp_context opaque, int rate, int format)
 	f->pbreak = 0;
 	f->rowdelay_set = 0;
 
+	/* No order has been checkpointed yet, not even order 0 */
+	p->ckpt.ord = -1;
+
 	f->loop = calloc(p->virt.virt_channels, sizeof(struct pattern_loop));
 	if (f->loop == NULL) {
 		ret = -XMP_ERROR_SYSTEM;
@@ -1703,6 +1711,10 @@ int xmp_play_frame(xmp_context opaque)
 
 	libxmp_mixer_softmixer(ctx);
 
+	if (p->ckpt.interval > 0) {
+		libxmp_checkpoint_save(ctx);
+	}
+
 	return 0;
 }
 
@@ -1786,6 +1798,7 @@ void xmp_end_player(xmp_context opaque)
 	}
 #endif
 
+	libxmp_checkpoint_release(ctx);
 	libxmp_virt_off(ctx);
 
 	free(p->xc_data);
@@ -1890,8 +1903,7 @@ void xmp_get_frame_info(xmp_context opaque, struct xmp_frame_info *info)
 				trk = mod->xxp[info->pattern]->index[i];
 				track = mod->xxt[trk];
 				if (info->row < track->rows) {
-					event = &track->event[info->row];
-					memcpy(&ci->event, event, sizeof(*event));
+					libxmp_get_event(m, trk, info->row, &ci->event);
 				}
 			}
 		}
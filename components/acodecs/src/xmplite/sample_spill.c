@@ -0,0 +1,388 @@
+/* Extended Module Player
+ * Copyright (C) 1996-2016 Claudio Matsuoka and Hipolito Carraro Jr
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Sample spill file
+ *
+ * Large IT/XM modules carry megabytes of sample data, far more than a
+ * small target can keep in RAM. When a spill directory is set, each sample
+ * is still loaded and converted as usual (including decompression of IT
+ * samples, loop unrolling and interpolation guard bytes) but the finished
+ * image is then written to a temporary file and released, so load needs
+ * only enough memory for the largest single sample.
+ *
+ * At play time the mixer asks for the range of sample frames it is about
+ * to read and gets a pointer into one of a few fixed-size windows that
+ * hold recently used parts of the spill file. Samples that fit in one
+ * window stay in RAM, as do short loops once they have been paged in.
+ * The invert loop effect writes to a window, which is written back to
+ * the spill file when it is reused.
+ *
+ * Spill files are named by a slot number, so a file left behind by a
+ * crash is found again: spill files in the directory are removed when
+ * the first one is opened.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _MSC_VER
+#include <direct.h>
+#else
+#include <dirent.h>
+#endif
+#include "common.h"
+
+#ifndef SPILL_WINDOW_SIZE
+#define SPILL_WINDOW_SIZE	4096
+#endif
+
+#define SPILL_MIN_WINDOWS	2
+#define SPILL_MAX_SLOTS		32
+#define SPILL_SUFFIX		".spl"
+
+struct spill_sample {
+	long offset;		/* image offset in the spill file */
+	int size;		/* image size in bytes, 0 if resident */
+	int shift;		/* 1 for 16 bit samples */
+};
+
+struct spill_window {
+	int smp;		/* sample number, -1 if unused */
+	long start;		/* first image byte held */
+	int len;		/* image bytes held */
+	unsigned int stamp;	/* last use */
+	int dirty;		/* written to since it was read */
+	uint8 *buf;
+};
+
+struct sample_spill {
+	FILE *f;
+	char *name;
+	int slot;
+	long size;		/* spill file size */
+	struct spill_sample *smp;
+	int num_smp;
+	struct spill_window *win;
+	int num_win;
+	unsigned int stamp;
+};
+
+/* Spill file slots in use, one bit each */
+static unsigned int spill_slots;
+
+/* Remove the spill files in path, left behind by a crash */
+static void spill_clear(const char *path)
+{
+#ifndef _MSC_VER
+	DIR *dir;
+	struct dirent *d;
+	char *name;
+	int len, slen = strlen(SPILL_SUFFIX);
+
+	if ((dir = opendir(path)) == NULL)
+		return;
+
+	while ((d = readdir(dir)) != NULL) {
+		len = strlen(d->d_name);
+		if (len <= slen || strcmp(d->d_name + len - slen, SPILL_SUFFIX))
+			continue;
+		len += strlen(path) + 2;
+		if ((name = malloc(len)) == NULL)
+			break;
+		snprintf(name, len, "%s/%s", path, d->d_name);
+		remove(name);
+		free(name);
+	}
+
+	closedir(dir);
+#endif
+}
+
+static struct sample_spill *spill_open(struct module_data *m)
+{
+	struct sample_spill *sp;
+	uint8 *buf;
+	int i, num, len, slot;
+
+	for (slot = 0; slot < SPILL_MAX_SLOTS; slot++) {
+		if (~spill_slots & (1U << slot))
+			break;
+	}
+	if (slot == SPILL_MAX_SLOTS)
+		return NULL;
+
+	if ((sp = calloc(1, sizeof (struct sample_spill))) == NULL)
+		return NULL;
+
+	num = m->sample_cache_size / SPILL_WINDOW_SIZE;
+	if (num < SPILL_MIN_WINDOWS)
+		num = SPILL_MIN_WINDOWS;
+
+	sp->win = calloc(num, sizeof (struct spill_window));
+	buf = malloc(num * SPILL_WINDOW_SIZE);
+	if (sp->win == NULL || buf == NULL)
+		goto err;
+
+	sp->num_win = num;
+	for (i = 0; i < num; i++) {
+		sp->win[i].smp = -1;
+		sp->win[i].buf = buf + i * SPILL_WINDOW_SIZE;
+	}
+	buf = NULL;
+
+	len = strlen(m->sample_spill_path) + 32;
+	if ((sp->name = malloc(len)) == NULL)
+		goto err;
+	snprintf(sp->name, len, "%s/%d" SPILL_SUFFIX, m->sample_spill_path, slot);
+
+#ifdef _MSC_VER
+	_mkdir(m->sample_spill_path);
+#else
+	mkdir(m->sample_spill_path, 0755);
+#endif
+
+	if (spill_slots == 0)
+		spill_clear(m->sample_spill_path);
+
+	if ((sp->f = fopen(sp->name, "w+b")) == NULL)
+		goto err;
+
+	/* Windows are our cache, don't buffer twice */
+	setvbuf(sp->f, NULL, _IONBF, 0);
+
+	D_(D_INFO "sample spill file: %s", sp->name);
+	sp->slot = slot;
+	spill_slots |= 1U << slot;
+	m->spill = sp;
+
+	return sp;
+
+    err:
+	free(buf);
+	if (sp->win != NULL)
+		free(sp->win[0].buf);
+	free(sp->win);
+	free(sp->name);
+	free(sp);
+	return NULL;
+}
+
+void libxmp_sample_spill(struct module_data *m, struct xmp_sample *xxs, int size)
+{
+	struct xmp_module *mod;
+	struct sample_spill *sp;
+	struct spill_sample *ss;
+	int smp;
+
+	if (m == NULL || m->sample_spill_path == NULL || xxs->data == NULL)
+		return;
+
+	mod = &m->mod;
+
+#ifndef LIBXMP_CORE_DISABLE_IT
+	/* The mixer only uses the loop points of sustain loop samples */
+	if (m->xsmp != NULL && xxs >= m->xsmp && xxs < m->xsmp + mod->smp) {
+		free(xxs->data - 4);
+		xxs->data = NULL;
+		return;
+	}
+#endif
+
+	if (mod->xxs == NULL || xxs < mod->xxs || xxs >= mod->xxs + mod->smp)
+		return;
+
+	/* Not worth paging what fits in a single window */
+	if (size <= SPILL_WINDOW_SIZE)
+		return;
+
+	if ((sp = m->spill) == NULL && (sp = spill_open(m)) == NULL)
+		return;
+
+	smp = xxs - mod->xxs;
+	if (smp >= sp->num_smp) {
+		int num = mod->smp > smp ? mod->smp : smp + 1;
+
+		ss = realloc(sp->smp, num * sizeof (struct spill_sample));
+		if (ss == NULL)
+			return;
+		memset(ss + sp->num_smp, 0,
+			(num - sp->num_smp) * sizeof (struct spill_sample));
+		sp->smp = ss;
+		sp->num_smp = num;
+	}
+
+	/* On write errors the sample simply stays in RAM */
+	if (fseek(sp->f, sp->size, SEEK_SET) < 0)
+		return;
+	if (fwrite(xxs->data - 4, 1, size, sp->f) != (size_t)size)
+		return;
+
+	ss = &sp->smp[smp];
+	ss->offset = sp->size;
+	ss->size = size;
+	ss->shift = xxs->flg & XMP_SAMPLE_16BIT ? 1 : 0;
+	sp->size += size;
+
+	free(xxs->data - 4);
+	xxs->data = NULL;
+}
+
+int libxmp_sample_spilled(struct module_data *m, int smp)
+{
+	struct sample_spill *sp = m->spill;
+
+	return sp != NULL && smp < sp->num_smp && sp->smp[smp].size > 0;
+}
+
+/* Write a window back to the spill file if it was changed */
+static int spill_flush(struct sample_spill *sp, struct spill_window *w)
+{
+	struct spill_sample *ss;
+
+	if (!w->dirty)
+		return 0;
+
+	ss = &sp->smp[w->smp];
+	if (fseek(sp->f, ss->offset + w->start, SEEK_SET) < 0)
+		return -1;
+	if (fwrite(w->buf, 1, w->len, sp->f) != (size_t)w->len)
+		return -1;
+	w->dirty = 0;
+
+	return 0;
+}
+
+/* Find or read in a window holding image bytes first to last of a sample */
+static struct spill_window *spill_window(struct sample_spill *sp, int smp,
+							long first, long last)
+{
+	struct spill_sample *ss = &sp->smp[smp];
+	struct spill_window *w, *lru;
+	int i;
+
+	if (first < 0)
+		first = 0;
+	if (last > ss->size)
+		last = ss->size;
+
+	lru = w = sp->win;
+	for (i = 0; i < sp->num_win; i++, w++) {
+		if (w->smp == smp && w->start <= first &&
+					w->start + w->len >= last) {
+			break;
+		}
+		if (w->stamp < lru->stamp) {
+			lru = w;
+		}
+	}
+
+	if (i == sp->num_win) {
+		/* Windows may overlap, so the file must have every change to
+		 * the sample before another part of it is read. On write errors
+		 * the changes are lost, as if the sample couldn't be written.
+		 */
+		for (i = 0; i < sp->num_win; i++) {
+			if (sp->win[i].smp == smp || &sp->win[i] == lru)
+				spill_flush(sp, &sp->win[i]);
+		}
+
+		w = lru;
+		w->smp = -1;
+		w->dirty = 0;
+		w->start = first;
+		w->len = ss->size - first;
+		if (w->len > SPILL_WINDOW_SIZE)
+			w->len = SPILL_WINDOW_SIZE;
+
+		if (fseek(sp->f, ss->offset + first, SEEK_SET) < 0)
+			return NULL;
+		if (fread(w->buf, 1, w->len, sp->f) != (size_t)w->len)
+			return NULL;
+		w->smp = smp;
+	}
+
+	w->stamp = ++sp->stamp;
+
+	return w;
+}
+
+/* Return a pointer to frame lo of a spilled sample, valid up to frame hi.
+ * If the window can't hold the whole range, avail is set to the number
+ * of frames from lo that can be read.
+ */
+void *libxmp_sample_fetch(struct module_data *m, int smp, int lo, int hi, int *avail)
+{
+	struct sample_spill *sp = m->spill;
+	struct spill_sample *ss = &sp->smp[smp];
+	struct spill_window *w;
+	long first = 4 + (long)lo * (1 << ss->shift);	/* lo may be -1 */
+
+	w = spill_window(sp, smp, first, 4 + ((long)(hi + 1) << ss->shift));
+	if (w == NULL)
+		return NULL;
+
+	*avail = (w->start + w->len - first) >> ss->shift;
+
+	return w->buf + (first - w->start);
+}
+
+/* Invert a frame of a spilled 8 bit sample, for the invert loop effect */
+void libxmp_sample_invert(struct module_data *m, int smp, int pos)
+{
+	struct sample_spill *sp = m->spill;
+	struct spill_window *w;
+	long first = 4 + pos;
+	int i;
+
+	if (spill_window(sp, smp, first, first + 1) == NULL)
+		return;
+
+	/* Change every copy of the byte, windows may overlap */
+	for (i = 0, w = sp->win; i < sp->num_win; i++, w++) {
+		if (w->smp == smp && w->start <= first &&
+					w->start + w->len > first) {
+			w->buf[first - w->start] ^= 0xff;
+			w->dirty = 1;
+		}
+	}
+}
+
+void libxmp_sample_spill_release(struct module_data *m)
+{
+	struct sample_spill *sp = m->spill;
+
+	if (sp == NULL)
+		return;
+
+	fclose(sp->f);
+	remove(sp->name);
+	spill_slots &= ~(1U << sp->slot);
+	free(sp->name);
+	free(sp->smp);
+	free(sp->win[0].buf);
+	free(sp->win);
+	free(sp);
+
+	m->spill = NULL;
+}
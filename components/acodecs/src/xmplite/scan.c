@@ -62,7 +62,7 @@ static int scan_module(struct context_data *ctx, int ep, int chain)
     int pdelay = 0;
     int loop_count[XMP_MAX_CHANNELS];
     int loop_row[XMP_MAX_CHANNELS];
-    struct xmp_event* event;
+    struct xmp_event ev, *event = &ev;
     int i, pat;
     int has_marker;
     struct ord_data *info;
@@ -222,7 +222,7 @@ static int scan_module(struct context_data *ctx, int ep, int chain)
 		if (row >= mod->xxt[mod->xxp[pat]->index[chn]]->rows)
 		    continue;
 
-		event = &EVENT(mod->xxo[ord], chn, row);
+		libxmp_get_event(m, TRACK_NUM(mod->xxo[ord], chn), row, event);
 
 		f1 = event->fxt;
 		p1 = event->fxp;
@@ -0,0 +1,255 @@
+/* Extended Module Player
+ * Copyright (C) 1996-2016 Claudio Matsuoka and Hipolito Carraro Jr
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Scan result cache
+ *
+ * libxmp_scan_sequences() walks every row of every reachable pattern to
+ * find the sequence entry points and the replay time of each order. For
+ * large IT/XM modules this dominates load time on slow targets, and the
+ * result only depends on the module data and a few player settings. We
+ * store it in a small file named after the module MD5 digest so that
+ * reopening the same module can skip the pattern walk entirely.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _MSC_VER
+#include <direct.h>
+#endif
+#include "common.h"
+
+#define SCAN_CACHE_MAGIC	0x58534331	/* "XSC1" */
+#define SCAN_CACHE_HDRSIZE	(4 + 16 + 5 * 4)
+#define SCAN_CACHE_SEQSIZE	(6 * 4)
+#ifndef LIBXMP_CORE_PLAYER
+#define SCAN_CACHE_ORDSIZE	(1 + 6 * 4)
+#else
+#define SCAN_CACHE_ORDSIZE	(1 + 5 * 4)
+#endif
+
+static uint8 *put32l(uint8 *b, uint32 w)
+{
+	b[0] = w & 0xff;
+	b[1] = (w >> 8) & 0xff;
+	b[2] = (w >> 16) & 0xff;
+	b[3] = (w >> 24) & 0xff;
+
+	return b + 4;
+}
+
+static int cache_filename(struct module_data *m, char *name, int size)
+{
+	char hex[33];
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		snprintf(hex + i * 2, 3, "%02x", m->md5[i]);
+	}
+
+	return snprintf(name, size, "%s/%s.xsc", m->scan_cache_path, hex);
+}
+
+static int cache_size(struct context_data *ctx, int num_sequences)
+{
+	struct module_data *m = &ctx->m;
+
+	return SCAN_CACHE_HDRSIZE + num_sequences * SCAN_CACHE_SEQSIZE +
+				m->mod.len * SCAN_CACHE_ORDSIZE;
+}
+
+/* Player settings that change the outcome of the scan are part of the key */
+static uint8 *put_key(struct context_data *ctx, uint8 *b)
+{
+	struct player_data *p = &ctx->p;
+	struct module_data *m = &ctx->m;
+
+	b = put32l(b, SCAN_CACHE_MAGIC);
+	memcpy(b, m->md5, 16);
+	b += 16;
+	b = put32l(b, m->mod.len);
+	b = put32l(b, p->flags & XMP_FLAGS_VBLANK);
+	b = put32l(b, (int)(m->time_factor * 1000));
+	b = put32l(b, (int)(m->rrate * 1000));
+
+	return b;
+}
+
+int libxmp_scan_cache_load(struct context_data *ctx)
+{
+	struct player_data *p = &ctx->p;
+	struct module_data *m = &ctx->m;
+	struct xmp_module *mod = &m->mod;
+	char name[PATH_MAX];
+	uint8 key[SCAN_CACHE_HDRSIZE];
+	uint8 *buf, *b;
+	FILE *f;
+	long size;
+	int i, num;
+
+	if (m->scan_cache_path == NULL || mod->len == 0)
+		return -1;
+
+	if (cache_filename(m, name, PATH_MAX) >= PATH_MAX)
+		return -1;
+
+	if ((f = fopen(name, "rb")) == NULL)
+		return -1;
+
+	if (fseek(f, 0, SEEK_END) < 0 || (size = ftell(f)) < SCAN_CACHE_HDRSIZE
+				|| fseek(f, 0, SEEK_SET) < 0) {
+		fclose(f);
+		return -1;
+	}
+
+	if ((buf = malloc(size)) == NULL) {
+		fclose(f);
+		return -1;
+	}
+
+	if (fread(buf, 1, size, f) != (size_t)size) {
+		goto err;
+	}
+	fclose(f);
+	f = NULL;
+
+	/* Key is everything up to the sequence count */
+	put_key(ctx, key);
+	if (memcmp(buf, key, SCAN_CACHE_HDRSIZE - 4) != 0) {
+		goto err;
+	}
+
+	num = readmem32l(buf + SCAN_CACHE_HDRSIZE - 4);
+	if (num < 1 || num > MAX_SEQUENCES || size != cache_size(ctx, num)) {
+		goto err;
+	}
+
+	b = buf + SCAN_CACHE_HDRSIZE;
+	m->num_sequences = num;
+	for (i = 0; i < num; i++) {
+		m->seq_data[i].entry_point = readmem32l(b);
+		m->seq_data[i].duration = readmem32l(b + 4);
+		p->scan[i].time = readmem32l(b + 8);
+		p->scan[i].ord = readmem32l(b + 12);
+		p->scan[i].row = readmem32l(b + 16);
+		p->scan[i].num = readmem32l(b + 20);
+		b += SCAN_CACHE_SEQSIZE;
+	}
+
+	memset(p->sequence_control, 0xff, XMP_MAX_MOD_LENGTH);
+	for (i = 0; i < XMP_MAX_MOD_LENGTH; i++) {
+		m->xxo_info[i].gvl = -1;
+	}
+
+	for (i = 0; i < mod->len; i++) {
+		struct ord_data *info = &m->xxo_info[i];
+
+		p->sequence_control[i] = b[0];
+		info->speed = readmem32l(b + 1);
+		info->bpm = readmem32l(b + 5);
+		info->gvl = readmem32l(b + 9);
+		info->time = readmem32l(b + 13);
+		info->start_row = readmem32l(b + 17);
+#ifndef LIBXMP_CORE_PLAYER
+		info->st26_speed = readmem32l(b + 21);
+#endif
+		b += SCAN_CACHE_ORDSIZE;
+	}
+
+	free(buf);
+
+	D_(D_INFO "scan cache hit: %s", name);
+	return 0;
+
+    err:
+	if (f != NULL)
+		fclose(f);
+	free(buf);
+	return -1;
+}
+
+void libxmp_scan_cache_save(struct context_data *ctx)
+{
+	struct player_data *p = &ctx->p;
+	struct module_data *m = &ctx->m;
+	struct xmp_module *mod = &m->mod;
+	char name[PATH_MAX];
+	uint8 *buf, *b;
+	FILE *f;
+	int i, size;
+
+	if (m->scan_cache_path == NULL || mod->len == 0)
+		return;
+
+	if (cache_filename(m, name, PATH_MAX) >= PATH_MAX)
+		return;
+
+	size = cache_size(ctx, m->num_sequences);
+	if ((buf = malloc(size)) == NULL)
+		return;
+
+	b = put_key(ctx, buf);
+	b = put32l(b, m->num_sequences);
+
+	for (i = 0; i < m->num_sequences; i++) {
+		b = put32l(b, m->seq_data[i].entry_point);
+		b = put32l(b, m->seq_data[i].duration);
+		b = put32l(b, p->scan[i].time);
+		b = put32l(b, p->scan[i].ord);
+		b = put32l(b, p->scan[i].row);
+		b = put32l(b, p->scan[i].num);
+	}
+
+	for (i = 0; i < mod->len; i++) {
+		struct ord_data *info = &m->xxo_info[i];
+
+		*b++ = p->sequence_control[i];
+		b = put32l(b, info->speed);
+		b = put32l(b, info->bpm);
+		b = put32l(b, info->gvl);
+		b = put32l(b, info->time);
+		b = put32l(b, info->start_row);
+#ifndef LIBXMP_CORE_PLAYER
+		b = put32l(b, info->st26_speed);
+#endif
+	}
+
+#ifdef _MSC_VER
+	_mkdir(m->scan_cache_path);
+#else
+	mkdir(m->scan_cache_path, 0755);
+#endif
+
+	if ((f = fopen(name, "wb")) != NULL) {
+		if (fwrite(buf, 1, size, f) != (size_t)size) {
+			fclose(f);
+			remove(name);
+		} else {
+			fclose(f);
+		}
+	}
+
+	free(buf);
+}
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""Packs game music files into a flash set for the appfs partition.
+
+The player lists the files of the set after the SD card, under /appfs, and
+plays them from memory-mapped flash instead of copying them to the heap.
+Write the image to the partition with esptool's parttool:
+
+    python3 flashset.py set.bin file...
+    parttool.py write_partition --partition-name appfs --input set.bin
+
+The image is a header (magic, file count), a 64-byte directory entry per
+file (name, offset, size) and the files, each on a 16-byte boundary. It
+must match GmeFlashHeader and GmeFlashEntry in src/acodecs.c.
+"""
+import os
+import struct
+import sys
+
+MAGIC = b"GMESET01"
+NAME_SIZE = 56
+ALIGN = 16
+PARTITION_SIZE = 0xDE0000  # appfs in partitions.csv
+EXTENSIONS = {".ay", ".gbs", ".gym", ".hes", ".kss", ".nsf", ".nsfe", ".sap", ".spc", ".vgm", ".vgz"}
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    output, paths = sys.argv[1], sys.argv[2:]
+
+    names = [os.path.basename(path) for path in paths]
+    for name in names:
+        if os.path.splitext(name)[1].lower() not in EXTENSIONS:
+            sys.exit(f"{name}: not a game music file")
+        if len(name.encode()) >= NAME_SIZE:
+            sys.exit(f"{name}: name longer than {NAME_SIZE - 1} bytes")
+    if len(set(names)) != len(names):
+        sys.exit("file names must be unique")
+
+    offset = 16 + 64 * len(paths)
+    directory, data = b"", b""
+    for name, path in zip(names, paths):
+        with open(path, "rb") as f:
+            contents = f.read()
+        offset += -offset % ALIGN
+        data += bytes(offset - 16 - 64 * len(paths) - len(data)) + contents
+        directory += struct.pack("<56sII", name.encode(), offset, len(contents))
+        offset += len(contents)
+    if offset > PARTITION_SIZE:
+        sys.exit(f"set is {offset} bytes, the partition holds {PARTITION_SIZE}")
+
+    with open(output, "wb") as f:
+        f.write(struct.pack("<8sII", MAGIC, len(paths), 0) + directory + data)
+
+
+if __name__ == "__main__":
+    main()
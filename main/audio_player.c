@@ -29,7 +29,8 @@ static void player_teardown_task(void);
 static void free_playlist(PlayerState *state);
 static FileType fops_determine_filetype(Entry *entry);
 static int make_playlist(PlayerState *state, const AudioPlayerParam params);
-static Song *create_song_from_entry(Entry *entry, const char *cwd);
+static Song *create_song_from_entry(Entry *entry, const char *cwd, int track, int track_count);
+static int entry_track_count(Entry *entry, const char *cwd);
 #define DECODER_ERROR(acodec, ...) do { \
   decoder->close(acodec); \
   ESP_LOGE(TAG, __VA_ARGS__); \
@@ -37,6 +38,8 @@ static Song *create_song_from_entry(Entry *entry, const char *cwd);
 } while(0)
 static int get_next_song_index(PlayerState *state, PlayerResult res, int current_index);
 static int fops_list_dir(Entry **entriesp, const char *cwd);
+static int fops_list_flash(Entry **entriesp);
+static void free_entries(Entry *entries, int n);
 static int entry_cmp(const void *a, const void *b);
 static void player_task(void *arg);
 
@@ -146,6 +149,12 @@ static FileType fops_determine_filetype(Entry *entry)
   {
     return FileTypeFLAC;
   }
+  else if (matches_extension(filename, len,
+                             (const char *[]){"nsf", "nsfe", "spc", "gbs", "vgm", "vgz", "ay", "kss", "hes", "sap", "gym", NULL},
+                             (const int[]){3, 4, 3, 3, 3, 3, 2, 3, 3, 3, 3}))
+  {
+    return FileTypeGME;
+  }
   return FileTypeNone;
 }
 
@@ -247,6 +256,7 @@ static PlayerResult handle_cmd(PlayerState *const state, const AudioInfo info,
  * @brief Set the metadata for the current song in the UI.
  *
  * Extracts and displays metadata for MP3 files or uses filename/artist fallback.
+ * Tracks of multi-track files get their track number appended.
  *
  * @param song The current song.
  */
@@ -258,10 +268,35 @@ static void set_metadata(const Song *const song)
     mp3_read_metadata(song->filepath, &meta);
     ui_player_set_metadata(meta.title, meta.artist, &app_ctx);
   }
+  else if (song->track_count > 1)
+  {
+    char title[PATH_MAX];
+    snprintf(title, sizeof(title), "%s (%d/%d)", song->filename,
+             song->track + 1, song->track_count);
+    ui_player_set_metadata(title, "Unknown Artist", &app_ctx);
+  }
   else
     ui_player_set_metadata(song->filename, "Unknown Artist", &app_ctx);
 }
 
+/**
+ * @brief Expand mono frames to stereo in place.
+ *
+ * audio_submit() takes stereo frames, so mono decoder output is duplicated
+ * into both channels, working backwards so no sample is overwritten early.
+ *
+ * @param buf The buffer holding the mono frames, with room for twice as many.
+ * @param n_frames The number of frames in the buffer.
+ */
+static void mono_to_stereo(int16_t *buf, int n_frames)
+{
+  for (int i = n_frames - 1; i >= 0; i--)
+  {
+    buf[2 * i + 1] = buf[i];
+    buf[2 * i] = buf[i];
+  }
+}
+
 /**
  * @brief Play a single song.
  *
@@ -285,7 +320,10 @@ static PlayerResult play_song(const Song *const song, int16_t *audio_buf)
     return PlayerResultError;
   }
 
-  if (decoder->open(&acodec, song->filepath) != 0)
+  int opened = song->track > 0 && decoder->open_track
+                   ? decoder->open_track(&acodec, song->filepath, song->track)
+                   : decoder->open(&acodec, song->filepath);
+  if (opened != 0)
   {
     ESP_LOGE(TAG, "error opening song %s\n", song->filepath);
     return PlayerResultError;
@@ -315,6 +353,10 @@ static PlayerResult play_song(const Song *const song, int16_t *audio_buf)
     {
       n_frames =
           decoder->decode(acodec, audio_buf, (int)info.channels, info.buf_size);
+      if (info.channels == 1 && n_frames > 0)
+      {
+        mono_to_stereo(audio_buf, n_frames);
+      }
       audio_submit(audio_buf, n_frames);
     }
     else
@@ -404,6 +446,55 @@ static int fops_list_dir(Entry **entriesp, const char *cwd)
   return n;
 }
 
+/**
+ * @brief List the files of the flash set.
+ *
+ * The flash set is game music packed into the appfs partition, played from
+ * memory-mapped flash. Its files are opened under ACODEC_FLASH_DIR.
+ *
+ * @param entriesp Pointer to store the array of entries.
+ * @return The number of entries, 0 if there is no flash set, or -1 on error.
+ */
+static int fops_list_flash(Entry **entriesp)
+{
+  int n = acodec_flash_count();
+  char name[PATH_MAX];
+
+  *entriesp = NULL;
+  if (n <= 0)
+    return 0;
+
+  Entry *entries = calloc(n, sizeof(*entries));
+  if (!entries)
+    return -1;
+  for (int i = 0; i < n; i++)
+  {
+    if (acodec_flash_name(i, name, sizeof(name)) != 0 || !(entries[i].name = strdup(name)))
+    {
+      free_entries(entries, i);
+      return -1;
+    }
+    entries[i].mode = S_IFREG;
+  }
+
+  qsort(entries, n, sizeof(*entries), entry_cmp);
+  *entriesp = entries;
+  return n;
+}
+
+/**
+ * @brief Free directory entries and their names.
+ *
+ * @param entries The array of entries.
+ * @param n The number of entries.
+ */
+static void free_entries(Entry *entries, int n)
+{
+  for (int i = 0; i < n; i++)
+    free(entries[i].name);
+  free(entries);
+}
+
 /**
  * @brief Get the next song index based on the result.
  *
@@ -452,12 +543,26 @@ static void player_task(void *arg)
   if (n_entries < 0)
   {
     ESP_LOGE(TAG, "Failed to list audio directory");
-    return;
   }
-  AudioPlayerParam params = {new_entries, n_entries, 0, AUDIO_FILE_PATH,
-                             true};
+  else
+  {
+    AudioPlayerParam params = {new_entries, n_entries, 0, AUDIO_FILE_PATH,
+                               true};
+    make_playlist(&player_state, params);
+    free_entries(new_entries, n_entries);
+  }
+
+  // The flash set plays after the SD card
+  n_entries = fops_list_flash(&new_entries);
+  if (n_entries > 0)
+  {
+    AudioPlayerParam params = {new_entries, n_entries, 0, ACODEC_FLASH_DIR,
+                               true};
+    make_playlist(&player_state, params);
+    free_entries(new_entries, n_entries);
+  }
 
-  if (make_playlist(&player_state, params) != 0)
+  if (player_state.playlist_length == 0)
   {
     ESP_LOGI(TAG, "Could not determine audio codec\n");
     return;
@@ -465,6 +570,8 @@ static void player_task(void *arg)
   struct PlayerState *state = &player_state;
   ESP_LOGI(TAG, "Playing playlist of length: %zu\n", state->playlist_length);
 
+  acodec_set_mode(AUDIO_DECODE_MODE);
+
   // Allocate audio buffer once for reuse
   const size_t max_buf_size = 16384; // Adjust based on needs
   int16_t *audio_buf = calloc(1, max_buf_size * sizeof(int16_t));
@@ -500,9 +607,11 @@ static void player_task(void *arg)
  *
  * @param entry The file entry.
  * @param cwd The current working directory.
+ * @param track The track to play within the file.
+ * @param track_count The number of tracks in the file.
  * @return Pointer to the created Song, or NULL on failure.
  */
-static Song *create_song_from_entry(Entry *entry, const char *cwd)
+static Song *create_song_from_entry(Entry *entry, const char *cwd, int track, int track_count)
 {
   Song *song = malloc(sizeof(Song));
   if (!song)
@@ -510,6 +619,8 @@ static Song *create_song_from_entry(Entry *entry, const char *cwd)
 
   AudioCodec codec = choose_codec(fops_determine_filetype(entry));
   song->codec = codec;
+  song->track = track;
+  song->track_count = track_count;
 
   char pathbuf[PATH_MAX];
   int printed = snprintf(pathbuf, PATH_MAX, "%s/%s", cwd, entry->name);
@@ -532,9 +643,34 @@ static Song *create_song_from_entry(Entry *entry, const char *cwd)
 }
 
 /**
- * @brief Create a playlist from directory entries.
+ * @brief Count the playable tracks in a directory entry.
  *
- * Builds a playlist of songs based on the provided parameters.
+ * Multi-track files such as NSF or GBS are probed by the decoder without
+ * being loaded. Other files hold a single track.
+ *
+ * @param entry The file entry.
+ * @param cwd The current working directory.
+ * @return The number of tracks, 0 if the entry can't be played.
+ */
+static int entry_track_count(Entry *entry, const char *cwd)
+{
+  AudioDecoder *decoder = acodec_get_decoder(choose_codec(fops_determine_filetype(entry)));
+  if (decoder == NULL)
+    return 0;
+  if (decoder->track_count == NULL)
+    return 1;
+
+  char pathbuf[PATH_MAX];
+  snprintf(pathbuf, PATH_MAX, "%s/%s", cwd, entry->name);
+  return decoder->track_count(pathbuf);
+}
+
+/**
+ * @brief Add directory entries to the playlist.
+ *
+ * Appends songs based on the provided parameters to the playlist. Each
+ * track of a multi-track file becomes its own playlist entry. The first
+ * call chooses the song to start with.
  *
  * @param state The player state to update.
  * @param params The parameters for playlist creation.
@@ -542,64 +678,59 @@ static Song *create_song_from_entry(Entry *entry, const char *cwd)
  */
 static int make_playlist(PlayerState *state, const AudioPlayerParam params)
 {
+  size_t first = params.play_all ? 0 : (size_t)params.index;
+  size_t last = params.play_all ? (size_t)params.n_entries : first + 1;
+  size_t start_song = 0;
+  size_t n_songs = 0;
+  static struct
+  {
+    int entry;
+    int track;
+    int track_count;
+  } songs[MAX_SONGS];
 
-  if (params.play_all)
+  const size_t max_songs = MAX_SONGS - state->playlist_length;
+
+  for (size_t i = first; i < last && n_songs < max_songs; i++)
   {
-    size_t start_song = 0;
-    size_t n_songs = 0;
-    size_t song_indices[MAX_SONGS];
-    for (size_t i = 0, j = 0; i < (size_t)params.n_entries; i++)
+    Entry *entry = &params.entries[i];
+    int track_count = entry_track_count(entry, params.cwd);
+    if ((size_t)params.index == i)
     {
-      Entry *entry = &params.entries[i];
-      AudioCodec codec = choose_codec(fops_determine_filetype(entry));
-      if (codec != AudioCodecUnknown)
-      {
-        if ((size_t)params.index == i)
-        {
-          start_song = j;
-        }
-        song_indices[j++] = i;
-        n_songs++;
-      }
+      start_song = n_songs;
     }
-
-    state->playlist = malloc(n_songs * sizeof(Song));
-    if (!state->playlist)
-      return -1;
-    state->playlist_length = n_songs;
-
-    for (size_t i = 0; i < n_songs; i++)
+    for (int track = 0; track < track_count && n_songs < max_songs; track++)
     {
-      Entry *entry = &params.entries[song_indices[i]];
-      Song *song = create_song_from_entry(entry, params.cwd);
-      if (!song)
-        return -1;
-      state->playlist[i] = *song;
-      free(song); // since we copied
+      songs[n_songs].entry = (int)i;
+      songs[n_songs].track = track;
+      songs[n_songs].track_count = track_count;
+      n_songs++;
     }
-    state->playlist_index = (int)start_song;
   }
-  else
+
+  if (n_songs == 0)
   {
-    Entry *entry = &params.entries[params.index];
-    AudioCodec codec = choose_codec(fops_determine_filetype(entry));
-    if (codec == AudioCodecUnknown)
-    {
-      return -1;
-    }
+    return -1;
+  }
 
-    state->playlist = malloc(1 * sizeof(Song));
-    if (!state->playlist)
-      return -1;
-    Song *song = create_song_from_entry(entry, params.cwd);
+  Song *playlist = realloc(state->playlist, (state->playlist_length + n_songs) * sizeof(Song));
+  if (!playlist)
+    return -1;
+  state->playlist = playlist;
+  if (state->playlist_length == 0)
+  {
+    state->playlist_index = start_song < n_songs ? (int)start_song : 0;
+  }
+
+  for (size_t i = 0; i < n_songs; i++)
+  {
+    Entry *entry = &params.entries[songs[i].entry];
+    Song *song = create_song_from_entry(entry, params.cwd, songs[i].track,
+                                        songs[i].track_count);
     if (!song)
-    {
-      free(state->playlist);
       return -1;
-    }
-    state->playlist[0] = *song;
-    free(song);
-    state->playlist_length = 1;
+    state->playlist[state->playlist_length++] = *song;
+    free(song); // since we copied
   }
 
   return 0;
@@ -48,6 +48,8 @@ typedef struct {
   char *filename;
   char *filepath;
   AudioCodec codec;
+  int track;       /** Track within a multi-track file */
+  int track_count; /** Number of tracks in the file */
 } Song;
 
 // Cmds sent to player task for control
@@ -8,6 +8,9 @@
 // Audio Configuration
 #define DEFAULT_SAMPLE_RATE 44100
 #define AUDIO_VOLUME_DEFAULT 20
+// Low-power decoding: AudioDecodeMono and/or AudioDecodeHalfRate trade
+// output quality for decode time, AudioDecodeFull plays files as they are
+#define AUDIO_DECODE_MODE AudioDecodeFull
 
 // Paths
 #define AUDIO_FILE_PATH "/sdcard/audio"